@@ -2,6 +2,23 @@
 #include <esp_log.h>
 #include "oscillator_handler.h"
 #include "logical_ops_handler.h"
+#include "output_handler.h"
+#include "mixer_handler.h"
+#include "engine_handler.h"
+#include "modulation_handler.h"
+#include "sweep_handler.h"
+#include "divider_handler.h"
+#include "lfsr_handler.h"
+#include "flip_flop_handler.h"
+#include "delay_handler.h"
+#include "multiplexer_handler.h"
+#include "voice_handler.h"
+#include "sequencer_handler.h"
+#include "mod_matrix_handler.h"
+#include "tap_handler.h"
+#include "node_stats_handler.h"
+#include "scope_handler.h"
+#include "udp_stream_handler.h"
 #include "api_utils.h"
 #include <string.h>
 
@@ -64,5 +81,124 @@ esp_err_t api_registry_init(httpd_handle_t server)
         return err;
     }
 
+    // Register output routing endpoints
+    err = api_register_endpoints(server, output_endpoints, output_endpoint_count);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Register DAC mixer endpoints
+    err = api_register_endpoints(server, mixer_endpoints, mixer_endpoint_count);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Register engine settings endpoints
+    err = api_register_endpoints(server, engine_endpoints, engine_endpoint_count);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Register oscillator modulation endpoints
+    err = api_register_endpoints(server, modulation_endpoints, modulation_endpoint_count);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Register frequency sweep endpoints
+    err = api_register_endpoints(server, sweep_endpoints, sweep_endpoint_count);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Register frequency divider endpoints
+    err = api_register_endpoints(server, divider_endpoints, divider_endpoint_count);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Register LFSR noise endpoints
+    err = api_register_endpoints(server, lfsr_endpoints, lfsr_endpoint_count);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Register flip-flop endpoints
+    err = api_register_endpoints(server, flip_flop_endpoints, flip_flop_endpoint_count);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Register delay line endpoints
+    err = api_register_endpoints(server, delay_endpoints, delay_endpoint_count);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Register multiplexer endpoints
+    err = api_register_endpoints(server, multiplexer_endpoints, multiplexer_endpoint_count);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Register voice pool endpoints
+    err = api_register_endpoints(server, voice_endpoints, voice_endpoint_count);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Register sequencer endpoints
+    err = api_register_endpoints(server, sequencer_endpoints, sequencer_endpoint_count);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Register modulation matrix endpoints
+    err = api_register_endpoints(server, mod_matrix_endpoints, mod_matrix_endpoint_count);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Register node tap endpoints
+    err = api_register_endpoints(server, tap_endpoints, tap_endpoint_count);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Register node statistics endpoints
+    err = api_register_endpoints(server, node_stats_endpoints, node_stats_endpoint_count);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Register scope endpoints
+    err = api_register_endpoints(server, scope_endpoints, scope_endpoint_count);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Register UDP stream endpoints
+    err = api_register_endpoints(server, udp_stream_endpoints, udp_stream_endpoint_count);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
     return ESP_OK;
 }
\ No newline at end of file
@@ -38,6 +38,9 @@ esp_err_t send_error_response(httpd_req_t *req, int status_code, const char* mes
     httpd_resp_set_status(req, status_code == 404 ? "404 Not Found" :
                               status_code == 400 ? "400 Bad Request" :
                               status_code == 408 ? "408 Request Timeout" :
+                              status_code == 409 ? "409 Conflict" :
+                              status_code == 429 ? "429 Too Many Requests" :
+                              status_code == 503 ? "503 Service Unavailable" :
                               "500 Internal Server Error");
     
     esp_err_t err = send_json_response(req, error);
@@ -0,0 +1,114 @@
+#include "delay_handler.h"
+#include "api_utils.h"
+#include <esp_log.h>
+#include "cJSON.h"
+#include "oscillator_logic.h"
+
+static const char *TAG = "delay_handler";
+
+esp_err_t delay_get_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "GET /api/delay");
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return send_error_response(req, 500, "Failed to create JSON object");
+    }
+
+    cJSON_AddNumberToObject(root, "input_node", oscillator_logic_get_delay_input());
+    cJSON_AddNumberToObject(root, "max_delay_ms", oscillator_logic_get_max_delay_ms());
+
+    cJSON *arr = cJSON_CreateArray();
+    for (int t = 0; t < DELAY_LINE_MAX_TAPS; t++)
+    {
+        cJSON *tap = cJSON_CreateObject();
+        cJSON_AddNumberToObject(tap, "tap", t);
+        cJSON_AddNumberToObject(tap, "node", OSCILLATOR_LOGIC_FIRST_DELAY_NODE + t);
+        cJSON_AddNumberToObject(tap, "delay_ms", oscillator_logic_get_delay_tap(t));
+        cJSON_AddItemToArray(arr, tap);
+    }
+    cJSON_AddItemToObject(root, "taps", arr);
+
+    esp_err_t err = send_json_response(req, root);
+    cJSON_Delete(root);
+    return err;
+}
+
+// input_node -1 отключает вход, tap и delay_ms задаются вместе, "clear": true стирает буфер
+esp_err_t delay_post_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "POST /api/delay");
+
+    cJSON *root = NULL;
+    esp_err_t err = parse_json_body(req, &root);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    cJSON *input_obj = cJSON_GetObjectItem(root, "input_node");
+    cJSON *tap_obj = cJSON_GetObjectItem(root, "tap");
+    cJSON *delay_obj = cJSON_GetObjectItem(root, "delay_ms");
+    cJSON *clear_obj = cJSON_GetObjectItem(root, "clear");
+
+    if ((tap_obj == NULL) != (delay_obj == NULL))
+    {
+        ESP_LOGE(TAG, "Missing required field: %s", tap_obj ? "delay_ms" : "tap");
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Missing required field");
+    }
+
+    if ((input_obj && !cJSON_IsNumber(input_obj))
+    || (tap_obj && !cJSON_IsNumber(tap_obj))
+    || (delay_obj && !cJSON_IsNumber(delay_obj))
+    || (clear_obj && !cJSON_IsBool(clear_obj)))
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid field type");
+    }
+
+    int input_node = input_obj ? input_obj->valueint : -1;
+    int tap = tap_obj ? tap_obj->valueint : 0;
+    double delay_ms = delay_obj ? delay_obj->valuedouble : 0.0;
+    bool clear = clear_obj && cJSON_IsTrue(clear_obj);
+    cJSON_Delete(root);
+
+    // все поля проверяются до того, как что-то из них встанет в очередь
+    if (input_obj && input_node >= 0 && oscillator_logic_get_node_result_pointer(input_node) == NULL)
+    {
+        return send_error_response(req, 400, "Invalid node ID");
+    }
+    if (delay_obj && oscillator_logic_set_delay_tap(tap, delay_ms) != ESP_OK)
+    {
+        return send_error_response(req, 400, "Invalid tap or delay");
+    }
+    if (input_obj)
+    {
+        oscillator_logic_set_delay_input(input_node < 0 ? -1 : input_node);
+    }
+    if (clear)
+    {
+        oscillator_logic_clear_delay_line();
+    }
+
+    // Create success response
+    cJSON *response = cJSON_CreateObject();
+    cJSON_AddStringToObject(response, "status", "success");
+    err = send_json_response(req, response);
+    cJSON_Delete(response);
+
+    return err;
+}
+
+const api_endpoint_t delay_endpoints[] = {
+    {.uri = "/api/delay",
+     .method = HTTP_GET,
+     .handler = delay_get_handler,
+     .user_ctx = NULL},
+    {.uri = "/api/delay",
+     .method = HTTP_POST,
+     .handler = delay_post_handler,
+     .user_ctx = NULL}};
+
+const int delay_endpoint_count = 2;
@@ -0,0 +1,108 @@
+#include "divider_handler.h"
+#include "api_utils.h"
+#include <esp_log.h>
+#include "cJSON.h"
+#include "oscillator_logic.h"
+
+static const char *TAG = "divider_handler";
+
+esp_err_t divider_get_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "GET /api/divider");
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return send_error_response(req, 500, "Failed to create JSON object");
+    }
+
+    frequency_divider_t *dividers = oscillator_logic_get_dividers();
+
+    cJSON *arr = cJSON_CreateArray();
+    for (int i = 0; i < OSCILLATOR_LOGIC_DIVIDER_COUNT; i++)
+    {
+        cJSON *divider = cJSON_CreateObject();
+        cJSON_AddNumberToObject(divider, "index", i);
+        cJSON_AddNumberToObject(divider, "clock_node", dividers[i].clock_id);
+        cJSON_AddNumberToObject(divider, "count", dividers[i].count);
+        cJSON_AddNumberToObject(divider, "first_node", OSCILLATOR_LOGIC_FIRST_DIVIDER_NODE + i * FREQUENCY_DIVIDER_STAGES);
+        cJSON_AddNumberToObject(divider, "stages", FREQUENCY_DIVIDER_STAGES);
+        cJSON_AddItemToArray(arr, divider);
+    }
+    cJSON_AddItemToObject(root, "dividers", arr);
+
+    esp_err_t err = send_json_response(req, root);
+    cJSON_Delete(root);
+    return err;
+}
+
+// clock_node -1 останавливает делитель, "reset": true обнуляет счетчик
+esp_err_t divider_post_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "POST /api/divider");
+
+    cJSON *root = NULL;
+    esp_err_t err = parse_json_body(req, &root);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    cJSON *index_obj = cJSON_GetObjectItem(root, "index");
+    cJSON *clock_obj = cJSON_GetObjectItem(root, "clock_node");
+    cJSON *reset_obj = cJSON_GetObjectItem(root, "reset");
+
+    if (!index_obj || (!clock_obj && !reset_obj))
+    {
+        ESP_LOGE(TAG, "Missing required field: %s", !index_obj ? "index" : "clock_node or reset");
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Missing required field");
+    }
+
+    if (!cJSON_IsNumber(index_obj)
+    || (clock_obj && !cJSON_IsNumber(clock_obj))
+    || (reset_obj && !cJSON_IsBool(reset_obj)))
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid field type");
+    }
+
+    int index = index_obj->valueint;
+    int clock_node = clock_obj ? clock_obj->valueint : -1;
+    bool reset = reset_obj && cJSON_IsTrue(reset_obj);
+    cJSON_Delete(root);
+
+    if (index < 0 || index >= OSCILLATOR_LOGIC_DIVIDER_COUNT)
+    {
+        return send_error_response(req, 400, "Invalid divider index");
+    }
+
+    if (clock_obj && oscillator_logic_set_divider_clock(index, clock_node < 0 ? -1 : clock_node) != ESP_OK)
+    {
+        return send_error_response(req, 400, "Invalid node ID");
+    }
+    if (reset)
+    {
+        oscillator_logic_reset_divider(index);
+    }
+
+    // Create success response
+    cJSON *response = cJSON_CreateObject();
+    cJSON_AddStringToObject(response, "status", "success");
+    err = send_json_response(req, response);
+    cJSON_Delete(response);
+
+    return err;
+}
+
+const api_endpoint_t divider_endpoints[] = {
+    {.uri = "/api/divider",
+     .method = HTTP_GET,
+     .handler = divider_get_handler,
+     .user_ctx = NULL},
+    {.uri = "/api/divider",
+     .method = HTTP_POST,
+     .handler = divider_post_handler,
+     .user_ctx = NULL}};
+
+const int divider_endpoint_count = 2;
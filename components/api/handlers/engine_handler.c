@@ -0,0 +1,114 @@
+#include "engine_handler.h"
+#include "api_utils.h"
+#include <esp_log.h>
+#include "cJSON.h"
+#include <string.h>
+#include "oscillator_logic.h"
+#include "common_defs.h"
+
+static const char *TAG = "engine_handler";
+
+static const char *engine_names[] = {
+    [OSCILLATOR_LOGIC_ENGINE_BLOCK] = "block",
+    [OSCILLATOR_LOGIC_ENGINE_EDGE] = "edge",
+};
+
+esp_err_t engine_get_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "GET /api/engine");
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return send_error_response(req, 500, "Failed to create JSON object");
+    }
+
+    int oversampling = oscillator_logic_get_oversampling();
+    cJSON_AddNumberToObject(root, "oversampling", oversampling);
+    cJSON_AddNumberToObject(root, "sample_rate", SYSTEM_SAMPLE_RATE);
+    cJSON_AddNumberToObject(root, "engine_rate", SYSTEM_SAMPLE_RATE * oversampling);
+    cJSON_AddNumberToObject(root, "block_size", OSCILLATOR_LOGIC_BLOCK_SIZE);
+    cJSON_AddStringToObject(root, "engine", engine_names[oscillator_logic_get_engine()]);
+    cJSON_AddStringToObject(root, "active_engine", engine_names[oscillator_logic_get_active_engine()]);
+
+    esp_err_t err = send_json_response(req, root);
+    cJSON_Delete(root);
+    return err;
+}
+
+esp_err_t engine_post_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "POST /api/engine");
+
+    cJSON *root = NULL;
+    esp_err_t err = parse_json_body(req, &root);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    cJSON *oversampling_obj = cJSON_GetObjectItem(root, "oversampling");
+    cJSON *engine_obj = cJSON_GetObjectItem(root, "engine");
+    if (!oversampling_obj && !engine_obj)
+    {
+        ESP_LOGE(TAG, "Missing required field: oversampling or engine");
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Missing required field");
+    }
+
+    if ((oversampling_obj && !cJSON_IsNumber(oversampling_obj))
+    || (engine_obj && !cJSON_IsString(engine_obj)))
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid field type");
+    }
+
+    int engine = -1;
+    if (engine_obj)
+    {
+        for (int i = 0; i < (int)(sizeof(engine_names) / sizeof(engine_names[0])); i++)
+        {
+            if (strcmp(engine_obj->valuestring, engine_names[i]) == 0)
+            {
+                engine = i;
+            }
+        }
+        if (engine < 0)
+        {
+            cJSON_Delete(root);
+            return send_error_response(req, 400, "Invalid engine");
+        }
+    }
+
+    int oversampling = oversampling_obj ? oversampling_obj->valueint : 0;
+    cJSON_Delete(root);
+
+    if (oversampling_obj && oscillator_logic_set_oversampling(oversampling) != ESP_OK)
+    {
+        return send_error_response(req, 400, "Invalid oversampling factor");
+    }
+    if (engine >= 0)
+    {
+        oscillator_logic_set_engine((oscillator_logic_engine_t)engine);
+    }
+
+    // Create success response
+    cJSON *response = cJSON_CreateObject();
+    cJSON_AddStringToObject(response, "status", "success");
+    err = send_json_response(req, response);
+    cJSON_Delete(response);
+
+    return err;
+}
+
+const api_endpoint_t engine_endpoints[] = {
+    {.uri = "/api/engine",
+     .method = HTTP_GET,
+     .handler = engine_get_handler,
+     .user_ctx = NULL},
+    {.uri = "/api/engine",
+     .method = HTTP_POST,
+     .handler = engine_post_handler,
+     .user_ctx = NULL}};
+
+const int engine_endpoint_count = 2;
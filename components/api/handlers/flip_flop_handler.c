@@ -0,0 +1,170 @@
+#include "flip_flop_handler.h"
+#include "api_utils.h"
+#include <esp_log.h>
+#include "cJSON.h"
+#include <string.h>
+#include "oscillator_logic.h"
+
+static const char *TAG = "flip_flop_handler";
+
+static const char *type_names[] = {
+    [FLIP_FLOP_D] = "d",
+    [FLIP_FLOP_T] = "t",
+    [FLIP_FLOP_JK] = "jk",
+    [FLIP_FLOP_SR] = "sr",
+    [FLIP_FLOP_SAMPLE_HOLD] = "sample_hold",
+};
+
+static const char *edge_names[] = {
+    [FLIP_FLOP_EDGE_RISING] = "rising",
+    [FLIP_FLOP_EDGE_FALLING] = "falling",
+};
+
+static int find_name(const char *const *names, int count, const char *name)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(name, names[i]) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// узел -1 (или меньше) отключает вход; false для неверного номера
+static bool resolve_input(const cJSON *obj, int *id)
+{
+    *id = obj->valueint < 0 ? -1 : obj->valueint;
+    return *id < 0 || oscillator_logic_get_node_result_pointer(*id) != NULL;
+}
+
+esp_err_t flip_flop_get_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "GET /api/flip-flops");
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return send_error_response(req, 500, "Failed to create JSON object");
+    }
+
+    flip_flop_t *flip_flops = oscillator_logic_get_flip_flops();
+
+    cJSON *arr = cJSON_CreateArray();
+    for (int i = 0; i < OSCILLATOR_LOGIC_FLIP_FLOP_COUNT; i++)
+    {
+        cJSON *ff = cJSON_CreateObject();
+        cJSON_AddNumberToObject(ff, "index", i);
+        cJSON_AddNumberToObject(ff, "node", OSCILLATOR_LOGIC_FIRST_FLIP_FLOP_NODE + i);
+        cJSON_AddStringToObject(ff, "type", type_names[flip_flops[i].type]);
+        cJSON_AddStringToObject(ff, "edge", edge_names[flip_flops[i].edge]);
+        cJSON_AddNumberToObject(ff, "input1", flip_flops[i].input_ids[0]);
+        cJSON_AddNumberToObject(ff, "input2", flip_flops[i].input_ids[1]);
+        cJSON_AddNumberToObject(ff, "clock_node", flip_flops[i].clock_id);
+        cJSON_AddBoolToObject(ff, "result", flip_flops[i].result);
+        cJSON_AddItemToArray(arr, ff);
+    }
+    cJSON_AddItemToObject(root, "flip_flops", arr);
+
+    esp_err_t err = send_json_response(req, root);
+    cJSON_Delete(root);
+    return err;
+}
+
+// все поля кроме index необязательны, отсутствующие остаются как были
+esp_err_t flip_flop_post_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "POST /api/flip-flops");
+
+    cJSON *root = NULL;
+    esp_err_t err = parse_json_body(req, &root);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    cJSON *index_obj = cJSON_GetObjectItem(root, "index");
+    cJSON *type_obj = cJSON_GetObjectItem(root, "type");
+    cJSON *edge_obj = cJSON_GetObjectItem(root, "edge");
+    cJSON *input1_obj = cJSON_GetObjectItem(root, "input1");
+    cJSON *input2_obj = cJSON_GetObjectItem(root, "input2");
+    cJSON *clock_obj = cJSON_GetObjectItem(root, "clock_node");
+
+    if (!index_obj)
+    {
+        ESP_LOGE(TAG, "Missing required field: index");
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Missing required field");
+    }
+
+    if (!cJSON_IsNumber(index_obj)
+    || (type_obj && !cJSON_IsString(type_obj))
+    || (edge_obj && !cJSON_IsString(edge_obj))
+    || (input1_obj && !cJSON_IsNumber(input1_obj))
+    || (input2_obj && !cJSON_IsNumber(input2_obj))
+    || (clock_obj && !cJSON_IsNumber(clock_obj)))
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid field type");
+    }
+
+    int index = index_obj->valueint;
+    if (index < 0 || index >= OSCILLATOR_LOGIC_FLIP_FLOP_COUNT)
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid flip-flop index");
+    }
+
+    oscillator_logic_flip_flop_config_t config;
+    oscillator_logic_get_flip_flop_config(index, &config);
+
+    int type = config.type;
+    int edge = config.edge;
+    if (type_obj)
+    {
+        type = find_name(type_names, FLIP_FLOP_TYPE_COUNT, type_obj->valuestring);
+    }
+    if (edge_obj)
+    {
+        edge = find_name(edge_names, FLIP_FLOP_EDGE_COUNT, edge_obj->valuestring);
+    }
+    if (type < 0 || edge < 0)
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, type < 0 ? "Invalid flip-flop type" : "Invalid clock edge");
+    }
+    config.type = (flip_flop_type_t)type;
+    config.edge = (flip_flop_edge_t)edge;
+
+    bool valid = (!input1_obj || resolve_input(input1_obj, &config.input_ids[0]))
+              && (!input2_obj || resolve_input(input2_obj, &config.input_ids[1]))
+              && (!clock_obj || resolve_input(clock_obj, &config.clock_id));
+    cJSON_Delete(root);
+
+    // тип, входы и такт встают в рендер вместе, в начале следующего блока
+    if (!valid || oscillator_logic_set_flip_flop(index, &config) != ESP_OK)
+    {
+        return send_error_response(req, 400, "Invalid node ID");
+    }
+
+    // Create success response
+    cJSON *response = cJSON_CreateObject();
+    cJSON_AddStringToObject(response, "status", "success");
+    err = send_json_response(req, response);
+    cJSON_Delete(response);
+
+    return err;
+}
+
+const api_endpoint_t flip_flop_endpoints[] = {
+    {.uri = "/api/flip-flops",
+     .method = HTTP_GET,
+     .handler = flip_flop_get_handler,
+     .user_ctx = NULL},
+    {.uri = "/api/flip-flops",
+     .method = HTTP_POST,
+     .handler = flip_flop_post_handler,
+     .user_ctx = NULL}};
+
+const int flip_flop_endpoint_count = 2;
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "esp_http_server.h"
+#include "api_types.h"
+
+esp_err_t flip_flop_get_handler(httpd_req_t *req);
+esp_err_t flip_flop_post_handler(httpd_req_t *req);
+
+extern const api_endpoint_t flip_flop_endpoints[];
+extern const int flip_flop_endpoint_count;
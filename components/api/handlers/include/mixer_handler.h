@@ -0,0 +1,10 @@
+#pragma once
+
+#include "esp_http_server.h"
+#include "api_types.h"
+
+esp_err_t mixer_get_handler(httpd_req_t *req);
+esp_err_t mixer_post_handler(httpd_req_t *req);
+
+extern const api_endpoint_t mixer_endpoints[];
+extern const int mixer_endpoint_count;
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "esp_http_server.h"
+#include "api_types.h"
+
+esp_err_t mod_matrix_get_handler(httpd_req_t *req);
+esp_err_t mod_matrix_post_handler(httpd_req_t *req);
+
+extern const api_endpoint_t mod_matrix_endpoints[];
+extern const int mod_matrix_endpoint_count;
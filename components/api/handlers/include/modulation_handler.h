@@ -0,0 +1,10 @@
+#pragma once
+
+#include "esp_http_server.h"
+#include "api_types.h"
+
+esp_err_t modulation_get_handler(httpd_req_t *req);
+esp_err_t modulation_post_handler(httpd_req_t *req);
+
+extern const api_endpoint_t modulation_endpoints[];
+extern const int modulation_endpoint_count;
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "esp_http_server.h"
+#include "api_types.h"
+
+esp_err_t node_stats_get_handler(httpd_req_t *req);
+
+extern const api_endpoint_t node_stats_endpoints[];
+extern const int node_stats_endpoint_count;
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "esp_http_server.h"
+#include "api_types.h"
+
+esp_err_t scope_get_handler(httpd_req_t *req);
+
+extern const api_endpoint_t scope_endpoints[];
+extern const int scope_endpoint_count;
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "esp_http_server.h"
+#include "api_types.h"
+
+// Binary pattern upload, POST /api/sequencer-patterns with one or more records
+// back to back, little-endian:
+//   0  uint8   sequencer index
+//   1  uint8   target (sequencer_target_t)
+//   2  uint8   target index
+//   3  uint8   length, 1..SEQUENCER_MAX_STEPS
+//   4  uint8   division, steps per beat
+//   5  uint8   reserved[3]
+//   8  uint64  gates, bit s set: step s fires
+//   16 float32 values[length]
+#define SEQUENCER_RECORD_HEADER_SIZE 16
+
+esp_err_t sequencer_get_handler(httpd_req_t *req);
+esp_err_t sequencer_post_handler(httpd_req_t *req);
+esp_err_t sequencer_pattern_post_handler(httpd_req_t *req);
+
+extern const api_endpoint_t sequencer_endpoints[];
+extern const int sequencer_endpoint_count;
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "esp_http_server.h"
+#include "api_types.h"
+
+esp_err_t sweep_get_handler(httpd_req_t *req);
+esp_err_t sweep_post_handler(httpd_req_t *req);
+
+extern const api_endpoint_t sweep_endpoints[];
+extern const int sweep_endpoint_count;
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "esp_http_server.h"
+#include "api_types.h"
+
+esp_err_t udp_stream_get_handler(httpd_req_t *req);
+esp_err_t udp_stream_post_handler(httpd_req_t *req);
+
+extern const api_endpoint_t udp_stream_endpoints[];
+extern const int udp_stream_endpoint_count;
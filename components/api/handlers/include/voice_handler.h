@@ -0,0 +1,10 @@
+#pragma once
+
+#include "esp_http_server.h"
+#include "api_types.h"
+
+esp_err_t voice_get_handler(httpd_req_t *req);
+esp_err_t voice_post_handler(httpd_req_t *req);
+
+extern const api_endpoint_t voice_endpoints[];
+extern const int voice_endpoint_count;
@@ -0,0 +1,213 @@
+#include "lfsr_handler.h"
+#include "api_utils.h"
+#include <esp_log.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include "cJSON.h"
+#include "oscillator_logic.h"
+
+static const char *TAG = "lfsr_handler";
+
+// Отводы передаются списком позиций: маска для 63-битного регистра не
+// помещается в число JSON без потерь
+static cJSON *taps_to_json(uint64_t taps)
+{
+    cJSON *arr = cJSON_CreateArray();
+    for (int t = 0; t < LFSR_MAX_LENGTH; t++)
+    {
+        if ((taps >> t) & 1u)
+        {
+            cJSON_AddItemToArray(arr, cJSON_CreateNumber(t));
+        }
+    }
+    return arr;
+}
+
+static bool taps_from_json(const cJSON *arr, uint64_t *taps)
+{
+    *taps = 0;
+    const cJSON *item = NULL;
+    cJSON_ArrayForEach(item, arr)
+    {
+        if (!cJSON_IsNumber(item) || item->valueint < 0 || item->valueint >= LFSR_MAX_LENGTH)
+        {
+            return false;
+        }
+        *taps |= 1ull << item->valueint;
+    }
+    return true;
+}
+
+// Затравка - целое число до 2^53, точнее JSON не передает, или строка из
+// шестнадцатеричных цифр (можно с 0x) для всех 63 бит регистра
+static bool seed_from_json(const cJSON *obj, uint64_t *seed)
+{
+    if (cJSON_IsNumber(obj))
+    {
+        double value = obj->valuedouble;
+        if (!(value >= 0.0 && value <= 9007199254740992.0) || (double)(uint64_t)value != value)
+        {
+            return false;
+        }
+        *seed = (uint64_t)value;
+        return true;
+    }
+    if (!cJSON_IsString(obj))
+    {
+        return false;
+    }
+    const char *digits = obj->valuestring;
+    if (digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X'))
+    {
+        digits += 2;
+    }
+    size_t n = 0;
+    while (n <= 16 && isxdigit((unsigned char)digits[n]))
+    {
+        n++;
+    }
+    if (n == 0 || n > 16 || digits[n] != '\0')
+    {
+        return false;
+    }
+    *seed = strtoull(digits, NULL, 16);
+    return true;
+}
+
+esp_err_t lfsr_get_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "GET /api/lfsr");
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return send_error_response(req, 500, "Failed to create JSON object");
+    }
+
+    lfsr_t *lfsrs = oscillator_logic_get_lfsrs();
+
+    cJSON *arr = cJSON_CreateArray();
+    for (int i = 0; i < OSCILLATOR_LOGIC_LFSR_COUNT; i++)
+    {
+        cJSON *lfsr = cJSON_CreateObject();
+        cJSON_AddNumberToObject(lfsr, "index", i);
+        cJSON_AddNumberToObject(lfsr, "node", OSCILLATOR_LOGIC_FIRST_LFSR_NODE + i);
+        cJSON_AddNumberToObject(lfsr, "length", lfsrs[i].length);
+        cJSON_AddItemToObject(lfsr, "taps", taps_to_json(lfsrs[i].taps));
+        cJSON_AddNumberToObject(lfsr, "clock_node", lfsrs[i].clock_id);
+        cJSON_AddItemToArray(arr, lfsr);
+    }
+    cJSON_AddItemToObject(root, "lfsrs", arr);
+
+    esp_err_t err = send_json_response(req, root);
+    cJSON_Delete(root);
+    return err;
+}
+
+// Меняются только переданные поля. clock_node -1 - сдвиг каждый отсчет,
+// length без taps берет отводы из таблицы, seed перезаряжает регистр
+esp_err_t lfsr_post_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "POST /api/lfsr");
+
+    cJSON *root = NULL;
+    esp_err_t err = parse_json_body(req, &root);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    cJSON *index_obj = cJSON_GetObjectItem(root, "index");
+    cJSON *length_obj = cJSON_GetObjectItem(root, "length");
+    cJSON *taps_obj = cJSON_GetObjectItem(root, "taps");
+    cJSON *clock_obj = cJSON_GetObjectItem(root, "clock_node");
+    cJSON *seed_obj = cJSON_GetObjectItem(root, "seed");
+
+    if (!index_obj)
+    {
+        ESP_LOGE(TAG, "Missing required field: index");
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Missing required field");
+    }
+
+    if (!cJSON_IsNumber(index_obj)
+    || (length_obj && !cJSON_IsNumber(length_obj))
+    || (taps_obj && !cJSON_IsArray(taps_obj))
+    || (clock_obj && !cJSON_IsNumber(clock_obj))
+    || (seed_obj && !cJSON_IsNumber(seed_obj) && !cJSON_IsString(seed_obj)))
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid field type");
+    }
+
+    uint64_t taps = 0;
+    if (taps_obj && !taps_from_json(taps_obj, &taps))
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid tap position");
+    }
+
+    uint64_t seed = 0;
+    if (seed_obj && !seed_from_json(seed_obj, &seed))
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid seed");
+    }
+
+    int index = index_obj->valueint;
+    int length = length_obj ? length_obj->valueint : 0;
+    int clock_node = clock_obj && clock_obj->valueint >= 0 ? clock_obj->valueint : -1;
+    cJSON_Delete(root);
+
+    if (index < 0 || index >= OSCILLATOR_LOGIC_LFSR_COUNT)
+    {
+        return send_error_response(req, 400, "Invalid LFSR index");
+    }
+
+    // все поля проверяются до того, как что-то из них встанет в очередь
+    if (clock_obj && clock_node >= 0 && oscillator_logic_get_node_result_pointer(clock_node) == NULL)
+    {
+        return send_error_response(req, 400, "Invalid node ID");
+    }
+
+    if (length_obj || taps_obj)
+    {
+        err = oscillator_logic_set_lfsr_length(index, length_obj ? length : 0, taps);
+        if (err == ESP_ERR_NOT_FOUND)
+        {
+            return send_error_response(req, 400, "No default taps for this length");
+        }
+        if (err != ESP_OK)
+        {
+            return send_error_response(req, 400, "Invalid length or taps");
+        }
+    }
+    if (clock_obj)
+    {
+        oscillator_logic_set_lfsr_clock(index, clock_node);
+    }
+    if (seed_obj)
+    {
+        oscillator_logic_seed_lfsr(index, seed);
+    }
+
+    // Create success response
+    cJSON *response = cJSON_CreateObject();
+    cJSON_AddStringToObject(response, "status", "success");
+    err = send_json_response(req, response);
+    cJSON_Delete(response);
+
+    return err;
+}
+
+const api_endpoint_t lfsr_endpoints[] = {
+    {.uri = "/api/lfsr",
+     .method = HTTP_GET,
+     .handler = lfsr_get_handler,
+     .user_ctx = NULL},
+    {.uri = "/api/lfsr",
+     .method = HTTP_POST,
+     .handler = lfsr_post_handler,
+     .user_ctx = NULL}};
+
+const int lfsr_endpoint_count = 2;
@@ -123,64 +123,22 @@ esp_err_t logical_ops_post_handler(httpd_req_t *req)
         return send_error_response(req, 400, "Invalid operation type");
     }
 
-    // Update the logical operation type
-    logical_ops_t *logical_ops = oscillator_logic_get_logical_ops();
-    if (logical_ops == NULL || logic_block_id < 0 || logic_block_id >= 3)
-    {
-        cJSON_Delete(root);
-        return send_error_response(req, 400, "Invalid logic block ID");
-    }
-
-    err = logical_ops_set_operation(&logical_ops[logic_block_id], operation_type);
-    if (err != ESP_OK)
-    {
-        cJSON_Delete(root);
-        return send_error_response(req, 500, "Failed to set operation type");
-    }
-
-    // Set inputs
-    Oscillator *oscillators = oscillator_logic_get_oscillators();
-    bool *input1 = &oscillators[input1_id_obj->valueint].result_bool;  // Default initialization
-    bool *input2 = &oscillators[input2_id_obj->valueint].result_bool;  // Default initialization
-
     int input1_id = input1_id_obj->valueint;
     int input2_id = input2_id_obj->valueint;
+    cJSON_Delete(root);
 
-    if (logic_block_id == 0 || logic_block_id == 1) {
-        if (input1_id >= 4) {
-            input1 = &logical_ops[input1_id-4].prev_result;
-        }
-        if (input2_id >= 4) {
-            input2 = &logical_ops[input2_id-4].prev_result;
-        }
+    if (logic_block_id < 0 || logic_block_id >= OSCILLATOR_LOGIC_LOGICAL_OP_COUNT)
+    {
+        return send_error_response(req, 400, "Invalid logic block ID");
     }
 
-    // Для logic_block_id 2 с input1_id 4 или 5 используем результаты из logical_ops
-    if (logic_block_id == 2) {
-        if (input1_id == 4 || input1_id == 5) {
-            input1 = &logical_ops[input1_id-4].result;
-        }
-        if (input2_id == 4 || input2_id == 5) {
-            input2 = &logical_ops[input2_id-4].result;
-        }
-        // взять предыдущий семпл для петли обратной связи
-        if (input1_id == 6) {
-            input1 = &logical_ops[input1_id-4].prev_result;
-        }
-        if (input2_id == 6) {
-            input2 = &logical_ops[input2_id-4].prev_result;
-        }
-    }    
-
-    err = logical_ops_set_inputs(&logical_ops[logic_block_id], input1, input2, input1_id_obj->valueint, input2_id_obj->valueint);
+    // указатели входов выбирает движок, операция и входы меняются между блоками
+    err = oscillator_logic_set_logical_op(logic_block_id, operation_type, input1_id, input2_id);
     if (err != ESP_OK)
     {
-        cJSON_Delete(root);
-        return send_error_response(req, 500, "Failed to set inputs");
+        return send_error_response(req, 400, "Invalid input ID");
     }
 
-    cJSON_Delete(root);
-
     // Create success response
     cJSON *response = cJSON_CreateObject();
     cJSON_AddStringToObject(response, "status", "success");
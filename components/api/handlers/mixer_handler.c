@@ -0,0 +1,123 @@
+#include "mixer_handler.h"
+#include "api_utils.h"
+#include <esp_log.h>
+#include "cJSON.h"
+#include "oscillator_logic.h"
+
+static const char *TAG = "mixer_handler";
+
+esp_err_t mixer_get_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "GET /api/mixer");
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return send_error_response(req, 500, "Failed to create JSON object");
+    }
+
+    cJSON *arr = cJSON_CreateArray();
+    for (int i = 0; i < DAC_MIXER_MAX_INPUTS; i++)
+    {
+        oscillator_logic_mixer_input_t settings;
+        oscillator_logic_get_mixer_input(i, &settings);
+        cJSON *input = cJSON_CreateObject();
+        cJSON_AddNumberToObject(input, "index", i);
+        cJSON_AddNumberToObject(input, "node_id", settings.node_id);
+        cJSON_AddNumberToObject(input, "weight", settings.weight);
+        cJSON_AddNumberToObject(input, "delay", settings.delay);
+        cJSON_AddItemToArray(arr, input);
+    }
+    cJSON_AddItemToObject(root, "inputs", arr);
+
+    esp_err_t err = send_json_response(req, root);
+    cJSON_Delete(root);
+    return err;
+}
+
+// node_id -1 отключает вход, weight и delay необязательны
+esp_err_t mixer_post_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "POST /api/mixer");
+
+    cJSON *root = NULL;
+    esp_err_t err = parse_json_body(req, &root);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    cJSON *index_obj = cJSON_GetObjectItem(root, "index");
+    cJSON *node_id_obj = cJSON_GetObjectItem(root, "node_id");
+    cJSON *weight_obj = cJSON_GetObjectItem(root, "weight");
+    cJSON *delay_obj = cJSON_GetObjectItem(root, "delay");
+
+    if (!index_obj || !node_id_obj)
+    {
+        ESP_LOGE(TAG, "Missing required field: %s", !index_obj ? "index" : "node_id");
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Missing required field");
+    }
+
+    if (!cJSON_IsNumber(index_obj)
+    || !cJSON_IsNumber(node_id_obj)
+    || (weight_obj && !cJSON_IsNumber(weight_obj))
+    || (delay_obj && !cJSON_IsNumber(delay_obj)))
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid field type");
+    }
+
+    int index = index_obj->valueint;
+    int node_id = node_id_obj->valueint;
+
+    // все поля проверяются до того, как что-то из них встанет в очередь
+    oscillator_logic_mixer_input_t input;
+    if (oscillator_logic_get_mixer_input(index, &input) != ESP_OK)
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid mixer input index");
+    }
+    input.node_id = node_id < 0 ? -1 : node_id;
+    bool valid = true;
+    if (weight_obj)
+    {
+        int weight = weight_obj->valueint;
+        valid = weight >= INT16_MIN && weight <= INT16_MAX;
+        input.weight = (int16_t)weight;
+    }
+    if (delay_obj)
+    {
+        input.delay = delay_obj->valueint;
+    }
+    cJSON_Delete(root);
+
+    if (input.node_id >= 0 && oscillator_logic_get_node_result_pointer(input.node_id) == NULL)
+    {
+        return send_error_response(req, 400, "Invalid node ID");
+    }
+    if (!valid || oscillator_logic_set_mixer_input(index, &input) != ESP_OK)
+    {
+        return send_error_response(req, 400, "Invalid mixer settings");
+    }
+
+    // Create success response
+    cJSON *response = cJSON_CreateObject();
+    cJSON_AddStringToObject(response, "status", "success");
+    err = send_json_response(req, response);
+    cJSON_Delete(response);
+
+    return err;
+}
+
+const api_endpoint_t mixer_endpoints[] = {
+    {.uri = "/api/mixer",
+     .method = HTTP_GET,
+     .handler = mixer_get_handler,
+     .user_ctx = NULL},
+    {.uri = "/api/mixer",
+     .method = HTTP_POST,
+     .handler = mixer_post_handler,
+     .user_ctx = NULL}};
+
+const int mixer_endpoint_count = 2;
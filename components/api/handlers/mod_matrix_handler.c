@@ -0,0 +1,270 @@
+#include "mod_matrix_handler.h"
+#include "api_utils.h"
+#include <esp_log.h>
+#include <string.h>
+#include "cJSON.h"
+#include "oscillator_logic.h"
+
+static const char *TAG = "mod_matrix_handler";
+
+// имя из списка в номер, -1 если такого нет
+static int find_name(const char *const *names, int count, const cJSON *obj)
+{
+    if (!cJSON_IsString(obj))
+    {
+        return -1;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(obj->valuestring, names[i]) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// число из поля или прежнее значение, если поля нет; false для не-числа
+static bool read_number(const cJSON *obj, const char *name, double *value)
+{
+    const cJSON *item = cJSON_GetObjectItem(obj, name);
+    if (item == NULL)
+    {
+        return true;
+    }
+    if (!cJSON_IsNumber(item))
+    {
+        return false;
+    }
+    *value = item->valuedouble;
+    return true;
+}
+
+static cJSON *names_to_json(const char *const *names, int count)
+{
+    cJSON *arr = cJSON_CreateArray();
+    for (int i = 0; i < count; i++)
+    {
+        cJSON_AddItemToArray(arr, cJSON_CreateString(names[i]));
+    }
+    return arr;
+}
+
+esp_err_t mod_matrix_get_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "GET /api/mod-matrix");
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return send_error_response(req, 500, "Failed to create JSON object");
+    }
+
+    mod_matrix_t state;
+    oscillator_logic_get_mod_matrix(&state);
+    const mod_matrix_t *matrix = &state;
+
+    cJSON *lfos = cJSON_CreateArray();
+    for (int l = 0; l < MOD_MATRIX_LFOS; l++)
+    {
+        const mod_matrix_lfo_t *lfo = &matrix->lfos[l];
+        cJSON *item = cJSON_CreateObject();
+        cJSON_AddNumberToObject(item, "index", l);
+        cJSON_AddStringToObject(item, "shape", mod_matrix_lfo_shape_names[lfo->shape]);
+        cJSON_AddNumberToObject(item, "rate", lfo->rate);
+        cJSON_AddNumberToObject(item, "value", lfo->value);
+        cJSON_AddItemToArray(lfos, item);
+    }
+    cJSON_AddItemToObject(root, "lfos", lfos);
+
+    cJSON *envelopes = cJSON_CreateArray();
+    for (int e = 0; e < MOD_MATRIX_ENVELOPES; e++)
+    {
+        const mod_matrix_envelope_t *env = &matrix->envelopes[e];
+        cJSON *item = cJSON_CreateObject();
+        cJSON_AddNumberToObject(item, "index", e);
+        cJSON_AddNumberToObject(item, "attack_ms", env->attack_ms);
+        cJSON_AddNumberToObject(item, "decay_ms", env->decay_ms);
+        cJSON_AddNumberToObject(item, "sustain", env->sustain);
+        cJSON_AddNumberToObject(item, "release_ms", env->release_ms);
+        cJSON_AddNumberToObject(item, "gate", env->gate_id);
+        cJSON_AddNumberToObject(item, "value", env->value);
+        cJSON_AddItemToArray(envelopes, item);
+    }
+    cJSON_AddItemToObject(root, "envelopes", envelopes);
+
+    cJSON *routes = cJSON_CreateArray();
+    for (int r = 0; r < MOD_MATRIX_MAX_ROUTES; r++)
+    {
+        const mod_matrix_route_t *route = &matrix->routes[r];
+        if (!route->active)
+        {
+            continue;
+        }
+        cJSON *item = cJSON_CreateObject();
+        cJSON_AddNumberToObject(item, "slot", r);
+        cJSON_AddStringToObject(item, "source", mod_matrix_source_names[route->source]);
+        cJSON_AddNumberToObject(item, "source_index", route->source_index);
+        cJSON_AddStringToObject(item, "destination", mod_matrix_dest_names[route->dest]);
+        cJSON_AddNumberToObject(item, "destination_index", route->dest_index);
+        cJSON_AddNumberToObject(item, "depth", route->depth);
+        cJSON_AddItemToArray(routes, item);
+    }
+    cJSON_AddItemToObject(root, "routes", routes);
+
+    cJSON_AddNumberToObject(root, "max_routes", MOD_MATRIX_MAX_ROUTES);
+    cJSON_AddItemToObject(root, "shapes", names_to_json(mod_matrix_lfo_shape_names, MOD_MATRIX_LFO_SHAPE_COUNT));
+    cJSON_AddItemToObject(root, "sources", names_to_json(mod_matrix_source_names, MOD_MATRIX_SOURCE_COUNT));
+    cJSON_AddItemToObject(root, "destinations", names_to_json(mod_matrix_dest_names, MOD_MATRIX_DEST_COUNT));
+
+    esp_err_t err = send_json_response(req, root);
+    cJSON_Delete(root);
+    return err;
+}
+
+// lfo: {index, shape, rate}, envelope: {index, attack_ms, decay_ms, sustain, release_ms, gate},
+// route: {slot, active, source, source_index, destination, destination_index, depth}.
+// Отсутствующие поля сохраняют прежние значения; ничего не меняется, пока весь запрос не проверен.
+esp_err_t mod_matrix_post_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "POST /api/mod-matrix");
+
+    cJSON *root = NULL;
+    esp_err_t err = parse_json_body(req, &root);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    cJSON *lfo_obj = cJSON_GetObjectItem(root, "lfo");
+    cJSON *env_obj = cJSON_GetObjectItem(root, "envelope");
+    cJSON *route_obj = cJSON_GetObjectItem(root, "route");
+
+    if (!lfo_obj && !env_obj && !route_obj)
+    {
+        ESP_LOGE(TAG, "Missing required field: lfo, envelope or route");
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Missing required field");
+    }
+
+    // изменения сначала проверяются на копии
+    mod_matrix_t check;
+    oscillator_logic_get_mod_matrix(&check);
+    bool valid = true;
+
+    int lfo_index = -1;
+    if (lfo_obj)
+    {
+        cJSON *index_obj = cJSON_GetObjectItem(lfo_obj, "index");
+        cJSON *shape_obj = cJSON_GetObjectItem(lfo_obj, "shape");
+        lfo_index = cJSON_IsNumber(index_obj) ? index_obj->valueint : -1;
+        if (lfo_index >= 0 && lfo_index < MOD_MATRIX_LFOS)
+        {
+            int shape = shape_obj ? find_name(mod_matrix_lfo_shape_names, MOD_MATRIX_LFO_SHAPE_COUNT, shape_obj)
+                                  : (int)check.lfos[lfo_index].shape;
+            double rate = check.lfos[lfo_index].rate;
+            valid = shape >= 0 && read_number(lfo_obj, "rate", &rate)
+                 && mod_matrix_set_lfo(&check, lfo_index, (mod_matrix_lfo_shape_t)shape, rate) == ESP_OK;
+        }
+        else
+        {
+            valid = false;
+        }
+    }
+
+    int env_index = -1;
+    int gate = -1;
+    if (valid && env_obj)
+    {
+        cJSON *index_obj = cJSON_GetObjectItem(env_obj, "index");
+        env_index = cJSON_IsNumber(index_obj) ? index_obj->valueint : -1;
+        if (env_index >= 0 && env_index < MOD_MATRIX_ENVELOPES)
+        {
+            mod_matrix_envelope_t *env = &check.envelopes[env_index];
+            double attack = env->attack_ms, decay = env->decay_ms, sustain = env->sustain, release = env->release_ms;
+            double gate_value = env->gate_id;
+            valid = read_number(env_obj, "attack_ms", &attack) && read_number(env_obj, "decay_ms", &decay)
+                 && read_number(env_obj, "sustain", &sustain) && read_number(env_obj, "release_ms", &release)
+                 && read_number(env_obj, "gate", &gate_value)
+                 && mod_matrix_set_envelope(&check, env_index, attack, decay, sustain, release) == ESP_OK;
+            gate = (int)gate_value;
+            valid = valid && gate >= -1 && gate < OSCILLATOR_LOGIC_NODE_COUNT;
+        }
+        else
+        {
+            valid = false;
+        }
+    }
+
+    int slot = -1;
+    mod_matrix_route_t route = {0};
+    if (valid && route_obj)
+    {
+        cJSON *slot_obj = cJSON_GetObjectItem(route_obj, "slot");
+        cJSON *active_obj = cJSON_GetObjectItem(route_obj, "active");
+        cJSON *source_obj = cJSON_GetObjectItem(route_obj, "source");
+        cJSON *dest_obj = cJSON_GetObjectItem(route_obj, "destination");
+        slot = cJSON_IsNumber(slot_obj) ? slot_obj->valueint : -1;
+        if (slot >= 0 && slot < MOD_MATRIX_MAX_ROUTES && (!active_obj || cJSON_IsBool(active_obj)))
+        {
+            route = check.routes[slot];
+            route.active = active_obj ? cJSON_IsTrue(active_obj) : true;
+            int source = source_obj ? find_name(mod_matrix_source_names, MOD_MATRIX_SOURCE_COUNT, source_obj) : (int)route.source;
+            int dest = dest_obj ? find_name(mod_matrix_dest_names, MOD_MATRIX_DEST_COUNT, dest_obj) : (int)route.dest;
+            double source_index = route.source_index, dest_index = route.dest_index;
+            valid = source >= 0 && dest >= 0
+                 && read_number(route_obj, "source_index", &source_index)
+                 && read_number(route_obj, "destination_index", &dest_index)
+                 && read_number(route_obj, "depth", &route.depth);
+            route.source = (mod_matrix_source_t)source;
+            route.dest = (mod_matrix_dest_t)dest;
+            route.source_index = (int)source_index;
+            route.dest_index = (int)dest_index;
+        }
+        else
+        {
+            valid = false;
+        }
+    }
+    cJSON_Delete(root);
+
+    // маршрут проверяется движком; все изменения применяются в начале следующего блока
+    if (!valid || (route_obj && oscillator_logic_set_mod_route(slot, &route) != ESP_OK))
+    {
+        return send_error_response(req, 400, "Invalid modulation parameters");
+    }
+
+    if (lfo_obj)
+    {
+        oscillator_logic_set_mod_lfo(lfo_index, check.lfos[lfo_index].shape, check.lfos[lfo_index].rate);
+    }
+    if (env_obj)
+    {
+        const mod_matrix_envelope_t *env = &check.envelopes[env_index];
+        oscillator_logic_set_mod_envelope(env_index, env->attack_ms, env->decay_ms, env->sustain, env->release_ms);
+        if (gate != env->gate_id)
+        {
+            oscillator_logic_set_mod_envelope_gate(env_index, gate);
+        }
+    }
+
+    // Create success response
+    cJSON *response = cJSON_CreateObject();
+    cJSON_AddStringToObject(response, "status", "success");
+    err = send_json_response(req, response);
+    cJSON_Delete(response);
+
+    return err;
+}
+
+const api_endpoint_t mod_matrix_endpoints[] = {
+    {.uri = "/api/mod-matrix",
+     .method = HTTP_GET,
+     .handler = mod_matrix_get_handler,
+     .user_ctx = NULL},
+    {.uri = "/api/mod-matrix",
+     .method = HTTP_POST,
+     .handler = mod_matrix_post_handler,
+     .user_ctx = NULL}};
+
+const int mod_matrix_endpoint_count = 2;
@@ -0,0 +1,145 @@
+#include "modulation_handler.h"
+#include "api_utils.h"
+#include <esp_log.h>
+#include "cJSON.h"
+#include <string.h>
+#include "oscillator_logic.h"
+
+static const char *TAG = "modulation_handler";
+
+static const char *fm_mode_names[] = {
+    [OSCILLATOR_LOGIC_FM_LINEAR] = "linear",
+    [OSCILLATOR_LOGIC_FM_EXPONENTIAL] = "exponential",
+};
+
+esp_err_t modulation_get_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "GET /api/modulation");
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return send_error_response(req, 500, "Failed to create JSON object");
+    }
+
+    cJSON *arr = cJSON_CreateArray();
+    for (int i = 0; i < OSCILLATOR_LOGIC_OSCILLATOR_COUNT; i++)
+    {
+        oscillator_logic_modulation_t modulation;
+        oscillator_logic_get_modulation(i, &modulation);
+
+        cJSON *item = cJSON_CreateObject();
+        cJSON_AddNumberToObject(item, "oscillator_id", i);
+        cJSON_AddNumberToObject(item, "fm_source", modulation.fm_source);
+        cJSON_AddStringToObject(item, "fm_mode", fm_mode_names[modulation.fm_mode]);
+        cJSON_AddNumberToObject(item, "fm_depth", modulation.fm_depth);
+        cJSON_AddNumberToObject(item, "sync_source", modulation.sync_source);
+        cJSON_AddItemToArray(arr, item);
+    }
+    cJSON_AddItemToObject(root, "modulations", arr);
+
+    esp_err_t err = send_json_response(req, root);
+    cJSON_Delete(root);
+    return err;
+}
+
+// все поля кроме oscillator_id необязательны, отсутствующие остаются как были;
+// источник -1 отключает FM или синхронизацию
+esp_err_t modulation_post_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "POST /api/modulation");
+
+    cJSON *root = NULL;
+    esp_err_t err = parse_json_body(req, &root);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    cJSON *oscillator_id_obj = cJSON_GetObjectItem(root, "oscillator_id");
+    cJSON *fm_source_obj = cJSON_GetObjectItem(root, "fm_source");
+    cJSON *fm_mode_obj = cJSON_GetObjectItem(root, "fm_mode");
+    cJSON *fm_depth_obj = cJSON_GetObjectItem(root, "fm_depth");
+    cJSON *sync_source_obj = cJSON_GetObjectItem(root, "sync_source");
+
+    if (!oscillator_id_obj)
+    {
+        ESP_LOGE(TAG, "Missing required field: oscillator_id");
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Missing required field");
+    }
+
+    if (!cJSON_IsNumber(oscillator_id_obj)
+    || (fm_source_obj && !cJSON_IsNumber(fm_source_obj))
+    || (fm_mode_obj && !cJSON_IsString(fm_mode_obj))
+    || (fm_depth_obj && !cJSON_IsNumber(fm_depth_obj))
+    || (sync_source_obj && !cJSON_IsNumber(sync_source_obj)))
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid field type");
+    }
+
+    int oscillator_id = oscillator_id_obj->valueint;
+    oscillator_logic_modulation_t modulation;
+    if (oscillator_logic_get_modulation(oscillator_id, &modulation) != ESP_OK)
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid oscillator ID");
+    }
+
+    if (fm_mode_obj)
+    {
+        int mode = -1;
+        for (int i = 0; i < (int)(sizeof(fm_mode_names) / sizeof(fm_mode_names[0])); i++)
+        {
+            if (strcmp(fm_mode_obj->valuestring, fm_mode_names[i]) == 0)
+            {
+                mode = i;
+            }
+        }
+        if (mode < 0)
+        {
+            cJSON_Delete(root);
+            return send_error_response(req, 400, "Invalid FM mode");
+        }
+        modulation.fm_mode = (oscillator_logic_fm_mode_t)mode;
+    }
+    if (fm_source_obj)
+    {
+        modulation.fm_source = fm_source_obj->valueint;
+    }
+    if (fm_depth_obj)
+    {
+        modulation.fm_depth = fm_depth_obj->valuedouble;
+    }
+    if (sync_source_obj)
+    {
+        modulation.sync_source = sync_source_obj->valueint;
+    }
+    cJSON_Delete(root);
+
+    if (oscillator_logic_set_modulation(oscillator_id, &modulation) != ESP_OK)
+    {
+        return send_error_response(req, 400, "Invalid modulation settings");
+    }
+
+    // Create success response
+    cJSON *response = cJSON_CreateObject();
+    cJSON_AddStringToObject(response, "status", "success");
+    err = send_json_response(req, response);
+    cJSON_Delete(response);
+
+    return err;
+}
+
+const api_endpoint_t modulation_endpoints[] = {
+    {.uri = "/api/modulation",
+     .method = HTTP_GET,
+     .handler = modulation_get_handler,
+     .user_ctx = NULL},
+    {.uri = "/api/modulation",
+     .method = HTTP_POST,
+     .handler = modulation_post_handler,
+     .user_ctx = NULL}};
+
+const int modulation_endpoint_count = 2;
@@ -0,0 +1,149 @@
+#include "multiplexer_handler.h"
+#include "api_utils.h"
+#include <esp_log.h>
+#include "cJSON.h"
+#include "oscillator_logic.h"
+
+static const char *TAG = "multiplexer_handler";
+
+// Список номеров узлов; короче max - остальные отключаются, -1 отключает
+// вход. false если список длиннее или в нем неверный узел
+static bool resolve_nodes(const cJSON *arr, int max, int *ids)
+{
+    if (cJSON_GetArraySize(arr) > max)
+    {
+        return false;
+    }
+    for (int i = 0; i < max; i++)
+    {
+        ids[i] = -1;
+        const cJSON *item = cJSON_GetArrayItem(arr, i);
+        if (item == NULL)
+        {
+            continue;
+        }
+        if (!cJSON_IsNumber(item))
+        {
+            return false;
+        }
+        if (item->valueint >= 0)
+        {
+            if (oscillator_logic_get_node_result_pointer(item->valueint) == NULL)
+            {
+                return false;
+            }
+            ids[i] = item->valueint;
+        }
+    }
+    return true;
+}
+
+static cJSON *ids_to_json(const int *ids, int count)
+{
+    cJSON *arr = cJSON_CreateArray();
+    for (int i = 0; i < count; i++)
+    {
+        cJSON_AddItemToArray(arr, cJSON_CreateNumber(ids[i]));
+    }
+    return arr;
+}
+
+esp_err_t multiplexer_get_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "GET /api/multiplexers");
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return send_error_response(req, 500, "Failed to create JSON object");
+    }
+
+    multiplexer_t *muxes = oscillator_logic_get_multiplexers();
+
+    cJSON *arr = cJSON_CreateArray();
+    for (int i = 0; i < OSCILLATOR_LOGIC_MULTIPLEXER_COUNT; i++)
+    {
+        cJSON *mux = cJSON_CreateObject();
+        cJSON_AddNumberToObject(mux, "index", i);
+        cJSON_AddNumberToObject(mux, "node", OSCILLATOR_LOGIC_FIRST_MULTIPLEXER_NODE + i);
+        cJSON_AddItemToObject(mux, "inputs", ids_to_json(muxes[i].input_ids, MULTIPLEXER_MAX_INPUTS));
+        cJSON_AddItemToObject(mux, "select", ids_to_json(muxes[i].select_ids, MULTIPLEXER_SELECT_BITS));
+        cJSON_AddItemToArray(arr, mux);
+    }
+    cJSON_AddItemToObject(root, "multiplexers", arr);
+
+    esp_err_t err = send_json_response(req, root);
+    cJSON_Delete(root);
+    return err;
+}
+
+// inputs - номера узлов по порядку входов, select - узлы шины выбора от младшего бита
+esp_err_t multiplexer_post_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "POST /api/multiplexers");
+
+    cJSON *root = NULL;
+    esp_err_t err = parse_json_body(req, &root);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    cJSON *index_obj = cJSON_GetObjectItem(root, "index");
+    cJSON *inputs_obj = cJSON_GetObjectItem(root, "inputs");
+    cJSON *select_obj = cJSON_GetObjectItem(root, "select");
+
+    if (!index_obj || (!inputs_obj && !select_obj))
+    {
+        ESP_LOGE(TAG, "Missing required field: %s", !index_obj ? "index" : "inputs or select");
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Missing required field");
+    }
+
+    if (!cJSON_IsNumber(index_obj)
+    || (inputs_obj && !cJSON_IsArray(inputs_obj))
+    || (select_obj && !cJSON_IsArray(select_obj)))
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid field type");
+    }
+
+    int index = index_obj->valueint;
+    if (index < 0 || index >= OSCILLATOR_LOGIC_MULTIPLEXER_COUNT)
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid multiplexer index");
+    }
+
+    oscillator_logic_multiplexer_config_t config;
+    oscillator_logic_get_multiplexer_config(index, &config);
+    bool valid = (!inputs_obj || resolve_nodes(inputs_obj, MULTIPLEXER_MAX_INPUTS, config.input_ids))
+              && (!select_obj || resolve_nodes(select_obj, MULTIPLEXER_SELECT_BITS, config.select_ids));
+    cJSON_Delete(root);
+
+    // входы и шина выбора встают в рендер вместе, в начале следующего блока
+    if (!valid || oscillator_logic_set_multiplexer(index, &config) != ESP_OK)
+    {
+        return send_error_response(req, 400, "Invalid node ID");
+    }
+
+    // Create success response
+    cJSON *response = cJSON_CreateObject();
+    cJSON_AddStringToObject(response, "status", "success");
+    err = send_json_response(req, response);
+    cJSON_Delete(response);
+
+    return err;
+}
+
+const api_endpoint_t multiplexer_endpoints[] = {
+    {.uri = "/api/multiplexers",
+     .method = HTTP_GET,
+     .handler = multiplexer_get_handler,
+     .user_ctx = NULL},
+    {.uri = "/api/multiplexers",
+     .method = HTTP_POST,
+     .handler = multiplexer_post_handler,
+     .user_ctx = NULL}};
+
+const int multiplexer_endpoint_count = 2;
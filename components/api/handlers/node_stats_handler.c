@@ -0,0 +1,91 @@
+#include "node_stats_handler.h"
+#include "api_utils.h"
+#include <esp_log.h>
+#include "cJSON.h"
+#include "oscillator_logic.h"
+#include "common_defs.h"
+
+static const char *TAG = "node_stats_handler";
+
+// Ожидаемая скважность оператора из измеренных скважностей входов,
+// если входы независимы (для двух разных осцилляторов почти так)
+static double expected_duty(logical_op_t op, double a, double b)
+{
+    switch (op)
+    {
+    case LOGICAL_OP_AND: return a * b;
+    case LOGICAL_OP_OR: return a + b - a * b;
+    case LOGICAL_OP_XOR: return a + b - 2.0 * a * b;
+    case LOGICAL_OP_NAND: return 1.0 - a * b;
+    case LOGICAL_OP_NOR: return 1.0 - (a + b - a * b);
+    case LOGICAL_OP_XNOR: return 1.0 - (a + b - 2.0 * a * b);
+    default: return 0.0;
+    }
+}
+
+esp_err_t node_stats_get_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "GET /api/node-stats");
+
+    static oscillator_logic_node_stats_t stats[OSCILLATOR_LOGIC_NODE_COUNT];
+    int count = oscillator_logic_get_node_stats(stats, OSCILLATOR_LOGIC_NODE_COUNT);
+    if (count == 0)
+    {
+        return send_error_response(req, 503, "Statistics are not ready");
+    }
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return send_error_response(req, 500, "Failed to create JSON object");
+    }
+
+    double engine_rate = (double)SYSTEM_SAMPLE_RATE * oscillator_logic_get_oversampling();
+    double duty[OSCILLATOR_LOGIC_NODE_COUNT];
+    for (int n = 0; n < count; n++)
+    {
+        duty[n] = (double)stats[n].ones / stats[n].samples;
+    }
+
+    logical_ops_t *ops = oscillator_logic_get_logical_ops();
+    cJSON *arr = cJSON_CreateArray();
+    for (int n = 0; n < count; n++)
+    {
+        cJSON *node = cJSON_CreateObject();
+        cJSON_AddNumberToObject(node, "node", n);
+        cJSON_AddNumberToObject(node, "duty", duty[n]);
+        cJSON_AddNumberToObject(node, "edges", stats[n].edges);
+        cJSON_AddNumberToObject(node, "edge_rate", stats[n].edges * engine_rate / stats[n].samples);
+        if (stats[n].edges == 0)
+        {
+            cJSON_AddStringToObject(node, "stuck", stats[n].ones ? "high" : "low");
+        }
+
+        int j = n - OSCILLATOR_LOGIC_FIRST_LOGICAL_OP_NODE;
+        if (j >= 0 && j < OSCILLATOR_LOGIC_LOGICAL_OP_COUNT)
+        {
+            int in1 = ops[j].input1_id;
+            int in2 = ops[j].input2_id;
+            if (in1 >= 0 && in1 < count && in2 >= 0 && in2 < count)
+            {
+                cJSON_AddNumberToObject(node, "expected_duty", expected_duty(ops[j].operation, duty[in1], duty[in2]));
+            }
+        }
+        cJSON_AddItemToArray(arr, node);
+    }
+    cJSON_AddItemToObject(root, "nodes", arr);
+    cJSON_AddNumberToObject(root, "window_samples", stats[0].samples);
+    cJSON_AddNumberToObject(root, "engine_rate", engine_rate);
+
+    esp_err_t err = send_json_response(req, root);
+    cJSON_Delete(root);
+    return err;
+}
+
+const api_endpoint_t node_stats_endpoints[] = {
+    {.uri = "/api/node-stats",
+     .method = HTTP_GET,
+     .handler = node_stats_get_handler,
+     .user_ctx = NULL}};
+
+const int node_stats_endpoint_count = 1;
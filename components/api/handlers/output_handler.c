@@ -0,0 +1,180 @@
+#include "output_handler.h"
+#include "api_utils.h"
+#include <esp_log.h>
+#include <string.h>
+#include "cJSON.h"
+#include "oscillator_logic.h"
+#include "output.h"
+#include "common_defs.h"
+
+static const char *TAG = "output_handler";
+
+#define MAX_OUTPUT_ROUTES 8
+
+static const char *output_mode_names[] = {
+    [OSCILLATOR_LOGIC_OUTPUT_SDM] = "sdm",
+    [OSCILLATOR_LOGIC_OUTPUT_BITSTREAM] = "bitstream",
+};
+
+static int output_mode_from_name(const char *name)
+{
+    for (int i = 0; i < (int)(sizeof(output_mode_names) / sizeof(output_mode_names[0])); i++)
+    {
+        if (strcmp(name, output_mode_names[i]) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+esp_err_t output_routes_get_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "GET /api/outputs");
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return send_error_response(req, 500, "Failed to create JSON object");
+    }
+
+    oscillator_logic_output_route_t routes[MAX_OUTPUT_ROUTES];
+    int count = oscillator_logic_get_output_routes(routes, MAX_OUTPUT_ROUTES);
+
+    cJSON *arr = cJSON_CreateArray();
+    for (int i = 0; i < count; i++)
+    {
+        cJSON *route = cJSON_CreateObject();
+        cJSON_AddNumberToObject(route, "gpio", routes[i].gpio_num);
+        cJSON_AddNumberToObject(route, "node_id", routes[i].node_id);
+        cJSON_AddStringToObject(route, "mode", output_mode_names[routes[i].mode]);
+        uint32_t decimation = output_get_stream_decimation(output_get_instance_by_gpio(routes[i].gpio_num));
+        if (decimation > 0)
+        {
+            cJSON_AddNumberToObject(route, "decimation", decimation);
+            cJSON_AddNumberToObject(route, "stream_rate", SYSTEM_SAMPLE_RATE / decimation);
+        }
+        uint32_t block_min, block_max;
+        output_handle_t handle = output_get_instance_by_gpio(routes[i].gpio_num);
+        if (output_get_stream_block_limits(handle, &block_min, &block_max) == ESP_OK)
+        {
+            cJSON_AddNumberToObject(route, "block_size", output_get_stream_block_size(handle));
+            cJSON_AddNumberToObject(route, "block_min", block_min);
+            cJSON_AddNumberToObject(route, "block_max", block_max);
+        }
+        cJSON_AddItemToArray(arr, route);
+    }
+    cJSON_AddItemToObject(root, "outputs", arr);
+
+    esp_err_t err = send_json_response(req, root);
+    cJSON_Delete(root);
+    return err;
+}
+
+esp_err_t output_route_post_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "POST /api/output");
+
+    cJSON *root = NULL;
+    esp_err_t err = parse_json_body(req, &root);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    cJSON *gpio_obj = cJSON_GetObjectItem(root, "gpio");
+    cJSON *node_id_obj = cJSON_GetObjectItem(root, "node_id");
+    cJSON *decimation_obj = cJSON_GetObjectItem(root, "decimation");
+    cJSON *block_min_obj = cJSON_GetObjectItem(root, "block_min");
+    cJSON *block_max_obj = cJSON_GetObjectItem(root, "block_max");
+    cJSON *mode_obj = cJSON_GetObjectItem(root, "mode");
+
+    if (!gpio_obj || !node_id_obj)
+    {
+        ESP_LOGE(TAG, "Missing required field: %s", !gpio_obj ? "gpio" : "node_id");
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Missing required field");
+    }
+
+    if (!cJSON_IsNumber(gpio_obj) || !cJSON_IsNumber(node_id_obj)
+    || (decimation_obj && !cJSON_IsNumber(decimation_obj))
+    || (block_min_obj && !cJSON_IsNumber(block_min_obj))
+    || (block_max_obj && !cJSON_IsNumber(block_max_obj))
+    || (mode_obj && !cJSON_IsString(mode_obj)))
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid field type");
+    }
+
+    // режим задается только при создании пина: sdm или bitstream
+    int mode = mode_obj ? output_mode_from_name(mode_obj->valuestring) : -1;
+    if (mode_obj && mode < 0)
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid output mode");
+    }
+
+    int gpio_num = gpio_obj->valueint;
+    int node_id = node_id_obj->valueint;
+    int decimation = decimation_obj ? decimation_obj->valueint : 0;
+    int block_min = block_min_obj ? block_min_obj->valueint : -1;
+    int block_max = block_max_obj ? block_max_obj->valueint : -1;
+    cJSON_Delete(root);
+
+    err = mode_obj
+        ? oscillator_logic_set_output_route_mode(gpio_num, node_id, (oscillator_logic_output_mode_t)mode)
+        : oscillator_logic_set_output_route(gpio_num, node_id);
+    if (err == ESP_ERR_INVALID_ARG)
+    {
+        return send_error_response(req, 400, "Invalid node ID");
+    }
+    if (err == ESP_ERR_INVALID_STATE)
+    {
+        return send_error_response(req, 409, "Output already runs in another mode");
+    }
+    if (err != ESP_OK)
+    {
+        return send_error_response(req, 500, "Failed to set output route");
+    }
+
+    // необязательный коэффициент децимации потока для клиента
+    if (decimation_obj
+    && output_set_stream_decimation(output_get_instance_by_gpio(gpio_num), decimation) != ESP_OK)
+    {
+        return send_error_response(req, 400, "Invalid decimation factor");
+    }
+
+    // границы длины блока потока, одна из них может остаться прежней
+    if (block_min_obj || block_max_obj)
+    {
+        output_handle_t handle = output_get_instance_by_gpio(gpio_num);
+        uint32_t current_min, current_max;
+        if (output_get_stream_block_limits(handle, &current_min, &current_max) != ESP_OK
+        || output_set_stream_block_limits(handle,
+                                          block_min_obj ? (uint32_t)block_min : current_min,
+                                          block_max_obj ? (uint32_t)block_max : current_max) != ESP_OK)
+        {
+            return send_error_response(req, 400, "Invalid block size limits");
+        }
+    }
+
+    // Create success response
+    cJSON *response = cJSON_CreateObject();
+    cJSON_AddStringToObject(response, "status", "success");
+    err = send_json_response(req, response);
+    cJSON_Delete(response);
+
+    return err;
+}
+
+const api_endpoint_t output_endpoints[] = {
+    {.uri = "/api/outputs",
+     .method = HTTP_GET,
+     .handler = output_routes_get_handler,
+     .user_ctx = NULL},
+    {.uri = "/api/output",
+     .method = HTTP_POST,
+     .handler = output_route_post_handler,
+     .user_ctx = NULL}};
+
+const int output_endpoint_count = 2;
@@ -0,0 +1,233 @@
+#include "scope_handler.h"
+#include "api_utils.h"
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <math.h>
+#include <stdlib.h>
+#include "cJSON.h"
+#include "oscillator_logic.h"
+#include "decimator.h"
+#include "spectrum.h"
+#include "common_defs.h"
+
+static const char *TAG = "scope_handler";
+
+// Рендер копирует слова узла, пока запрос ждет асинхронно: таймер раз в
+// SCOPE_POLL_MS ставит проверку в очередь сервера, а готовый снимок считается
+// в задаче HTTP-сервера прямо из буфера движка. Задача сервера не ждет, так
+// что кадры и пинги /ws идут своим чередом. Не чаще раза в
+// SCOPE_MIN_INTERVAL_MS, чтобы БПФ не отнимало время у звука.
+#define SCOPE_MIN_INTERVAL_MS 250
+#define SCOPE_CAPTURE_TIMEOUT_MS 500
+#define SCOPE_POLL_MS 10
+#define SCOPE_DEFAULT_POINTS 256
+#define SCOPE_MAX_POINTS 1024
+// первые отсчеты CIC, пока интеграторы не набрали историю
+#define SCOPE_SETTLE_SAMPLES 16
+#define SCOPE_DB_FLOOR -120
+
+static int64_t last_scope_us;
+static esp_timer_handle_t poll_timer;
+// запрос, ждущий снимка, NULL если никто не ждет
+static httpd_req_t *waiting_req;
+static httpd_handle_t waiting_server;
+static int waiting_node;
+static int waiting_points;
+static int64_t waiting_since_us;
+// при x1 снимок округлен до целых слов, отсюда запас в слово
+static int16_t pcm[OSCILLATOR_LOGIC_CAPTURE_SAMPLES + PACKED_WORD_BITS];
+static int16_t fft_re[SPECTRUM_MAX_POINTS];
+static int16_t fft_im[SPECTRUM_MAX_POINTS];
+static uint32_t power[SPECTRUM_MAX_POINTS / 2 + 1];
+
+static int query_int(const char *query, const char *key, int fallback)
+{
+    char value[16];
+    if (!query || httpd_query_key_value(query, key, value, sizeof(value)) != ESP_OK)
+    {
+        return fallback;
+    }
+    char *end;
+    long v = strtol(value, &end, 10);
+    return (end == value || *end != '\0') ? -1 : (int)v;
+}
+
+// снимок в PCM, спектр и ответ; слова читаются прямо из буфера движка
+static esp_err_t send_scope(httpd_req_t *req, int node_id, int points, const uint32_t *capture, size_t bits, int factor)
+{
+    // биты в PCM на выходной частоте тем же CIC, что и основной выход
+    decimator_t dec;
+    if (decimator_init(&dec, factor, DECIMATOR_INPUT_BITS) != ESP_OK)
+    {
+        return send_error_response(req, 500, "Failed to initialize decimator");
+    }
+    size_t count = decimator_process_bits(&dec, capture, bits, pcm, sizeof(pcm) / sizeof(pcm[0]));
+    if (count <= SCOPE_SETTLE_SAMPLES + SPECTRUM_MIN_POINTS)
+    {
+        return send_error_response(req, 500, "Capture is too short");
+    }
+    const int16_t *samples = &pcm[SCOPE_SETTLE_SAMPLES];
+    count -= SCOPE_SETTLE_SAMPLES;
+
+    size_t fft_points = SPECTRUM_MAX_POINTS;
+    while (fft_points > count)
+    {
+        fft_points >>= 1;
+    }
+    for (size_t i = 0; i < fft_points; i++)
+    {
+        fft_re[i] = samples[i];
+        fft_im[i] = 0;
+    }
+    spectrum_apply_hann(fft_re, fft_points);
+    spectrum_fft_q15(fft_re, fft_im, fft_points);
+    size_t bins = fft_points / 2 + 1;
+    spectrum_power(fft_re, fft_im, bins, power);
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return send_error_response(req, 500, "Failed to create JSON object");
+    }
+    cJSON_AddNumberToObject(root, "node", node_id);
+    cJSON_AddNumberToObject(root, "sample_rate", SYSTEM_SAMPLE_RATE);
+    cJSON_AddNumberToObject(root, "oversampling", factor);
+
+    // осциллограмма в int8, как основной поток /ws
+    if ((size_t)points > count)
+    {
+        points = (int)count;
+    }
+    cJSON *waveform = cJSON_CreateArray();
+    for (int i = 0; i < points; i++)
+    {
+        cJSON_AddItemToArray(waveform, cJSON_CreateNumber(samples[i] >> 8));
+    }
+    cJSON_AddItemToObject(root, "waveform", waveform);
+
+    // 0 дБ - синус полной шкалы: Ханн и масштаб БПФ оставляют от него четверть
+    double reference = (INT16_MAX / 4.0) * (INT16_MAX / 4.0);
+    cJSON *spectrum = cJSON_CreateArray();
+    for (size_t k = 0; k < bins; k++)
+    {
+        double db = power[k] ? 10.0 * log10(power[k] / reference) : SCOPE_DB_FLOOR;
+        if (db < SCOPE_DB_FLOOR) db = SCOPE_DB_FLOOR;
+        cJSON_AddItemToArray(spectrum, cJSON_CreateNumber(lround(db)));
+    }
+    cJSON_AddItemToObject(root, "spectrum_db", spectrum);
+    cJSON_AddNumberToObject(root, "fft_points", fft_points);
+    cJSON_AddNumberToObject(root, "bin_hz", (double)SYSTEM_SAMPLE_RATE / fft_points);
+
+    esp_err_t err = send_json_response(req, root);
+    cJSON_Delete(root);
+    return err;
+}
+
+// задача сервера: готов ли снимок для ждущего запроса
+static void scope_poll_work(void *arg)
+{
+    httpd_req_t *req = waiting_req;
+    if (!req)
+    {
+        return;
+    }
+    size_t bits = 0;
+    int factor = 1;
+    const uint32_t *capture = oscillator_logic_get_capture(&bits, &factor);
+    bool timed_out = esp_timer_get_time() - waiting_since_us >= (int64_t)SCOPE_CAPTURE_TIMEOUT_MS * 1000;
+    if (!capture && !timed_out)
+    {
+        return;
+    }
+
+    esp_timer_stop(poll_timer);
+    waiting_req = NULL;
+    if (capture)
+    {
+        send_scope(req, waiting_node, waiting_points, capture, bits, factor);
+    }
+    else
+    {
+        send_error_response(req, 503, "Capture timed out, is the engine running?");
+    }
+    httpd_req_async_handler_complete(req);
+}
+
+static void scope_poll_timer_callback(void *arg)
+{
+    httpd_queue_work(waiting_server, scope_poll_work, NULL);
+}
+
+esp_err_t scope_get_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "GET /api/scope");
+
+    char query[64];
+    const char *q = NULL;
+    size_t query_len = httpd_req_get_url_query_len(req);
+    if (query_len > 0 && query_len < sizeof(query) &&
+        httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK)
+    {
+        q = query;
+    }
+    int node_id = query_int(q, "node", OSCILLATOR_LOGIC_FINAL_LOGICAL_OP_NODE);
+    int points = query_int(q, "points", SCOPE_DEFAULT_POINTS);
+    if (node_id < 0 || node_id >= OSCILLATOR_LOGIC_NODE_COUNT)
+    {
+        return send_error_response(req, 400, "Invalid node");
+    }
+    if (points < SPECTRUM_MIN_POINTS || points > SCOPE_MAX_POINTS)
+    {
+        return send_error_response(req, 400, "Invalid points");
+    }
+
+    // новый снимок затер бы буфер, который еще ждет ответа
+    if (waiting_req)
+    {
+        return send_error_response(req, 429, "Scope capture in progress");
+    }
+    int64_t now = esp_timer_get_time();
+    if (last_scope_us != 0 && now - last_scope_us < (int64_t)SCOPE_MIN_INTERVAL_MS * 1000)
+    {
+        return send_error_response(req, 429, "Scope requested too often");
+    }
+    last_scope_us = now;
+
+    if (!poll_timer)
+    {
+        const esp_timer_create_args_t poll_timer_args = {
+            .callback = scope_poll_timer_callback,
+            .name = "scope_poll",
+        };
+        if (esp_timer_create(&poll_timer_args, &poll_timer) != ESP_OK)
+        {
+            return send_error_response(req, 500, "Failed to create scope timer");
+        }
+    }
+
+    if (oscillator_logic_request_capture(node_id) != ESP_OK)
+    {
+        return send_error_response(req, 400, "Invalid node");
+    }
+    // ответ уйдет из scope_poll_work, когда рендер наполнит снимок
+    httpd_req_t *async_req;
+    if (httpd_req_async_handler_begin(req, &async_req) != ESP_OK)
+    {
+        return send_error_response(req, 500, "Failed to hold the request");
+    }
+    waiting_node = node_id;
+    waiting_points = points;
+    waiting_since_us = now;
+    waiting_server = req->handle;
+    waiting_req = async_req;
+    esp_timer_start_periodic(poll_timer, (uint64_t)SCOPE_POLL_MS * 1000);
+    return ESP_OK;
+}
+
+const api_endpoint_t scope_endpoints[] = {
+    {.uri = "/api/scope",
+     .method = HTTP_GET,
+     .handler = scope_get_handler,
+     .user_ctx = NULL}};
+
+const int scope_endpoint_count = 1;
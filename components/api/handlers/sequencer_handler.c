@@ -0,0 +1,229 @@
+#include "sequencer_handler.h"
+#include "api_utils.h"
+#include <esp_log.h>
+#include <string.h>
+#include "cJSON.h"
+#include "oscillator_logic.h"
+
+static const char *TAG = "sequencer_handler";
+
+#define SEQUENCER_MAX_MESSAGE_SIZE \
+    (OSCILLATOR_LOGIC_SEQUENCER_COUNT * (SEQUENCER_RECORD_HEADER_SIZE + SEQUENCER_MAX_STEPS * 4))
+
+static uint64_t read_u64_le(const uint8_t *p)
+{
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--)
+    {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+static float read_f32_le(const uint8_t *p)
+{
+    uint32_t bits = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+esp_err_t sequencer_get_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "GET /api/sequencers");
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return send_error_response(req, 500, "Failed to create JSON object");
+    }
+
+    cJSON_AddNumberToObject(root, "bpm", oscillator_logic_get_tempo());
+    cJSON_AddBoolToObject(root, "running", oscillator_logic_get_sequencers_running());
+
+    const sequencer_t *sequencers = oscillator_logic_get_sequencers();
+    cJSON *arr = cJSON_CreateArray();
+    for (int i = 0; i < OSCILLATOR_LOGIC_SEQUENCER_COUNT; i++)
+    {
+        const sequencer_pattern_t *pattern = &sequencers[i].pattern;
+        cJSON *seq = cJSON_CreateObject();
+        cJSON_AddNumberToObject(seq, "index", i);
+        cJSON_AddStringToObject(seq, "target", sequencer_get_target_name(pattern->target));
+        cJSON_AddNumberToObject(seq, "target_index", pattern->target_index);
+        cJSON_AddNumberToObject(seq, "length", pattern->length);
+        cJSON_AddNumberToObject(seq, "division", pattern->division);
+        cJSON_AddNumberToObject(seq, "step", sequencers[i].step);
+
+        cJSON *gates = cJSON_CreateArray();
+        cJSON *values = cJSON_CreateArray();
+        for (int s = 0; s < pattern->length; s++)
+        {
+            cJSON_AddItemToArray(gates, cJSON_CreateBool((pattern->gates >> s) & 1u));
+            cJSON_AddItemToArray(values, cJSON_CreateNumber(pattern->values[s]));
+        }
+        cJSON_AddItemToObject(seq, "gates", gates);
+        cJSON_AddItemToObject(seq, "values", values);
+        cJSON_AddItemToArray(arr, seq);
+    }
+    cJSON_AddItemToObject(root, "sequencers", arr);
+
+    esp_err_t err = send_json_response(req, root);
+    cJSON_Delete(root);
+    return err;
+}
+
+// транспорт: темп и запуск/остановка всех секвенсоров
+esp_err_t sequencer_post_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "POST /api/sequencers");
+
+    cJSON *root = NULL;
+    esp_err_t err = parse_json_body(req, &root);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    cJSON *bpm_obj = cJSON_GetObjectItem(root, "bpm");
+    cJSON *running_obj = cJSON_GetObjectItem(root, "running");
+
+    if (!bpm_obj && !running_obj)
+    {
+        ESP_LOGE(TAG, "Missing required field: bpm or running");
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Missing required field");
+    }
+
+    if ((bpm_obj && !cJSON_IsNumber(bpm_obj)) || (running_obj && !cJSON_IsBool(running_obj)))
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid field type");
+    }
+
+    if (bpm_obj && oscillator_logic_set_tempo(bpm_obj->valuedouble) != ESP_OK)
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid tempo");
+    }
+    if (running_obj)
+    {
+        oscillator_logic_set_sequencers_running(cJSON_IsTrue(running_obj));
+    }
+    cJSON_Delete(root);
+
+    // Create success response
+    cJSON *response = cJSON_CreateObject();
+    cJSON_AddStringToObject(response, "status", "success");
+    err = send_json_response(req, response);
+    cJSON_Delete(response);
+
+    return err;
+}
+
+// Все записи проверяются до применения: неверное сообщение не меняет ни одного секвенсора
+esp_err_t sequencer_pattern_post_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "POST /api/sequencer-patterns");
+
+    int total_len = req->content_len;
+    if (total_len < SEQUENCER_RECORD_HEADER_SIZE || total_len > SEQUENCER_MAX_MESSAGE_SIZE)
+    {
+        return send_error_response(req, 400, "Invalid message size");
+    }
+
+    uint8_t *content = malloc(total_len);
+    if (!content)
+    {
+        return ESP_FAIL;
+    }
+
+    int received = 0;
+    while (received < total_len)
+    {
+        int ret = httpd_req_recv(req, (char *)content + received, total_len - received);
+        if (ret <= 0)
+        {
+            free(content);
+            if (ret == HTTPD_SOCK_ERR_TIMEOUT)
+            {
+                return send_error_response(req, 408, "Request timeout");
+            }
+            return ESP_FAIL;
+        }
+        received += ret;
+    }
+
+    int indexes[OSCILLATOR_LOGIC_SEQUENCER_COUNT];
+    // 4 KB, не на стеке задачи сервера; обработчики идут в одной задаче
+    static sequencer_pattern_t patterns[OSCILLATOR_LOGIC_SEQUENCER_COUNT];
+    int count = 0;
+    int pos = 0;
+    bool valid = true;
+    while (valid && pos < total_len)
+    {
+        const uint8_t *record = content + pos;
+        if (count >= OSCILLATOR_LOGIC_SEQUENCER_COUNT || total_len - pos < SEQUENCER_RECORD_HEADER_SIZE)
+        {
+            valid = false;
+            break;
+        }
+        int length = record[3];
+        int size = SEQUENCER_RECORD_HEADER_SIZE + length * (int)sizeof(float);
+        if (length < 1 || length > SEQUENCER_MAX_STEPS || record[0] >= OSCILLATOR_LOGIC_SEQUENCER_COUNT
+        || total_len - pos < size)
+        {
+            valid = false;
+            break;
+        }
+
+        sequencer_pattern_t *pattern = &patterns[count];
+        memset(pattern, 0, sizeof(*pattern));
+        pattern->target = (sequencer_target_t)record[1];
+        pattern->target_index = record[2];
+        pattern->length = length;
+        pattern->division = record[4];
+        pattern->gates = read_u64_le(record + 8);
+        for (int s = 0; s < length; s++)
+        {
+            pattern->values[s] = read_f32_le(record + SEQUENCER_RECORD_HEADER_SIZE + s * sizeof(float));
+        }
+        valid = oscillator_logic_validate_sequencer_pattern(pattern) == ESP_OK;
+        indexes[count++] = record[0];
+        pos += size;
+    }
+    free(content);
+
+    if (!valid)
+    {
+        return send_error_response(req, 400, "Invalid pattern");
+    }
+    for (int i = 0; i < count; i++)
+    {
+        oscillator_logic_set_sequencer_pattern(indexes[i], &patterns[i]);
+    }
+
+    // Create success response
+    cJSON *response = cJSON_CreateObject();
+    cJSON_AddStringToObject(response, "status", "success");
+    cJSON_AddNumberToObject(response, "patterns", count);
+    esp_err_t err = send_json_response(req, response);
+    cJSON_Delete(response);
+
+    return err;
+}
+
+const api_endpoint_t sequencer_endpoints[] = {
+    {.uri = "/api/sequencers",
+     .method = HTTP_GET,
+     .handler = sequencer_get_handler,
+     .user_ctx = NULL},
+    {.uri = "/api/sequencers",
+     .method = HTTP_POST,
+     .handler = sequencer_post_handler,
+     .user_ctx = NULL},
+    {.uri = "/api/sequencer-patterns",
+     .method = HTTP_POST,
+     .handler = sequencer_pattern_post_handler,
+     .user_ctx = NULL}};
+
+const int sequencer_endpoint_count = 3;
@@ -0,0 +1,154 @@
+#include "sweep_handler.h"
+#include "api_utils.h"
+#include <esp_log.h>
+#include "cJSON.h"
+#include <string.h>
+#include "oscillator_logic.h"
+
+static const char *TAG = "sweep_handler";
+
+static const char *shape_names[] = {
+    [OSCILLATOR_LOGIC_SWEEP_LINEAR] = "linear",
+    [OSCILLATOR_LOGIC_SWEEP_EXPONENTIAL] = "exponential",
+};
+
+esp_err_t sweep_get_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "GET /api/sweep");
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return send_error_response(req, 500, "Failed to create JSON object");
+    }
+
+    cJSON *arr = cJSON_CreateArray();
+    for (int i = 0; i < OSCILLATOR_LOGIC_OSCILLATOR_COUNT; i++)
+    {
+        oscillator_logic_sweep_status_t status;
+        oscillator_logic_get_sweep_status(i, &status);
+
+        cJSON *item = cJSON_CreateObject();
+        cJSON_AddNumberToObject(item, "oscillator_id", i);
+        cJSON_AddBoolToObject(item, "active", status.active);
+        cJSON_AddNumberToObject(item, "frequency", status.frequency);
+        cJSON_AddNumberToObject(item, "end_frequency", status.end_frequency);
+        cJSON_AddNumberToObject(item, "remaining_ms", status.remaining_ms);
+        cJSON_AddItemToArray(arr, item);
+    }
+    cJSON_AddItemToObject(root, "sweeps", arr);
+
+    esp_err_t err = send_json_response(req, root);
+    cJSON_Delete(root);
+    return err;
+}
+
+// start_frequency по умолчанию текущая частота, shape по умолчанию exponential;
+// "stop": true останавливает свип на достигнутой частоте
+esp_err_t sweep_post_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "POST /api/sweep");
+
+    cJSON *root = NULL;
+    esp_err_t err = parse_json_body(req, &root);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    cJSON *oscillator_id_obj = cJSON_GetObjectItem(root, "oscillator_id");
+    cJSON *stop_obj = cJSON_GetObjectItem(root, "stop");
+    cJSON *start_obj = cJSON_GetObjectItem(root, "start_frequency");
+    cJSON *end_obj = cJSON_GetObjectItem(root, "end_frequency");
+    cJSON *duration_obj = cJSON_GetObjectItem(root, "duration_ms");
+    cJSON *shape_obj = cJSON_GetObjectItem(root, "shape");
+
+    bool stop = stop_obj && cJSON_IsTrue(stop_obj);
+    if (!oscillator_id_obj || (!stop && (!end_obj || !duration_obj)))
+    {
+        ESP_LOGE(TAG, "Missing required field: %s",
+                 !oscillator_id_obj ? "oscillator_id" :
+                 !end_obj ? "end_frequency" : "duration_ms");
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Missing required field");
+    }
+
+    if (!cJSON_IsNumber(oscillator_id_obj)
+    || (stop_obj && !cJSON_IsBool(stop_obj))
+    || (start_obj && !cJSON_IsNumber(start_obj))
+    || (end_obj && !cJSON_IsNumber(end_obj))
+    || (duration_obj && !cJSON_IsNumber(duration_obj))
+    || (shape_obj && !cJSON_IsString(shape_obj)))
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid field type");
+    }
+
+    int oscillator_id = oscillator_id_obj->valueint;
+    if (oscillator_id < 0 || oscillator_id >= OSCILLATOR_LOGIC_OSCILLATOR_COUNT)
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid oscillator ID");
+    }
+
+    if (stop)
+    {
+        cJSON_Delete(root);
+        err = oscillator_logic_stop_sweep(oscillator_id);
+    }
+    else
+    {
+        oscillator_logic_sweep_t sweep = {
+            .start_frequency = start_obj ? start_obj->valuedouble
+                                         : oscillator_logic_get_oscillators()[oscillator_id].frequency,
+            .end_frequency = end_obj->valuedouble,
+            .duration_ms = duration_obj->valuedouble,
+            .shape = OSCILLATOR_LOGIC_SWEEP_EXPONENTIAL,
+        };
+
+        if (shape_obj)
+        {
+            int shape = -1;
+            for (int i = 0; i < (int)(sizeof(shape_names) / sizeof(shape_names[0])); i++)
+            {
+                if (strcmp(shape_obj->valuestring, shape_names[i]) == 0)
+                {
+                    shape = i;
+                }
+            }
+            if (shape < 0)
+            {
+                cJSON_Delete(root);
+                return send_error_response(req, 400, "Invalid sweep shape");
+            }
+            sweep.shape = (oscillator_logic_sweep_shape_t)shape;
+        }
+        cJSON_Delete(root);
+        err = oscillator_logic_start_sweep(oscillator_id, &sweep);
+    }
+
+    if (err != ESP_OK)
+    {
+        return send_error_response(req, 400, "Invalid sweep settings");
+    }
+
+    // Create success response
+    cJSON *response = cJSON_CreateObject();
+    cJSON_AddStringToObject(response, "status", "success");
+    err = send_json_response(req, response);
+    cJSON_Delete(response);
+
+    return err;
+}
+
+const api_endpoint_t sweep_endpoints[] = {
+    {.uri = "/api/sweep",
+     .method = HTTP_GET,
+     .handler = sweep_get_handler,
+     .user_ctx = NULL},
+    {.uri = "/api/sweep",
+     .method = HTTP_POST,
+     .handler = sweep_post_handler,
+     .user_ctx = NULL}};
+
+const int sweep_endpoint_count = 2;
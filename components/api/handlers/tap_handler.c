@@ -0,0 +1,98 @@
+#include "tap_handler.h"
+#include "api_utils.h"
+#include <esp_log.h>
+#include "cJSON.h"
+#include "oscillator_logic.h"
+
+static const char *TAG = "tap_handler";
+
+esp_err_t tap_get_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "GET /api/taps");
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return send_error_response(req, 500, "Failed to create JSON object");
+    }
+
+    cJSON *arr = cJSON_CreateArray();
+    for (int t = 0; t < OSCILLATOR_LOGIC_MAX_TAPS; t++)
+    {
+        cJSON *tap = cJSON_CreateObject();
+        cJSON_AddNumberToObject(tap, "tap", t);
+        cJSON_AddNumberToObject(tap, "node", oscillator_logic_get_tap_node(t));
+        cJSON_AddNumberToObject(tap, "dropped_words", oscillator_logic_get_tap_dropped(t));
+        cJSON_AddItemToArray(arr, tap);
+    }
+    cJSON_AddItemToObject(root, "taps", arr);
+    cJSON_AddNumberToObject(root, "max_taps", OSCILLATOR_LOGIC_MAX_TAPS);
+    cJSON_AddNumberToObject(root, "oversampling", oscillator_logic_get_oversampling());
+
+    esp_err_t err = send_json_response(req, root);
+    cJSON_Delete(root);
+    return err;
+}
+
+// nodes - номера узлов для отводов по порядку, -1 или пустой список выключают
+esp_err_t tap_post_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "POST /api/taps");
+
+    cJSON *root = NULL;
+    esp_err_t err = parse_json_body(req, &root);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    cJSON *nodes_obj = cJSON_GetObjectItem(root, "nodes");
+    if (!nodes_obj)
+    {
+        ESP_LOGE(TAG, "Missing required field: nodes");
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Missing required field");
+    }
+
+    int count = cJSON_IsArray(nodes_obj) ? cJSON_GetArraySize(nodes_obj) : -1;
+    if (count < 0 || count > OSCILLATOR_LOGIC_MAX_TAPS)
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid field type or too many taps");
+    }
+
+    int nodes[OSCILLATOR_LOGIC_MAX_TAPS];
+    bool valid = true;
+    for (int t = 0; t < count; t++)
+    {
+        const cJSON *item = cJSON_GetArrayItem(nodes_obj, t);
+        valid = valid && cJSON_IsNumber(item);
+        nodes[t] = valid ? item->valueint : -1;
+    }
+    cJSON_Delete(root);
+
+    if (!valid || oscillator_logic_set_taps(nodes, count) != ESP_OK)
+    {
+        return send_error_response(req, 400, "Invalid node ID");
+    }
+
+    // Create success response
+    cJSON *response = cJSON_CreateObject();
+    cJSON_AddStringToObject(response, "status", "success");
+    err = send_json_response(req, response);
+    cJSON_Delete(response);
+
+    return err;
+}
+
+const api_endpoint_t tap_endpoints[] = {
+    {.uri = "/api/taps",
+     .method = HTTP_GET,
+     .handler = tap_get_handler,
+     .user_ctx = NULL},
+    {.uri = "/api/taps",
+     .method = HTTP_POST,
+     .handler = tap_post_handler,
+     .user_ctx = NULL}};
+
+const int tap_endpoint_count = 2;
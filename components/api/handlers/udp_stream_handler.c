@@ -0,0 +1,103 @@
+#include "udp_stream_handler.h"
+#include "api_utils.h"
+#include <esp_log.h>
+#include "cJSON.h"
+#include "udp_stream.h"
+
+static const char *TAG = "udp_stream_handler";
+
+static esp_err_t send_udp_stream_status(httpd_req_t *req)
+{
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return send_error_response(req, 500, "Failed to create JSON object");
+    }
+
+    udp_stream_status_t status;
+    udp_stream_get_status(&status);
+    cJSON_AddBoolToObject(root, "enabled", status.enabled);
+    cJSON_AddStringToObject(root, "host", status.host);
+    cJSON_AddNumberToObject(root, "port", status.port);
+    cJSON_AddNumberToObject(root, "payload_type", UDP_STREAM_PAYLOAD_TYPE);
+    cJSON_AddNumberToObject(root, "sample_rate", status.sample_rate);
+    cJSON_AddNumberToObject(root, "ssrc", status.ssrc);
+    cJSON_AddNumberToObject(root, "packets_sent", status.packets_sent);
+    cJSON_AddNumberToObject(root, "send_errors", status.send_errors);
+
+    esp_err_t err = send_json_response(req, root);
+    cJSON_Delete(root);
+    return err;
+}
+
+esp_err_t udp_stream_get_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "GET /api/udp-stream");
+    return send_udp_stream_status(req);
+}
+
+esp_err_t udp_stream_post_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "POST /api/udp-stream");
+
+    cJSON *root = NULL;
+    esp_err_t err = parse_json_body(req, &root);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    cJSON *enabled_obj = cJSON_GetObjectItem(root, "enabled");
+    cJSON *host_obj = cJSON_GetObjectItem(root, "host");
+    cJSON *port_obj = cJSON_GetObjectItem(root, "port");
+
+    if (!enabled_obj || !cJSON_IsBool(enabled_obj))
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Missing required field");
+    }
+
+    if (!cJSON_IsTrue(enabled_obj))
+    {
+        cJSON_Delete(root);
+        udp_stream_stop();
+        return send_udp_stream_status(req);
+    }
+
+    if (!host_obj || !cJSON_IsString(host_obj) || (port_obj && !cJSON_IsNumber(port_obj)))
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid field type");
+    }
+    int port = port_obj ? port_obj->valueint : UDP_STREAM_DEFAULT_PORT;
+    if (port <= 0 || port > 65535)
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid port");
+    }
+
+    err = udp_stream_start(host_obj->valuestring, (uint16_t)port);
+    cJSON_Delete(root);
+    if (err == ESP_ERR_NOT_FOUND)
+    {
+        return send_error_response(req, 400, "Host does not resolve");
+    }
+    if (err != ESP_OK)
+    {
+        return send_error_response(req, 400, "Invalid host");
+    }
+
+    return send_udp_stream_status(req);
+}
+
+const api_endpoint_t udp_stream_endpoints[] = {
+    {.uri = "/api/udp-stream",
+     .method = HTTP_GET,
+     .handler = udp_stream_get_handler,
+     .user_ctx = NULL},
+    {.uri = "/api/udp-stream",
+     .method = HTTP_POST,
+     .handler = udp_stream_post_handler,
+     .user_ctx = NULL}};
+
+const int udp_stream_endpoint_count = 2;
@@ -0,0 +1,170 @@
+#include "voice_handler.h"
+#include "api_utils.h"
+#include <esp_log.h>
+#include <string.h>
+#include "cJSON.h"
+#include "oscillator_logic.h"
+
+static const char *TAG = "voice_handler";
+
+// note_on и note_off принимают одну ноту или массив нот (аккорд)
+static bool notes_valid(const cJSON *obj)
+{
+    if (cJSON_IsNumber(obj))
+    {
+        return obj->valueint >= 0 && obj->valueint <= 127;
+    }
+    if (!cJSON_IsArray(obj) || cJSON_GetArraySize(obj) > OSCILLATOR_LOGIC_VOICE_COUNT)
+    {
+        return false;
+    }
+    const cJSON *item = NULL;
+    cJSON_ArrayForEach(item, obj)
+    {
+        if (!cJSON_IsNumber(item) || item->valueint < 0 || item->valueint > 127)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool parse_operation(const char *name, logical_op_t *op)
+{
+    for (int i = 0; i < LOGICAL_OP_COUNT; i++)
+    {
+        if (strcmp(name, get_logical_op_name((logical_op_t)i)) == 0)
+        {
+            *op = (logical_op_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+esp_err_t voice_get_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "GET /api/voices");
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        return send_error_response(req, 500, "Failed to create JSON object");
+    }
+
+    voice_pool_t *pool = oscillator_logic_get_voice_pool();
+    cJSON_AddNumberToObject(root, "node", OSCILLATOR_LOGIC_VOICE_POOL_NODE);
+    cJSON_AddNumberToObject(root, "voice_count", pool->voice_count);
+    cJSON_AddNumberToObject(root, "active_count", voice_pool_active_count(pool));
+    cJSON_AddStringToObject(root, "combine", get_logical_op_name(pool->combine.operation));
+
+    cJSON *voices = cJSON_CreateArray();
+    for (int v = 0; v < pool->voice_count; v++)
+    {
+        cJSON *voice = cJSON_CreateObject();
+        cJSON_AddNumberToObject(voice, "voice", v);
+        cJSON_AddBoolToObject(voice, "active", pool->active[v]);
+        cJSON_AddNumberToObject(voice, "note", pool->notes[v]);
+        cJSON_AddItemToArray(voices, voice);
+    }
+    cJSON_AddItemToObject(root, "voices", voices);
+
+    esp_err_t err = send_json_response(req, root);
+    cJSON_Delete(root);
+    return err;
+}
+
+// all_off применяется первым, затем note_off и note_on, так аккорд меняется одним запросом
+esp_err_t voice_post_handler(httpd_req_t *req)
+{
+    ESP_LOGD(TAG, "POST /api/voices");
+
+    cJSON *root = NULL;
+    esp_err_t err = parse_json_body(req, &root);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    cJSON *note_on_obj = cJSON_GetObjectItem(root, "note_on");
+    cJSON *note_off_obj = cJSON_GetObjectItem(root, "note_off");
+    cJSON *all_off_obj = cJSON_GetObjectItem(root, "all_off");
+    cJSON *combine_obj = cJSON_GetObjectItem(root, "combine");
+
+    if (!note_on_obj && !note_off_obj && !all_off_obj && !combine_obj)
+    {
+        ESP_LOGE(TAG, "Missing required field: note_on, note_off, all_off or combine");
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Missing required field");
+    }
+
+    logical_op_t combine = LOGICAL_OP_OR;
+    if ((note_on_obj && !notes_valid(note_on_obj))
+    || (note_off_obj && !notes_valid(note_off_obj))
+    || (all_off_obj && !cJSON_IsBool(all_off_obj))
+    || (combine_obj && (!cJSON_IsString(combine_obj) || !parse_operation(combine_obj->valuestring, &combine))))
+    {
+        cJSON_Delete(root);
+        return send_error_response(req, 400, "Invalid field value");
+    }
+
+    if (combine_obj)
+    {
+        voice_pool_set_combine(oscillator_logic_get_voice_pool(), combine);
+    }
+    // ноты ставятся в очередь, рендер применяет их по порядку в начале блока
+    bool queue_full = false;
+    if (all_off_obj && cJSON_IsTrue(all_off_obj))
+    {
+        queue_full |= oscillator_logic_all_notes_off() != ESP_OK;
+    }
+    if (cJSON_IsNumber(note_off_obj))
+    {
+        queue_full |= oscillator_logic_note_off(note_off_obj->valueint) != ESP_OK;
+    }
+    else if (note_off_obj)
+    {
+        const cJSON *item = NULL;
+        cJSON_ArrayForEach(item, note_off_obj)
+        {
+            queue_full |= oscillator_logic_note_off(item->valueint) != ESP_OK;
+        }
+    }
+    if (cJSON_IsNumber(note_on_obj))
+    {
+        queue_full |= oscillator_logic_note_on(note_on_obj->valueint) != ESP_OK;
+    }
+    else if (note_on_obj)
+    {
+        const cJSON *item = NULL;
+        cJSON_ArrayForEach(item, note_on_obj)
+        {
+            queue_full |= oscillator_logic_note_on(item->valueint) != ESP_OK;
+        }
+    }
+    cJSON_Delete(root);
+    if (queue_full)
+    {
+        return send_error_response(req, 503, "Note queue is full");
+    }
+
+    // Create success response
+    cJSON *response = cJSON_CreateObject();
+    cJSON_AddStringToObject(response, "status", "success");
+    err = send_json_response(req, response);
+    cJSON_Delete(response);
+
+    return err;
+}
+
+const api_endpoint_t voice_endpoints[] = {
+    {.uri = "/api/voices",
+     .method = HTTP_GET,
+     .handler = voice_get_handler,
+     .user_ctx = NULL},
+    {.uri = "/api/voices",
+     .method = HTTP_POST,
+     .handler = voice_post_handler,
+     .user_ctx = NULL}};
+
+const int voice_endpoint_count = 2;
@@ -0,0 +1,185 @@
+#include "benchmark.h"
+#include <esp_log.h>
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "oscillator_logic.h"
+#include "oscillator.h"
+#include "oscillator_bank.h"
+#include "voice_pool.h"
+#include "common_defs.h"
+
+// замеры стоимости движка на живом патче, результат только в лог
+
+static const char *TAG = "benchmark";
+
+#ifdef CONFIG_LUNETTE_BENCHMARK_BLOCKS
+#define BENCHMARK_BLOCKS CONFIG_LUNETTE_BENCHMARK_BLOCKS
+#else
+#define BENCHMARK_BLOCKS 200
+#endif
+
+// Time budget for one output sample in microseconds
+#define SAMPLE_BUDGET_US (1000000.0 / SYSTEM_SAMPLE_RATE)
+
+static double benchmark_render_us_per_sample(void)
+{
+    // первый блок применяет новые настройки, в замер не входит
+    oscillator_logic_render_block();
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < BENCHMARK_BLOCKS; i++) {
+        oscillator_logic_render_block();
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+
+    return (double)elapsed / ((double)BENCHMARK_BLOCKS * OSCILLATOR_LOGIC_BLOCK_SIZE);
+}
+
+static void benchmark_oversampling(oscillator_logic_engine_t engine, const char* name)
+{
+    int saved = oscillator_logic_get_oversampling();
+    oscillator_logic_engine_t saved_engine = oscillator_logic_get_engine();
+    oscillator_logic_set_engine(engine);
+
+    ESP_LOGI(TAG, "%s engine, %d output samples per block", name, OSCILLATOR_LOGIC_BLOCK_SIZE);
+    for (int factor = OSCILLATOR_LOGIC_MIN_OVERSAMPLING; factor <= OSCILLATOR_LOGIC_MAX_OVERSAMPLING; factor *= 2) {
+        oscillator_logic_set_oversampling(factor);
+        double us = benchmark_render_us_per_sample();
+        if (oscillator_logic_get_active_engine() != engine) {
+            ESP_LOGW(TAG, "%s engine not usable with the current patch", name);
+            break;
+        }
+        ESP_LOGI(TAG, "oversampling x%-2d: %.2f us per sample, %.1f%% of budget",
+                 factor, us, 100.0 * us / SAMPLE_BUDGET_US);
+    }
+
+    oscillator_logic_set_oversampling(saved);
+    oscillator_logic_set_engine(saved_engine);
+}
+
+// Samples rendered per oscillator measurement
+#define BENCHMARK_OSC_SAMPLES 4096
+
+static double benchmark_oscillator_us_per_sample(oscillator_type_t type, bool block)
+{
+    static Oscillator osc;
+    static float buffer[OSCILLATOR_LOGIC_BLOCK_SIZE];
+    oscillator_init(&osc, 0, 1234.5, 1.0, type);
+
+    int64_t start = esp_timer_get_time();
+    if (block) {
+        for (int i = 0; i < BENCHMARK_OSC_SAMPLES; i += OSCILLATOR_LOGIC_BLOCK_SIZE) {
+            oscillator_render_block(&osc, buffer, OSCILLATOR_LOGIC_BLOCK_SIZE);
+        }
+    } else {
+        for (int i = 0; i < BENCHMARK_OSC_SAMPLES; i++) {
+            oscillator_calculate(&osc);
+        }
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+
+    return (double)elapsed / BENCHMARK_OSC_SAMPLES;
+}
+
+// многобитные осцилляторы: табличный синус на double против BLEP на float
+static void benchmark_oscillators(void)
+{
+    ESP_LOGI(TAG, "Multi-bit oscillators, us per sample");
+    ESP_LOGI(TAG, "sine table (double):   %.3f", benchmark_oscillator_us_per_sample(OSCILLATOR_TYPE_SINE, false));
+    ESP_LOGI(TAG, "square BLEP per sample: %.3f", benchmark_oscillator_us_per_sample(OSCILLATOR_TYPE_SQUARE, false));
+    ESP_LOGI(TAG, "square BLEP block:     %.3f", benchmark_oscillator_us_per_sample(OSCILLATOR_TYPE_SQUARE, true));
+    ESP_LOGI(TAG, "sawtooth BLEP block:   %.3f", benchmark_oscillator_us_per_sample(OSCILLATOR_TYPE_SAWTOOTH, true));
+    ESP_LOGI(TAG, "triangle BLAMP block:  %.3f", benchmark_oscillator_us_per_sample(OSCILLATOR_TYPE_TRIANGLE, true));
+}
+
+// Oscillators per bank in the bank measurement, doubled each step
+#define BENCHMARK_BANK_MIN 4
+
+static double benchmark_bank_us_per_oscillator(int count, bool packed)
+{
+    static oscillator_bank_t bank;
+    static uint32_t words[OSCILLATOR_BANK_MAX];
+    static int16_t frames[OSCILLATOR_LOGIC_BLOCK_SIZE * OSCILLATOR_BANK_MAX];
+
+    oscillator_bank_init(&bank, SYSTEM_SAMPLE_RATE);
+    for (int i = 0; i < count; i++) {
+        oscillator_bank_add(&bank, OSCILLATOR_TYPE_SAWTOOTH, 100.0 + 37.0 * i, 1.0);
+    }
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < BENCHMARK_OSC_SAMPLES; i += OSCILLATOR_LOGIC_BLOCK_SIZE) {
+        if (packed) {
+            oscillator_bank_render_packed(&bank, words, 1, OSCILLATOR_LOGIC_BLOCK_SIZE);
+        } else {
+            oscillator_bank_render_pcm(&bank, frames, OSCILLATOR_LOGIC_BLOCK_SIZE);
+        }
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+
+    return (double)elapsed / ((double)BENCHMARK_OSC_SAMPLES * count);
+}
+
+// банк осцилляторов: стоимость одного осциллятора на отсчет в зависимости от их числа
+static void benchmark_bank(void)
+{
+    ESP_LOGI(TAG, "Oscillator bank, us per oscillator per sample");
+    for (int count = BENCHMARK_BANK_MIN; count <= OSCILLATOR_BANK_MAX; count *= 2) {
+        ESP_LOGI(TAG, "%2d oscillators: packed %.3f, pcm %.3f", count,
+                 benchmark_bank_us_per_oscillator(count, true),
+                 benchmark_bank_us_per_oscillator(count, false));
+    }
+}
+
+// Output blocks rendered per voice pool measurement
+#define BENCHMARK_VOICE_BLOCKS 64
+
+static double benchmark_voice_pool_us_per_sample(int voices)
+{
+    static voice_pool_t pool;
+    static uint32_t words[PACKED_WORDS(OSCILLATOR_LOGIC_BLOCK_SIZE * OSCILLATOR_LOGIC_DEFAULT_OVERSAMPLING)];
+    static const int chord[] = { 48, 52, 55, 59, 62, 65, 69, 72 };
+
+    voice_pool_init(&pool, VOICE_POOL_MAX_VOICES, (double)SYSTEM_SAMPLE_RATE * OSCILLATOR_LOGIC_DEFAULT_OVERSAMPLING);
+    for (int v = 0; v < voices; v++) {
+        voice_pool_note_on(&pool, chord[v]);
+    }
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < BENCHMARK_VOICE_BLOCKS; i++) {
+        voice_pool_render_packed(&pool, words, PACKED_WORDS(OSCILLATOR_LOGIC_BLOCK_SIZE * OSCILLATOR_LOGIC_DEFAULT_OVERSAMPLING));
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+
+    return (double)elapsed / ((double)BENCHMARK_VOICE_BLOCKS * OSCILLATOR_LOGIC_BLOCK_SIZE);
+}
+
+// пул голосов на частоте движка: все дорожки банка считаются всегда,
+// от числа звучащих голосов зависят только логические операции
+static void benchmark_voice_pool(void)
+{
+    ESP_LOGI(TAG, "Voice pool at oversampling x%d, us per output sample", OSCILLATOR_LOGIC_DEFAULT_OVERSAMPLING);
+    for (int voices = 1; voices <= VOICE_POOL_MAX_VOICES; voices++) {
+        double us = benchmark_voice_pool_us_per_sample(voices);
+        ESP_LOGI(TAG, "%d voices: %.2f us, %.1f%% of budget", voices, us, 100.0 * us / SAMPLE_BUDGET_US);
+    }
+}
+
+esp_err_t benchmark_run(void)
+{
+    bool was_enabled = false;
+    oscillator_logic_get_enabled(&was_enabled);
+
+    // таймер мог уже начать блок, даем ему закончить
+    oscillator_logic_set_enabled(false);
+    vTaskDelay(1);
+
+    benchmark_oversampling(OSCILLATOR_LOGIC_ENGINE_BLOCK, "Block");
+    benchmark_oversampling(OSCILLATOR_LOGIC_ENGINE_EDGE, "Edge");
+    benchmark_oscillators();
+    benchmark_bank();
+    benchmark_voice_pool();
+
+    oscillator_logic_set_enabled(was_enabled);
+    return ESP_OK;
+}
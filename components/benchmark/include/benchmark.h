@@ -0,0 +1,14 @@
+#pragma once
+
+#include "esp_err.h"
+
+/**
+ * @brief Measure the engine and log the cost of each setting
+ *
+ * The engine is paused while measuring and resumed afterwards, the
+ * current settings are restored. Results are reported as time per output
+ * sample and as a share of the 1 / SYSTEM_SAMPLE_RATE budget.
+ *
+ * @return esp_err_t ESP_OK on success, otherwise an error code
+ */
+esp_err_t benchmark_run(void);
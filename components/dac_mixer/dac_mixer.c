@@ -0,0 +1,242 @@
+#include "dac_mixer.h"
+#include <esp_log.h>
+#include <string.h>
+
+// 8-битный ЦАП как иерархический микшер: каждый следующий вход в два раза тише
+// веса и задержки настраиваются, сумма для каждого набора входов лежит в таблице
+
+static const char *TAG = "dac_mixer";
+
+// для каждого из 256 сочетаний входов готовая сумма с заданными весами
+static void dac_mixer_fill_table(const dac_mixer_t* mixer, const int16_t* weights, int16_t* table)
+{
+    for (int pattern = 0; pattern < (1 << DAC_MIXER_MAX_INPUTS); pattern++) {
+        int32_t sum = 0;
+        for (int i = 0; i < DAC_MIXER_MAX_INPUTS; i++) {
+            if (mixer->input_ids[i] < 0) continue;
+            sum += (pattern >> i) & 1 ? weights[i] : -weights[i];
+        }
+        if (sum > INT16_MAX) sum = INT16_MAX;
+        if (sum < INT16_MIN) sum = INT16_MIN;
+        table[pattern] = (int16_t)sum;
+    }
+}
+
+// пересчет таблицы после смены весов или входов
+static void dac_mixer_build_table(dac_mixer_t* mixer)
+{
+    dac_mixer_fill_table(mixer, mixer->weights, mixer->pattern_table);
+}
+
+esp_err_t dac_mixer_init(dac_mixer_t* mixer)
+{
+    if (!mixer) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for (int i = 0; i < DAC_MIXER_MAX_INPUTS; i++) {
+        mixer->inputs[i] = NULL;
+        mixer->input_ids[i] = -1;
+        mixer->weights[i] = DAC_MIXER_DEFAULT_MSB_WEIGHT >> i;
+        mixer->delays[i] = 0;
+        mixer->history[i] = 0;
+        mixer->prev_words[i] = 0;
+    }
+    mixer->result = 0;
+    mixer->result8 = 0;
+    dac_mixer_build_table(mixer);
+
+    ESP_LOGI(TAG, "Initializing DAC mixer");
+    return ESP_OK;
+}
+
+esp_err_t dac_mixer_set_input(dac_mixer_t* mixer, int index, const bool* input, int input_id)
+{
+    if (!mixer || index < 0 || index >= DAC_MIXER_MAX_INPUTS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mixer->inputs[index] = input;
+    mixer->input_ids[index] = input ? input_id : -1;
+    mixer->history[index] = 0;
+    mixer->prev_words[index] = 0;
+    dac_mixer_build_table(mixer);
+    return ESP_OK;
+}
+
+esp_err_t dac_mixer_set_weight(dac_mixer_t* mixer, int index, int16_t weight)
+{
+    if (!mixer || index < 0 || index >= DAC_MIXER_MAX_INPUTS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mixer->weights[index] = weight;
+    dac_mixer_build_table(mixer);
+    return ESP_OK;
+}
+
+esp_err_t dac_mixer_set_delay(dac_mixer_t* mixer, int index, int delay)
+{
+    if (!mixer || index < 0 || index >= DAC_MIXER_MAX_INPUTS || delay < 0 || delay > DAC_MIXER_MAX_DELAY) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mixer->delays[index] = (uint8_t)delay;
+    return ESP_OK;
+}
+
+int16_t dac_mixer_calculate(dac_mixer_t* mixer)
+{
+    if (!mixer) return 0;
+
+    uint32_t pattern = 0;
+    for (int i = 0; i < DAC_MIXER_MAX_INPUTS; i++) {
+        if (!mixer->inputs[i]) continue;
+        mixer->history[i] = (mixer->history[i] << 1) | (uint32_t)*(mixer->inputs[i]);
+        pattern |= ((mixer->history[i] >> mixer->delays[i]) & 1u) << i;
+    }
+
+    mixer->result = mixer->pattern_table[pattern];
+    mixer->result8 = (int8_t)(mixer->result >> 8);
+    return mixer->result;
+}
+
+// Transpose an 8x8 bit matrix held one row per byte (Hacker's Delight 7-3):
+// afterwards byte j holds bit j of every original row
+static inline uint64_t transpose8(uint64_t x)
+{
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+    return x;
+}
+
+// берет слово входа с учетом его задержки, для отключенного входа нули
+static inline uint32_t dac_mixer_delayed_word(dac_mixer_t* mixer, const uint32_t* const inputs[DAC_MIXER_MAX_INPUTS],
+                                              int i, size_t w)
+{
+    if (!inputs[i] || mixer->input_ids[i] < 0) return 0;
+    uint32_t word = inputs[i][w];
+    uint32_t delayed = packed_delay(word, mixer->prev_words[i], mixer->delays[i]);
+    mixer->prev_words[i] = word;
+    return delayed;
+}
+
+// сочетание входов на каждом из 32 отсчетов слова w
+static void dac_mixer_word_patterns(dac_mixer_t* mixer, const uint32_t* const inputs[DAC_MIXER_MAX_INPUTS],
+                                    size_t w, uint8_t patterns[PACKED_WORD_BITS])
+{
+    uint32_t words[DAC_MIXER_MAX_INPUTS];
+    for (int i = 0; i < DAC_MIXER_MAX_INPUTS; i++) {
+        words[i] = dac_mixer_delayed_word(mixer, inputs, i, w);
+    }
+
+    // по 8 отсчетов за раз: строки - входы, после транспонирования байт j = входы на отсчете j
+    for (int lane = 0; lane < 4; lane++) {
+        uint64_t matrix = 0;
+        for (int i = 0; i < DAC_MIXER_MAX_INPUTS; i++) {
+            matrix |= (uint64_t)((words[i] >> (lane * 8)) & 0xFFu) << (i * 8);
+        }
+        matrix = transpose8(matrix);
+
+        for (int j = 0; j < 8; j++) {
+            patterns[lane * 8 + j] = (uint8_t)(matrix >> (j * 8));
+        }
+    }
+}
+
+void dac_mixer_calculate_packed(dac_mixer_t* mixer, const uint32_t* const inputs[DAC_MIXER_MAX_INPUTS],
+                                size_t n_words, int16_t* out)
+{
+    if (!mixer || !inputs || !out || n_words == 0) return;
+
+    for (size_t w = 0; w < n_words; w++) {
+        uint8_t patterns[PACKED_WORD_BITS];
+        dac_mixer_word_patterns(mixer, inputs, w, patterns);
+
+        int16_t* dst = &out[w * PACKED_WORD_BITS];
+        for (int j = 0; j < PACKED_WORD_BITS; j++) {
+            dst[j] = mixer->pattern_table[patterns[j]];
+        }
+    }
+
+    mixer->result = out[n_words * PACKED_WORD_BITS - 1];
+    mixer->result8 = (int8_t)(mixer->result >> 8);
+}
+
+// Две таблицы на концах блока, отсчет - их смесь с долей, растущей от 0.
+// Доля в Q12, чтобы разность таблиц (17 бит) на нее умножалась в int32.
+void dac_mixer_calculate_packed_ramp(dac_mixer_t* mixer, const uint32_t* const inputs[DAC_MIXER_MAX_INPUTS],
+                                     const int16_t from[DAC_MIXER_MAX_INPUTS], const int16_t to[DAC_MIXER_MAX_INPUTS],
+                                     size_t n_words, int16_t* out)
+{
+    if (!mixer || !inputs || !from || !to || !out || n_words == 0) return;
+
+    int16_t table_from[1 << DAC_MIXER_MAX_INPUTS];
+    int16_t table_to[1 << DAC_MIXER_MAX_INPUTS];
+    dac_mixer_fill_table(mixer, from, table_from);
+    dac_mixer_fill_table(mixer, to, table_to);
+
+    uint32_t fade = 0;
+    uint32_t fade_step = (1u << 16) / (uint32_t)(n_words * PACKED_WORD_BITS);
+    for (size_t w = 0; w < n_words; w++) {
+        uint8_t patterns[PACKED_WORD_BITS];
+        dac_mixer_word_patterns(mixer, inputs, w, patterns);
+
+        int16_t* dst = &out[w * PACKED_WORD_BITS];
+        for (int j = 0; j < PACKED_WORD_BITS; j++) {
+            int32_t a = table_from[patterns[j]];
+            int32_t b = table_to[patterns[j]];
+            dst[j] = (int16_t)(a + (((b - a) * (int32_t)(fade >> 4)) >> 12));
+            fade += fade_step;
+        }
+    }
+
+    mixer->result = out[n_words * PACKED_WORD_BITS - 1];
+    mixer->result8 = (int8_t)(mixer->result >> 8);
+}
+
+void dac_mixer_calculate_packed_mean(dac_mixer_t* mixer, const uint32_t* const inputs[DAC_MIXER_MAX_INPUTS],
+                                     size_t n_words, int16_t* out)
+{
+    if (!mixer || !inputs || !out || n_words == 0) return;
+
+    for (size_t w = 0; w < n_words; w++) {
+        // среднее за слово: вход дает weight * (единицы - нули) / 32
+        int32_t sum = 0;
+        for (int i = 0; i < DAC_MIXER_MAX_INPUTS; i++) {
+            if (!inputs[i] || mixer->input_ids[i] < 0) continue;
+            uint32_t word = dac_mixer_delayed_word(mixer, inputs, i, w);
+            sum += (int32_t)mixer->weights[i] * (2 * packed_popcount(word) - PACKED_WORD_BITS);
+        }
+        sum /= PACKED_WORD_BITS;
+        if (sum > INT16_MAX) sum = INT16_MAX;
+        if (sum < INT16_MIN) sum = INT16_MIN;
+        out[w] = (int16_t)sum;
+    }
+
+    mixer->result = out[n_words - 1];
+    mixer->result8 = (int8_t)(mixer->result >> 8);
+}
+
+int16_t* dac_mixer_get_result_pointer(dac_mixer_t* mixer)
+{
+    if (!mixer) {
+        ESP_LOGE(TAG, "Invalid mixer pointer");
+        return NULL;
+    }
+    return &mixer->result;
+}
+
+int8_t* dac_mixer_get_result8_pointer(dac_mixer_t* mixer)
+{
+    if (!mixer) {
+        ESP_LOGE(TAG, "Invalid mixer pointer");
+        return NULL;
+    }
+    return &mixer->result8;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "packed_bits.h"
+
+#define DAC_MIXER_MAX_INPUTS 8
+#define DAC_MIXER_MAX_DELAY (PACKED_WORD_BITS - 1)
+
+// Default weight of input 0 (most significant bit), every next input gets half
+#define DAC_MIXER_DEFAULT_MSB_WEIGHT 16384
+
+typedef struct {
+    const bool* inputs[DAC_MIXER_MAX_INPUTS];   // NULL for an unused input
+    int input_ids[DAC_MIXER_MAX_INPUTS];        // node ids, -1 for an unused input
+    int16_t weights[DAC_MIXER_MAX_INPUTS];
+    uint8_t delays[DAC_MIXER_MAX_INPUTS];       // per-input delay in samples
+    uint32_t history[DAC_MIXER_MAX_INPUTS];     // last 32 samples of each input, bit 0 newest
+    uint32_t prev_words[DAC_MIXER_MAX_INPUTS];  // previous packed word of each input
+    int16_t pattern_table[1 << DAC_MIXER_MAX_INPUTS]; // output for every input bit pattern
+    int16_t result;
+    int8_t result8;
+} dac_mixer_t;
+
+/**
+ * @brief Initialize the mixer with no inputs and binary weights
+ *
+ * @param mixer Pointer to dac_mixer_t structure to initialize
+ * @return esp_err_t ESP_OK on success, otherwise an error code
+ */
+esp_err_t dac_mixer_init(dac_mixer_t* mixer);
+
+/**
+ * @brief Connect a boolean source to a mixer input
+ *
+ * @param mixer Pointer to dac_mixer_t structure
+ * @param index Input index, 0 is the most significant bit
+ * @param input Pointer to the boolean source, NULL to disconnect
+ * @param input_id Node id of the source, stored for reporting
+ * @return esp_err_t ESP_OK on success, otherwise an error code
+ */
+esp_err_t dac_mixer_set_input(dac_mixer_t* mixer, int index, const bool* input, int input_id);
+
+/**
+ * @brief Set the weight of a mixer input
+ *
+ * A connected input adds +weight when high and -weight when low.
+ *
+ * @param mixer Pointer to dac_mixer_t structure
+ * @param index Input index
+ * @param weight Input weight
+ * @return esp_err_t ESP_OK on success, otherwise an error code
+ */
+esp_err_t dac_mixer_set_weight(dac_mixer_t* mixer, int index, int16_t weight);
+
+/**
+ * @brief Set the delay of a mixer input
+ *
+ * @param mixer Pointer to dac_mixer_t structure
+ * @param index Input index
+ * @param delay Delay in samples, 0..DAC_MIXER_MAX_DELAY
+ * @return esp_err_t ESP_OK on success, otherwise an error code
+ */
+esp_err_t dac_mixer_set_delay(dac_mixer_t* mixer, int index, int delay);
+
+/**
+ * @brief Mix the current input values into one PCM sample
+ *
+ * @param mixer Pointer to dac_mixer_t structure
+ * @return int16_t Mixed sample, also stored in result and result8
+ */
+int16_t dac_mixer_calculate(dac_mixer_t* mixer);
+
+/**
+ * @brief Mix packed input streams into PCM samples
+ *
+ * Inputs are transposed 8x8 bits at a time so each sample costs one table lookup.
+ *
+ * @param mixer Pointer to dac_mixer_t structure
+ * @param inputs Packed stream for each input, NULL entries are ignored
+ * @param n_words Number of words in each stream
+ * @param out Output buffer, n_words * PACKED_WORD_BITS samples
+ */
+void dac_mixer_calculate_packed(dac_mixer_t* mixer, const uint32_t* const inputs[DAC_MIXER_MAX_INPUTS],
+                                size_t n_words, int16_t* out);
+
+/**
+ * @brief Mix packed input streams while the weights move across the block
+ *
+ * The output crossfades sample by sample from the mix with the from weights
+ * to the mix with the to weights, so modulated weights change without steps.
+ * The mixer's own weights and table are left as they are.
+ *
+ * @param mixer Pointer to dac_mixer_t structure
+ * @param inputs Packed stream for each input, NULL entries are ignored
+ * @param from Weights at the first sample
+ * @param to Weights one sample past the last
+ * @param n_words Number of words in each stream
+ * @param out Output buffer, n_words * PACKED_WORD_BITS samples
+ */
+void dac_mixer_calculate_packed_ramp(dac_mixer_t* mixer, const uint32_t* const inputs[DAC_MIXER_MAX_INPUTS],
+                                     const int16_t from[DAC_MIXER_MAX_INPUTS], const int16_t to[DAC_MIXER_MAX_INPUTS],
+                                     size_t n_words, int16_t* out);
+
+/**
+ * @brief Mix packed input streams into one averaged sample per word
+ *
+ * Uses popcount only, useful when the streams are oversampled by PACKED_WORD_BITS.
+ *
+ * @param mixer Pointer to dac_mixer_t structure
+ * @param inputs Packed stream for each input, NULL entries are ignored
+ * @param n_words Number of words in each stream
+ * @param out Output buffer, n_words samples
+ */
+void dac_mixer_calculate_packed_mean(dac_mixer_t* mixer, const uint32_t* const inputs[DAC_MIXER_MAX_INPUTS],
+                                     size_t n_words, int16_t* out);
+
+/**
+ * @brief Get pointer to the 16-bit result
+ *
+ * @param mixer Pointer to dac_mixer_t structure
+ * @return int16_t* Pointer to the result value, NULL if mixer is NULL
+ */
+int16_t* dac_mixer_get_result_pointer(dac_mixer_t* mixer);
+
+/**
+ * @brief Get pointer to the 8-bit result (top byte of the 16-bit result)
+ *
+ * @param mixer Pointer to dac_mixer_t structure
+ * @return int8_t* Pointer to the result value, NULL if mixer is NULL
+ */
+int8_t* dac_mixer_get_result8_pointer(dac_mixer_t* mixer);
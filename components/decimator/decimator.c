@@ -0,0 +1,204 @@
+#include "decimator.h"
+#include <esp_log.h>
+#include <string.h>
+
+// децимация потока с высокой внутренней частоты до частоты выдачи PCM
+// CIC фильтр третьего порядка (интеграторы на входной частоте, гребенки на выходной)
+// и короткий КИХ для компенсации спада АЧХ в полосе
+
+static const char *TAG = "decimator";
+
+#define DECIMATOR_GAIN_SHIFT    24
+#define DECIMATOR_FULL_SCALE    32768
+
+// Droop compensator [-3, 22, -3] / 16, unity at DC, +2.8 dB at a quarter of the output rate
+#define COMP_EDGE               3
+#define COMP_CENTER             22
+#define COMP_SHIFT              4
+
+// Integrator increments for 8 samples at once, indexed by the byte of input bits.
+// With d_j = +-1 for bit j (bit 0 earliest) the three integrators advance by
+//   I1 += P,  I2 += 8*I1 + A,  I3 += 8*I2 + 36*I1 + B
+// where P = sum d_j, A = sum (8-j)*d_j, B = sum (8-j)*(9-j)/2*d_j
+static int8_t byte_sum[256];
+static int16_t byte_ramp[256];
+static int16_t byte_ramp2[256];
+static bool byte_tables_ready = false;
+
+static void build_byte_tables(void)
+{
+    for (int b = 0; b < 256; b++) {
+        int p = 0, a = 0, c = 0;
+        for (int j = 0; j < 8; j++) {
+            int d = (b >> j) & 1 ? 1 : -1;
+            p += d;
+            a += (8 - j) * d;
+            c += (8 - j) * (9 - j) / 2 * d;
+        }
+        byte_sum[b] = (int8_t)p;
+        byte_ramp[b] = (int16_t)a;
+        byte_ramp2[b] = (int16_t)c;
+    }
+    byte_tables_ready = true;
+}
+
+static int ceil_log2(uint32_t x)
+{
+    int n = 0;
+    while ((1u << n) < x) n++;
+    return n;
+}
+
+esp_err_t decimator_init(decimator_t* dec, uint32_t factor, decimator_input_t input)
+{
+    if (!dec || factor < DECIMATOR_MIN_FACTOR || factor > DECIMATOR_MAX_FACTOR) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (input != DECIMATOR_INPUT_BITS && input != DECIMATOR_INPUT_PCM) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!byte_tables_ready) {
+        build_byte_tables();
+    }
+
+    dec->input = input;
+    dec->factor = factor;
+
+    // CIC gain is factor^3; PCM input is pre-shifted so that the full output
+    // range, 2^15 * factor^3, still fits the 32-bit registers
+    int64_t cic_gain = (int64_t)factor * factor * factor;
+    int64_t full_scale = 1;
+    dec->input_shift = 0;
+    if (input == DECIMATOR_INPUT_PCM) {
+        int growth = DECIMATOR_ORDER * ceil_log2(factor);
+        dec->input_shift = growth > 15 ? growth - 15 : 0;
+        full_scale = DECIMATOR_FULL_SCALE >> dec->input_shift;
+    }
+    dec->gain = ((int64_t)DECIMATOR_FULL_SCALE << DECIMATOR_GAIN_SHIFT) / (cic_gain * full_scale);
+
+    decimator_reset(dec);
+
+    ESP_LOGI(TAG, "Decimator x%lu, %s input", (unsigned long)factor,
+             input == DECIMATOR_INPUT_BITS ? "bit" : "PCM");
+    return ESP_OK;
+}
+
+void decimator_reset(decimator_t* dec)
+{
+    if (!dec) return;
+    dec->phase = 0;
+    memset(dec->integrator, 0, sizeof(dec->integrator));
+    memset(dec->comb, 0, sizeof(dec->comb));
+    memset(dec->fir, 0, sizeof(dec->fir));
+}
+
+static inline int16_t saturate16(int32_t x)
+{
+    if (x > INT16_MAX) return INT16_MAX;
+    if (x < INT16_MIN) return INT16_MIN;
+    return (int16_t)x;
+}
+
+// гребенки, нормализация и компенсатор, вызывается раз в factor входных отсчетов
+static int16_t decimator_emit(decimator_t* dec)
+{
+    uint32_t x = dec->integrator[2];
+    for (int i = 0; i < DECIMATOR_ORDER; i++) {
+        uint32_t y = x - dec->comb[i];
+        dec->comb[i] = x;
+        x = y;
+    }
+
+    int32_t cic = (int32_t)(((int64_t)(int32_t)x * dec->gain) >> DECIMATOR_GAIN_SHIFT);
+    int32_t comp = (COMP_CENTER * dec->fir[0] - COMP_EDGE * (cic + dec->fir[1])) >> COMP_SHIFT;
+    dec->fir[1] = dec->fir[0];
+    dec->fir[0] = cic;
+
+    dec->phase = 0;
+    return saturate16(comp);
+}
+
+static inline void integrate(decimator_t* dec, int32_t x)
+{
+    dec->integrator[0] += (uint32_t)x;
+    dec->integrator[1] += dec->integrator[0];
+    dec->integrator[2] += dec->integrator[1];
+}
+
+bool decimator_push(decimator_t* dec, int16_t sample, int16_t* out)
+{
+    int32_t x;
+    if (dec->input == DECIMATOR_INPUT_BITS) {
+        x = sample ? 1 : -1;
+        if (dec->factor == 1) {
+            *out = sample ? INT16_MAX : INT16_MIN;
+            return true;
+        }
+    } else {
+        if (dec->factor == 1) {
+            *out = sample;
+            return true;
+        }
+        x = sample >> dec->input_shift;
+    }
+
+    integrate(dec, x);
+    if (++dec->phase < dec->factor) {
+        return false;
+    }
+    *out = decimator_emit(dec);
+    return true;
+}
+
+size_t decimator_process_bits(decimator_t* dec, const uint32_t* words, size_t bit_count,
+                              int16_t* out, size_t max_out)
+{
+    if (!dec || !words || !out || dec->input != DECIMATOR_INPUT_BITS) {
+        return 0;
+    }
+
+    size_t produced = 0;
+    size_t i = 0;
+    while (i < bit_count) {
+        // целый байт за раз, если он начинается на границе байта и не пересекает момент выдачи
+        if ((i & 7) == 0 && i + 8 <= bit_count && dec->phase + 8 <= dec->factor && dec->factor > 1) {
+            uint8_t b = (uint8_t)(words[i / PACKED_WORD_BITS] >> (i % PACKED_WORD_BITS));
+            uint32_t i1 = dec->integrator[0];
+            uint32_t i2 = dec->integrator[1];
+            dec->integrator[2] += 8 * i2 + 36 * i1 + (uint32_t)(int32_t)byte_ramp2[b];
+            dec->integrator[1] = i2 + 8 * i1 + (uint32_t)(int32_t)byte_ramp[b];
+            dec->integrator[0] = i1 + (uint32_t)(int32_t)byte_sum[b];
+            dec->phase += 8;
+            i += 8;
+            if (dec->phase == dec->factor) {
+                int16_t y = decimator_emit(dec);
+                if (produced < max_out) out[produced++] = y;
+            }
+            continue;
+        }
+
+        int16_t y;
+        if (decimator_push(dec, packed_get_bit(words, i), &y) && produced < max_out) {
+            out[produced++] = y;
+        }
+        i++;
+    }
+    return produced;
+}
+
+size_t decimator_process_pcm(decimator_t* dec, const int16_t* input, size_t count,
+                             int16_t* out, size_t max_out)
+{
+    if (!dec || !input || !out || dec->input != DECIMATOR_INPUT_PCM) {
+        return 0;
+    }
+
+    size_t produced = 0;
+    for (size_t i = 0; i < count; i++) {
+        int16_t y;
+        if (decimator_push(dec, input[i], &y) && produced < max_out) {
+            out[produced++] = y;
+        }
+    }
+    return produced;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "packed_bits.h"
+
+// Третий порядок CIC: подавление около 40 дБ у первого зеркала при R >= 8
+#define DECIMATOR_ORDER 3
+
+// Factor 1 is a plain pass-through, the CIC is bypassed
+#define DECIMATOR_MIN_FACTOR 1
+#define DECIMATOR_MAX_FACTOR 64
+
+typedef enum {
+    DECIMATOR_INPUT_BITS,   // boolean stream, high is +full scale and low is -full scale
+    DECIMATOR_INPUT_PCM,    // 16-bit samples
+} decimator_input_t;
+
+typedef struct {
+    decimator_input_t input;
+    uint32_t factor;                        // input samples per output sample
+    uint32_t phase;                         // input samples since the last output
+    int input_shift;                        // PCM headroom so the CIC registers do not overflow
+    int64_t gain;                           // normalizes the CIC output back to 16 bits, Q24
+    // Integrators wrap around on purpose, the combs recover the exact difference
+    uint32_t integrator[DECIMATOR_ORDER];
+    uint32_t comb[DECIMATOR_ORDER];         // previous input of each comb stage
+    int32_t fir[2];                         // droop compensator history
+} decimator_t;
+
+/**
+ * @brief Initialize a CIC decimator with droop compensation
+ *
+ * @param dec Pointer to decimator_t structure to initialize
+ * @param factor Decimation factor, DECIMATOR_MIN_FACTOR..DECIMATOR_MAX_FACTOR
+ * @param input Kind of samples the decimator will be fed with
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t decimator_init(decimator_t* dec, uint32_t factor, decimator_input_t input);
+
+/**
+ * @brief Clear the filter state
+ *
+ * @param dec Pointer to decimator_t structure
+ */
+void decimator_reset(decimator_t* dec);
+
+/**
+ * @brief Feed one input sample
+ *
+ * @param dec Pointer to decimator_t structure
+ * @param sample Input sample, for DECIMATOR_INPUT_BITS any non-zero value is high
+ * @param out Where the output sample is stored when one is produced
+ * @return true if an output sample was produced
+ */
+bool decimator_push(decimator_t* dec, int16_t sample, int16_t* out);
+
+/**
+ * @brief Decimate a packed boolean stream
+ *
+ * Whole bytes that do not cross an output boundary go through the
+ * integrators in one step, so factors that are a multiple of 8 never
+ * touch single bits.
+ *
+ * @param dec Pointer to decimator_t structure, must use DECIMATOR_INPUT_BITS
+ * @param words Input stream, packed LSB first
+ * @param bit_count Number of input samples
+ * @param out Output samples
+ * @param max_out Capacity of the output buffer, outputs past it are dropped
+ * @return size_t Number of output samples written
+ */
+size_t decimator_process_bits(decimator_t* dec, const uint32_t* words, size_t bit_count,
+                              int16_t* out, size_t max_out);
+
+/**
+ * @brief Decimate a block of 16-bit samples
+ *
+ * @param dec Pointer to decimator_t structure, must use DECIMATOR_INPUT_PCM
+ * @param input Input samples
+ * @param count Number of input samples
+ * @param out Output samples
+ * @param max_out Capacity of the output buffer, outputs past it are dropped
+ * @return size_t Number of output samples written
+ */
+size_t decimator_process_pcm(decimator_t* dec, const int16_t* input, size_t count,
+                             int16_t* out, size_t max_out);
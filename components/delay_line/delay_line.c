@@ -0,0 +1,148 @@
+#include "delay_line.h"
+#include <esp_log.h>
+#include <string.h>
+#include "packed_bits.h"
+
+static const char *TAG = "delay_line";
+
+static inline uint32_t delay_line_bit_mask(const delay_line_t* line)
+{
+    return (uint32_t)(line->n_words * PACKED_WORD_BITS - 1);
+}
+
+// 32 отсчета начиная с бита pos, слово может быть не выровнено
+static inline uint32_t delay_line_read_word(const delay_line_t* line, uint32_t pos)
+{
+    size_t word_mask = line->n_words - 1;
+    size_t i = pos / PACKED_WORD_BITS;
+    int shift = pos % PACKED_WORD_BITS;
+    uint32_t lo = line->buffer[i];
+    if (shift == 0) return lo;
+    uint32_t hi = line->buffer[(i + 1) & word_mask];
+    return (lo >> shift) | (hi << (PACKED_WORD_BITS - shift));
+}
+
+static inline void delay_line_write_word(delay_line_t* line, uint32_t pos, uint32_t value)
+{
+    size_t word_mask = line->n_words - 1;
+    size_t i = pos / PACKED_WORD_BITS;
+    int shift = pos % PACKED_WORD_BITS;
+    if (shift == 0) {
+        line->buffer[i] = value;
+        return;
+    }
+    uint32_t low_bits = (1u << shift) - 1;
+    size_t next = (i + 1) & word_mask;
+    line->buffer[i] = (line->buffer[i] & low_bits) | (value << shift);
+    line->buffer[next] = (line->buffer[next] & ~low_bits) | (value >> (PACKED_WORD_BITS - shift));
+}
+
+static inline bool delay_line_read_bit(const delay_line_t* line, uint32_t pos)
+{
+    return (line->buffer[pos / PACKED_WORD_BITS] >> (pos % PACKED_WORD_BITS)) & 1u;
+}
+
+esp_err_t delay_line_init(delay_line_t* line, uint32_t* buffer, size_t n_words)
+{
+    if (!line || !buffer || n_words < 2 || (n_words & (n_words - 1)) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    line->buffer = buffer;
+    line->n_words = n_words;
+    line->input = NULL;
+    line->input_id = -1;
+    for (int t = 0; t < DELAY_LINE_MAX_TAPS; t++) {
+        line->delays[t] = 1;
+    }
+    delay_line_clear(line);
+
+    ESP_LOGI(TAG, "Initializing delay line, %u samples", (unsigned)(n_words * PACKED_WORD_BITS));
+    return ESP_OK;
+}
+
+esp_err_t delay_line_set_input(delay_line_t* line, const bool* input, int input_id)
+{
+    if (!line) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    line->input = input;
+    line->input_id = input ? input_id : -1;
+    return ESP_OK;
+}
+
+uint32_t delay_line_get_max_delay(const delay_line_t* line)
+{
+    if (!line) return 0;
+    return (uint32_t)((line->n_words - 1) * PACKED_WORD_BITS);
+}
+
+esp_err_t delay_line_set_delay(delay_line_t* line, int tap, uint32_t samples)
+{
+    if (!line || tap < 0 || tap >= DELAY_LINE_MAX_TAPS || samples < 1 || samples > delay_line_get_max_delay(line)) {
+        ESP_LOGE(TAG, "Invalid delay tap %d or delay %u", tap, (unsigned)samples);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    line->delays[tap] = samples;
+    return ESP_OK;
+}
+
+void delay_line_clear(delay_line_t* line)
+{
+    if (!line) return;
+    memset(line->buffer, 0, line->n_words * sizeof(uint32_t));
+    line->write_pos = 0;
+    for (int t = 0; t < DELAY_LINE_MAX_TAPS; t++) {
+        line->results[t] = false;
+    }
+}
+
+void delay_line_calculate(delay_line_t* line)
+{
+    if (!line) return;
+
+    uint32_t mask = delay_line_bit_mask(line);
+    uint32_t pos = line->write_pos;
+    uint32_t bit = 1u << (pos % PACKED_WORD_BITS);
+    uint32_t* word = &line->buffer[pos / PACKED_WORD_BITS];
+    *word = (line->input && *line->input) ? (*word | bit) : (*word & ~bit);
+
+    for (int t = 0; t < DELAY_LINE_MAX_TAPS; t++) {
+        line->results[t] = delay_line_read_bit(line, (pos - line->delays[t]) & mask);
+    }
+    line->write_pos = (pos + 1) & mask;
+}
+
+void delay_line_calculate_packed(delay_line_t* line, const uint32_t* input,
+                                 uint32_t* const outputs[DELAY_LINE_MAX_TAPS], size_t n_words)
+{
+    if (!line || !outputs || n_words == 0) return;
+
+    uint32_t mask = delay_line_bit_mask(line);
+    uint32_t pos = line->write_pos;
+
+    for (size_t w = 0; w < n_words; w++) {
+        delay_line_write_word(line, pos, input ? input[w] : 0);
+        for (int t = 0; t < DELAY_LINE_MAX_TAPS; t++) {
+            outputs[t][w] = delay_line_read_word(line, (pos - line->delays[t]) & mask);
+        }
+        pos = (pos + PACKED_WORD_BITS) & mask;
+    }
+
+    line->write_pos = pos;
+    uint32_t last = (pos - 1) & mask;
+    for (int t = 0; t < DELAY_LINE_MAX_TAPS; t++) {
+        line->results[t] = delay_line_read_bit(line, (last - line->delays[t]) & mask);
+    }
+}
+
+bool* delay_line_get_result_pointer(delay_line_t* line, int tap)
+{
+    if (!line || tap < 0 || tap >= DELAY_LINE_MAX_TAPS) {
+        ESP_LOGE(TAG, "Invalid delay tap %d", tap);
+        return NULL;
+    }
+    return &line->results[tap];
+}
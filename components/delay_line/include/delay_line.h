@@ -0,0 +1,102 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+// Цифровая линия задержки на кольцевом битовом буфере: один бит на отсчет,
+// 32 отсчета в слове. Запись и чтение идут словами, отвод с произвольной
+// задержкой читается сдвигом из двух соседних слов.
+
+#define DELAY_LINE_MAX_TAPS 4
+
+typedef struct {
+    uint32_t* buffer;                       // caller owned, n_words long
+    size_t n_words;                         // power of two
+    uint32_t write_pos;                     // bit index of the next sample written
+    const bool* input;
+    int input_id;                           // node id of the input, -1 when not connected (low)
+    uint32_t delays[DELAY_LINE_MAX_TAPS];   // tap delays in samples, 1..delay_line_get_max_delay()
+    bool results[DELAY_LINE_MAX_TAPS];      // tap outputs for per-sample readers
+} delay_line_t;
+
+/**
+ * @brief Initialize a delay line over a caller owned buffer
+ *
+ * The buffer is cleared, the input is not connected and every tap is one sample.
+ *
+ * @param line Pointer to delay_line_t structure to initialize
+ * @param buffer Bit buffer, 32 samples per word
+ * @param n_words Buffer length in words, a power of two, at least 2
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t delay_line_init(delay_line_t* line, uint32_t* buffer, size_t n_words);
+
+/**
+ * @brief Set the input
+ *
+ * @param line Pointer to delay_line_t structure
+ * @param input Input value pointer, NULL writes low
+ * @param input_id Node id of the input, -1 with a NULL input
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG if line is NULL
+ */
+esp_err_t delay_line_set_input(delay_line_t* line, const bool* input, int input_id);
+
+/**
+ * @brief Get the longest delay a tap can have
+ *
+ * One word of the buffer is kept free, so a whole word can be written
+ * before the taps of the same word are read.
+ *
+ * @param line Pointer to delay_line_t structure
+ * @return uint32_t Maximum delay in samples, 0 if line is NULL
+ */
+uint32_t delay_line_get_max_delay(const delay_line_t* line);
+
+/**
+ * @brief Set the delay of a tap
+ *
+ * @param line Pointer to delay_line_t structure
+ * @param tap Tap index, 0..DELAY_LINE_MAX_TAPS-1
+ * @param samples Delay in samples, 1..delay_line_get_max_delay()
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t delay_line_set_delay(delay_line_t* line, int tap, uint32_t samples);
+
+/**
+ * @brief Clear the buffer, all taps read low until the input reaches them
+ *
+ * @param line Pointer to delay_line_t structure
+ */
+void delay_line_clear(delay_line_t* line);
+
+/**
+ * @brief Advance the delay line by one sample from the input pointer
+ *
+ * @param line Pointer to delay_line_t structure
+ */
+void delay_line_calculate(delay_line_t* line);
+
+/**
+ * @brief Advance the delay line over packed words
+ *
+ * Each input word is written first, then every tap reads the 32 samples
+ * that are its delay older, so delays shorter than a word work too.
+ *
+ * @param line Pointer to delay_line_t structure
+ * @param input Input stream, NULL writes low
+ * @param outputs One output stream per tap
+ * @param n_words Number of words in each stream
+ */
+void delay_line_calculate_packed(delay_line_t* line, const uint32_t* input,
+                                 uint32_t* const outputs[DELAY_LINE_MAX_TAPS], size_t n_words);
+
+/**
+ * @brief Get pointer to the output of a tap
+ *
+ * @param line Pointer to delay_line_t structure
+ * @param tap Tap index, 0..DELAY_LINE_MAX_TAPS-1
+ * @return bool* Pointer to the tap output, NULL for a bad tap
+ */
+bool* delay_line_get_result_pointer(delay_line_t* line, int tap);
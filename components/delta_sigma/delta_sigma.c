@@ -0,0 +1,149 @@
+#include "delta_sigma.h"
+#include <esp_log.h>
+#include <string.h>
+
+// программный дельта-сигма модулятор второго/третьего порядка
+// превращает многобитный сигнал в поток единиц и нулей для вывода через один пин
+
+static const char *TAG = "delta_sigma";
+
+// Samples are carried with 8 extra fractional bits so the interpolation step
+// stays exact enough at high oversampling ratios
+#define DS_INPUT_SHIFT      8
+#define DS_FULL_SCALE       (32768 << DS_INPUT_SHIFT)
+
+// Third order CIFB coefficients (a1 = 3/64, a2 = 9/32, a3 = 13/16),
+// NTF out-of-band gain about 1.5, stable up to roughly 0.75 of full scale
+#define DS3_A1              ((3 * DS_FULL_SCALE) >> 6)
+#define DS3_A2              ((9 * DS_FULL_SCALE) >> 5)
+#define DS3_A3              ((13 * DS_FULL_SCALE) >> 4)
+
+// Input gains (out of 64) keep each loop inside its stable input range:
+// 57/64 ~ 0.9 for the second order loop, 45/64 ~ 0.7 for the third order one
+#define DS2_INPUT_GAIN      57
+#define DS3_INPUT_GAIN      45
+#define DS_INPUT_GAIN_SHIFT 6
+
+// Integrators above this are treated as an overload and the loop is restarted
+#define DS_STATE_LIMIT      (8 * DS_FULL_SCALE)
+
+esp_err_t delta_sigma_init(delta_sigma_t* ds, int order, uint32_t oversample)
+{
+    if (!ds || order < DELTA_SIGMA_MIN_ORDER || order > DELTA_SIGMA_MAX_ORDER) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (oversample < DELTA_SIGMA_MIN_OVERSAMPLE || oversample > DELTA_SIGMA_MAX_OVERSAMPLE ||
+        oversample % DELTA_SIGMA_WORD_BITS != 0) {
+        ESP_LOGE(TAG, "Invalid oversample ratio %lu", (unsigned long)oversample);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ds->order = order;
+    ds->oversample = oversample;
+    delta_sigma_reset(ds);
+
+    ESP_LOGI(TAG, "Delta-sigma order %d, oversample x%lu", order, (unsigned long)oversample);
+    return ESP_OK;
+}
+
+void delta_sigma_reset(delta_sigma_t* ds)
+{
+    if (!ds) return;
+    memset(ds->integrator, 0, sizeof(ds->integrator));
+    ds->prev_input = 0;
+}
+
+size_t delta_sigma_words_for_samples(const delta_sigma_t* ds, size_t count)
+{
+    if (!ds) return 0;
+    return count * (ds->oversample / DELTA_SIGMA_WORD_BITS);
+}
+
+// Boser-Wooley second order loop, NTF = (1 - z^-1)^2
+static void modulate_order2(delta_sigma_t* ds, int32_t u, int32_t step, uint32_t* bits, size_t words)
+{
+    int32_t x1 = ds->integrator[0];
+    int32_t x2 = ds->integrator[1];
+
+    for (size_t w = 0; w < words; w++) {
+        uint32_t word = 0;
+        for (int j = 0; j < DELTA_SIGMA_WORD_BITS; j++) {
+            // s is 0 for a one and -1 for a zero, v = s ? -FS : FS without a branch
+            int32_t s = x2 >> 31;
+            int32_t v = (DS_FULL_SCALE ^ s) - s;
+            word |= (uint32_t)(~s & 1) << j;
+
+            x2 += (x1 - v) >> 1;
+            x1 += (u - v) >> 1;
+            u += step;
+        }
+        bits[w] = word;
+    }
+
+    ds->integrator[0] = x1;
+    ds->integrator[1] = x2;
+}
+
+// Cascade of integrators with distributed feedback and direct input feed to the quantizer
+static void modulate_order3(delta_sigma_t* ds, int32_t u, int32_t step, uint32_t* bits, size_t words)
+{
+    int32_t x1 = ds->integrator[0];
+    int32_t x2 = ds->integrator[1];
+    int32_t x3 = ds->integrator[2];
+
+    for (size_t w = 0; w < words; w++) {
+        uint32_t word = 0;
+        for (int j = 0; j < DELTA_SIGMA_WORD_BITS; j++) {
+            int32_t s = (x3 + u) >> 31;
+            word |= (uint32_t)(~s & 1) << j;
+
+            x3 += x2 - ((DS3_A3 ^ s) - s);
+            x2 += x1 - ((DS3_A2 ^ s) - s);
+            x1 += ((u * 3) >> 6) - ((DS3_A1 ^ s) - s);
+            u += step;
+        }
+        bits[w] = word;
+
+        // проверка раз в слово, чтобы не тратить такты на каждом бите
+        if (x3 > DS_STATE_LIMIT || x3 < -DS_STATE_LIMIT) {
+            x1 = 0;
+            x2 = 0;
+            x3 = 0;
+        }
+    }
+
+    ds->integrator[0] = x1;
+    ds->integrator[1] = x2;
+    ds->integrator[2] = x3;
+}
+
+size_t delta_sigma_process_block(delta_sigma_t* ds, const int16_t* input, size_t count,
+                                 uint32_t* bits, size_t max_words)
+{
+    if (!ds || !input || !bits) return 0;
+
+    size_t words_per_sample = ds->oversample / DELTA_SIGMA_WORD_BITS;
+    size_t total_words = count * words_per_sample;
+    if (total_words > max_words) {
+        ESP_LOGE(TAG, "Bitstream buffer too small: %u < %u", (unsigned)max_words, (unsigned)total_words);
+        return 0;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        int32_t gain = (ds->order == 2) ? DS2_INPUT_GAIN : DS3_INPUT_GAIN;
+        int32_t target = (((int32_t)input[i] << DS_INPUT_SHIFT) * gain) >> DS_INPUT_GAIN_SHIFT;
+
+        // Linear interpolation from the previous sample removes the zero-order hold images
+        int32_t step = (target - ds->prev_input) / (int32_t)ds->oversample;
+        uint32_t* out = &bits[i * words_per_sample];
+
+        if (ds->order == 2) {
+            modulate_order2(ds, ds->prev_input, step, out, words_per_sample);
+        } else {
+            modulate_order3(ds, ds->prev_input, step, out, words_per_sample);
+        }
+        ds->prev_input = target;
+    }
+
+    return total_words;
+}
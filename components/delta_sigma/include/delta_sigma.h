@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#define DELTA_SIGMA_MIN_ORDER 2
+#define DELTA_SIGMA_MAX_ORDER 3
+
+// Bits are packed LSB first: bit 0 of a word is the earliest sample
+#define DELTA_SIGMA_WORD_BITS 32
+
+// Oversampling ratio must be a whole number of words per input sample
+#define DELTA_SIGMA_MIN_OVERSAMPLE 32
+#define DELTA_SIGMA_MAX_OVERSAMPLE 1024
+
+typedef struct {
+    int order;
+    uint32_t oversample;                        // output bits per input sample
+    int32_t integrator[DELTA_SIGMA_MAX_ORDER];  // loop filter state
+    int32_t prev_input;                         // last input sample, scaled, for interpolation
+} delta_sigma_t;
+
+/**
+ * @brief Initialize a software delta-sigma modulator
+ *
+ * @param ds Pointer to delta_sigma_t structure to initialize
+ * @param order Noise shaping order (2 or 3)
+ * @param oversample Output bits per input sample, multiple of DELTA_SIGMA_WORD_BITS
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t delta_sigma_init(delta_sigma_t* ds, int order, uint32_t oversample);
+
+/**
+ * @brief Clear the loop filter state
+ *
+ * @param ds Pointer to delta_sigma_t structure
+ */
+void delta_sigma_reset(delta_sigma_t* ds);
+
+/**
+ * @brief Get the number of bitstream words produced for a block of input samples
+ *
+ * @param ds Pointer to delta_sigma_t structure
+ * @param count Number of input samples
+ * @return size_t Number of 32-bit words
+ */
+size_t delta_sigma_words_for_samples(const delta_sigma_t* ds, size_t count);
+
+/**
+ * @brief Modulate a block of multi-bit samples into a 1-bit stream
+ *
+ * Input is linearly interpolated up to the oversampled rate and noise shaped,
+ * so the quantization noise is pushed above the audio band.
+ *
+ * @param ds Pointer to delta_sigma_t structure
+ * @param input Input samples, full scale is INT16_MIN..INT16_MAX
+ * @param count Number of input samples
+ * @param bits Output bitstream, packed LSB first
+ * @param max_words Capacity of the output buffer in words
+ * @return size_t Number of words written, 0 if the buffer is too small
+ */
+size_t delta_sigma_process_block(delta_sigma_t* ds, const int16_t* input, size_t count,
+                                 uint32_t* bits, size_t max_words);
@@ -0,0 +1,228 @@
+#include "edge_engine.h"
+#include <esp_log.h>
+#include <string.h>
+
+static const char *TAG = "edge_engine";
+
+#define PHASE_HALF_TURN     (1ULL << 31)
+#define PHASE_FULL_TURN     (1ULL << 32)
+#define HALF_PERIOD_NUM     (1ULL << 63)    // half a turn in Q32.32 phase-samples
+
+// Edge times sit on the 2^-32 sample grid, edges closer than that count as simultaneous
+static inline bool source_before(const edge_source_t* a, const edge_source_t* b)
+{
+    return a->next < b->next;
+}
+
+static void heap_sift_up(edge_engine_t* ee, int pos)
+{
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!source_before(&ee->sources[ee->heap[pos]], &ee->sources[ee->heap[parent]])) break;
+        uint8_t t = ee->heap[pos];
+        ee->heap[pos] = ee->heap[parent];
+        ee->heap[parent] = t;
+        pos = parent;
+    }
+}
+
+static void heap_sift_down(edge_engine_t* ee, int pos)
+{
+    for (;;) {
+        int left = 2 * pos + 1;
+        int right = left + 1;
+        int best = pos;
+        if (left < ee->heap_size && source_before(&ee->sources[ee->heap[left]], &ee->sources[ee->heap[best]])) {
+            best = left;
+        }
+        if (right < ee->heap_size && source_before(&ee->sources[ee->heap[right]], &ee->sources[ee->heap[best]])) {
+            best = right;
+        }
+        if (best == pos) break;
+        uint8_t t = ee->heap[pos];
+        ee->heap[pos] = ee->heap[best];
+        ee->heap[best] = t;
+        pos = best;
+    }
+}
+
+static void heap_remove(edge_engine_t* ee, int index)
+{
+    for (int pos = 0; pos < ee->heap_size; pos++) {
+        if (ee->heap[pos] == index) {
+            ee->heap[pos] = ee->heap[--ee->heap_size];
+            if (pos < ee->heap_size) {
+                heap_sift_down(ee, pos);
+                heap_sift_up(ee, pos);
+            }
+            return;
+        }
+    }
+}
+
+esp_err_t edge_engine_init(edge_engine_t* ee, int n_sources, double sample_rate)
+{
+    if (!ee || n_sources < 1 || n_sources > EDGE_ENGINE_MAX_SOURCES || sample_rate <= 0.0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(ee, 0, sizeof(*ee));
+    ee->sample_rate = sample_rate;
+    ee->n_sources = n_sources;
+    return ESP_OK;
+}
+
+// расписание следующего фронта из фазы в начале окна (время 0)
+static void source_schedule(edge_source_t* src, uint32_t phase)
+{
+    src->level = phase < PHASE_HALF_TURN;
+    uint64_t to_edge = src->level ? PHASE_HALF_TURN - phase : PHASE_FULL_TURN - phase;
+    uint64_t num = to_edge << EDGE_ENGINE_TIME_SHIFT;
+    src->next = num / src->inc;
+    src->slack = 0;
+    if (num % src->inc != 0) {
+        src->next++;
+        src->slack = src->inc - num % src->inc;
+    }
+}
+
+// следующий фронт через полпериода, 2^63 / inc с точным учетом остатка
+static void source_advance(edge_source_t* src)
+{
+    src->level = !src->level;
+    src->next += src->half_q;
+    if (src->half_r > src->slack) {
+        src->next++;
+        src->slack = src->inc - (src->half_r - src->slack);
+    } else {
+        src->slack -= src->half_r;
+    }
+}
+
+esp_err_t edge_engine_set_source(edge_engine_t* ee, int index, double frequency, uint32_t phase)
+{
+    if (!ee || index < 0 || index >= ee->n_sources || frequency < 0.0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    edge_source_t* src = &ee->sources[index];
+    heap_remove(ee, index);
+
+    src->frequency = frequency;
+    src->inc = (uint64_t)(frequency / ee->sample_rate * (double)PHASE_FULL_TURN);
+    if (src->inc == 0) {
+        // остановленный источник держит уровень своей фазы
+        src->level = phase < PHASE_HALF_TURN;
+        ee->levels[index] = src->level;
+        return ESP_OK;
+    }
+    src->half_q = HALF_PERIOD_NUM / src->inc;
+    src->half_r = HALF_PERIOD_NUM % src->inc;
+    source_schedule(src, phase);
+    ee->levels[index] = src->level;
+
+    ee->heap[ee->heap_size++] = (uint8_t)index;
+    heap_sift_up(ee, ee->heap_size - 1);
+    return ESP_OK;
+}
+
+uint32_t edge_engine_get_phase(const edge_engine_t* ee, int index)
+{
+    if (!ee || index < 0 || index >= ee->n_sources) return 0;
+
+    const edge_source_t* src = &ee->sources[index];
+    if (src->inc == 0) {
+        return src->level ? 0 : (uint32_t)PHASE_HALF_TURN;
+    }
+    // фаза до следующего фронта: (время до фронта) * inc
+    uint64_t boundary = src->level ? PHASE_HALF_TURN : PHASE_FULL_TURN;
+    uint64_t to_edge = (src->next * src->inc - src->slack) >> EDGE_ENGINE_TIME_SHIFT;
+    return (uint32_t)(boundary - to_edge);
+}
+
+esp_err_t edge_engine_set_frequency(edge_engine_t* ee, int index, double frequency)
+{
+    if (!ee || index < 0 || index >= ee->n_sources) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return edge_engine_set_source(ee, index, frequency, edge_engine_get_phase(ee, index));
+}
+
+static void evaluate_gate(edge_engine_t* ee, int index)
+{
+    edge_gate_t* gate = &ee->gates[index];
+    if (!gate->active) return;
+    ee->levels[ee->n_sources + index] =
+        logical_ops_evaluate(gate->op, ee->levels[gate->input1], ee->levels[gate->input2]);
+}
+
+esp_err_t edge_engine_set_gate(edge_engine_t* ee, int index, logical_op_t op, int input1, int input2)
+{
+    if (!ee || index < 0 || index >= EDGE_ENGINE_MAX_GATES || op < 0 || op >= LOGICAL_OP_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int node = ee->n_sources + index;
+    if (input1 < 0 || input2 < 0 || input1 >= node || input2 >= node) {
+        ESP_LOGD(TAG, "Gate %d input is not feed-forward", index);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    edge_gate_t* gate = &ee->gates[index];
+    gate->op = op;
+    gate->input1 = (uint8_t)input1;
+    gate->input2 = (uint8_t)input2;
+    gate->active = true;
+    evaluate_gate(ee, index);
+    return ESP_OK;
+}
+
+bool edge_engine_get_level(const edge_engine_t* ee, int node)
+{
+    if (!ee || node < 0 || node >= EDGE_ENGINE_MAX_NODES) return false;
+    return ee->levels[node];
+}
+
+size_t edge_engine_run(edge_engine_t* ee, uint32_t n_samples, edge_engine_callback_t callback, void* ctx)
+{
+    if (!ee) return 0;
+
+    const uint64_t end = (uint64_t)n_samples << EDGE_ENGINE_TIME_SHIFT;
+    const int n_nodes = ee->n_sources + EDGE_ENGINE_MAX_GATES;
+    size_t edges = 0;
+
+    while (ee->heap_size > 0 && ee->sources[ee->heap[0]].next < end) {
+        uint64_t now = ee->sources[ee->heap[0]].next;
+        bool before[EDGE_ENGINE_MAX_NODES];
+        memcpy(before, ee->levels, sizeof(before));
+
+        // все источники с фронтом в этот же момент переключаются вместе
+        while (ee->heap_size > 0) {
+            int index = ee->heap[0];
+            edge_source_t* src = &ee->sources[index];
+            if (src->next != now) break;
+
+            source_advance(src);
+            ee->levels[index] = src->level;
+            heap_sift_down(ee, 0);
+        }
+
+        for (int g = 0; g < EDGE_ENGINE_MAX_GATES; g++) {
+            evaluate_gate(ee, g);
+        }
+
+        edge_event_t event = { .time = now };
+        for (int n = 0; n < n_nodes; n++) {
+            if (ee->levels[n] != before[n]) {
+                event.node = (uint8_t)n;
+                event.level = ee->levels[n];
+                if (callback) callback(ctx, &event);
+                edges++;
+            }
+        }
+    }
+
+    for (int i = 0; i < ee->heap_size; i++) {
+        ee->sources[ee->heap[i]].next -= end;
+    }
+    return edges;
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "logical_ops.h"
+
+// Событийная модель квадратных осцилляторов и логики: вместо опроса каждого
+// отсчета считается время следующего фронта, вентили пересчитываются только
+// на фронтах входов. Стоимость зависит от числа фронтов, а не от частоты.
+
+#define EDGE_ENGINE_MAX_SOURCES 8
+#define EDGE_ENGINE_MAX_GATES 8
+#define EDGE_ENGINE_MAX_NODES (EDGE_ENGINE_MAX_SOURCES + EDGE_ENGINE_MAX_GATES)
+
+// Times are Q32.32 output samples from the start of the current window
+#define EDGE_ENGINE_TIME_SHIFT 32
+
+typedef struct {
+    uint64_t time;      // Q32.32 output samples from the window start
+    uint8_t node;
+    bool level;         // level from this instant on
+} edge_event_t;
+
+typedef void (*edge_engine_callback_t)(void* ctx, const edge_event_t* event);
+
+// Square wave source, phase 0..2^32 per period, high for the first half
+typedef struct {
+    double frequency;
+    uint64_t inc;           // phase step per output sample, 0 for a stopped source
+    uint64_t half_q;        // half period is half_q + half_r / inc
+    uint64_t half_r;
+    uint64_t next;          // next edge time rounded up to Q32.32
+    uint64_t slack;         // exact time is next - slack / inc, slack < inc
+    bool level;
+} edge_source_t;
+
+typedef struct {
+    logical_op_t op;
+    uint8_t input1;         // node ids, always lower than the gate's own node
+    uint8_t input2;
+    bool active;
+} edge_gate_t;
+
+typedef struct {
+    double sample_rate;
+    int n_sources;          // gate nodes start at n_sources
+    edge_source_t sources[EDGE_ENGINE_MAX_SOURCES];
+    edge_gate_t gates[EDGE_ENGINE_MAX_GATES];
+    bool levels[EDGE_ENGINE_MAX_NODES];
+    uint8_t heap[EDGE_ENGINE_MAX_SOURCES];  // running sources ordered by next edge
+    int heap_size;
+} edge_engine_t;
+
+/**
+ * @brief Initialize an edge engine with stopped sources and no gates
+ *
+ * @param ee Pointer to edge_engine_t structure to initialize
+ * @param n_sources Number of square sources, node ids 0..n_sources-1
+ * @param sample_rate Output sample rate the times are counted in
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t edge_engine_init(edge_engine_t* ee, int n_sources, double sample_rate);
+
+/**
+ * @brief Start a source at a given phase
+ *
+ * @param ee Pointer to edge_engine_t structure
+ * @param index Source index
+ * @param frequency Frequency in Hz, 0 holds the current level
+ * @param phase Phase at the current window position, 2^32 per period
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t edge_engine_set_source(edge_engine_t* ee, int index, double frequency, uint32_t phase);
+
+/**
+ * @brief Change the frequency of a source keeping its phase
+ *
+ * @param ee Pointer to edge_engine_t structure
+ * @param index Source index
+ * @param frequency Frequency in Hz
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t edge_engine_set_frequency(edge_engine_t* ee, int index, double frequency);
+
+/**
+ * @brief Get the phase of a source at the current window position
+ *
+ * @param ee Pointer to edge_engine_t structure
+ * @param index Source index
+ * @return uint32_t Phase, 2^32 per period
+ */
+uint32_t edge_engine_get_phase(const edge_engine_t* ee, int index);
+
+/**
+ * @brief Configure a gate
+ *
+ * Only feed-forward graphs are supported: both inputs must be nodes
+ * evaluated before the gate (sources or lower numbered gates).
+ *
+ * @param ee Pointer to edge_engine_t structure
+ * @param index Gate index, its node id is n_sources + index
+ * @param op Logical operation
+ * @param input1 First input node
+ * @param input2 Second input node
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_SUPPORTED for a feedback input
+ */
+esp_err_t edge_engine_set_gate(edge_engine_t* ee, int index, logical_op_t op, int input1, int input2);
+
+/**
+ * @brief Get the current level of a node
+ *
+ * @param ee Pointer to edge_engine_t structure
+ * @param node Node id
+ * @return bool Level
+ */
+bool edge_engine_get_level(const edge_engine_t* ee, int node);
+
+/**
+ * @brief Simulate a window of output samples
+ *
+ * Every level change of any node is reported in time order; edges at the
+ * same instant are resolved together so gates do not glitch. Afterwards
+ * the time origin moves to the end of the window.
+ *
+ * @param ee Pointer to edge_engine_t structure
+ * @param n_samples Window length in output samples
+ * @param callback Called for every edge, may be NULL
+ * @param ctx Passed to the callback
+ * @return size_t Number of edges
+ */
+size_t edge_engine_run(edge_engine_t* ee, uint32_t n_samples, edge_engine_callback_t callback, void* ctx);
+
+/**
+ * @brief Sample index at which an edge shows up when rasterized
+ *
+ * @param time Edge time, Q32.32 output samples
+ * @param oversample Samples per output sample
+ * @return size_t First sample with the new level
+ */
+static inline size_t edge_engine_time_to_sample(uint64_t time, uint32_t oversample)
+{
+    uint64_t scaled = time * oversample;
+    return (size_t)((scaled + ((1ULL << EDGE_ENGINE_TIME_SHIFT) - 1)) >> EDGE_ENGINE_TIME_SHIFT);
+}
@@ -0,0 +1,152 @@
+#include "flip_flop.h"
+#include <esp_log.h>
+#include "packed_bits.h"
+
+static const char *TAG = "flip_flop";
+
+esp_err_t flip_flop_init(flip_flop_t* ff)
+{
+    if (!ff) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ff->type = FLIP_FLOP_D;
+    ff->edge = FLIP_FLOP_EDGE_RISING;
+    flip_flop_set_inputs(ff, NULL, NULL, -1, -1);
+    flip_flop_set_clock(ff, NULL, -1);
+    ff->result = false;
+
+    ESP_LOGI(TAG, "Initializing flip-flop");
+    return ESP_OK;
+}
+
+esp_err_t flip_flop_set_type(flip_flop_t* ff, flip_flop_type_t type, flip_flop_edge_t edge)
+{
+    if (!ff || type < 0 || type >= FLIP_FLOP_TYPE_COUNT || edge < 0 || edge >= FLIP_FLOP_EDGE_COUNT) {
+        ESP_LOGE(TAG, "Invalid flip-flop type or edge");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ff->type = type;
+    ff->edge = edge;
+    return ESP_OK;
+}
+
+esp_err_t flip_flop_set_inputs(flip_flop_t* ff, const bool* input1, const bool* input2, int input1_id, int input2_id)
+{
+    if (!ff) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ff->inputs[0] = input1;
+    ff->inputs[1] = input2;
+    ff->input_ids[0] = input1 ? input1_id : -1;
+    ff->input_ids[1] = input2 ? input2_id : -1;
+    return ESP_OK;
+}
+
+esp_err_t flip_flop_set_clock(flip_flop_t* ff, const bool* clock, int clock_id)
+{
+    if (!ff) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ff->clock = clock;
+    ff->clock_id = clock ? clock_id : -1;
+    // без ложного фронта при переключении источника
+    ff->prev_clock = clock ? *clock : false;
+    return ESP_OK;
+}
+
+bool flip_flop_calculate(flip_flop_t* ff)
+{
+    if (!ff) return false;
+
+    bool a = ff->inputs[0] ? *ff->inputs[0] : false;
+    bool b = ff->inputs[1] ? *ff->inputs[1] : false;
+    bool clock = ff->clock ? *ff->clock : false;
+    bool rising = ff->edge == FLIP_FLOP_EDGE_RISING;
+    bool edge = rising ? (clock && !ff->prev_clock) : (!clock && ff->prev_clock);
+    ff->prev_clock = clock;
+
+    switch (ff->type) {
+    case FLIP_FLOP_D:
+        if (edge) ff->result = a;
+        break;
+    case FLIP_FLOP_T:
+        if (edge && a) ff->result = !ff->result;
+        break;
+    case FLIP_FLOP_JK:
+        if (edge && (a || b)) ff->result = (a && b) ? !ff->result : a;
+        break;
+    case FLIP_FLOP_SR:
+        if (b) ff->result = false;
+        else if (a) ff->result = true;
+        break;
+    case FLIP_FLOP_SAMPLE_HOLD:
+        if (clock == rising) ff->result = a;
+        break;
+    default:
+        break;
+    }
+    return ff->result;
+}
+
+void flip_flop_calculate_packed(flip_flop_t* ff, const uint32_t* input1, const uint32_t* input2,
+                                const uint32_t* clock, uint32_t* out, size_t n_words)
+{
+    if (!ff || !out || n_words == 0) return;
+
+    bool rising = ff->edge == FLIP_FLOP_EDGE_RISING;
+    bool prev_clock = ff->prev_clock;
+    bool q = ff->result;
+
+    for (size_t w = 0; w < n_words; w++) {
+        uint32_t a = input1 ? input1[w] : 0;
+        uint32_t b = input2 ? input2[w] : 0;
+        uint32_t c = clock ? clock[w] : 0;
+        uint32_t edges = rising ? packed_rising_edges(c, prev_clock) : packed_falling_edges(c, prev_clock);
+        prev_clock = c >> (PACKED_WORD_BITS - 1);
+
+        uint32_t word;
+        switch (ff->type) {
+        case FLIP_FLOP_D:
+            word = packed_hold(a, edges, q);
+            break;
+        case FLIP_FLOP_T:
+            word = packed_prefix_xor(edges & a) ^ packed_broadcast(q);
+            break;
+        case FLIP_FLOP_JK: {
+            // J != K загружает J, J = K = 1 переключает: между загрузками
+            // выход - загруженное значение XOR четность переключений
+            uint32_t parity = packed_prefix_xor(edges & a & b);
+            word = packed_hold(a ^ parity, edges & (a ^ b), q) ^ parity;
+            break;
+        }
+        case FLIP_FLOP_SR:
+            word = packed_hold(a & ~b, a | b, q);
+            break;
+        case FLIP_FLOP_SAMPLE_HOLD:
+            word = packed_hold(a, rising ? c : ~c, q);
+            break;
+        default:
+            word = packed_broadcast(q);
+            break;
+        }
+
+        out[w] = word;
+        q = word >> (PACKED_WORD_BITS - 1);
+    }
+
+    ff->prev_clock = prev_clock;
+    ff->result = q;
+}
+
+bool* flip_flop_get_result_pointer(flip_flop_t* ff)
+{
+    if (!ff) {
+        ESP_LOGE(TAG, "Flip-flop is NULL");
+        return NULL;
+    }
+    return &ff->result;
+}
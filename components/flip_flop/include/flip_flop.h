@@ -0,0 +1,112 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+// Последовательностные узлы: триггеры, защелка и выборка-хранение.
+// Тактируемые типы срабатывают по фронту такта, SR и выборка-хранение
+// работают по уровню. В упакованном режиме фронты и удержание значений
+// считаются масками на все слово, без цикла по отсчетам.
+
+typedef enum {
+    FLIP_FLOP_D,            // q = input1 on the clock edge
+    FLIP_FLOP_T,            // q toggles on the clock edge while input1 is high
+    FLIP_FLOP_JK,           // J = input1, K = input2, both high toggles
+    FLIP_FLOP_SR,           // S = input1, R = input2, level sensitive, R wins, no clock
+    FLIP_FLOP_SAMPLE_HOLD,  // follows input1 while the clock is active, holds otherwise
+    FLIP_FLOP_TYPE_COUNT
+} flip_flop_type_t;
+
+typedef enum {
+    FLIP_FLOP_EDGE_RISING,  // S&H: transparent while the clock is high
+    FLIP_FLOP_EDGE_FALLING, // S&H: transparent while the clock is low
+    FLIP_FLOP_EDGE_COUNT
+} flip_flop_edge_t;
+
+#define FLIP_FLOP_INPUTS 2
+
+typedef struct {
+    flip_flop_type_t type;
+    flip_flop_edge_t edge;
+    const bool* inputs[FLIP_FLOP_INPUTS];
+    int input_ids[FLIP_FLOP_INPUTS];    // node ids, -1 for an input that is not connected (low)
+    const bool* clock;
+    int clock_id;                       // node id of the clock, -1 when not clocked
+    bool prev_clock;
+    bool result;
+} flip_flop_t;
+
+/**
+ * @brief Initialize a D flip-flop on the rising edge, nothing connected, output low
+ *
+ * @param ff Pointer to flip_flop_t structure to initialize
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG if ff is NULL
+ */
+esp_err_t flip_flop_init(flip_flop_t* ff);
+
+/**
+ * @brief Set the flip-flop type and the clock edge it reacts to
+ *
+ * @param ff Pointer to flip_flop_t structure
+ * @param type Flip-flop type
+ * @param edge Active clock edge
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t flip_flop_set_type(flip_flop_t* ff, flip_flop_type_t type, flip_flop_edge_t edge);
+
+/**
+ * @brief Set the data inputs
+ *
+ * @param ff Pointer to flip_flop_t structure
+ * @param input1 D, T, J or S value pointer, NULL reads low
+ * @param input2 K or R value pointer, NULL reads low
+ * @param input1_id Node id of input1, -1 with a NULL pointer
+ * @param input2_id Node id of input2, -1 with a NULL pointer
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG if ff is NULL
+ */
+esp_err_t flip_flop_set_inputs(flip_flop_t* ff, const bool* input1, const bool* input2, int input1_id, int input2_id);
+
+/**
+ * @brief Set the clock input
+ *
+ * @param ff Pointer to flip_flop_t structure
+ * @param clock Clock value pointer, NULL reads low
+ * @param clock_id Node id of the clock, -1 with a NULL clock
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG if ff is NULL
+ */
+esp_err_t flip_flop_set_clock(flip_flop_t* ff, const bool* clock, int clock_id);
+
+/**
+ * @brief Advance the flip-flop by one sample from the input pointers
+ *
+ * @param ff Pointer to flip_flop_t structure
+ * @return bool Output after the sample
+ */
+bool flip_flop_calculate(flip_flop_t* ff);
+
+/**
+ * @brief Advance the flip-flop over packed streams
+ *
+ * Clock edges come from one mask operation per word, held values from a
+ * segmented scan (packed_hold), so the cost per word is the same as for a
+ * logical operation plus a few shifts.
+ *
+ * @param ff Pointer to flip_flop_t structure
+ * @param input1 Input1 stream, NULL for a low input
+ * @param input2 Input2 stream, NULL for a low input
+ * @param clock Clock stream, NULL for a low clock
+ * @param out Output stream
+ * @param n_words Number of words in each stream
+ */
+void flip_flop_calculate_packed(flip_flop_t* ff, const uint32_t* input1, const uint32_t* input2,
+                                const uint32_t* clock, uint32_t* out, size_t n_words);
+
+/**
+ * @brief Get pointer to the output value
+ *
+ * @param ff Pointer to flip_flop_t structure
+ * @return bool* Pointer to the output, NULL if ff is NULL
+ */
+bool* flip_flop_get_result_pointer(flip_flop_t* ff);
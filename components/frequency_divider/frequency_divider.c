@@ -0,0 +1,107 @@
+#include "frequency_divider.h"
+#include <esp_log.h>
+#include "packed_bits.h"
+
+static const char *TAG = "frequency_divider";
+
+#define FREQUENCY_DIVIDER_MASK ((1u << FREQUENCY_DIVIDER_STAGES) - 1)
+
+static void frequency_divider_update_results(frequency_divider_t* divider)
+{
+    for (int s = 0; s < FREQUENCY_DIVIDER_STAGES; s++) {
+        divider->results[s] = (divider->count >> s) & 1u;
+    }
+}
+
+esp_err_t frequency_divider_init(frequency_divider_t* divider)
+{
+    if (!divider) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    divider->clock = NULL;
+    divider->clock_id = -1;
+    divider->prev_clock = false;
+    frequency_divider_reset(divider);
+
+    ESP_LOGI(TAG, "Initializing %d stage frequency divider", FREQUENCY_DIVIDER_STAGES);
+    return ESP_OK;
+}
+
+esp_err_t frequency_divider_set_clock(frequency_divider_t* divider, const bool* clock, int clock_id)
+{
+    if (!divider) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    divider->clock = clock;
+    divider->clock_id = clock ? clock_id : -1;
+    // без ложного спада при переключении источника
+    divider->prev_clock = clock ? *clock : false;
+    return ESP_OK;
+}
+
+void frequency_divider_reset(frequency_divider_t* divider)
+{
+    if (!divider) return;
+    divider->count = 0;
+    frequency_divider_update_results(divider);
+}
+
+uint32_t frequency_divider_calculate(frequency_divider_t* divider)
+{
+    if (!divider) return 0;
+
+    bool clock = divider->clock ? *divider->clock : false;
+    if (divider->prev_clock && !clock) {
+        divider->count = (divider->count + 1) & FREQUENCY_DIVIDER_MASK;
+        frequency_divider_update_results(divider);
+    }
+    divider->prev_clock = clock;
+    return divider->count;
+}
+
+void frequency_divider_calculate_packed(frequency_divider_t* divider, const uint32_t* clock,
+                                        uint32_t* const outputs[FREQUENCY_DIVIDER_STAGES], size_t n_words)
+{
+    if (!divider || !outputs || n_words == 0) return;
+
+    uint32_t count = divider->count;
+    bool prev_clock = divider->prev_clock;
+
+    for (size_t w = 0; w < n_words; w++) {
+        uint32_t edges = 0;
+        if (clock) {
+            edges = packed_falling_edges(clock[w], prev_clock);
+            prev_clock = clock[w] >> (PACKED_WORD_BITS - 1);
+        }
+        int toggles = packed_popcount(edges);
+
+        // ступень переключается на спадах предыдущей, дальше первой неподвижной - константы
+        int s = 0;
+        for (; s < FREQUENCY_DIVIDER_STAGES && edges != 0; s++) {
+            bool level = (count >> s) & 1u;
+            uint32_t out = packed_prefix_xor(edges) ^ packed_broadcast(level);
+            outputs[s][w] = out;
+            edges = packed_falling_edges(out, level);
+        }
+        for (; s < FREQUENCY_DIVIDER_STAGES; s++) {
+            outputs[s][w] = packed_broadcast((count >> s) & 1u);
+        }
+
+        count = (count + (uint32_t)toggles) & FREQUENCY_DIVIDER_MASK;
+    }
+
+    divider->count = count;
+    divider->prev_clock = prev_clock;
+    frequency_divider_update_results(divider);
+}
+
+bool* frequency_divider_get_result_pointer(frequency_divider_t* divider, int stage)
+{
+    if (!divider || stage < 0 || stage >= FREQUENCY_DIVIDER_STAGES) {
+        ESP_LOGE(TAG, "Invalid divider stage %d", stage);
+        return NULL;
+    }
+    return &divider->results[stage];
+}
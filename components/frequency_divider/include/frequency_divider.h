@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+// Двоичный счетчик-делитель как CD4040: один счетчик, бит n - выход ступени n,
+// делит частоту такта на 2^(n+1). Счетчик прибавляет единицу по спаду такта.
+
+#define FREQUENCY_DIVIDER_STAGES 12
+
+typedef struct {
+    const bool* clock;
+    int clock_id;                               // node id of the clock, -1 when not clocked
+    uint32_t count;
+    bool prev_clock;
+    bool results[FREQUENCY_DIVIDER_STAGES];     // stage outputs for per-sample readers
+} frequency_divider_t;
+
+/**
+ * @brief Initialize a divider, not clocked and cleared
+ *
+ * @param divider Pointer to frequency_divider_t structure to initialize
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG if divider is NULL
+ */
+esp_err_t frequency_divider_init(frequency_divider_t* divider);
+
+/**
+ * @brief Set the clock input
+ *
+ * @param divider Pointer to frequency_divider_t structure
+ * @param clock Clock value pointer, NULL stops the counter
+ * @param clock_id Node id of the clock, -1 with a NULL clock
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG if divider is NULL
+ */
+esp_err_t frequency_divider_set_clock(frequency_divider_t* divider, const bool* clock, int clock_id);
+
+/**
+ * @brief Clear the counter, all stages go low
+ *
+ * @param divider Pointer to frequency_divider_t structure
+ */
+void frequency_divider_reset(frequency_divider_t* divider);
+
+/**
+ * @brief Advance the divider by one sample from the clock pointer
+ *
+ * @param divider Pointer to frequency_divider_t structure
+ * @return uint32_t Counter value after the sample
+ */
+uint32_t frequency_divider_calculate(frequency_divider_t* divider);
+
+/**
+ * @brief Advance the divider over packed clock words
+ *
+ * Falling edges of a word are found with one mask operation; every stage is
+ * the prefix XOR of the falling edges of the stage before it, so the cost
+ * per word does not depend on the number of edges. Stages above the last
+ * one that toggles are written as constant words.
+ *
+ * @param divider Pointer to frequency_divider_t structure
+ * @param clock Clock stream, NULL for a divider that is not clocked
+ * @param outputs One output stream per stage
+ * @param n_words Number of words in each stream
+ */
+void frequency_divider_calculate_packed(frequency_divider_t* divider, const uint32_t* clock,
+                                        uint32_t* const outputs[FREQUENCY_DIVIDER_STAGES], size_t n_words);
+
+/**
+ * @brief Get pointer to the output of a stage
+ *
+ * @param divider Pointer to frequency_divider_t structure
+ * @param stage Stage, 0 divides by 2 and FREQUENCY_DIVIDER_STAGES-1 by 2^FREQUENCY_DIVIDER_STAGES
+ * @return bool* Pointer to the stage output, NULL for a bad stage
+ */
+bool* frequency_divider_get_result_pointer(frequency_divider_t* divider, int stage);
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+// Генератор шума на регистре сдвига с линейной обратной связью (схема Фибоначчи).
+// Выходная последовательность s[k+length] = XOR s[k+t] по всем отводам t.
+// Пока самый старший отвод меньше length, следующие length - tap_max бит
+// зависят только от уже известных, поэтому они считаются одним сдвигом и XOR
+// всего регистра: для length 63 и отводов 0, 1 это 62 бита за шаг.
+
+#define LFSR_MIN_LENGTH 2
+#define LFSR_MAX_LENGTH 63
+// x^63 + x + 1: период 2^63 - 1 и 32 отсчета за один шаг
+#define LFSR_DEFAULT_LENGTH 63
+
+typedef struct {
+    uint64_t state;         // bit i is s[k+i], bit 0 is the current output
+    uint64_t taps;          // bit t set feeds s[k+t] back, bit 0 is always set
+    int length;
+    int span;               // bits produced per shift and XOR, length - highest tap
+    const bool* clock;
+    int clock_id;           // node id of the clock, -1 advances every sample
+    bool prev_clock;
+    bool result;
+} lfsr_t;
+
+/**
+ * @brief Initialize an LFSR with the default length, advancing every sample
+ *
+ * @param lfsr Pointer to lfsr_t structure to initialize
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG if lfsr is NULL
+ */
+esp_err_t lfsr_init(lfsr_t* lfsr);
+
+/**
+ * @brief Get the taps of a maximal length trinomial x^length + x^t + 1
+ *
+ * @param length Register length
+ * @return uint64_t Tap mask (bits 0 and t), 0 if the table has no trinomial for this length
+ */
+uint64_t lfsr_default_taps(int length);
+
+/**
+ * @brief Set the register length and feedback taps, the register is reseeded
+ *
+ * Short registers repeat quickly and sound pitched ("metallic" noise), long
+ * ones give white noise.
+ *
+ * @param lfsr Pointer to lfsr_t structure
+ * @param length Register length, LFSR_MIN_LENGTH..LFSR_MAX_LENGTH
+ * @param taps Tap mask below bit length with bit 0 set, 0 picks lfsr_default_taps
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters,
+ *                   ESP_ERR_NOT_FOUND if taps is 0 and there is no default for length
+ */
+esp_err_t lfsr_set_length(lfsr_t* lfsr, int length, uint64_t taps);
+
+/**
+ * @brief Load the register, a seed that is zero in the low length bits loads 1
+ *
+ * @param lfsr Pointer to lfsr_t structure
+ * @param seed Initial register value, bit 0 is the first output
+ */
+void lfsr_seed(lfsr_t* lfsr, uint64_t seed);
+
+/**
+ * @brief Set the clock input
+ *
+ * @param lfsr Pointer to lfsr_t structure
+ * @param clock Clock value pointer, the register shifts on its rising edges;
+ *              NULL shifts it every sample
+ * @param clock_id Node id of the clock, -1 with a NULL clock
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG if lfsr is NULL
+ */
+esp_err_t lfsr_set_clock(lfsr_t* lfsr, const bool* clock, int clock_id);
+
+/**
+ * @brief Advance the LFSR by one sample from the clock pointer
+ *
+ * @param lfsr Pointer to lfsr_t structure
+ * @return bool Output after the sample
+ */
+bool lfsr_calculate(lfsr_t* lfsr);
+
+/**
+ * @brief Advance the LFSR over packed clock words
+ *
+ * Without a clock every word is 32 new bits of the sequence. With a clock
+ * the bits for all rising edges of a word are produced at once and held
+ * from each edge to the next.
+ *
+ * @param lfsr Pointer to lfsr_t structure
+ * @param clock Clock stream, NULL to shift every sample
+ * @param out Output stream
+ * @param n_words Number of words in each stream
+ */
+void lfsr_calculate_packed(lfsr_t* lfsr, const uint32_t* clock, uint32_t* out, size_t n_words);
+
+/**
+ * @brief Get pointer to the output value
+ *
+ * @param lfsr Pointer to lfsr_t structure
+ * @return bool* Pointer to the output, NULL if lfsr is NULL
+ */
+bool* lfsr_get_result_pointer(lfsr_t* lfsr);
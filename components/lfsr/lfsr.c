@@ -0,0 +1,173 @@
+#include "lfsr.h"
+#include <esp_log.h>
+#include "packed_bits.h"
+
+static const char *TAG = "lfsr";
+
+// Плотная затравка: от затравки 1 длинный регистр с редкими отводами
+// тысячи отсчетов выдает почти одни нули
+#define LFSR_DEFAULT_SEED 0x9E3779B97F4A7C15ull
+
+// Средний член примитивного трехчлена x^length + x^t + 1, 0 если его нет.
+// Из двух взаимных трехчленов взят тот, у которого t меньше: так шаг длиннее.
+static const uint8_t default_tap[LFSR_MAX_LENGTH + 1] = {
+    [2] = 1, [3] = 1, [4] = 1, [5] = 2, [6] = 1, [7] = 1, [9] = 4, [10] = 3,
+    [11] = 2, [15] = 1, [17] = 3, [18] = 7, [20] = 3, [21] = 2, [22] = 1, [23] = 5,
+    [25] = 3, [28] = 3, [29] = 2, [31] = 3, [33] = 13, [35] = 2, [36] = 11, [39] = 4,
+    [41] = 3, [47] = 5, [49] = 9, [52] = 3, [55] = 24, [57] = 7, [58] = 19, [60] = 1,
+    [63] = 1,
+};
+
+static inline uint64_t lfsr_mask(int bits)
+{
+    return bits >= 64 ? ~0ull : (1ull << bits) - 1;
+}
+
+// Сдвигает регистр на n <= 32 отсчетов, бит i результата - выход после i+1 сдвигов
+static uint32_t lfsr_advance(lfsr_t* lfsr, int n)
+{
+    uint32_t out = 0;
+    int done = 0;
+    while (done < n) {
+        int step = n - done < lfsr->span ? n - done : lfsr->span;
+        uint64_t state = lfsr->state;
+        uint64_t feedback = 0;
+        for (uint64_t taps = lfsr->taps; taps; taps &= taps - 1) {
+            feedback ^= state >> __builtin_ctzll(taps);
+        }
+        feedback &= lfsr_mask(step);
+
+        out |= (uint32_t)(((state >> 1) | (feedback << (lfsr->length - 1))) & lfsr_mask(step)) << done;
+        lfsr->state = (state >> step) | (feedback << (lfsr->length - step));
+        done += step;
+    }
+    lfsr->result = lfsr->state & 1u;
+    return out;
+}
+
+esp_err_t lfsr_init(lfsr_t* lfsr)
+{
+    if (!lfsr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    lfsr->clock = NULL;
+    lfsr->clock_id = -1;
+    lfsr->prev_clock = false;
+    lfsr_set_length(lfsr, LFSR_DEFAULT_LENGTH, 0);
+
+    ESP_LOGI(TAG, "Initializing %d bit LFSR", lfsr->length);
+    return ESP_OK;
+}
+
+uint64_t lfsr_default_taps(int length)
+{
+    if (length < LFSR_MIN_LENGTH || length > LFSR_MAX_LENGTH || default_tap[length] == 0) {
+        return 0;
+    }
+    return 1ull | (1ull << default_tap[length]);
+}
+
+esp_err_t lfsr_set_length(lfsr_t* lfsr, int length, uint64_t taps)
+{
+    if (!lfsr || length < LFSR_MIN_LENGTH || length > LFSR_MAX_LENGTH) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (taps == 0) {
+        taps = lfsr_default_taps(length);
+        if (taps == 0) {
+            ESP_LOGE(TAG, "No default taps for length %d", length);
+            return ESP_ERR_NOT_FOUND;
+        }
+    }
+    if (!(taps & 1u) || (taps & ~lfsr_mask(length))) {
+        ESP_LOGE(TAG, "Invalid taps 0x%llx for length %d", (unsigned long long)taps, length);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    lfsr->length = length;
+    lfsr->taps = taps;
+    lfsr->span = length - (63 - __builtin_clzll(taps));
+    lfsr_seed(lfsr, LFSR_DEFAULT_SEED);
+    return ESP_OK;
+}
+
+void lfsr_seed(lfsr_t* lfsr, uint64_t seed)
+{
+    if (!lfsr) return;
+    seed &= lfsr_mask(lfsr->length);
+    // из нулевого состояния регистр не выходит
+    lfsr->state = seed ? seed : 1;
+    lfsr->result = lfsr->state & 1u;
+}
+
+esp_err_t lfsr_set_clock(lfsr_t* lfsr, const bool* clock, int clock_id)
+{
+    if (!lfsr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    lfsr->clock = clock;
+    lfsr->clock_id = clock ? clock_id : -1;
+    // без ложного фронта при переключении источника
+    lfsr->prev_clock = clock ? *clock : false;
+    return ESP_OK;
+}
+
+bool lfsr_calculate(lfsr_t* lfsr)
+{
+    if (!lfsr) return false;
+
+    if (lfsr->clock) {
+        bool clock = *lfsr->clock;
+        if (clock && !lfsr->prev_clock) {
+            lfsr_advance(lfsr, 1);
+        }
+        lfsr->prev_clock = clock;
+    } else {
+        lfsr_advance(lfsr, 1);
+    }
+    return lfsr->result;
+}
+
+void lfsr_calculate_packed(lfsr_t* lfsr, const uint32_t* clock, uint32_t* out, size_t n_words)
+{
+    if (!lfsr || !out || n_words == 0) return;
+
+    if (!clock) {
+        for (size_t w = 0; w < n_words; w++) {
+            out[w] = lfsr_advance(lfsr, PACKED_WORD_BITS);
+        }
+        return;
+    }
+
+    bool prev_clock = lfsr->prev_clock;
+    for (size_t w = 0; w < n_words; w++) {
+        uint32_t edges = packed_rising_edges(clock[w], prev_clock);
+        prev_clock = clock[w] >> (PACKED_WORD_BITS - 1);
+
+        // уровень держится от фронта до фронта: переключения - фронты, где бит сменился
+        bool start = lfsr->result;
+        bool level = start;
+        uint32_t toggles = 0;
+        if (edges) {
+            uint32_t bits = lfsr_advance(lfsr, packed_popcount(edges));
+            for (uint32_t e = edges; e; e &= e - 1, bits >>= 1) {
+                bool next = bits & 1u;
+                if (next != level) toggles |= e & -e;
+                level = next;
+            }
+        }
+        out[w] = packed_prefix_xor(toggles) ^ packed_broadcast(start);
+    }
+    lfsr->prev_clock = prev_clock;
+}
+
+bool* lfsr_get_result_pointer(lfsr_t* lfsr)
+{
+    if (!lfsr) {
+        ESP_LOGE(TAG, "LFSR is NULL");
+        return NULL;
+    }
+    return &lfsr->result;
+}
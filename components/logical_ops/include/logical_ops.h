@@ -1,6 +1,8 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
 #include "esp_err.h"
 
 typedef enum {
@@ -81,6 +83,33 @@ esp_err_t logical_ops_set_inputs(logical_ops_t* ops, bool *input1, bool *input2,
  */
 bool logical_ops_calculate(logical_ops_t* ops);
 
+/**
+ * @brief Apply a logical operation to two values
+ *
+ * @param op The logical operation
+ * @param input1 First input value
+ * @param input2 Second input value
+ * @return bool Result, false for an unknown operation
+ */
+bool logical_ops_evaluate(logical_op_t op, bool input1, bool input2);
+
+/**
+ * @brief Calculate the logical operation over packed streams
+ *
+ * Each word holds 32 consecutive samples, bit 0 is the earliest. The inputs
+ * are taken as they are, so the caller resolves which streams feed the
+ * operation. result and prev_result are left at the last two samples.
+ *
+ * @param ops Pointer to logical_ops_t structure
+ * @param input1 First input stream
+ * @param input2 Second input stream
+ * @param out Output stream, may alias an input
+ * @param n_words Number of words in each stream
+ * @return esp_err_t ESP_OK on success, otherwise an error code
+ */
+esp_err_t logical_ops_calculate_packed(logical_ops_t* ops, const uint32_t* input1, const uint32_t* input2,
+                                       uint32_t* out, size_t n_words);
+
 /**
  * @brief Get pointer to the result value
  * 
@@ -120,33 +120,78 @@ bool logical_ops_calculate(logical_ops_t *ops)
     const bool input1 = *(ops->input1);
     const bool input2 = *(ops->input2);
 
+    if (ops->operation < 0 || ops->operation >= LOGICAL_OP_COUNT)
+    {
+        ESP_LOGE(TAG, "Invalid operation type");
+        return false;
+    }
+    result = logical_ops_evaluate(ops->operation, input1, input2);
+
+    ops->result = result;
+    return result;
+}
+
+// одна операция над двумя булевыми значениями, без входов и состояния узла
+bool logical_ops_evaluate(logical_op_t op, bool input1, bool input2)
+{
+    switch (op)
+    {
+    case LOGICAL_OP_AND:
+        return input1 && input2;
+    case LOGICAL_OP_OR:
+        return input1 || input2;
+    case LOGICAL_OP_XOR:
+        return input1 != input2;
+    case LOGICAL_OP_NAND:
+        return !(input1 && input2);
+    case LOGICAL_OP_NOR:
+        return !(input1 || input2);
+    case LOGICAL_OP_XNOR:
+        return input1 == input2;
+    default:
+        return false;
+    }
+}
+
+// та же операция над упакованными потоками, 32 отсчета за одну инструкцию
+esp_err_t logical_ops_calculate_packed(logical_ops_t *ops, const uint32_t *input1, const uint32_t *input2,
+                                       uint32_t *out, size_t n_words)
+{
+    if (!ops || !input1 || !input2 || !out || n_words == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
     switch (ops->operation)
     {
     case LOGICAL_OP_AND:
-        result = input1 && input2;
+        for (size_t w = 0; w < n_words; w++) out[w] = input1[w] & input2[w];
         break;
     case LOGICAL_OP_OR:
-        result = input1 || input2;
+        for (size_t w = 0; w < n_words; w++) out[w] = input1[w] | input2[w];
         break;
     case LOGICAL_OP_XOR:
-        result = input1 != input2;
+        for (size_t w = 0; w < n_words; w++) out[w] = input1[w] ^ input2[w];
         break;
     case LOGICAL_OP_NAND:
-        result = !input1 && !input2;
+        for (size_t w = 0; w < n_words; w++) out[w] = ~(input1[w] & input2[w]);
         break;
     case LOGICAL_OP_NOR:
-        result = !input1 || !input2;
+        for (size_t w = 0; w < n_words; w++) out[w] = ~(input1[w] | input2[w]);
         break;
     case LOGICAL_OP_XNOR:
-        result = input1 == input2;
+        for (size_t w = 0; w < n_words; w++) out[w] = ~(input1[w] ^ input2[w]);
         break;
     default:
         ESP_LOGE(TAG, "Invalid operation type");
-        return false;
+        return ESP_ERR_INVALID_ARG;
     }
 
-    ops->result = result;
-    return result;
+    // последние два отсчета блока, чтобы поотсчетный режим мог продолжить с того же места
+    uint32_t last = out[n_words - 1];
+    ops->result = (last >> 31) & 1u;
+    ops->prev_result = (last >> 30) & 1u;
+    return ESP_OK;
 }
 
 bool *logical_ops_get_result_pointer(logical_ops_t *ops)
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+// Матрица модуляции на управляющей частоте: LFO и ADSR-огибающие двигаются
+// раз в управляющий блок, разреженный список маршрутов складывает
+// источники с глубиной в значения назначений. Что значит назначение,
+// решает вызывающий.
+
+#define MOD_MATRIX_LFOS 4
+#define MOD_MATRIX_ENVELOPES 4
+#define MOD_MATRIX_MAX_ROUTES 16
+
+typedef enum {
+    MOD_MATRIX_LFO_SINE,
+    MOD_MATRIX_LFO_TRIANGLE,
+    MOD_MATRIX_LFO_SAW,
+    MOD_MATRIX_LFO_SQUARE,
+    MOD_MATRIX_LFO_RANDOM,          // new random level every cycle
+    MOD_MATRIX_LFO_SHAPE_COUNT
+} mod_matrix_lfo_shape_t;
+
+typedef enum {
+    MOD_MATRIX_SOURCE_LFO,          // -1..1
+    MOD_MATRIX_SOURCE_ENVELOPE,     // 0..1
+    MOD_MATRIX_SOURCE_COUNT
+} mod_matrix_source_t;
+
+typedef enum {
+    MOD_MATRIX_DEST_FREQUENCY,      // oscillator, depth in octaves
+    MOD_MATRIX_DEST_MIXER_WEIGHT,   // mixer input, depth as a share of the set weight
+    MOD_MATRIX_DEST_COUNT
+} mod_matrix_dest_t;
+
+typedef enum {
+    MOD_MATRIX_ENV_IDLE,
+    MOD_MATRIX_ENV_ATTACK,
+    MOD_MATRIX_ENV_DECAY,
+    MOD_MATRIX_ENV_SUSTAIN,
+    MOD_MATRIX_ENV_RELEASE,
+} mod_matrix_env_stage_t;
+
+extern const char* mod_matrix_lfo_shape_names[];
+extern const char* mod_matrix_source_names[];
+extern const char* mod_matrix_dest_names[];
+
+typedef struct {
+    mod_matrix_lfo_shape_t shape;
+    double rate;                    // Hz
+    double phase;                   // 0..1
+    double held;                    // random shape level
+    double value;
+} mod_matrix_lfo_t;
+
+typedef struct {
+    double attack_ms;
+    double decay_ms;
+    double sustain;                 // 0..1
+    double release_ms;
+    int gate_id;                    // boolean node that gates the envelope, -1 none
+    mod_matrix_env_stage_t stage;
+    double value;
+} mod_matrix_envelope_t;
+
+typedef struct {
+    bool active;
+    mod_matrix_source_t source;
+    int source_index;
+    mod_matrix_dest_t dest;
+    int dest_index;
+    double depth;
+} mod_matrix_route_t;
+
+typedef struct {
+    mod_matrix_lfo_t lfos[MOD_MATRIX_LFOS];
+    mod_matrix_envelope_t envelopes[MOD_MATRIX_ENVELOPES];
+    mod_matrix_route_t routes[MOD_MATRIX_MAX_ROUTES];
+    uint32_t random_state;
+} mod_matrix_t;
+
+/**
+ * @brief Initialize a matrix with no routes
+ *
+ * LFOs are 1 Hz sines, envelopes are ungated 10/100/0.7/200 ms ADSRs.
+ *
+ * @param matrix Pointer to mod_matrix_t structure to initialize
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG if matrix is NULL
+ */
+esp_err_t mod_matrix_init(mod_matrix_t* matrix);
+
+/**
+ * @brief Set the shape and rate of an LFO
+ *
+ * @param matrix Pointer to mod_matrix_t structure
+ * @param index LFO index
+ * @param shape Waveform
+ * @param rate Rate in Hz, 0 and up
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t mod_matrix_set_lfo(mod_matrix_t* matrix, int index, mod_matrix_lfo_shape_t shape, double rate);
+
+/**
+ * @brief Set the stage times and sustain level of an envelope
+ *
+ * @param matrix Pointer to mod_matrix_t structure
+ * @param index Envelope index
+ * @param attack_ms Attack time, 0 and up
+ * @param decay_ms Decay time, 0 and up
+ * @param sustain Sustain level, 0..1
+ * @param release_ms Release time, 0 and up
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t mod_matrix_set_envelope(mod_matrix_t* matrix, int index, double attack_ms, double decay_ms,
+                                  double sustain, double release_ms);
+
+/**
+ * @brief Set the node that gates an envelope, stored for the caller
+ *
+ * @param matrix Pointer to mod_matrix_t structure
+ * @param index Envelope index
+ * @param gate_id Node id, -1 for none
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t mod_matrix_set_envelope_gate(mod_matrix_t* matrix, int index, int gate_id);
+
+/**
+ * @brief Drive an envelope gate for the next control block
+ *
+ * @param matrix Pointer to mod_matrix_t structure
+ * @param index Envelope index
+ * @param level Gate level at the end of the block
+ * @param retrigger A rising edge happened, restart the attack
+ */
+void mod_matrix_gate(mod_matrix_t* matrix, int index, bool level, bool retrigger);
+
+/**
+ * @brief Set a route slot
+ *
+ * @param matrix Pointer to mod_matrix_t structure
+ * @param slot Route slot, 0..MOD_MATRIX_MAX_ROUTES-1
+ * @param route Route, active false frees the slot
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t mod_matrix_set_route(mod_matrix_t* matrix, int slot, const mod_matrix_route_t* route);
+
+/**
+ * @brief Move every LFO and envelope by one control block
+ *
+ * @param matrix Pointer to mod_matrix_t structure
+ * @param dt Block duration in seconds
+ */
+void mod_matrix_advance(mod_matrix_t* matrix, double dt);
+
+/**
+ * @brief Sum the active routes into one destination type
+ *
+ * @param matrix Pointer to mod_matrix_t structure
+ * @param dest Destination type
+ * @param out Sum of depth times source value per destination index, cleared first
+ * @param count Number of destination indexes; routes to higher indexes are skipped
+ * @return bool true if any route feeds this destination type
+ */
+bool mod_matrix_sum(const mod_matrix_t* matrix, mod_matrix_dest_t dest, double* out, int count);
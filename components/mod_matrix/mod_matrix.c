@@ -0,0 +1,228 @@
+#include "mod_matrix.h"
+#include <esp_log.h>
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "mod_matrix";
+
+const char* mod_matrix_lfo_shape_names[] = {
+    "sine",
+    "triangle",
+    "saw",
+    "square",
+    "random",
+};
+
+const char* mod_matrix_source_names[] = {
+    "lfo",
+    "envelope",
+};
+
+const char* mod_matrix_dest_names[] = {
+    "frequency",
+    "mixer_weight",
+};
+
+esp_err_t mod_matrix_init(mod_matrix_t* matrix)
+{
+    if (!matrix) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(matrix, 0, sizeof(*matrix));
+    matrix->random_state = 0x2545F491u;
+    for (int l = 0; l < MOD_MATRIX_LFOS; l++) {
+        matrix->lfos[l].shape = MOD_MATRIX_LFO_SINE;
+        matrix->lfos[l].rate = 1.0;
+    }
+    for (int e = 0; e < MOD_MATRIX_ENVELOPES; e++) {
+        mod_matrix_set_envelope(matrix, e, 10.0, 100.0, 0.7, 200.0);
+        matrix->envelopes[e].gate_id = -1;
+    }
+    return ESP_OK;
+}
+
+esp_err_t mod_matrix_set_lfo(mod_matrix_t* matrix, int index, mod_matrix_lfo_shape_t shape, double rate)
+{
+    if (!matrix || index < 0 || index >= MOD_MATRIX_LFOS
+    || shape < 0 || shape >= MOD_MATRIX_LFO_SHAPE_COUNT || !(rate >= 0.0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    matrix->lfos[index].shape = shape;
+    matrix->lfos[index].rate = rate;
+    return ESP_OK;
+}
+
+esp_err_t mod_matrix_set_envelope(mod_matrix_t* matrix, int index, double attack_ms, double decay_ms,
+                                  double sustain, double release_ms)
+{
+    if (!matrix || index < 0 || index >= MOD_MATRIX_ENVELOPES
+    || !(attack_ms >= 0.0) || !(decay_ms >= 0.0) || !(release_ms >= 0.0)
+    || !(sustain >= 0.0 && sustain <= 1.0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mod_matrix_envelope_t* env = &matrix->envelopes[index];
+    env->attack_ms = attack_ms;
+    env->decay_ms = decay_ms;
+    env->sustain = sustain;
+    env->release_ms = release_ms;
+    return ESP_OK;
+}
+
+esp_err_t mod_matrix_set_envelope_gate(mod_matrix_t* matrix, int index, int gate_id)
+{
+    if (!matrix || index < 0 || index >= MOD_MATRIX_ENVELOPES || gate_id < -1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    matrix->envelopes[index].gate_id = gate_id;
+    if (gate_id < 0) {
+        mod_matrix_gate(matrix, index, false, false);
+    }
+    return ESP_OK;
+}
+
+void mod_matrix_gate(mod_matrix_t* matrix, int index, bool level, bool retrigger)
+{
+    if (!matrix || index < 0 || index >= MOD_MATRIX_ENVELOPES) return;
+
+    mod_matrix_envelope_t* env = &matrix->envelopes[index];
+    bool open = env->stage != MOD_MATRIX_ENV_IDLE && env->stage != MOD_MATRIX_ENV_RELEASE;
+    // атака стартует с текущего уровня, без щелчка в ноль
+    if (retrigger || (level && !open)) {
+        env->stage = MOD_MATRIX_ENV_ATTACK;
+    }
+    if (!level && (open || env->stage == MOD_MATRIX_ENV_ATTACK)) {
+        env->stage = MOD_MATRIX_ENV_RELEASE;
+    }
+}
+
+esp_err_t mod_matrix_set_route(mod_matrix_t* matrix, int slot, const mod_matrix_route_t* route)
+{
+    if (!matrix || !route || slot < 0 || slot >= MOD_MATRIX_MAX_ROUTES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int sources = route->source == MOD_MATRIX_SOURCE_LFO ? MOD_MATRIX_LFOS : MOD_MATRIX_ENVELOPES;
+    if (route->active
+    && (route->source < 0 || route->source >= MOD_MATRIX_SOURCE_COUNT
+    || route->source_index < 0 || route->source_index >= sources
+    || route->dest < 0 || route->dest >= MOD_MATRIX_DEST_COUNT
+    || route->dest_index < 0 || !isfinite(route->depth))) {
+        ESP_LOGE(TAG, "Invalid route in slot %d", slot);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    matrix->routes[slot] = *route;
+    return ESP_OK;
+}
+
+static double mod_matrix_random(mod_matrix_t* matrix)
+{
+    uint32_t x = matrix->random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    matrix->random_state = x;
+    return (double)x / 2147483648.0 - 1.0;
+}
+
+static void mod_matrix_advance_lfo(mod_matrix_t* matrix, mod_matrix_lfo_t* lfo, double dt)
+{
+    double phase = lfo->phase + lfo->rate * dt;
+    if (phase >= 1.0) {
+        phase -= floor(phase);
+        lfo->held = mod_matrix_random(matrix);
+    }
+    lfo->phase = phase;
+
+    switch (lfo->shape) {
+    case MOD_MATRIX_LFO_SINE:
+        lfo->value = sin(2.0 * M_PI * phase);
+        break;
+    case MOD_MATRIX_LFO_TRIANGLE:
+        lfo->value = phase < 0.5 ? 4.0 * phase - 1.0 : 3.0 - 4.0 * phase;
+        break;
+    case MOD_MATRIX_LFO_SAW:
+        lfo->value = 2.0 * phase - 1.0;
+        break;
+    case MOD_MATRIX_LFO_SQUARE:
+        lfo->value = phase < 0.5 ? 1.0 : -1.0;
+        break;
+    case MOD_MATRIX_LFO_RANDOM:
+        lfo->value = lfo->held;
+        break;
+    default:
+        lfo->value = 0.0;
+        break;
+    }
+}
+
+// линейные участки, время участка - полный ход уровня 0..1
+static void mod_matrix_advance_envelope(mod_matrix_envelope_t* env, double dt)
+{
+    double dt_ms = dt * 1000.0;
+    switch (env->stage) {
+    case MOD_MATRIX_ENV_ATTACK:
+        env->value = env->attack_ms > 0.0 ? env->value + dt_ms / env->attack_ms : 1.0;
+        if (env->value >= 1.0) {
+            env->value = 1.0;
+            env->stage = MOD_MATRIX_ENV_DECAY;
+        }
+        break;
+    case MOD_MATRIX_ENV_DECAY:
+        env->value = env->decay_ms > 0.0 ? env->value - dt_ms / env->decay_ms : env->sustain;
+        if (env->value <= env->sustain) {
+            env->value = env->sustain;
+            env->stage = MOD_MATRIX_ENV_SUSTAIN;
+        }
+        break;
+    case MOD_MATRIX_ENV_SUSTAIN:
+        env->value = env->sustain;
+        break;
+    case MOD_MATRIX_ENV_RELEASE:
+        env->value = env->release_ms > 0.0 ? env->value - dt_ms / env->release_ms : 0.0;
+        if (env->value <= 0.0) {
+            env->value = 0.0;
+            env->stage = MOD_MATRIX_ENV_IDLE;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void mod_matrix_advance(mod_matrix_t* matrix, double dt)
+{
+    if (!matrix) return;
+
+    for (int l = 0; l < MOD_MATRIX_LFOS; l++) {
+        mod_matrix_advance_lfo(matrix, &matrix->lfos[l], dt);
+    }
+    for (int e = 0; e < MOD_MATRIX_ENVELOPES; e++) {
+        mod_matrix_advance_envelope(&matrix->envelopes[e], dt);
+    }
+}
+
+bool mod_matrix_sum(const mod_matrix_t* matrix, mod_matrix_dest_t dest, double* out, int count)
+{
+    if (!matrix || !out) return false;
+
+    bool used = false;
+    for (int i = 0; i < count; i++) {
+        out[i] = 0.0;
+    }
+    for (int r = 0; r < MOD_MATRIX_MAX_ROUTES; r++) {
+        const mod_matrix_route_t* route = &matrix->routes[r];
+        if (!route->active || route->dest != dest || route->dest_index >= count) continue;
+
+        double value = route->source == MOD_MATRIX_SOURCE_LFO
+            ? matrix->lfos[route->source_index].value
+            : matrix->envelopes[route->source_index].value;
+        out[route->dest_index] += route->depth * value;
+        used = true;
+    }
+    return used;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+// Мультиплексор на 16 булевых входов: выход равен входу с номером, который
+// набран на шине выбора (бит 0 шины - младший). Шину обычно берут с выходов
+// делителя или счетчика, так источник переключается по кругу.
+// Неподключенные входы и биты выбора читаются как 0.
+
+#define MULTIPLEXER_MAX_INPUTS 16
+#define MULTIPLEXER_SELECT_BITS 4
+
+typedef struct {
+    const bool* inputs[MULTIPLEXER_MAX_INPUTS];
+    int input_ids[MULTIPLEXER_MAX_INPUTS];      // node ids, -1 when not connected
+    const bool* select[MULTIPLEXER_SELECT_BITS];
+    int select_ids[MULTIPLEXER_SELECT_BITS];    // node ids, -1 when not connected
+    bool result;
+} multiplexer_t;
+
+/**
+ * @brief Initialize a multiplexer with nothing connected, output low
+ *
+ * @param mux Pointer to multiplexer_t structure to initialize
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG if mux is NULL
+ */
+esp_err_t multiplexer_init(multiplexer_t* mux);
+
+/**
+ * @brief Connect a data input
+ *
+ * @param mux Pointer to multiplexer_t structure
+ * @param index Input index, 0..MULTIPLEXER_MAX_INPUTS-1
+ * @param input Input value pointer, NULL reads low
+ * @param input_id Node id of the input, -1 with a NULL input
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t multiplexer_set_input(multiplexer_t* mux, int index, const bool* input, int input_id);
+
+/**
+ * @brief Connect a bit of the select bus
+ *
+ * @param mux Pointer to multiplexer_t structure
+ * @param bit Select bit, 0..MULTIPLEXER_SELECT_BITS-1, 0 is the least significant
+ * @param select Select value pointer, NULL reads low
+ * @param select_id Node id of the select bit, -1 with a NULL pointer
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t multiplexer_set_select(multiplexer_t* mux, int bit, const bool* select, int select_id);
+
+/**
+ * @brief Select one sample from the input pointers, without branches on the data
+ *
+ * @param mux Pointer to multiplexer_t structure
+ * @return bool Selected input
+ */
+bool multiplexer_calculate(multiplexer_t* mux);
+
+/**
+ * @brief Select over packed streams
+ *
+ * A tree of MULTIPLEXER_MAX_INPUTS - 1 two-way selects, one per select bit
+ * level, each a mask operation on whole words: a ^ ((a ^ b) & select).
+ *
+ * @param mux Pointer to multiplexer_t structure
+ * @param inputs Input streams, NULL entries read low
+ * @param select Select bus streams, NULL entries read low
+ * @param out Output stream
+ * @param n_words Number of words in each stream
+ */
+void multiplexer_calculate_packed(multiplexer_t* mux, const uint32_t* const inputs[MULTIPLEXER_MAX_INPUTS],
+                                  const uint32_t* const select[MULTIPLEXER_SELECT_BITS],
+                                  uint32_t* out, size_t n_words);
+
+/**
+ * @brief Get pointer to the output value
+ *
+ * @param mux Pointer to multiplexer_t structure
+ * @return bool* Pointer to the output, NULL if mux is NULL
+ */
+bool* multiplexer_get_result_pointer(multiplexer_t* mux);
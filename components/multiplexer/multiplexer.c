@@ -0,0 +1,101 @@
+#include "multiplexer.h"
+#include <esp_log.h>
+
+static const char *TAG = "multiplexer";
+
+esp_err_t multiplexer_init(multiplexer_t* mux)
+{
+    if (!mux) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for (int i = 0; i < MULTIPLEXER_MAX_INPUTS; i++) {
+        multiplexer_set_input(mux, i, NULL, -1);
+    }
+    for (int b = 0; b < MULTIPLEXER_SELECT_BITS; b++) {
+        multiplexer_set_select(mux, b, NULL, -1);
+    }
+    mux->result = false;
+
+    ESP_LOGI(TAG, "Initializing %d input multiplexer", MULTIPLEXER_MAX_INPUTS);
+    return ESP_OK;
+}
+
+esp_err_t multiplexer_set_input(multiplexer_t* mux, int index, const bool* input, int input_id)
+{
+    if (!mux || index < 0 || index >= MULTIPLEXER_MAX_INPUTS) {
+        ESP_LOGE(TAG, "Invalid multiplexer input %d", index);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mux->inputs[index] = input;
+    mux->input_ids[index] = input ? input_id : -1;
+    return ESP_OK;
+}
+
+esp_err_t multiplexer_set_select(multiplexer_t* mux, int bit, const bool* select, int select_id)
+{
+    if (!mux || bit < 0 || bit >= MULTIPLEXER_SELECT_BITS) {
+        ESP_LOGE(TAG, "Invalid multiplexer select bit %d", bit);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mux->select[bit] = select;
+    mux->select_ids[bit] = select ? select_id : -1;
+    return ESP_OK;
+}
+
+// входы собираются в слово и выбираются сдвигом, без ветвлений по данным
+bool multiplexer_calculate(multiplexer_t* mux)
+{
+    if (!mux) return false;
+
+    uint32_t levels = 0;
+    for (int i = 0; i < MULTIPLEXER_MAX_INPUTS; i++) {
+        levels |= (uint32_t)(mux->inputs[i] && *mux->inputs[i]) << i;
+    }
+    uint32_t index = 0;
+    for (int b = 0; b < MULTIPLEXER_SELECT_BITS; b++) {
+        index |= (uint32_t)(mux->select[b] && *mux->select[b]) << b;
+    }
+
+    mux->result = (levels >> index) & 1u;
+    return mux->result;
+}
+
+void multiplexer_calculate_packed(multiplexer_t* mux, const uint32_t* const inputs[MULTIPLEXER_MAX_INPUTS],
+                                  const uint32_t* const select[MULTIPLEXER_SELECT_BITS],
+                                  uint32_t* out, size_t n_words)
+{
+    if (!mux || !inputs || !select || !out || n_words == 0) return;
+
+    for (size_t w = 0; w < n_words; w++) {
+        uint32_t v[MULTIPLEXER_MAX_INPUTS];
+        for (int i = 0; i < MULTIPLEXER_MAX_INPUTS; i++) {
+            v[i] = inputs[i] ? inputs[i][w] : 0;
+        }
+
+        // уровень b дерева выбирает между соседними парами по биту b шины
+        int width = MULTIPLEXER_MAX_INPUTS;
+        for (int b = 0; b < MULTIPLEXER_SELECT_BITS; b++) {
+            uint32_t s = select[b] ? select[b][w] : 0;
+            width /= 2;
+            for (int i = 0; i < width; i++) {
+                uint32_t a = v[2 * i];
+                v[i] = a ^ ((a ^ v[2 * i + 1]) & s);
+            }
+        }
+        out[w] = v[0];
+    }
+
+    mux->result = out[n_words - 1] >> 31;
+}
+
+bool* multiplexer_get_result_pointer(multiplexer_t* mux)
+{
+    if (!mux) {
+        ESP_LOGE(TAG, "Multiplexer is NULL");
+        return NULL;
+    }
+    return &mux->result;
+}
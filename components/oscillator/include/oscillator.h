@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #define WAVETABLE_SIZE 256
 
@@ -27,6 +28,12 @@ typedef struct {
     oscillator_type_t type;
     bool result_bool;
     double result;
+    // Fixed point phase for packed rendering, a full period is 2^32
+    uint32_t phase_acc;
+    uint32_t phase_inc;
+    // Band-limited square/sawtooth/triangle, single precision for the ESP32 FPU
+    float blep_phase;       // 0..1
+    float blep_inc;         // cycles per sample
 } Oscillator;
 
 // Initialize oscillator with given parameters
@@ -41,9 +48,19 @@ double oscillator_calculate_phase_increment(Oscillator* osc);
 // Generate next sample from oscillator using wavetable
 void oscillator_calculate(Oscillator* osc);
 
+// Render n samples, band-limited for square, sawtooth and triangle (PolyBLEP/PolyBLAMP),
+// the table is used for sine; amplitude is applied
+void oscillator_render_block(Oscillator* osc, float* out, size_t n);
+
+// Same as oscillator_render_block, full scale 1.0 maps to INT16_MAX
+void oscillator_render_block_pcm(Oscillator* osc, int16_t* out, size_t n);
+
 // Calculate the boolean value from the oscillator
 void oscillator_calculate_bool(volatile Oscillator* osc);
 
+// Render n_bits samples of the boolean square wave, packed LSB first (32 per word)
+void oscillator_render_bool_packed(Oscillator* osc, uint32_t* words, size_t n_bits);
+
 // Get the result of the oscillator
 bool* oscillator_get_result_bool_pointer(Oscillator* osc);
 
@@ -52,6 +69,9 @@ double* oscillator_get_result_pointer(Oscillator* osc);
 // Update oscillator frequency
 void oscillator_set_frequency(Oscillator* osc, double frequency);
 
+// Change the rate the oscillator is run at, keeps the frequency
+void oscillator_set_sample_rate(Oscillator* osc, double sample_rate);
+
 // Update oscillator amplitude
 void oscillator_set_amplitude(Oscillator* osc, double amplitude);
 
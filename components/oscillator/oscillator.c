@@ -2,8 +2,56 @@
 #include <math.h>
 #include <stdbool.h>
 #include "common_defs.h"
+#include "packed_bits.h"
 
 #define TWO_PI 6.28318530717958647692
+#define PHASE_FULL_TURN 4294967296.0
+#define PHASE_HALF_TURN 0x80000000u
+
+// шаг фазы в формате 0..2^32 на период, не выше половины оборота (частота Найквиста)
+static uint32_t oscillator_calculate_phase_inc_fixed(Oscillator* osc) {
+    if (!osc || osc->frequency <= 0.0 || osc->sample_rate <= 0.0) return 0;
+    double inc = PHASE_FULL_TURN * osc->frequency / osc->sample_rate;
+    if (inc >= (double)PHASE_HALF_TURN) return PHASE_HALF_TURN;
+    return (uint32_t)inc;
+}
+
+// шаг фазы для BLEP осцилляторов в периодах за отсчет, не выше половины (частота Найквиста)
+static float oscillator_calculate_blep_inc(Oscillator* osc) {
+    if (!osc || osc->frequency <= 0.0 || osc->sample_rate <= 0.0) return 0.0f;
+    float inc = (float)(osc->frequency / osc->sample_rate);
+    return inc < 0.5f ? inc : 0.5f;
+}
+
+// Two-sample polynomial residual of a unit step at phase 0, t is the phase and dt the increment
+static inline float poly_blep(float t, float dt) {
+    if (t < dt) {
+        t /= dt;
+        return t + t - t * t - 1.0f;
+    }
+    if (t > 1.0f - dt) {
+        t = (t - 1.0f) / dt;
+        return t * t + t + t + 1.0f;
+    }
+    return 0.0f;
+}
+
+// Integrated poly_blep, residual of a unit change of slope at phase 0
+static inline float poly_blamp(float t, float dt) {
+    if (t < dt) {
+        t = t / dt - 1.0f;
+        return -(1.0f / 3.0f) * t * t * t;
+    }
+    if (t > 1.0f - dt) {
+        t = (t - 1.0f) / dt + 1.0f;
+        return (1.0f / 3.0f) * t * t * t;
+    }
+    return 0.0f;
+}
+
+static inline float wrap_phase(float t) {
+    return t >= 1.0f ? t - 1.0f : t;
+}
 
 double oscillator_calculate_phase_increment(Oscillator* osc) {
     if (!osc || osc->frequency <= 0.0 || osc->sample_rate <= 0.0) return 0.0;
@@ -23,6 +71,10 @@ void oscillator_init(Oscillator* osc, int oscillator_id, double frequency, doubl
     osc->result = 0.0;
     osc->result_bool = false;
     osc->phase_increment = oscillator_calculate_phase_increment(osc);
+    osc->phase_acc = 0;
+    osc->phase_inc = oscillator_calculate_phase_inc_fixed(osc);
+    osc->blep_phase = 0.0f;
+    osc->blep_inc = oscillator_calculate_blep_inc(osc);
     
     // Initialize with sine wave by default
     if (type == OSCILLATOR_TYPE_SINE) {
@@ -85,8 +137,124 @@ void oscillator_calculate_bool(volatile Oscillator* osc) {
     osc->result_bool = sample;
 }
 
+// Square wave straight from the phase accumulator: high for the first half of
+// the period, like generate_square_wavetable_bool. Works run by run instead of
+// sample by sample, each run is filled with one mask operation.
+void oscillator_render_bool_packed(Oscillator* osc, uint32_t* words, size_t n_bits) {
+    if (!osc || !words || n_bits == 0) return;
+
+    uint32_t phase = osc->phase_acc;
+    uint32_t inc = osc->phase_inc;
+    size_t pos = 0;
+
+    for (size_t w = 0; w < PACKED_WORDS(n_bits); w++) {
+        words[w] = 0;
+    }
+
+    while (pos < n_bits) {
+        bool level = phase < PHASE_HALF_TURN;
+        size_t left = n_bits - pos;
+        size_t run = left;
+        if (inc != 0) {
+            // отсчетов до следующего фронта: до середины периода или до переполнения фазы
+            uint32_t to_edge = level ? PHASE_HALF_TURN - phase : (uint32_t)0 - phase;
+            uint32_t samples = to_edge / inc + (to_edge % inc != 0);
+            if (samples < run) run = samples;
+        }
+
+        if (level) {
+            packed_fill(words, pos, pos + run, true);
+        }
+
+        phase += (uint32_t)run * inc;
+        pos += run;
+    }
+
+    osc->phase_acc = phase;
+    osc->result_bool = packed_get_bit(words, n_bits - 1);
+}
+
+// Naive waveform plus a polynomial correction around every discontinuity,
+// removes most of the aliasing of the table versions for two extra branches per sample
+void oscillator_render_block(Oscillator* osc, float* out, size_t n) {
+    if (!osc || !out) return;
+
+    if (osc->type != OSCILLATOR_TYPE_SQUARE &&
+        osc->type != OSCILLATOR_TYPE_SAWTOOTH &&
+        osc->type != OSCILLATOR_TYPE_TRIANGLE) {
+        for (size_t i = 0; i < n; i++) {
+            oscillator_calculate(osc);
+            out[i] = (float)osc->result;
+        }
+        return;
+    }
+
+    float t = osc->blep_phase;
+    const float dt = osc->blep_inc;
+    const float amp = (float)osc->amplitude;
+
+    switch (osc->type) {
+    case OSCILLATOR_TYPE_SAWTOOTH:
+        for (size_t i = 0; i < n; i++) {
+            out[i] = amp * (t + t - 1.0f - poly_blep(t, dt));
+            t = wrap_phase(t + dt);
+        }
+        break;
+    case OSCILLATOR_TYPE_SQUARE:
+        for (size_t i = 0; i < n; i++) {
+            float t2 = wrap_phase(t + 0.5f);
+            float y = t < 0.5f ? 1.0f : -1.0f;
+            out[i] = amp * (y + poly_blep(t, dt) - poly_blep(t2, dt));
+            t = wrap_phase(t + dt);
+        }
+        break;
+    default:  // OSCILLATOR_TYPE_TRIANGLE
+        for (size_t i = 0; i < n; i++) {
+            // фаза как у таблицы (0 -> 1 -> -1 -> 0), изломы в четверти и трех четвертях периода
+            float t1 = wrap_phase(t + 0.25f);
+            float t2 = wrap_phase(t + 0.75f);
+            float y = t1 < 0.5f ? 4.0f * t1 - 1.0f : 3.0f - 4.0f * t1;
+            y += 4.0f * dt * (poly_blamp(t1, dt) - poly_blamp(t2, dt));
+            out[i] = amp * y;
+            t = wrap_phase(t + dt);
+        }
+        break;
+    }
+
+    osc->blep_phase = t;
+    if (n > 0) {
+        osc->result = out[n - 1];
+    }
+}
+
+void oscillator_render_block_pcm(Oscillator* osc, int16_t* out, size_t n) {
+    if (!osc || !out) return;
+
+    float buffer[32];
+    while (n > 0) {
+        size_t chunk = n < 32 ? n : 32;
+        oscillator_render_block(osc, buffer, chunk);
+        for (size_t i = 0; i < chunk; i++) {
+            float v = buffer[i] * 32767.0f;
+            if (v > 32767.0f) v = 32767.0f;
+            if (v < -32768.0f) v = -32768.0f;
+            out[i] = (int16_t)v;
+        }
+        out += chunk;
+        n -= chunk;
+    }
+}
+
 void oscillator_calculate(Oscillator* osc) {
     if (!osc) return;
+
+    if (osc->type == OSCILLATOR_TYPE_SQUARE ||
+        osc->type == OSCILLATOR_TYPE_SAWTOOTH ||
+        osc->type == OSCILLATOR_TYPE_TRIANGLE) {
+        float sample;
+        oscillator_render_block(osc, &sample, 1);
+        return;
+    }
     
     // todo delete this after debugging
     // Ensure table_index is within bounds
@@ -107,6 +275,16 @@ void oscillator_set_frequency(Oscillator* osc, double frequency) {
     if (!osc || frequency <= 0.0) return;
     osc->frequency = frequency;
     osc->phase_increment = oscillator_calculate_phase_increment(osc);
+    osc->phase_inc = oscillator_calculate_phase_inc_fixed(osc);
+    osc->blep_inc = oscillator_calculate_blep_inc(osc);
+}
+
+void oscillator_set_sample_rate(Oscillator* osc, double sample_rate) {
+    if (!osc || sample_rate <= 0.0) return;
+    osc->sample_rate = sample_rate;
+    osc->phase_increment = oscillator_calculate_phase_increment(osc);
+    osc->phase_inc = oscillator_calculate_phase_inc_fixed(osc);
+    osc->blep_inc = oscillator_calculate_blep_inc(osc);
 }
 
 void oscillator_set_amplitude(Oscillator* osc, double amplitude) {
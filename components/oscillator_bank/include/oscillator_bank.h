@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "oscillator.h"
+#include "packed_bits.h"
+
+// Банк осцилляторов в виде структуры массивов: горячие поля (фаза, шаг,
+// амплитуда) лежат подряд, блок считается одним циклом по всем осцилляторам,
+// который компилятор может векторизовать.
+
+#define OSCILLATOR_BANK_MAX 64
+
+// Lanes are processed in groups of this many, unused lanes in the last group are silent
+#define OSCILLATOR_BANK_LANE_GROUP 4
+
+typedef struct {
+    // Hot state, one entry per lane, a full period is 2^32
+    uint32_t phase[OSCILLATOR_BANK_MAX] __attribute__((aligned(16)));
+    uint32_t inc[OSCILLATOR_BANK_MAX] __attribute__((aligned(16)));
+    int32_t amplitude[OSCILLATOR_BANK_MAX] __attribute__((aligned(16)));   // Q15
+    // Shape selection as masks so the block loop has no branches
+    int32_t mask_sine[OSCILLATOR_BANK_MAX] __attribute__((aligned(16)));
+    int32_t mask_square[OSCILLATOR_BANK_MAX] __attribute__((aligned(16)));
+    int32_t mask_saw[OSCILLATOR_BANK_MAX] __attribute__((aligned(16)));
+    int32_t mask_triangle[OSCILLATOR_BANK_MAX] __attribute__((aligned(16)));
+    // Cold settings
+    double frequency[OSCILLATOR_BANK_MAX];
+    oscillator_type_t type[OSCILLATOR_BANK_MAX];
+    int count;              // lanes in use
+    int lanes;              // count rounded up to OSCILLATOR_BANK_LANE_GROUP
+    double sample_rate;
+} oscillator_bank_t;
+
+/**
+ * @brief Initialize an empty oscillator bank
+ *
+ * @param bank Pointer to oscillator_bank_t structure to initialize
+ * @param sample_rate Rate the bank is rendered at
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_bank_init(oscillator_bank_t* bank, double sample_rate);
+
+/**
+ * @brief Add an oscillator to the bank
+ *
+ * @param bank Pointer to oscillator_bank_t structure
+ * @param type Waveform, SQUARE_BOOL lanes render the same as SQUARE
+ * @param frequency Frequency in Hz
+ * @param amplitude Amplitude, 0.0..1.0
+ * @return int Lane index, -1 if the bank is full or parameters are bad
+ */
+int oscillator_bank_add(oscillator_bank_t* bank, oscillator_type_t type, double frequency, double amplitude);
+
+/**
+ * @brief Change the frequency of a lane
+ *
+ * @param bank Pointer to oscillator_bank_t structure
+ * @param index Lane index
+ * @param frequency Frequency in Hz
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_bank_set_frequency(oscillator_bank_t* bank, int index, double frequency);
+
+/**
+ * @brief Change the amplitude of a lane
+ *
+ * @param bank Pointer to oscillator_bank_t structure
+ * @param index Lane index
+ * @param amplitude Amplitude, 0.0..1.0
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_bank_set_amplitude(oscillator_bank_t* bank, int index, double amplitude);
+
+/**
+ * @brief Change the rate the bank is rendered at, frequencies are kept
+ *
+ * @param bank Pointer to oscillator_bank_t structure
+ * @param sample_rate New sample rate
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_bank_set_sample_rate(oscillator_bank_t* bank, double sample_rate);
+
+/**
+ * @brief Render the boolean square of every lane as packed streams
+ *
+ * Lane i is written to words[i * stride], PACKED_WORDS(n_bits) words each.
+ *
+ * @param bank Pointer to oscillator_bank_t structure
+ * @param words Output streams
+ * @param stride Words between the streams of two lanes
+ * @param n_bits Samples per lane
+ */
+void oscillator_bank_render_packed(oscillator_bank_t* bank, uint32_t* words, size_t stride, size_t n_bits);
+
+/**
+ * @brief Render every lane as 16-bit PCM
+ *
+ * Output is interleaved: frame k holds lanes 0..count-1 at out[k * count].
+ * Shapes are the plain (not band-limited) ones, sine is a parabolic approximation.
+ *
+ * @param bank Pointer to oscillator_bank_t structure
+ * @param out Output frames, n * count samples
+ * @param n Number of frames
+ */
+void oscillator_bank_render_pcm(oscillator_bank_t* bank, int16_t* out, size_t n);
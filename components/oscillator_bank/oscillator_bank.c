@@ -0,0 +1,169 @@
+#include "oscillator_bank.h"
+#include <esp_log.h>
+#include <string.h>
+
+// Все циклы по осцилляторам внутренние и без ветвлений: фаза, шаг и маски формы
+// лежат в отдельных выровненных массивах, так что GCC может развернуть их в
+// векторные инструкции там, где они есть. Число дорожек кратно OSCILLATOR_BANK_LANE_GROUP,
+// лишние дорожки стоят с нулевым шагом и нулевой амплитудой.
+
+#define PHASE_FULL_TURN 4294967296.0
+#define PHASE_HALF_TURN 0x80000000u
+#define PHASE_QUARTER_TURN 0x40000000u
+
+// 0.225 в Q15, поправка параболической аппроксимации синуса
+#define SINE_REFINE_Q15 7373
+
+static const char *TAG = "oscillator_bank";
+
+// шаг фазы на отсчет, не выше половины оборота (частота Найквиста)
+static uint32_t oscillator_bank_phase_inc(const oscillator_bank_t* bank, double frequency) {
+    double inc = PHASE_FULL_TURN * frequency / bank->sample_rate;
+    if (inc >= (double)PHASE_HALF_TURN) return PHASE_HALF_TURN;
+    return (uint32_t)inc;
+}
+
+static void oscillator_bank_set_type(oscillator_bank_t* bank, int index, oscillator_type_t type) {
+    bank->type[index] = type;
+    bank->mask_sine[index] = type == OSCILLATOR_TYPE_SINE ? -1 : 0;
+    bank->mask_square[index] = (type == OSCILLATOR_TYPE_SQUARE || type == OSCILLATOR_TYPE_SQUARE_BOOL) ? -1 : 0;
+    bank->mask_saw[index] = type == OSCILLATOR_TYPE_SAWTOOTH ? -1 : 0;
+    bank->mask_triangle[index] = type == OSCILLATOR_TYPE_TRIANGLE ? -1 : 0;
+}
+
+esp_err_t oscillator_bank_init(oscillator_bank_t* bank, double sample_rate) {
+    if (!bank || sample_rate <= 0.0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(bank, 0, sizeof(*bank));
+    bank->sample_rate = sample_rate;
+    return ESP_OK;
+}
+
+int oscillator_bank_add(oscillator_bank_t* bank, oscillator_type_t type, double frequency, double amplitude) {
+    if (!bank || frequency <= 0.0 || amplitude < 0.0 || amplitude > 1.0) {
+        return -1;
+    }
+    if (bank->count >= OSCILLATOR_BANK_MAX) {
+        ESP_LOGE(TAG, "Bank is full (%d oscillators)", OSCILLATOR_BANK_MAX);
+        return -1;
+    }
+
+    int index = bank->count++;
+    bank->lanes = (bank->count + OSCILLATOR_BANK_LANE_GROUP - 1) & ~(OSCILLATOR_BANK_LANE_GROUP - 1);
+    bank->phase[index] = 0;
+    bank->frequency[index] = frequency;
+    bank->inc[index] = oscillator_bank_phase_inc(bank, frequency);
+    bank->amplitude[index] = (int32_t)(amplitude * INT16_MAX);
+    oscillator_bank_set_type(bank, index, type);
+    return index;
+}
+
+esp_err_t oscillator_bank_set_frequency(oscillator_bank_t* bank, int index, double frequency) {
+    if (!bank || index < 0 || index >= bank->count || frequency <= 0.0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bank->frequency[index] = frequency;
+    bank->inc[index] = oscillator_bank_phase_inc(bank, frequency);
+    return ESP_OK;
+}
+
+esp_err_t oscillator_bank_set_amplitude(oscillator_bank_t* bank, int index, double amplitude) {
+    if (!bank || index < 0 || index >= bank->count || amplitude < 0.0 || amplitude > 1.0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bank->amplitude[index] = (int32_t)(amplitude * INT16_MAX);
+    return ESP_OK;
+}
+
+esp_err_t oscillator_bank_set_sample_rate(oscillator_bank_t* bank, double sample_rate) {
+    if (!bank || sample_rate <= 0.0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bank->sample_rate = sample_rate;
+    for (int i = 0; i < bank->count; i++) {
+        bank->inc[i] = oscillator_bank_phase_inc(bank, bank->frequency[i]);
+    }
+    return ESP_OK;
+}
+
+// Square is high for the first half of the period, like oscillator_render_bool_packed.
+// Lanes are the inner loop so every bit position is one pass over contiguous arrays.
+void oscillator_bank_render_packed(oscillator_bank_t* bank, uint32_t* words, size_t stride, size_t n_bits) {
+    if (!bank || !words || n_bits == 0 || bank->count == 0) return;
+
+    uint32_t* restrict phase = bank->phase;
+    const uint32_t* restrict inc = bank->inc;
+    const int lanes = bank->lanes;
+    uint32_t acc[OSCILLATOR_BANK_MAX] __attribute__((aligned(16)));
+
+    for (size_t w = 0; w < PACKED_WORDS(n_bits); w++) {
+        size_t bits = n_bits - w * PACKED_WORD_BITS;
+        if (bits > PACKED_WORD_BITS) bits = PACKED_WORD_BITS;
+
+        for (int i = 0; i < lanes; i++) {
+            acc[i] = 0;
+        }
+        for (size_t b = 0; b < bits; b++) {
+            for (int i = 0; i < lanes; i++) {
+                acc[i] |= (~phase[i] >> 31) << b;
+                phase[i] += inc[i];
+            }
+        }
+
+        for (int i = 0; i < bank->count; i++) {
+            words[(size_t)i * stride + w] = acc[i];
+        }
+    }
+}
+
+// Целочисленные формы прямо из фазы, все четыре считаются для каждой дорожки
+// и выбираются масками: это дешевле ветвления и не мешает векторизации
+void oscillator_bank_render_pcm(oscillator_bank_t* bank, int16_t* out, size_t n) {
+    if (!bank || !out || bank->count == 0) return;
+
+    uint32_t* restrict phase = bank->phase;
+    const uint32_t* restrict inc = bank->inc;
+    const int32_t* restrict amplitude = bank->amplitude;
+    const int32_t* restrict mask_sine = bank->mask_sine;
+    const int32_t* restrict mask_square = bank->mask_square;
+    const int32_t* restrict mask_saw = bank->mask_saw;
+    const int32_t* restrict mask_triangle = bank->mask_triangle;
+    const int lanes = bank->lanes;
+    const int count = bank->count;
+    int32_t frame[OSCILLATOR_BANK_MAX] __attribute__((aligned(16)));
+
+    for (size_t k = 0; k < n; k++) {
+        for (int i = 0; i < lanes; i++) {
+            uint32_t p = phase[i];
+
+            // x = фаза со знаком в Q15 (-1..1), синус через 4x(1-|x|) с одним уточнением
+            int32_t x = (int32_t)p >> 16;
+            int32_t ax = x < 0 ? -x : x;
+            int32_t y = (x * (32768 - ax)) >> 13;
+            int32_t ay = y < 0 ? -y : y;
+            int32_t sine = y + ((((y * ay) >> 15) - y) * SINE_REFINE_Q15 >> 15);
+
+            int32_t square = INT16_MAX ^ ((int32_t)p >> 31);
+            int32_t saw = (int32_t)(p ^ PHASE_HALF_TURN) >> 16;
+
+            // треугольник: модуль пилы, сдвинутой на четверть периода, пик на 0.25
+            int32_t u = (int32_t)((p + PHASE_QUARTER_TURN) ^ PHASE_HALF_TURN) >> 15;
+            int32_t triangle = INT16_MAX - (u < 0 ? -u : u);
+
+            int32_t value = (sine & mask_sine[i]) | (square & mask_square[i]) |
+                            (saw & mask_saw[i]) | (triangle & mask_triangle[i]);
+            frame[i] = (value * amplitude[i]) >> 15;
+            phase[i] = p + inc[i];
+        }
+
+        int16_t* dst = &out[k * count];
+        for (int i = 0; i < count; i++) {
+            dst[i] = (int16_t)frame[i];
+        }
+    }
+}
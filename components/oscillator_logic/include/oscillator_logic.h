@@ -4,6 +4,155 @@
 #include "esp_err.h"
 #include "oscillator.h"
 #include "logical_ops.h"
+#include "dac_mixer.h"
+#include "packed_bits.h"
+#include "edge_engine.h"
+#include "frequency_divider.h"
+#include "lfsr.h"
+#include "flip_flop.h"
+#include "delay_line.h"
+#include "multiplexer.h"
+#include "voice_pool.h"
+#include "sequencer.h"
+#include "mod_matrix.h"
+
+#define OSCILLATOR_LOGIC_OSCILLATOR_COUNT 4
+#define OSCILLATOR_LOGIC_LOGICAL_OP_COUNT 3
+#define OSCILLATOR_LOGIC_DIVIDER_COUNT 1
+#define OSCILLATOR_LOGIC_LFSR_COUNT 2
+#define OSCILLATOR_LOGIC_FLIP_FLOP_COUNT 4
+#define OSCILLATOR_LOGIC_MULTIPLEXER_COUNT 2
+#define OSCILLATOR_LOGIC_VOICE_COUNT 8
+#define OSCILLATOR_LOGIC_SEQUENCER_COUNT 8
+
+// Node ids: 0..3 are oscillators, 4..6 are logical operation results,
+// 7..18 are the divider stages (divide by 2, 4, ... 4096), 19..20 are LFSR noise,
+// 21..24 are flip-flops, 25..28 are the delay line taps, 29..30 are multiplexers,
+// 31 is the voice pool output
+#define OSCILLATOR_LOGIC_FIRST_LOGICAL_OP_NODE OSCILLATOR_LOGIC_OSCILLATOR_COUNT
+#define OSCILLATOR_LOGIC_FIRST_DIVIDER_NODE (OSCILLATOR_LOGIC_FIRST_LOGICAL_OP_NODE + OSCILLATOR_LOGIC_LOGICAL_OP_COUNT)
+#define OSCILLATOR_LOGIC_FIRST_LFSR_NODE (OSCILLATOR_LOGIC_FIRST_DIVIDER_NODE + OSCILLATOR_LOGIC_DIVIDER_COUNT * FREQUENCY_DIVIDER_STAGES)
+#define OSCILLATOR_LOGIC_FIRST_FLIP_FLOP_NODE (OSCILLATOR_LOGIC_FIRST_LFSR_NODE + OSCILLATOR_LOGIC_LFSR_COUNT)
+#define OSCILLATOR_LOGIC_FIRST_DELAY_NODE (OSCILLATOR_LOGIC_FIRST_FLIP_FLOP_NODE + OSCILLATOR_LOGIC_FLIP_FLOP_COUNT)
+#define OSCILLATOR_LOGIC_FIRST_MULTIPLEXER_NODE (OSCILLATOR_LOGIC_FIRST_DELAY_NODE + DELAY_LINE_MAX_TAPS)
+#define OSCILLATOR_LOGIC_VOICE_POOL_NODE (OSCILLATOR_LOGIC_FIRST_MULTIPLEXER_NODE + OSCILLATOR_LOGIC_MULTIPLEXER_COUNT)
+#define OSCILLATOR_LOGIC_NODE_COUNT (OSCILLATOR_LOGIC_VOICE_POOL_NODE + 1)
+
+// Last logical operation, the end of the default patch
+#define OSCILLATOR_LOGIC_FINAL_LOGICAL_OP_NODE (OSCILLATOR_LOGIC_FIRST_DIVIDER_NODE - 1)
+
+// Multi-bit DAC mixer output, can be routed to a pin but is not a boolean node
+#define OSCILLATOR_LOGIC_MIXER_NODE OSCILLATOR_LOGIC_NODE_COUNT
+
+// Pin of the main output, driven by the last logical operation
+#define OSCILLATOR_LOGIC_MAIN_OUTPUT_GPIO 4
+
+// Output samples rendered per block, the timer plays them back one per tick
+#define OSCILLATOR_LOGIC_BLOCK_SIZE 32
+
+// Internal rate is SYSTEM_SAMPLE_RATE times the oversampling factor, 1 turns it off
+#define OSCILLATOR_LOGIC_MIN_OVERSAMPLING 1
+#define OSCILLATOR_LOGIC_MAX_OVERSAMPLING 64
+#define OSCILLATOR_LOGIC_DEFAULT_OVERSAMPLING 8
+
+#define OSCILLATOR_LOGIC_MAX_BLOCK_WORDS PACKED_WORDS(OSCILLATOR_LOGIC_BLOCK_SIZE * OSCILLATOR_LOGIC_MAX_OVERSAMPLING)
+
+// Delay line buffer, 16 KB: about 1.6 s at the default oversampling, 13 s without it
+#define OSCILLATOR_LOGIC_DELAY_WORDS 4096
+
+// Debug taps: nodes whose packed words are kept for streaming, 4 KB ring each
+#define OSCILLATOR_LOGIC_MAX_TAPS 4
+#define OSCILLATOR_LOGIC_TAP_RING_WORDS 1024
+
+// Node statistics are counted over this many blocks, about 100 ms
+#define OSCILLATOR_LOGIC_STATS_WINDOW_BLOCKS 32
+
+// One-shot capture for the scope: enough output samples for a 1024-point
+// spectrum plus the decimator settling, about 8 KB at the top oversampling
+#define OSCILLATOR_LOGIC_CAPTURE_SAMPLES 1040
+#define OSCILLATOR_LOGIC_CAPTURE_WORDS PACKED_WORDS(OSCILLATOR_LOGIC_CAPTURE_SAMPLES * OSCILLATOR_LOGIC_MAX_OVERSAMPLING)
+
+typedef enum {
+    OSCILLATOR_LOGIC_ENGINE_BLOCK,  // packed sample rendering, handles feedback
+    OSCILLATOR_LOGIC_ENGINE_EDGE,   // edge times only, feed-forward patches
+} oscillator_logic_engine_t;
+
+// How a route drives its pin
+typedef enum {
+    OSCILLATOR_LOGIC_OUTPUT_SDM,        // 8-bit value through the hardware sigma-delta channel
+    OSCILLATOR_LOGIC_OUTPUT_BITSTREAM,  // 16-bit value through the software modulator and I2S DMA
+} oscillator_logic_output_mode_t;
+
+typedef struct {
+    int gpio_num;
+    int node_id;
+    oscillator_logic_output_mode_t mode;
+} oscillator_logic_output_route_t;
+
+// Counters of one node over the last finished statistics window
+typedef struct {
+    uint32_t ones;              // high samples
+    uint32_t edges;             // level changes, rising and falling
+    uint32_t samples;           // window length in engine samples
+} oscillator_logic_node_stats_t;
+
+typedef enum {
+    OSCILLATOR_LOGIC_FM_LINEAR,         // increment times 1 +/- depth, depth 0..1
+    OSCILLATOR_LOGIC_FM_EXPONENTIAL,    // increment times 2^(+/- depth), depth in octaves
+} oscillator_logic_fm_mode_t;
+
+#define OSCILLATOR_LOGIC_MAX_FM_OCTAVES 4.0
+
+// One mixer input: node id or -1 when not connected, weight and delay in engine samples
+typedef struct {
+    int node_id;
+    int16_t weight;
+    int delay;
+} oscillator_logic_mixer_input_t;
+
+// Settings of one flip-flop, node ids or -1 for an input or clock that is not connected
+typedef struct {
+    flip_flop_type_t type;
+    flip_flop_edge_t edge;
+    int input_ids[FLIP_FLOP_INPUTS];
+    int clock_id;
+} oscillator_logic_flip_flop_config_t;
+
+// Connections of one multiplexer, node ids or -1 for an input or select bit that is not connected
+typedef struct {
+    int input_ids[MULTIPLEXER_MAX_INPUTS];
+    int select_ids[MULTIPLEXER_SELECT_BITS];
+} oscillator_logic_multiplexer_config_t;
+
+typedef enum {
+    OSCILLATOR_LOGIC_SWEEP_LINEAR,      // same number of Hz every sample
+    OSCILLATOR_LOGIC_SWEEP_EXPONENTIAL, // same ratio every sample, constant speed in octaves
+} oscillator_logic_sweep_shape_t;
+
+// 10 minutes, well inside 32-bit sample counts at the highest oversampling
+#define OSCILLATOR_LOGIC_MAX_SWEEP_MS 600000.0
+
+typedef struct {
+    double start_frequency;             // Hz
+    double end_frequency;               // Hz, the oscillator stays here afterwards
+    double duration_ms;
+    oscillator_logic_sweep_shape_t shape;
+} oscillator_logic_sweep_t;
+
+typedef struct {
+    bool active;
+    double frequency;                   // Hz reached so far
+    double end_frequency;
+    double remaining_ms;
+} oscillator_logic_sweep_status_t;
+
+// Modulation inputs of one oscillator, sources are boolean node ids or -1 for none
+typedef struct {
+    int fm_source;                      // node that switches the increment up (high) or down (low)
+    oscillator_logic_fm_mode_t fm_mode;
+    double fm_depth;
+    int sync_source;                    // node whose rising edges reset the phase
+} oscillator_logic_modulation_t;
 
 
 /**
@@ -14,7 +163,7 @@
 esp_err_t oscillator_logic_init(void);
 
 /**
- * @brief Enable or disable the logical operation
+ * @brief Pause or resume the engine, outputs hold their last value while paused
  * 
  * @param enabled true to enable, false to disable
  * @return esp_err_t ESP_OK on success, otherwise an error code
@@ -44,6 +193,672 @@ Oscillator* oscillator_logic_get_oscillators(void);
 logical_ops_t* oscillator_logic_get_logical_ops(void);
 
 /**
- * @brief Process the next boolean values from all oscillators and apply logical operations
+ * @brief Set the operation and inputs of a logical operation
+ *
+ * Operations 0 and 1 read any operation at the previous sample, the last one
+ * reads the earlier operations at the current sample and itself at the
+ * previous one. The change is applied before the next block.
+ *
+ * @param index Operation index, 0..OSCILLATOR_LOGIC_LOGICAL_OP_COUNT-1
+ * @param operation Logical operation
+ * @param input1_id Node id of the first input
+ * @param input2_id Node id of the second input
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_logic_set_logical_op(int index, logical_op_t operation, int input1_id, int input2_id);
+
+/**
+ * @brief Get the DAC mixer that sums boolean nodes into a PCM signal
+ *
+ * @return dac_mixer_t* Pointer to the mixer
+ */
+dac_mixer_t* oscillator_logic_get_mixer(void);
+
+/**
+ * @brief Get the settings of a mixer input, including a change not applied yet
+ *
+ * @param index Input index, 0..DAC_MIXER_MAX_INPUTS-1
+ * @param input Filled with the settings
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_logic_get_mixer_input(int index, oscillator_logic_mixer_input_t* input);
+
+/**
+ * @brief Set the node, weight and delay of a mixer input
+ *
+ * Everything is checked before anything changes. The input is applied and
+ * the pattern table rebuilt by the render task before the next block.
+ *
+ * @param index Input index, 0..DAC_MIXER_MAX_INPUTS-1
+ * @param input New settings, delay 0..DAC_MIXER_MAX_DELAY
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_logic_set_mixer_input(int index, const oscillator_logic_mixer_input_t* input);
+
+/**
+ * @brief Get the frequency dividers
+ *
+ * Divider d drives nodes OSCILLATOR_LOGIC_FIRST_DIVIDER_NODE + d * FREQUENCY_DIVIDER_STAGES
+ * and up, one per stage. The clock is any boolean node.
+ *
+ * @return frequency_divider_t* Pointer to the dividers array
+ */
+frequency_divider_t* oscillator_logic_get_dividers(void);
+
+/**
+ * @brief Set the clock node of a divider, applied before the next block
+ *
+ * @param index Divider index, 0..OSCILLATOR_LOGIC_DIVIDER_COUNT-1
+ * @param clock_node Node id of the clock, -1 stops the divider
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_logic_set_divider_clock(int index, int clock_node);
+
+/**
+ * @brief Clear the count of a divider before the next block
+ *
+ * @param index Divider index, 0..OSCILLATOR_LOGIC_DIVIDER_COUNT-1
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on a bad index
+ */
+esp_err_t oscillator_logic_reset_divider(int index);
+
+/**
+ * @brief Get the LFSR noise sources
+ *
+ * LFSR i drives node OSCILLATOR_LOGIC_FIRST_LFSR_NODE + i. It shifts every
+ * sample at the oversampled rate, or on rising edges of a clock node.
+ *
+ * @return lfsr_t* Pointer to the LFSR array
+ */
+lfsr_t* oscillator_logic_get_lfsrs(void);
+
+/**
+ * @brief Set the register length and feedback taps of an LFSR
+ *
+ * The register is reseeded when the change is applied before the next block.
+ *
+ * @param index LFSR index, 0..OSCILLATOR_LOGIC_LFSR_COUNT-1
+ * @param length Register length, LFSR_MIN_LENGTH..LFSR_MAX_LENGTH, 0 keeps the last set length
+ * @param taps Tap mask below bit length with bit 0 set, 0 picks lfsr_default_taps
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters,
+ *                   ESP_ERR_NOT_FOUND if taps is 0 and there is no default for length
+ */
+esp_err_t oscillator_logic_set_lfsr_length(int index, int length, uint64_t taps);
+
+/**
+ * @brief Set the clock node of an LFSR, applied before the next block
+ *
+ * @param index LFSR index, 0..OSCILLATOR_LOGIC_LFSR_COUNT-1
+ * @param clock_node Node id of the clock, -1 shifts every sample
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_logic_set_lfsr_clock(int index, int clock_node);
+
+/**
+ * @brief Load an LFSR register, applied before the next block
+ *
+ * @param index LFSR index, 0..OSCILLATOR_LOGIC_LFSR_COUNT-1
+ * @param seed Initial register value, see lfsr_seed
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on a bad index
+ */
+esp_err_t oscillator_logic_seed_lfsr(int index, uint64_t seed);
+
+/**
+ * @brief Get the flip-flops
+ *
+ * Flip-flop i drives node OSCILLATOR_LOGIC_FIRST_FLIP_FLOP_NODE + i. Inputs
+ * and clock are any boolean nodes, a flip-flop fed by its own output or a
+ * later node runs per sample.
+ *
+ * @return flip_flop_t* Pointer to the flip-flop array
+ */
+flip_flop_t* oscillator_logic_get_flip_flops(void);
+
+/**
+ * @brief Get the settings of a flip-flop, including a change not applied yet
+ *
+ * @param index Flip-flop index, 0..OSCILLATOR_LOGIC_FLIP_FLOP_COUNT-1
+ * @param config Filled with the settings
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_logic_get_flip_flop_config(int index, oscillator_logic_flip_flop_config_t* config);
+
+/**
+ * @brief Set type, inputs and clock of a flip-flop together
+ *
+ * The settings are applied as a whole before the next block. The clock edge
+ * detector is only reset when the clock node changes.
+ *
+ * @param index Flip-flop index, 0..OSCILLATOR_LOGIC_FLIP_FLOP_COUNT-1
+ * @param config New settings
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_logic_set_flip_flop(int index, const oscillator_logic_flip_flop_config_t* config);
+
+/**
+ * @brief Get the delay line
+ *
+ * Tap t drives node OSCILLATOR_LOGIC_FIRST_DELAY_NODE + t. The input is any
+ * boolean node set with oscillator_logic_set_delay_input, tap delays are set
+ * in milliseconds with oscillator_logic_set_delay_tap.
+ *
+ * @return delay_line_t* Pointer to the delay line
+ */
+delay_line_t* oscillator_logic_get_delay_line(void);
+
+/**
+ * @brief Set the delay of a delay line tap
+ *
+ * The delay is resolved to engine samples, so with oversampling it has a
+ * finer step than one output sample, and follows later oversampling changes.
+ * It is applied before the next block.
+ *
+ * @param tap Tap index, 0..DELAY_LINE_MAX_TAPS-1
+ * @param delay_ms Delay in milliseconds, above 0 and up to oscillator_logic_get_max_delay_ms()
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_logic_set_delay_tap(int tap, double delay_ms);
+
+/**
+ * @brief Set the input node of the delay line, applied before the next block
+ *
+ * @param node_id Input node, -1 disconnects the input
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG for a bad node
+ */
+esp_err_t oscillator_logic_set_delay_input(int node_id);
+
+/**
+ * @brief Get the input node of the delay line, including a change not applied yet
+ *
+ * @return int Input node, -1 when not connected
+ */
+int oscillator_logic_get_delay_input(void);
+
+/**
+ * @brief Clear the delay buffer before the next block
+ */
+void oscillator_logic_clear_delay_line(void);
+
+/**
+ * @brief Get the delay of a delay line tap
+ *
+ * @param tap Tap index, 0..DELAY_LINE_MAX_TAPS-1
+ * @return double Delay in milliseconds, -1 for a bad tap
+ */
+double oscillator_logic_get_delay_tap(int tap);
+
+/**
+ * @brief Get the longest tap delay at the current oversampling factor
+ *
+ * @return double Maximum delay in milliseconds
+ */
+double oscillator_logic_get_max_delay_ms(void);
+
+/**
+ * @brief Get the multiplexers
+ *
+ * Multiplexer i drives node OSCILLATOR_LOGIC_FIRST_MULTIPLEXER_NODE + i.
+ * Data inputs and select bits are any boolean nodes, typically divider stages.
+ *
+ * @return multiplexer_t* Pointer to the multiplexer array
+ */
+multiplexer_t* oscillator_logic_get_multiplexers(void);
+
+/**
+ * @brief Get the connections of a multiplexer, including a change not applied yet
+ *
+ * @param index Multiplexer index, 0..OSCILLATOR_LOGIC_MULTIPLEXER_COUNT-1
+ * @param config Filled with the connections
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_logic_get_multiplexer_config(int index, oscillator_logic_multiplexer_config_t* config);
+
+/**
+ * @brief Connect the data inputs and the select bus of a multiplexer
+ *
+ * All connections change together before the next block, so no block reads
+ * a select bus that is half old and half new.
+ *
+ * @param index Multiplexer index, 0..OSCILLATOR_LOGIC_MULTIPLEXER_COUNT-1
+ * @param config New connections
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_logic_set_multiplexer(int index, const oscillator_logic_multiplexer_config_t* config);
+
+/**
+ * @brief Get the voice pool
+ *
+ * The pool drives node OSCILLATOR_LOGIC_VOICE_POOL_NODE: every voice plays a
+ * copy of oscillators 0..3 and logical operations 0..2 transposed to its
+ * note, and the voices are joined into one boolean stream.
+ *
+ * @return voice_pool_t* Pointer to the voice pool
+ */
+voice_pool_t* oscillator_logic_get_voice_pool(void);
+
+/**
+ * @brief Start a note on the voice pool
+ *
+ * The note is queued and started by the render task at the start of the
+ * next block. The pool takes the current patch first: oscillator
+ * frequencies become ratios to oscillator 0, which is tuned to the note,
+ * and the logical operations keep their inputs. An input from a divider or
+ * later node, or a feedback input, reads low in the voices.
+ *
+ * @param note MIDI note, 0..127
+ * @return esp_err_t ESP_OK when queued, ESP_ERR_INVALID_ARG on a bad note,
+ *         ESP_ERR_NO_MEM if the note queue is full
+ */
+esp_err_t oscillator_logic_note_on(int note);
+
+/**
+ * @brief Stop a note on the voice pool
+ *
+ * Queued like oscillator_logic_note_on, a note that is not sounding then
+ * is ignored.
+ *
+ * @param note MIDI note, 0..127
+ * @return esp_err_t ESP_OK when queued, ESP_ERR_INVALID_ARG on a bad note,
+ *         ESP_ERR_NO_MEM if the note queue is full
+ */
+esp_err_t oscillator_logic_note_off(int note);
+
+/**
+ * @brief Stop every note on the voice pool, queued like oscillator_logic_note_on
+ *
+ * @return esp_err_t ESP_OK when queued, ESP_ERR_NO_MEM if the note queue is full
+ */
+esp_err_t oscillator_logic_all_notes_off(void);
+
+/**
+ * @brief Get the step sequencers, for reporting
+ *
+ * Steps run on the engine clock. A step that falls inside a block splits
+ * the block, so its change takes effect at the start of its 32-sample
+ * engine word (rounded down to a whole output sample), independent of
+ * when the request arrived over the network.
+ *
+ * @return const sequencer_t* Pointer to the sequencer array
+ */
+const sequencer_t* oscillator_logic_get_sequencers(void);
+
+/**
+ * @brief Check a pattern and its target index without applying it
+ *
+ * Every step value must be finite and fit its target: a frequency up to half
+ * the highest engine rate (0 or less keeps the frequency), a logical_op_t,
+ * a MIDI note 0..127 or an int16 mixer weight.
+ *
+ * @param pattern Pattern to check
+ * @return esp_err_t ESP_OK if valid, ESP_ERR_INVALID_ARG otherwise
+ */
+esp_err_t oscillator_logic_validate_sequencer_pattern(const sequencer_pattern_t* pattern);
+
+/**
+ * @brief Replace the pattern of a sequencer before the next block
+ *
+ * A running sequencer keeps its time position. Targets: frequency of
+ * oscillator target_index, operation of logical operation target_index,
+ * notes on the voice pool, weight of mixer input target_index.
+ *
+ * @param index Sequencer index, 0..OSCILLATOR_LOGIC_SEQUENCER_COUNT-1
+ * @param pattern Pattern to play
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_logic_set_sequencer_pattern(int index, const sequencer_pattern_t* pattern);
+
+/**
+ * @brief Set the tempo shared by all sequencers
+ *
+ * @param bpm Beats per minute, SEQUENCER_MIN_BPM..SEQUENCER_MAX_BPM
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_logic_set_tempo(double bpm);
+
+/**
+ * @brief Get the tempo shared by all sequencers
+ *
+ * @return double Beats per minute
+ */
+double oscillator_logic_get_tempo(void);
+
+/**
+ * @brief Start all sequencers from step 0 or stop them
+ *
+ * Starting takes the voice pool patch like oscillator_logic_note_on, stopping
+ * releases the notes the sequencers hold.
+ *
+ * @param running true to start, false to stop
+ */
+void oscillator_logic_set_sequencers_running(bool running);
+
+/**
+ * @brief Check whether the sequencers run
+ *
+ * @return bool true if started
+ */
+bool oscillator_logic_get_sequencers_running(void);
+
+/**
+ * @brief Copy the modulation matrix
+ *
+ * LFO and envelope values are the ones of the last block. Settings, routes
+ * and gates are the last ones set, even if the next block has not applied
+ * them yet.
+ *
+ * @param matrix Receives the matrix
+ */
+void oscillator_logic_get_mod_matrix(mod_matrix_t* matrix);
+
+/**
+ * @brief Set the shape and rate of an LFO
+ *
+ * Applied at the start of the next block, the phase carries on.
+ *
+ * @param index LFO index
+ * @param shape LFO shape
+ * @param rate Rate in Hz, >= 0
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_logic_set_mod_lfo(int index, mod_matrix_lfo_shape_t shape, double rate);
+
+/**
+ * @brief Set the times and sustain level of an envelope
+ *
+ * Applied at the start of the next block, the running stage carries on.
+ *
+ * @param envelope Envelope index
+ * @param attack_ms Attack time, ms
+ * @param decay_ms Decay time, ms
+ * @param sustain Sustain level, 0..1
+ * @param release_ms Release time, ms
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_logic_set_mod_envelope(int envelope, double attack_ms, double decay_ms, double sustain, double release_ms);
+
+/**
+ * @brief Set a modulation matrix route
+ *
+ * The matrix is evaluated once per block and every destination moves linearly
+ * across the block. Frequency routes take the depth in octaves, at most
+ * OSCILLATOR_LOGIC_MAX_FM_OCTAVES, and turn the oscillator into a modulated
+ * one (the edge engine hands such patches to the block engine). Mixer weight
+ * routes take the depth as a share of the set weight, -1..1. The route is
+ * checked here and applied at the start of the next block.
+ *
+ * @param slot Route slot, 0..MOD_MATRIX_MAX_ROUTES-1
+ * @param route Route, active false frees the slot
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_logic_set_mod_route(int slot, const mod_matrix_route_t* route);
+
+/**
+ * @brief Gate an envelope from a boolean node
+ *
+ * A rising edge of the node starts the attack, the falling edge the release.
+ * The gate is read once per block, one block behind the node. Applied at the
+ * start of the next block.
+ *
+ * @param envelope Envelope index
+ * @param node_id Node id, -1 for none
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t oscillator_logic_set_mod_envelope_gate(int envelope, int node_id);
+
+/**
+ * @brief Advance the engine by one output sample
+ *
+ * Called by the timer at SYSTEM_SAMPLE_RATE. Every OSCILLATOR_LOGIC_BLOCK_SIZE
+ * calls a new block is rendered, the calls in between only hand out samples.
  */
 void oscillator_logic_next_bool(void);
+
+/**
+ * @brief Render the next block of OSCILLATOR_LOGIC_BLOCK_SIZE output samples
+ *
+ * Oscillators, logical operations, dividers, LFSRs, flip-flops, the delay
+ * line, multiplexers and the voice pool run at the oversampled rate on packed 32-sample
+ * words, each one after the nodes it reads. When the graph has a loop (a prev_result input, a divider or LFSR
+ * clocked by itself, a flip-flop fed back to its own input, an oscillator
+ * modulated by its own output) the unit falls back to per-sample evaluation
+ * in node id order for the block, where a node reads the previous sample of
+ * any node with a higher id.
+ * Each routed node is then decimated to the output rate.
+ * Normally driven by oscillator_logic_next_bool(), exposed for benchmarking
+ * while the engine is paused.
+ */
+void oscillator_logic_render_block(void);
+
+/**
+ * @brief Set the internal oversampling factor
+ *
+ * Applied at the start of the next block.
+ *
+ * @param factor OSCILLATOR_LOGIC_MIN_OVERSAMPLING..OSCILLATOR_LOGIC_MAX_OVERSAMPLING
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG for a bad factor
+ */
+esp_err_t oscillator_logic_set_oversampling(int factor);
+
+/**
+ * @brief Select the engine that renders blocks
+ *
+ * The edge engine schedules the next edge of every oscillator and updates
+ * the logical operations only when an input changes, so its cost follows the
+ * number of edges instead of the sample rate. Edges are rasterized at the
+ * oversampled rate. A patch with feedback is rendered by the block engine
+ * until the feedback is removed.
+ *
+ * @param engine Engine to use from the next block
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG for an unknown engine
+ */
+esp_err_t oscillator_logic_set_engine(oscillator_logic_engine_t engine);
+
+/**
+ * @brief Get the selected engine
+ *
+ * @return oscillator_logic_engine_t Selected engine
+ */
+oscillator_logic_engine_t oscillator_logic_get_engine(void);
+
+/**
+ * @brief Get the engine that rendered the last block
+ *
+ * @return oscillator_logic_engine_t Engine in use
+ */
+oscillator_logic_engine_t oscillator_logic_get_active_engine(void);
+
+/**
+ * @brief Select the nodes copied into the tap rings
+ *
+ * After every block the packed words of each tapped node are appended to its
+ * ring at the engine rate (SYSTEM_SAMPLE_RATE times the oversampling). A full
+ * ring drops whole blocks until it is read. The nodes change at the start of
+ * the next block; a tap whose node changes starts over with an empty ring
+ * and a zero drop count.
+ *
+ * @param node_ids Node ids, -1 leaves a tap off
+ * @param count Number of ids, 0..OSCILLATOR_LOGIC_MAX_TAPS; the taps after them are turned off
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG for a bad count or node id
+ */
+esp_err_t oscillator_logic_set_taps(const int* node_ids, int count);
+
+/**
+ * @brief Get the node of a tap
+ *
+ * @param tap Tap index
+ * @return int Node id as last set, -1 if the tap is off or the index is bad
+ */
+int oscillator_logic_get_tap_node(int tap);
+
+/**
+ * @brief Take the words waiting in a tap ring
+ *
+ * Meant for a single reader, the stream sender. Words the previous node left
+ * in the ring are skipped after a node change.
+ *
+ * @param tap Tap index
+ * @param words Buffer to fill, bit 0 of the first word is the oldest sample
+ * @param max_words Capacity of the buffer
+ * @param node_id Receives the node the words belong to, -1 if the tap is off; may be NULL
+ * @return size_t Number of words copied
+ */
+size_t oscillator_logic_read_tap(int tap, uint32_t* words, size_t max_words, int* node_id);
+
+/**
+ * @brief Get the number of words a tap lost to a full ring
+ *
+ * @param tap Tap index
+ * @return uint32_t Dropped words since the tap got its node, 0 for a bad index
+ */
+uint32_t oscillator_logic_get_tap_dropped(int tap);
+
+/**
+ * @brief Get the duty and transition counters of every node
+ *
+ * The engine counts ones and level changes of each node with popcount on the
+ * packed words after every block and publishes the sums once per
+ * OSCILLATOR_LOGIC_STATS_WINDOW_BLOCKS blocks. A node with no ones, or with
+ * only ones, is stuck for the whole window.
+ *
+ * @param stats Array to fill, indexed by node id
+ * @param max_nodes Capacity of the array
+ * @return int Number of nodes copied, 0 before the first window is done
+ */
+int oscillator_logic_get_node_stats(oscillator_logic_node_stats_t* stats, int max_nodes);
+
+/**
+ * @brief Start a one-shot capture of a node
+ *
+ * The render task copies the packed words of the node from the next blocks
+ * until OSCILLATOR_LOGIC_CAPTURE_SAMPLES output samples are collected. A new
+ * request drops a capture that is still running.
+ *
+ * @param node_id Boolean node, 0..OSCILLATOR_LOGIC_NODE_COUNT-1
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG for a bad node
+ */
+esp_err_t oscillator_logic_request_capture(int node_id);
+
+/**
+ * @brief Get a finished capture
+ *
+ * The words stay in the engine's buffer and are read in place; they are
+ * valid until the next oscillator_logic_request_capture.
+ *
+ * @param bits Where the number of engine samples is stored, may be NULL
+ * @param factor Where the oversampling factor of the capture is stored, may be NULL
+ * @return const uint32_t* Packed words, NULL while the capture is still running
+ */
+const uint32_t* oscillator_logic_get_capture(size_t* bits, int* factor);
+
+/**
+ * @brief Get the internal oversampling factor
+ *
+ * @return int Oversampling factor
+ */
+int oscillator_logic_get_oversampling(void);
+
+/**
+ * @brief Set the FM and hard sync inputs of an oscillator
+ *
+ * Modulation is applied per oversampled sample from the packed source
+ * streams; a source that depends on the oscillator itself makes a loop and
+ * the block engine evaluates the whole unit per sample, like feedback does.
+ * The edge engine is not used while any oscillator is modulated or sweeping.
+ * The settings are applied as a whole at the start of the next block.
+ *
+ * @param oscillator_id Oscillator, 0..OSCILLATOR_LOGIC_OSCILLATOR_COUNT-1
+ * @param modulation New settings
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG for a bad oscillator, source or depth
+ */
+esp_err_t oscillator_logic_set_modulation(int oscillator_id, const oscillator_logic_modulation_t* modulation);
+
+/**
+ * @brief Get the FM and hard sync inputs of an oscillator
+ *
+ * @param oscillator_id Oscillator, 0..OSCILLATOR_LOGIC_OSCILLATOR_COUNT-1
+ * @param modulation Settings are copied here
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG for a bad oscillator
+ */
+esp_err_t oscillator_logic_get_modulation(int oscillator_id, oscillator_logic_modulation_t* modulation);
+
+/**
+ * @brief Sweep the frequency of an oscillator from one value to another
+ *
+ * The sweep starts with the next block and moves the phase increment every
+ * oversampled sample, so it needs no further calls. At the end the oscillator
+ * frequency is set to end_frequency. Starting a new sweep replaces a running one.
+ * Sweeping oscillators are rendered like modulated ones.
+ *
+ * @param oscillator_id Oscillator, 0..OSCILLATOR_LOGIC_OSCILLATOR_COUNT-1
+ * @param sweep Frequencies up to half the highest engine rate, duration up to
+ *              OSCILLATOR_LOGIC_MAX_SWEEP_MS and shape
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG for bad settings
+ */
+esp_err_t oscillator_logic_start_sweep(int oscillator_id, const oscillator_logic_sweep_t* sweep);
+
+/**
+ * @brief Stop a running sweep, the oscillator keeps the frequency it reached
+ *
+ * @param oscillator_id Oscillator, 0..OSCILLATOR_LOGIC_OSCILLATOR_COUNT-1
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG for a bad oscillator
+ */
+esp_err_t oscillator_logic_stop_sweep(int oscillator_id);
+
+/**
+ * @brief Get the progress of the sweep of an oscillator
+ *
+ * @param oscillator_id Oscillator, 0..OSCILLATOR_LOGIC_OSCILLATOR_COUNT-1
+ * @param status Filled with the current state
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG for a bad oscillator
+ */
+esp_err_t oscillator_logic_get_sweep_status(int oscillator_id, oscillator_logic_sweep_status_t* status);
+
+/**
+ * @brief Get the boolean result of any node in the unit
+ *
+ * @param node_id Node id, 0..OSCILLATOR_LOGIC_NODE_COUNT-1
+ * @return bool* Pointer to the node result, NULL if node_id is out of range
+ */
+bool* oscillator_logic_get_node_result_pointer(int node_id);
+
+/**
+ * @brief Route a node to an output pin
+ *
+ * Creates a new output instance on the pin, or switches the source of the
+ * existing one, so separate nodes can drive separate analog channels.
+ * Every route is decimated from the engine rate to an 8-bit PCM value,
+ * OSCILLATOR_LOGIC_MIXER_NODE sends the mixer output to the pin.
+ *
+ * @param gpio_num GPIO pin number
+ * @param node_id Node id to send to the pin
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG for a bad node,
+ *         ESP_ERR_NO_MEM if all output slots are in use
+ */
+esp_err_t oscillator_logic_set_output_route(int gpio_num, int node_id);
+
+/**
+ * @brief Route a node to an output pin with a given output mode
+ *
+ * Same as oscillator_logic_set_output_route, but a new pin is created in
+ * the given mode. OSCILLATOR_LOGIC_OUTPUT_BITSTREAM keeps the full 16-bit
+ * decimated value and noise shapes it in software (order
+ * OUTPUT_BITSTREAM_DEFAULT_ORDER). The mode of a pin that is already in use
+ * can not change, only its source.
+ *
+ * @param gpio_num GPIO pin number
+ * @param node_id Node id to send to the pin
+ * @param mode Output mode
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG for a bad node or mode,
+ *         ESP_ERR_INVALID_STATE if the pin runs in another mode,
+ *         ESP_ERR_NO_MEM if all output slots are in use
+ */
+esp_err_t oscillator_logic_set_output_route_mode(int gpio_num, int node_id, oscillator_logic_output_mode_t mode);
+
+/**
+ * @brief Get the current output routes
+ *
+ * @param routes Array to fill, at least OUTPUT_MAX_INSTANCES entries
+ * @param max_routes Capacity of the array
+ * @return int Number of routes written
+ */
+int oscillator_logic_get_output_routes(oscillator_logic_output_route_t* routes, int max_routes);
@@ -2,47 +2,2450 @@
 #include "oscillator_logic.h"
 #include "oscillator.h"
 #include "logical_ops.h"
+#include "dac_mixer.h"
+#include "decimator.h"
+#include "edge_engine.h"
+#include "frequency_divider.h"
+#include "lfsr.h"
+#include "flip_flop.h"
+#include "delay_line.h"
+#include "multiplexer.h"
+#include "mod_matrix.h"
+#include "packed_bits.h"
 #include "output.h"
 #include "timer.h"
+#include "common_defs.h"
+#include <string.h>
+#include <math.h>
 #include <esp_log.h>
 
 static const char *TAG = "oscillator_logic";
 
+#define PHASE_HALF_TURN 0x80000000u
+#define PHASE_FULL_TURN 4294967296.0
+
+// Движок считает блоками по OSCILLATOR_LOGIC_BLOCK_SIZE выходных отсчетов.
+// Внутри блока осцилляторы и логика работают на частоте в oversampling раз выше,
+// каждый узел - упакованный поток бит, логика считается по 32 отсчета за раз.
+// Маршруты на выходы прореживаются дециматором обратно до SYSTEM_SAMPLE_RATE,
+// так фронты не квантуются на сетку 100 мкс и не дают алиасинга.
+// Второй вариант движка - событийный: считаются только моменты фронтов,
+// потом они растеризуются в те же упакованные потоки.
+
 // Initialize oscillators
-static Oscillator oscillators[4];
+static Oscillator oscillators[OSCILLATOR_LOGIC_OSCILLATOR_COUNT];
+
+// Initialize logical operators
+static logical_ops_t logical_ops[OSCILLATOR_LOGIC_LOGICAL_OP_COUNT];
+// новые операция и входы из API ждут начала следующего блока
+typedef struct {
+    logical_op_t operation;
+    int input_ids[2];
+} logic_request_t;
+
+static logic_request_t logic_requests[OSCILLATOR_LOGIC_LOGICAL_OP_COUNT];
+static volatile bool logic_request_pending[OSCILLATOR_LOGIC_LOGICAL_OP_COUNT];
+
+// делители частоты, тактируются любым булевым узлом
+static frequency_divider_t dividers[OSCILLATOR_LOGIC_DIVIDER_COUNT];
+// смена такта и сброс счетчика из API ждут начала следующего блока
+static int divider_clock_requests[OSCILLATOR_LOGIC_DIVIDER_COUNT];
+static volatile bool divider_clock_pending[OSCILLATOR_LOGIC_DIVIDER_COUNT];
+static volatile bool divider_reset_pending[OSCILLATOR_LOGIC_DIVIDER_COUNT];
+
+// генераторы шума, по умолчанию сдвигаются каждый отсчет
+static lfsr_t lfsrs[OSCILLATOR_LOGIC_LFSR_COUNT];
+// Настройки из API: lfsr_requests хранит последние заданные значения,
+// флаги отмечают то, что ждет начала следующего блока
+typedef struct {
+    int length;
+    uint64_t taps;
+    int clock_id;
+    uint64_t seed;
+} lfsr_request_t;
+
+static lfsr_request_t lfsr_requests[OSCILLATOR_LOGIC_LFSR_COUNT];
+static volatile bool lfsr_length_pending[OSCILLATOR_LOGIC_LFSR_COUNT];
+static volatile bool lfsr_clock_pending[OSCILLATOR_LOGIC_LFSR_COUNT];
+static volatile bool lfsr_seed_pending[OSCILLATOR_LOGIC_LFSR_COUNT];
+
+// триггеры и выборка-хранение, тактируются любым булевым узлом
+static flip_flop_t flip_flops[OSCILLATOR_LOGIC_FLIP_FLOP_COUNT];
+// новая настройка из API целиком ждет начала следующего блока
+static oscillator_logic_flip_flop_config_t flip_flop_requests[OSCILLATOR_LOGIC_FLIP_FLOP_COUNT];
+static volatile bool flip_flop_request_pending[OSCILLATOR_LOGIC_FLIP_FLOP_COUNT];
+
+// Линия задержки с отводами. Задержки в мс пересчитываются в отсчеты движка
+// между блоками; вход и очистка буфера из API тоже ждут начала блока.
+static delay_line_t delay_line;
+static uint32_t delay_buffer[OSCILLATOR_LOGIC_DELAY_WORDS];
+static uint32_t* delay_outputs[DELAY_LINE_MAX_TAPS];
+static double delay_tap_ms[DELAY_LINE_MAX_TAPS] = { 10.0, 20.0, 50.0, 100.0 };
+static volatile int delay_input_request = -1;
+static volatile bool delay_clear_request;
+static volatile bool delay_taps_pending = true;
+
+// мультиплексоры, шина выбора обычно с выходов делителя
+static multiplexer_t multiplexers[OSCILLATOR_LOGIC_MULTIPLEXER_COUNT];
+// входы и шина выбора из API меняются вместе в начале следующего блока
+static oscillator_logic_multiplexer_config_t multiplexer_requests[OSCILLATOR_LOGIC_MULTIPLEXER_COUNT];
+static volatile bool multiplexer_request_pending[OSCILLATOR_LOGIC_MULTIPLEXER_COUNT];
+
+// Voice pool
+static voice_pool_t voice_pool;
+
+// Ноты из API идут через очередь, рендер разбирает ее в начале блока:
+// пул голосов и его патч меняет только задача рендера
+typedef enum {
+    NOTE_EVENT_ON,
+    NOTE_EVENT_OFF,
+    NOTE_EVENT_ALL_OFF,
+} note_event_type_t;
+
+typedef struct {
+    note_event_type_t type;
+    int note;
+} note_event_t;
+
+#define NOTE_QUEUE_SIZE 32
+
+static note_event_t note_queue[NOTE_QUEUE_SIZE];
+static volatile uint32_t note_queue_head;   // events written, free-running
+static volatile uint32_t note_queue_tail;   // events applied
+
+// 8-битный ЦАП-микшер, собирает булевы узлы в многобитный сигнал
+static dac_mixer_t mixer;
+// Входы из API ждут начала следующего блока: таблицу шаблонов перестраивает
+// только рендер, между блоками
+static oscillator_logic_mixer_input_t mixer_requests[DAC_MIXER_MAX_INPUTS];
+static volatile bool mixer_request_pending[DAC_MIXER_MAX_INPUTS];
+
+// какой узел выведен на какой пин, слот свободен если handle NULL
+static oscillator_logic_output_route_t output_routes[OUTPUT_MAX_INSTANCES];
+static output_handle_t output_handles[OUTPUT_MAX_INSTANCES];
+
+// Per-route decimation from the engine rate to the output rate, the output reads value
+typedef struct {
+    decimator_t decimator;
+    int active_node;                                // node the decimator was set up for
+    int8_t block[OSCILLATOR_LOGIC_BLOCK_SIZE];
+    int8_t value;
+    // bitstream routes read the full 16-bit value
+    int16_t pcm_block[OSCILLATOR_LOGIC_BLOCK_SIZE];
+    int16_t pcm_value;
+} route_render_t;
+
+static route_render_t route_render[OUTPUT_MAX_INSTANCES];
+
+#define ROUTE_NODE_UNSET (-2)
+
+// Packed node streams of the current block
+static uint32_t node_words[OSCILLATOR_LOGIC_NODE_COUNT][OSCILLATOR_LOGIC_MAX_BLOCK_WORDS];
+static int16_t mixer_block[OSCILLATOR_LOGIC_BLOCK_SIZE * OSCILLATOR_LOGIC_MAX_OVERSAMPLING];
+
+// Stage streams of each divider, filled in by oscillator_logic_init
+static uint32_t* divider_outputs[OSCILLATOR_LOGIC_DIVIDER_COUNT][FREQUENCY_DIVIDER_STAGES];
+
+// Event driven engine, used for feed-forward patches when selected
+static edge_engine_t edge_engine;
+static volatile oscillator_logic_engine_t requested_engine = OSCILLATOR_LOGIC_ENGINE_BLOCK;
+static oscillator_logic_engine_t active_engine = OSCILLATOR_LOGIC_ENGINE_BLOCK;
+
+// Rasterizer state while an edge block is being drawn
+typedef struct {
+    size_t pos[OSCILLATOR_LOGIC_NODE_COUNT];
+    bool level[OSCILLATOR_LOGIC_NODE_COUNT];
+    size_t n_bits;
+    uint32_t oversample;
+} edge_raster_t;
+
+// FM и жесткая синхронизация осцилляторов от булевых узлов
+static oscillator_logic_modulation_t modulations[OSCILLATOR_LOGIC_OSCILLATOR_COUNT];
+// уровень источника синхронизации на предыдущем отсчете, нужен для поиска фронта
+static bool sync_prev[OSCILLATOR_LOGIC_OSCILLATOR_COUNT];
+// новая модуляция из API ждет начала следующего блока
+static oscillator_logic_modulation_t modulation_requests[OSCILLATOR_LOGIC_OSCILLATOR_COUNT];
+static volatile bool modulation_request_pending[OSCILLATOR_LOGIC_OSCILLATOR_COUNT];
+
+// Свип частоты от A до B за заданное время, считается прямо в блоке.
+// Запрос из API ждет в request до начала следующего блока.
+typedef enum {
+    SWEEP_REQUEST_NONE,
+    SWEEP_REQUEST_START,
+    SWEEP_REQUEST_STOP,
+} sweep_request_t;
+
+typedef struct {
+    oscillator_logic_sweep_t request;
+    volatile sweep_request_t pending;
+    bool active;
+    oscillator_logic_sweep_shape_t shape;
+    double frequency;           // at the start of the next word, Hz
+    double end_frequency;
+    double word_delta;          // linear: Hz added per word
+    double word_ratio;          // exponential: ratio per word
+    uint32_t remaining;         // engine samples to the end
+} sweep_state_t;
+
+static sweep_state_t sweeps[OSCILLATOR_LOGIC_OSCILLATOR_COUNT];
+
+// Шаговые секвенсоры на часах движка. Шаг, попавший внутрь блока, делит
+// блок на отрезки: отрезок до шага считается со старыми параметрами.
+typedef struct {
+    uint32_t offset;            // engine sample in the block
+    int sequencer;
+    int step;
+} sequencer_event_t;
+
+#define SEQUENCER_MAX_BLOCK_EVENTS (OSCILLATOR_LOGIC_SEQUENCER_COUNT * 2)
+
+static sequencer_t sequencers[OSCILLATOR_LOGIC_SEQUENCER_COUNT];
+static sequencer_pattern_t sequencer_requests[OSCILLATOR_LOGIC_SEQUENCER_COUNT];
+static volatile bool sequencer_request_pending[OSCILLATOR_LOGIC_SEQUENCER_COUNT];
+// double пишется не одной инструкцией, рендер читает темп только под флагом
+static double requested_bpm = SEQUENCER_DEFAULT_BPM;
+static volatile bool tempo_request_pending = true;
+static double active_bpm = 0.0;
+static int sequencer_oversampling = 0;
+static volatile bool requested_sequencers_running = false;
+static bool sequencers_running = false;
+static sequencer_event_t block_events[SEQUENCER_MAX_BLOCK_EVENTS];
+static size_t block_event_count;
+// блок собирается здесь по отрезкам, потом копируется в node_words
+static uint32_t segment_words[OSCILLATOR_LOGIC_NODE_COUNT][OSCILLATOR_LOGIC_MAX_BLOCK_WORDS];
+// отрезок, который сейчас считает render_graph: начало и длина всего блока
+static size_t segment_first_bit;
+static size_t segment_block_bits = 1;
+
+// Матрица модуляции считается раз в блок. Новое значение - конец линейного
+// перехода через весь блок, начало - значение прошлого блока.
+static mod_matrix_t mod_matrix;
+static double pitch_from[OSCILLATOR_LOGIC_OSCILLATOR_COUNT];      // frequency multipliers
+static double pitch_to[OSCILLATOR_LOGIC_OSCILLATOR_COUNT];
+static int16_t weight_from[DAC_MIXER_MAX_INPUTS];
+static int16_t weight_to[DAC_MIXER_MAX_INPUTS];
+static bool weights_modulated;
+static bool weights_ramp;
+static bool gate_prev[MOD_MATRIX_ENVELOPES];
+static size_t gate_bits;                    // length of the block in node_words
+// Настройки из API: mod_requests всегда хранит последние заданные значения,
+// флаги отмечают то, что ждет начала следующего блока
+static mod_matrix_t mod_requests;
+static volatile bool mod_lfo_pending[MOD_MATRIX_LFOS];
+static volatile bool mod_envelope_pending[MOD_MATRIX_ENVELOPES];
+static volatile bool mod_gate_pending[MOD_MATRIX_ENVELOPES];
+static volatile bool mod_route_pending[MOD_MATRIX_MAX_ROUTES];
+
+// Отводы для отладки: слова выбранных узлов копируются после блока в кольца,
+// поток WebSocket забирает их вместе с основным выходом. Смена узла
+// перезапускает кольцо: слова до start принадлежат прежнему узлу и читателю
+// не отдаются.
+typedef struct {
+    volatile int node_id;       // -1 off
+    volatile uint32_t start;    // head at the last node change
+    volatile uint32_t head;     // words written, free-running
+    volatile uint32_t tail;     // words read
+    volatile uint32_t dropped;  // since the last node change
+    uint32_t ring[OSCILLATOR_LOGIC_TAP_RING_WORDS];
+} node_tap_t;
+
+static node_tap_t taps[OSCILLATOR_LOGIC_MAX_TAPS];
+// новый набор узлов из API ждет начала следующего блока
+static int tap_requests[OSCILLATOR_LOGIC_MAX_TAPS];
+static volatile bool tap_request_pending;
+
+// Счетчики единиц и фронтов узлов. Окно набирается в window, готовое окно
+// копируется в published; нечетный stats_seq - копия идет, читатель повторяет.
+static oscillator_logic_node_stats_t stats_window[OSCILLATOR_LOGIC_NODE_COUNT];
+static oscillator_logic_node_stats_t stats_published[OSCILLATOR_LOGIC_NODE_COUNT];
+static volatile uint32_t stats_seq;
+static bool stats_prev[OSCILLATOR_LOGIC_NODE_COUNT];
+static int stats_blocks;
+
+// Снимок узла для осциллографа: запрос ставит API, рендер подхватывает его
+// между блоками и копирует слова, пока буфер не наполнится
+static volatile int capture_request_node = -1;
+static volatile bool capture_pending;
+static volatile bool capture_ready;
+static int capture_node = -1;
+static int capture_factor;
+static size_t capture_fill;
+static size_t capture_target;
+static uint32_t capture_words[OSCILLATOR_LOGIC_CAPTURE_WORDS];
+
+static volatile bool engine_enabled = true;
+static volatile int requested_oversampling = OSCILLATOR_LOGIC_DEFAULT_OVERSAMPLING;
+static int active_oversampling = 0;
+static int block_pos = OSCILLATOR_LOGIC_BLOCK_SIZE;
+
+// Get oscillators array
+Oscillator* oscillator_logic_get_oscillators(void) {
+    return oscillators;
+}
+
+// Get logical operations array
+logical_ops_t* oscillator_logic_get_logical_ops(void) {
+    return logical_ops;
+}
+
+// Get frequency dividers array
+frequency_divider_t* oscillator_logic_get_dividers(void) {
+    return dividers;
+}
+
+// Get LFSR noise sources array
+lfsr_t* oscillator_logic_get_lfsrs(void) {
+    return lfsrs;
+}
+
+// Get flip-flops array
+flip_flop_t* oscillator_logic_get_flip_flops(void) {
+    return flip_flops;
+}
+
+// Get the delay line
+delay_line_t* oscillator_logic_get_delay_line(void) {
+    return &delay_line;
+}
+
+// Get multiplexers array
+multiplexer_t* oscillator_logic_get_multiplexers(void) {
+    return multiplexers;
+}
+
+// Get the voice pool
+voice_pool_t* oscillator_logic_get_voice_pool(void) {
+    return &voice_pool;
+}
+
+// Get the DAC mixer
+dac_mixer_t* oscillator_logic_get_mixer(void) {
+    return &mixer;
+}
+
+bool* oscillator_logic_get_node_result_pointer(int node_id)
+{
+    if (node_id >= 0 && node_id < OSCILLATOR_LOGIC_FIRST_LOGICAL_OP_NODE) {
+        return oscillator_get_result_bool_pointer(&oscillators[node_id]);
+    }
+    if (node_id >= OSCILLATOR_LOGIC_FIRST_LOGICAL_OP_NODE && node_id < OSCILLATOR_LOGIC_FIRST_DIVIDER_NODE) {
+        return logical_ops_get_result_pointer(&logical_ops[node_id - OSCILLATOR_LOGIC_FIRST_LOGICAL_OP_NODE]);
+    }
+    if (node_id >= OSCILLATOR_LOGIC_FIRST_DIVIDER_NODE && node_id < OSCILLATOR_LOGIC_FIRST_LFSR_NODE) {
+        int stage = node_id - OSCILLATOR_LOGIC_FIRST_DIVIDER_NODE;
+        return frequency_divider_get_result_pointer(&dividers[stage / FREQUENCY_DIVIDER_STAGES],
+                                                    stage % FREQUENCY_DIVIDER_STAGES);
+    }
+    if (node_id >= OSCILLATOR_LOGIC_FIRST_LFSR_NODE && node_id < OSCILLATOR_LOGIC_FIRST_FLIP_FLOP_NODE) {
+        return lfsr_get_result_pointer(&lfsrs[node_id - OSCILLATOR_LOGIC_FIRST_LFSR_NODE]);
+    }
+    if (node_id >= OSCILLATOR_LOGIC_FIRST_FLIP_FLOP_NODE && node_id < OSCILLATOR_LOGIC_FIRST_DELAY_NODE) {
+        return flip_flop_get_result_pointer(&flip_flops[node_id - OSCILLATOR_LOGIC_FIRST_FLIP_FLOP_NODE]);
+    }
+    if (node_id >= OSCILLATOR_LOGIC_FIRST_DELAY_NODE && node_id < OSCILLATOR_LOGIC_FIRST_MULTIPLEXER_NODE) {
+        return delay_line_get_result_pointer(&delay_line, node_id - OSCILLATOR_LOGIC_FIRST_DELAY_NODE);
+    }
+    if (node_id >= OSCILLATOR_LOGIC_FIRST_MULTIPLEXER_NODE && node_id < OSCILLATOR_LOGIC_VOICE_POOL_NODE) {
+        return multiplexer_get_result_pointer(&multiplexers[node_id - OSCILLATOR_LOGIC_FIRST_MULTIPLEXER_NODE]);
+    }
+    if (node_id == OSCILLATOR_LOGIC_VOICE_POOL_NODE) {
+        return voice_pool_get_result_pointer(&voice_pool);
+    }
+    return NULL;
+}
+
+// keep_mode: существующий пин остается в своем режиме, mode только для нового
+static esp_err_t set_output_route(int gpio_num, int node_id, oscillator_logic_output_mode_t mode, bool keep_mode)
+{
+    bool is_mixer = (node_id == OSCILLATOR_LOGIC_MIXER_NODE);
+    if (!oscillator_logic_get_node_result_pointer(node_id) && !is_mixer) {
+        ESP_LOGE(TAG, "Invalid node id %d for output", node_id);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (mode != OSCILLATOR_LOGIC_OUTPUT_SDM && mode != OSCILLATOR_LOGIC_OUTPUT_BITSTREAM) {
+        ESP_LOGE(TAG, "Invalid output mode %d", mode);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for (int i = 0; i < OUTPUT_MAX_INSTANCES; i++) {
+        if (output_handles[i] && output_routes[i].gpio_num == gpio_num) {
+            if (!keep_mode && output_routes[i].mode != mode) {
+                ESP_LOGE(TAG, "Output GPIO %d runs in mode %d", gpio_num, output_routes[i].mode);
+                return ESP_ERR_INVALID_STATE;
+            }
+            // пин уже занят - меняем источник, дециматор перенастроится на следующем блоке
+            output_routes[i].node_id = node_id;
+            ESP_LOGI(TAG, "Output GPIO %d now plays node %d", gpio_num, node_id);
+            return ESP_OK;
+        }
+    }
+
+    for (int i = 0; i < OUTPUT_MAX_INSTANCES; i++) {
+        if (output_handles[i] == NULL) {
+            // все маршруты многобитные: и булев узел, и микшер после децимации дают PCM
+            route_render_t* render = &route_render[i];
+            memset(render->block, 0, sizeof(render->block));
+            memset(render->pcm_block, 0, sizeof(render->pcm_block));
+            render->value = 0;
+            render->pcm_value = 0;
+            render->active_node = ROUTE_NODE_UNSET;
+            output_routes[i].gpio_num = gpio_num;
+            output_routes[i].node_id = node_id;
+            output_routes[i].mode = mode;
+
+            output_handle_t handle = mode == OSCILLATOR_LOGIC_OUTPUT_BITSTREAM
+                ? output_init_bitstream(gpio_num, &render->pcm_value, OUTPUT_BITSTREAM_DEFAULT_ORDER)
+                : output_init(gpio_num, &render->value);
+            if (!handle) {
+                return ESP_ERR_NO_MEM;
+            }
+            output_handles[i] = handle;
+            ESP_LOGI(TAG, "Output GPIO %d added for node %d, mode %d", gpio_num, node_id, mode);
+            return ESP_OK;
+        }
+    }
+
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t oscillator_logic_set_output_route(int gpio_num, int node_id)
+{
+    return set_output_route(gpio_num, node_id, OSCILLATOR_LOGIC_OUTPUT_SDM, true);
+}
+
+esp_err_t oscillator_logic_set_output_route_mode(int gpio_num, int node_id, oscillator_logic_output_mode_t mode)
+{
+    return set_output_route(gpio_num, node_id, mode, false);
+}
+
+int oscillator_logic_get_output_routes(oscillator_logic_output_route_t* routes, int max_routes)
+{
+    if (!routes) return 0;
+
+    int count = 0;
+    for (int i = 0; i < OUTPUT_MAX_INSTANCES && count < max_routes; i++) {
+        if (output_handles[i]) {
+            routes[count++] = output_routes[i];
+        }
+    }
+    return count;
+}
+
+// номер узла, чей текущий результат лежит по указателю, только среди уже посчитанных узлов;
+// -1 для обратной связи (prev_result, свой или более поздний узел) и пустого входа
+static int resolve_node(const bool* ptr, int before_node)
+{
+    if (!ptr) return -1;
+    for (int n = 0; n < before_node; n++) {
+        if (ptr == oscillator_logic_get_node_result_pointer(n)) {
+            return n;
+        }
+    }
+    return -1;
+}
+
+// входы всех операций как номера более ранних узлов, false если их порядок не прямой
+static bool resolve_logic_inputs(int inputs[OSCILLATOR_LOGIC_LOGICAL_OP_COUNT][2])
+{
+    for (int j = 0; j < OSCILLATOR_LOGIC_LOGICAL_OP_COUNT; j++) {
+        int node = OSCILLATOR_LOGIC_FIRST_LOGICAL_OP_NODE + j;
+        inputs[j][0] = resolve_node(logical_ops[j].input1, node);
+        inputs[j][1] = resolve_node(logical_ops[j].input2, node);
+        if (inputs[j][0] < 0 || inputs[j][1] < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Патч голоса из текущего графа: частоты относительно осциллятора 0,
+// операции со своими входами, если они читают осцилляторы или младшие операции
+static void capture_voice_patch(void)
+{
+    voice_pool_patch_t patch;
+    for (int i = 0; i < VOICE_POOL_OSCILLATORS; i++) {
+        patch.ratios[i] = oscillators[i].frequency / oscillators[0].frequency;
+    }
+    for (int g = 0; g < VOICE_POOL_GATES; g++) {
+        const logical_ops_t* op = &logical_ops[g];
+        int node = OSCILLATOR_LOGIC_FIRST_LOGICAL_OP_NODE + g;
+        patch.operations[g] = op->operation;
+        patch.inputs[g][0] = resolve_node(op->input1, node);
+        patch.inputs[g][1] = resolve_node(op->input2, node);
+    }
+    voice_pool_set_patch(&voice_pool, &patch);
+}
+
+static bool oscillator_is_modulated(int i)
+{
+    return modulations[i].fm_source >= 0 || modulations[i].sync_source >= 0 || sweeps[i].active
+        || pitch_from[i] != 1.0 || pitch_to[i] != 1.0;
+}
+
+static bool any_oscillator_modulated(void)
+{
+    for (int i = 0; i < OSCILLATOR_LOGIC_OSCILLATOR_COUNT; i++) {
+        if (oscillator_is_modulated(i)) return true;
+    }
+    return false;
+}
+
+static uint32_t clamp_phase_inc(double inc)
+{
+    if (inc <= 0.0) return 0;
+    if (inc >= (double)PHASE_HALF_TURN) return PHASE_HALF_TURN;
+    return (uint32_t)inc;
+}
+
+// Increment multipliers while the FM source is low (0) and high (1),
+// computed once per block so the sample loop only indexes with the source bit
+static void modulation_ratios(int i, double ratio[2])
+{
+    const oscillator_logic_modulation_t* mod = &modulations[i];
+    ratio[0] = 1.0;
+    ratio[1] = 1.0;
+
+    if (mod->fm_source >= 0) {
+        if (mod->fm_mode == OSCILLATOR_LOGIC_FM_EXPONENTIAL) {
+            double octave = pow(2.0, mod->fm_depth);
+            ratio[0] = 1.0 / octave;
+            ratio[1] = octave;
+        } else {
+            ratio[0] = 1.0 - mod->fm_depth;
+            ratio[1] = 1.0 + mod->fm_depth;
+        }
+    }
+}
+
+// Per-sample state of a modulated oscillator. Increments are Q32.32 so a
+// sweep can move them by a fraction of a phase step every sample.
+typedef struct {
+    uint32_t phase;
+    uint64_t inc[2];        // while the FM source is low / high
+    int64_t step[2];        // added to inc every sample while sweeping
+    double ratio[2];
+    double pitch;           // modulation matrix multiplier at the start of the next word
+    double pitch_step;      // change of the multiplier per word
+} osc_run_t;
+
+// постоянная частота осциллятора, шаг тот же что у oscillator_render_bool_packed
+static void run_set_constant(osc_run_t* run, int i)
+{
+    for (int s = 0; s < 2; s++) {
+        run->inc[s] = (uint64_t)clamp_phase_inc(oscillators[i].phase_inc * run->ratio[s] * run->pitch) << 32;
+        run->step[s] = 0;
+    }
+}
+
+// линейный переход частоты from -> to (Гц) за span отсчетов
+static void run_set_ramp(osc_run_t* run, int i, double from, double to, int span)
+{
+    double scale = PHASE_FULL_TURN / oscillators[i].sample_rate;
+    for (int s = 0; s < 2; s++) {
+        uint64_t start = (uint64_t)clamp_phase_inc(from * scale * run->ratio[s]) << 32;
+        uint64_t end = (uint64_t)clamp_phase_inc(to * scale * run->ratio[s]) << 32;
+        run->inc[s] = start;
+        run->step[s] = span > 0 ? (int64_t)(((double)end - (double)start) / span) : 0;
+    }
+}
+
+// переход множителя матрицы идет через весь блок, отрезок берет свою часть
+static void run_begin_block(osc_run_t* run, int i)
+{
+    double span = pitch_to[i] - pitch_from[i];
+    run->phase = oscillators[i].phase_acc;
+    run->pitch = pitch_from[i] + span * segment_first_bit / segment_block_bits;
+    run->pitch_step = span * PACKED_WORD_BITS / segment_block_bits;
+    modulation_ratios(i, run->ratio);
+    run_set_constant(run, i);
+}
+
+// Moves the sweep and the matrix multiplier by one word. Exponential sweeps
+// are linear within the word, the word ends are one multiply apart. Returns
+// the bit where the sweep ends, PACKED_WORD_BITS if it goes on past this word
+// or no sweep is running.
+static int run_begin_word(osc_run_t* run, int i)
+{
+    sweep_state_t* sweep = &sweeps[i];
+    double pitch = run->pitch;
+    run->pitch += run->pitch_step;
+    if (!sweep->active) {
+        if (run->pitch_step != 0.0) {
+            double frequency = oscillators[i].frequency;
+            run_set_ramp(run, i, frequency * pitch, frequency * run->pitch, PACKED_WORD_BITS);
+        }
+        return PACKED_WORD_BITS;
+    }
+
+    double from = sweep->frequency;
+    int span;
+    if (sweep->remaining > PACKED_WORD_BITS) {
+        sweep->frequency = sweep->shape == OSCILLATOR_LOGIC_SWEEP_EXPONENTIAL
+            ? from * sweep->word_ratio
+            : from + sweep->word_delta;
+        sweep->remaining -= PACKED_WORD_BITS;
+        span = PACKED_WORD_BITS;
+    } else {
+        sweep->frequency = sweep->end_frequency;
+        span = (int)sweep->remaining;
+        sweep->remaining = 0;
+    }
+    double to_pitch = pitch + run->pitch_step * span / PACKED_WORD_BITS;
+    run_set_ramp(run, i, from * pitch, sweep->frequency * to_pitch, span);
+    return span;
+}
+
+// свип дошел до конца: осциллятор остается на конечной частоте
+static void run_end_sweep(osc_run_t* run, int i)
+{
+    sweeps[i].active = false;
+    oscillator_set_frequency(&oscillators[i], sweeps[i].end_frequency);
+    run_set_constant(run, i);
+}
+
+static inline uint32_t run_render_span(osc_run_t* run, uint32_t fm_word, uint32_t reset, int from, int to, uint32_t word)
+{
+    uint32_t phase = run->phase;
+    for (int b = from; b < to; b++) {
+        phase &= ((reset >> b) & 1u) - 1u;              // ноль на фронте синхронизации
+        word |= (~phase >> 31) << b;
+        phase += (uint32_t)(run->inc[(fm_word >> b) & 1u] >> 32);
+        run->inc[0] += run->step[0];
+        run->inc[1] += run->step[1];
+    }
+    run->phase = phase;
+    return word;
+}
+
+// Square from the phase accumulator with the increment picked by the FM
+// stream, moved by a running sweep and the phase cleared on every rising
+// edge of the sync stream. The source words for this block are ready.
+static void render_modulated_oscillator(int i, size_t n_bits)
+{
+    const oscillator_logic_modulation_t* mod = &modulations[i];
+    const uint32_t* fm = mod->fm_source >= 0 ? node_words[mod->fm_source] : NULL;
+    const uint32_t* sync = mod->sync_source >= 0 ? node_words[mod->sync_source] : NULL;
+    uint32_t* out = node_words[i];
+    osc_run_t run;
+    run_begin_block(&run, i);
+
+    for (size_t w = 0; w < PACKED_WORDS(n_bits); w++) {
+        uint32_t fm_word = fm ? fm[w] : 0;
+        uint32_t reset = 0;
+        if (sync) {
+            reset = packed_rising_edges(sync[w], sync_prev[i]);
+            sync_prev[i] = sync[w] >> (PACKED_WORD_BITS - 1);
+        }
+
+        int split = run_begin_word(&run, i);
+        uint32_t word = run_render_span(&run, fm_word, reset, 0, split, 0);
+        if (split < PACKED_WORD_BITS) {
+            run_end_sweep(&run, i);
+            word = run_render_span(&run, fm_word, reset, split, PACKED_WORD_BITS, word);
+        }
+        out[w] = word;
+    }
+
+    oscillators[i].phase_acc = run.phase;
+    oscillators[i].result_bool = packed_get_bit(out, n_bits - 1);
+}
+
+// Поотсчетный проход по всему блоку, когда в графе есть петля. Узлы считаются
+// по порядку номеров: меньшие номера дают значение текущего отсчета,
+// остальные - предыдущего.
+static void render_unit_scalar(size_t n_bits)
+{
+    osc_run_t runs[OSCILLATOR_LOGIC_OSCILLATOR_COUNT];
+    int split[OSCILLATOR_LOGIC_OSCILLATOR_COUNT];
+    const bool* fm[OSCILLATOR_LOGIC_OSCILLATOR_COUNT];
+    const bool* sync[OSCILLATOR_LOGIC_OSCILLATOR_COUNT];
+    static const bool low = false;
+
+    for (int i = 0; i < OSCILLATOR_LOGIC_OSCILLATOR_COUNT; i++) {
+        run_begin_block(&runs[i], i);
+        fm[i] = modulations[i].fm_source >= 0 ? oscillator_logic_get_node_result_pointer(modulations[i].fm_source) : &low;
+        sync[i] = modulations[i].sync_source >= 0 ? oscillator_logic_get_node_result_pointer(modulations[i].sync_source) : NULL;
+    }
+    for (int n = 0; n < OSCILLATOR_LOGIC_NODE_COUNT; n++) {
+        memset(node_words[n], 0, PACKED_WORDS(n_bits) * sizeof(uint32_t));
+    }
+    // пул голосов ничего не читает, он считается словами заранее
+    const uint32_t* voice_words = node_words[OSCILLATOR_LOGIC_VOICE_POOL_NODE];
+    voice_pool_render_packed(&voice_pool, node_words[OSCILLATOR_LOGIC_VOICE_POOL_NODE], PACKED_WORDS(n_bits));
+
+    for (size_t k = 0; k < n_bits; k++) {
+        int b = k % PACKED_WORD_BITS;
+        uint32_t bit = 1u << b;
+        size_t w = k / PACKED_WORD_BITS;
+
+        voice_pool.result = (voice_words[w] >> b) & 1u;
+        for (int i = 0; i < OSCILLATOR_LOGIC_OSCILLATOR_COUNT; i++) {
+            osc_run_t* run = &runs[i];
+            if (b == 0) split[i] = run_begin_word(run, i);
+            if (b == split[i]) run_end_sweep(run, i);
+
+            if (sync[i]) {
+                bool level = *sync[i];
+                if (level && !sync_prev[i]) run->phase = 0;
+                sync_prev[i] = level;
+            }
+            bool level = run->phase < PHASE_HALF_TURN;
+            oscillators[i].result_bool = level;
+            run->phase += (uint32_t)(run->inc[*fm[i]] >> 32);
+            run->inc[0] += run->step[0];
+            run->inc[1] += run->step[1];
+            if (level) node_words[i][w] |= bit;
+        }
+        for (int j = 0; j < OSCILLATOR_LOGIC_LOGICAL_OP_COUNT; j++) {
+            if (logical_ops_calculate(&logical_ops[j])) {
+                node_words[OSCILLATOR_LOGIC_FIRST_LOGICAL_OP_NODE + j][w] |= bit;
+            }
+        }
+        for (int d = 0; d < OSCILLATOR_LOGIC_DIVIDER_COUNT; d++) {
+            uint32_t count = frequency_divider_calculate(&dividers[d]);
+            uint32_t* const* outputs = divider_outputs[d];
+            for (int stage = 0; stage < FREQUENCY_DIVIDER_STAGES; stage++) {
+                if ((count >> stage) & 1u) outputs[stage][w] |= bit;
+            }
+        }
+        for (int l = 0; l < OSCILLATOR_LOGIC_LFSR_COUNT; l++) {
+            if (lfsr_calculate(&lfsrs[l])) {
+                node_words[OSCILLATOR_LOGIC_FIRST_LFSR_NODE + l][w] |= bit;
+            }
+        }
+        for (int f = 0; f < OSCILLATOR_LOGIC_FLIP_FLOP_COUNT; f++) {
+            if (flip_flop_calculate(&flip_flops[f])) {
+                node_words[OSCILLATOR_LOGIC_FIRST_FLIP_FLOP_NODE + f][w] |= bit;
+            }
+        }
+        delay_line_calculate(&delay_line);
+        for (int t = 0; t < DELAY_LINE_MAX_TAPS; t++) {
+            if (delay_line.results[t]) delay_outputs[t][w] |= bit;
+        }
+        for (int m = 0; m < OSCILLATOR_LOGIC_MULTIPLEXER_COUNT; m++) {
+            if (multiplexer_calculate(&multiplexers[m])) {
+                node_words[OSCILLATOR_LOGIC_FIRST_MULTIPLEXER_NODE + m][w] |= bit;
+            }
+        }
+    }
+
+    for (int i = 0; i < OSCILLATOR_LOGIC_OSCILLATOR_COUNT; i++) {
+        oscillators[i].phase_acc = runs[i].phase;
+    }
+}
+
+// Части графа, которые считаются целиком за блок: осциллятор, логическая
+// операция, делитель, LFSR, триггер, линия задержки, мультиплексор, пул
+// голосов. Каждая считается после узлов, которые она читает.
+#define UNIT_COUNT (OSCILLATOR_LOGIC_OSCILLATOR_COUNT + OSCILLATOR_LOGIC_LOGICAL_OP_COUNT + \
+                    OSCILLATOR_LOGIC_DIVIDER_COUNT + OSCILLATOR_LOGIC_LFSR_COUNT + OSCILLATOR_LOGIC_FLIP_FLOP_COUNT + 1 + \
+                    OSCILLATOR_LOGIC_MULTIPLEXER_COUNT + 1)
+#define UNIT_MAX_INPUTS (MULTIPLEXER_MAX_INPUTS + MULTIPLEXER_SELECT_BITS)
+#define UNIT_FIRST_LOGICAL_OP OSCILLATOR_LOGIC_OSCILLATOR_COUNT
+#define UNIT_FIRST_DIVIDER (UNIT_FIRST_LOGICAL_OP + OSCILLATOR_LOGIC_LOGICAL_OP_COUNT)
+#define UNIT_FIRST_LFSR (UNIT_FIRST_DIVIDER + OSCILLATOR_LOGIC_DIVIDER_COUNT)
+#define UNIT_FIRST_FLIP_FLOP (UNIT_FIRST_LFSR + OSCILLATOR_LOGIC_LFSR_COUNT)
+#define UNIT_DELAY_LINE (UNIT_FIRST_FLIP_FLOP + OSCILLATOR_LOGIC_FLIP_FLOP_COUNT)
+#define UNIT_FIRST_MULTIPLEXER (UNIT_DELAY_LINE + 1)
+#define UNIT_VOICE_POOL (UNIT_FIRST_MULTIPLEXER + OSCILLATOR_LOGIC_MULTIPLEXER_COUNT)
+
+// Nodes a unit reads this sample; -1 marks an input that is not a current
+// node result (prev_result or an empty pointer) and can only run per sample
+static int unit_inputs(int unit, int inputs[UNIT_MAX_INPUTS])
+{
+    int count = 0;
+    if (unit < UNIT_FIRST_LOGICAL_OP) {
+        const oscillator_logic_modulation_t* mod = &modulations[unit];
+        if (mod->fm_source >= 0) inputs[count++] = mod->fm_source;
+        if (mod->sync_source >= 0) inputs[count++] = mod->sync_source;
+    } else if (unit < UNIT_FIRST_DIVIDER) {
+        const logical_ops_t* op = &logical_ops[unit - UNIT_FIRST_LOGICAL_OP];
+        inputs[count++] = resolve_node(op->input1, OSCILLATOR_LOGIC_NODE_COUNT);
+        inputs[count++] = resolve_node(op->input2, OSCILLATOR_LOGIC_NODE_COUNT);
+    } else if (unit < UNIT_FIRST_LFSR) {
+        const frequency_divider_t* divider = &dividers[unit - UNIT_FIRST_DIVIDER];
+        if (divider->clock_id >= 0) inputs[count++] = divider->clock_id;
+    } else if (unit < UNIT_FIRST_FLIP_FLOP) {
+        const lfsr_t* lfsr = &lfsrs[unit - UNIT_FIRST_LFSR];
+        if (lfsr->clock_id >= 0) inputs[count++] = lfsr->clock_id;
+    } else if (unit < UNIT_DELAY_LINE) {
+        const flip_flop_t* ff = &flip_flops[unit - UNIT_FIRST_FLIP_FLOP];
+        for (int k = 0; k < FLIP_FLOP_INPUTS; k++) {
+            if (ff->input_ids[k] >= 0) inputs[count++] = ff->input_ids[k];
+        }
+        if (ff->clock_id >= 0) inputs[count++] = ff->clock_id;
+    } else if (unit == UNIT_DELAY_LINE) {
+        if (delay_line.input_id >= 0) inputs[count++] = delay_line.input_id;
+    } else if (unit < UNIT_VOICE_POOL) {
+        const multiplexer_t* mux = &multiplexers[unit - UNIT_FIRST_MULTIPLEXER];
+        for (int k = 0; k < MULTIPLEXER_MAX_INPUTS; k++) {
+            if (mux->input_ids[k] >= 0) inputs[count++] = mux->input_ids[k];
+        }
+        for (int k = 0; k < MULTIPLEXER_SELECT_BITS; k++) {
+            if (mux->select_ids[k] >= 0) inputs[count++] = mux->select_ids[k];
+        }
+    }
+    return count;
+}
+
+static void unit_outputs(int unit, int* first, int* count)
+{
+    if (unit < UNIT_FIRST_LOGICAL_OP) {
+        *first = unit;
+        *count = 1;
+    } else if (unit < UNIT_FIRST_DIVIDER) {
+        *first = OSCILLATOR_LOGIC_FIRST_LOGICAL_OP_NODE + unit - UNIT_FIRST_LOGICAL_OP;
+        *count = 1;
+    } else if (unit < UNIT_FIRST_LFSR) {
+        *first = OSCILLATOR_LOGIC_FIRST_DIVIDER_NODE + (unit - UNIT_FIRST_DIVIDER) * FREQUENCY_DIVIDER_STAGES;
+        *count = FREQUENCY_DIVIDER_STAGES;
+    } else if (unit < UNIT_FIRST_FLIP_FLOP) {
+        *first = OSCILLATOR_LOGIC_FIRST_LFSR_NODE + unit - UNIT_FIRST_LFSR;
+        *count = 1;
+    } else if (unit < UNIT_DELAY_LINE) {
+        *first = OSCILLATOR_LOGIC_FIRST_FLIP_FLOP_NODE + unit - UNIT_FIRST_FLIP_FLOP;
+        *count = 1;
+    } else if (unit == UNIT_DELAY_LINE) {
+        *first = OSCILLATOR_LOGIC_FIRST_DELAY_NODE;
+        *count = DELAY_LINE_MAX_TAPS;
+    } else if (unit < UNIT_VOICE_POOL) {
+        *first = OSCILLATOR_LOGIC_FIRST_MULTIPLEXER_NODE + unit - UNIT_FIRST_MULTIPLEXER;
+        *count = 1;
+    } else {
+        *first = OSCILLATOR_LOGIC_VOICE_POOL_NODE;
+        *count = 1;
+    }
+}
+
+// Порядок расчета блоков, false если в графе есть петля. Входы операций
+// запоминаются в logic_inputs, блок считается по ним, а не по указателям.
+static bool schedule_units(int order[UNIT_COUNT], int logic_inputs[OSCILLATOR_LOGIC_LOGICAL_OP_COUNT][2])
+{
+    bool node_ready[OSCILLATOR_LOGIC_NODE_COUNT] = { false };
+    bool scheduled[UNIT_COUNT] = { false };
+    int n = 0;
+
+    while (n < UNIT_COUNT) {
+        bool progress = false;
+        for (int u = 0; u < UNIT_COUNT; u++) {
+            if (scheduled[u]) continue;
+
+            int inputs[UNIT_MAX_INPUTS];
+            int n_inputs = unit_inputs(u, inputs);
+            bool ready = true;
+            for (int k = 0; k < n_inputs; k++) {
+                if (inputs[k] < 0 || !node_ready[inputs[k]]) ready = false;
+            }
+            if (!ready) continue;
+
+            if (u >= UNIT_FIRST_LOGICAL_OP && u < UNIT_FIRST_DIVIDER) {
+                logic_inputs[u - UNIT_FIRST_LOGICAL_OP][0] = inputs[0];
+                logic_inputs[u - UNIT_FIRST_LOGICAL_OP][1] = inputs[1];
+            }
+            int first, count;
+            unit_outputs(u, &first, &count);
+            for (int k = 0; k < count; k++) {
+                node_ready[first + k] = true;
+            }
+            scheduled[u] = true;
+            order[n++] = u;
+            progress = true;
+        }
+        if (!progress) return false;
+    }
+    return true;
+}
+
+static void render_divider(int d, size_t n_bits)
+{
+    int clock = dividers[d].clock_id;
+    frequency_divider_calculate_packed(&dividers[d], clock >= 0 ? node_words[clock] : NULL,
+                                       divider_outputs[d], PACKED_WORDS(n_bits));
+}
+
+static void render_lfsr(int l, size_t n_bits)
+{
+    int clock = lfsrs[l].clock_id;
+    lfsr_calculate_packed(&lfsrs[l], clock >= 0 ? node_words[clock] : NULL,
+                          node_words[OSCILLATOR_LOGIC_FIRST_LFSR_NODE + l], PACKED_WORDS(n_bits));
+}
+
+static void render_flip_flop(int f, size_t n_bits)
+{
+    const flip_flop_t* ff = &flip_flops[f];
+    flip_flop_calculate_packed(&flip_flops[f],
+                               ff->input_ids[0] >= 0 ? node_words[ff->input_ids[0]] : NULL,
+                               ff->input_ids[1] >= 0 ? node_words[ff->input_ids[1]] : NULL,
+                               ff->clock_id >= 0 ? node_words[ff->clock_id] : NULL,
+                               node_words[OSCILLATOR_LOGIC_FIRST_FLIP_FLOP_NODE + f], PACKED_WORDS(n_bits));
+}
+
+static void render_delay_line(size_t n_bits)
+{
+    int input = delay_line.input_id;
+    delay_line_calculate_packed(&delay_line, input >= 0 ? node_words[input] : NULL,
+                                delay_outputs, PACKED_WORDS(n_bits));
+}
+
+static void render_multiplexer(int m, size_t n_bits)
+{
+    const multiplexer_t* mux = &multiplexers[m];
+    const uint32_t* inputs[MULTIPLEXER_MAX_INPUTS];
+    const uint32_t* select[MULTIPLEXER_SELECT_BITS];
+    for (int k = 0; k < MULTIPLEXER_MAX_INPUTS; k++) {
+        inputs[k] = mux->input_ids[k] >= 0 ? node_words[mux->input_ids[k]] : NULL;
+    }
+    for (int k = 0; k < MULTIPLEXER_SELECT_BITS; k++) {
+        select[k] = mux->select_ids[k] >= 0 ? node_words[mux->select_ids[k]] : NULL;
+    }
+    multiplexer_calculate_packed(&multiplexers[m], inputs, select,
+                                 node_words[OSCILLATOR_LOGIC_FIRST_MULTIPLEXER_NODE + m], PACKED_WORDS(n_bits));
+}
+
+static void render_unit(int unit, size_t n_bits, const int logic_inputs[OSCILLATOR_LOGIC_LOGICAL_OP_COUNT][2])
+{
+    if (unit < UNIT_FIRST_LOGICAL_OP) {
+        if (oscillator_is_modulated(unit)) {
+            render_modulated_oscillator(unit, n_bits);
+        } else {
+            oscillator_render_bool_packed(&oscillators[unit], node_words[unit], n_bits);
+        }
+    } else if (unit < UNIT_FIRST_DIVIDER) {
+        int j = unit - UNIT_FIRST_LOGICAL_OP;
+        logical_ops_calculate_packed(&logical_ops[j], node_words[logic_inputs[j][0]], node_words[logic_inputs[j][1]],
+                                     node_words[OSCILLATOR_LOGIC_FIRST_LOGICAL_OP_NODE + j], PACKED_WORDS(n_bits));
+    } else if (unit < UNIT_FIRST_LFSR) {
+        render_divider(unit - UNIT_FIRST_DIVIDER, n_bits);
+    } else if (unit < UNIT_FIRST_FLIP_FLOP) {
+        render_lfsr(unit - UNIT_FIRST_LFSR, n_bits);
+    } else if (unit < UNIT_DELAY_LINE) {
+        render_flip_flop(unit - UNIT_FIRST_FLIP_FLOP, n_bits);
+    } else if (unit == UNIT_DELAY_LINE) {
+        render_delay_line(n_bits);
+    } else if (unit < UNIT_VOICE_POOL) {
+        render_multiplexer(unit - UNIT_FIRST_MULTIPLEXER, n_bits);
+    } else {
+        voice_pool_render_packed(&voice_pool, node_words[OSCILLATOR_LOGIC_VOICE_POOL_NODE], PACKED_WORDS(n_bits));
+    }
+}
+
+static void edge_raster_callback(void* ctx, const edge_event_t* event)
+{
+    edge_raster_t* raster = (edge_raster_t*)ctx;
+    int node = event->node;
+    if (node >= OSCILLATOR_LOGIC_FIRST_DIVIDER_NODE) return;
+
+    size_t k = edge_engine_time_to_sample(event->time, raster->oversample);
+    if (k > raster->n_bits) k = raster->n_bits;
+    packed_fill(node_words[node], raster->pos[node], k, raster->level[node]);
+    raster->pos[node] = k;
+    raster->level[node] = event->level;
+}
+
+// переход на блочный движок: фазы и состояния узлов возвращаются в осцилляторы и операции
+static void leave_edge_engine(void)
+{
+    for (int i = 0; i < OSCILLATOR_LOGIC_OSCILLATOR_COUNT; i++) {
+        oscillators[i].phase_acc = edge_engine_get_phase(&edge_engine, i);
+    }
+    active_engine = OSCILLATOR_LOGIC_ENGINE_BLOCK;
+    ESP_LOGI(TAG, "Block engine active");
+}
+
+// событийный движок, false если патч для него не подходит; n_bits - целое число выходных отсчетов
+static bool render_edges(size_t n_bits, int factor)
+{
+    int inputs[OSCILLATOR_LOGIC_LOGICAL_OP_COUNT][2];
+    if (!resolve_logic_inputs(inputs) || any_oscillator_modulated()) {
+        return false;
+    }
+    // делители и LFSR считаются после событий, такт делителя может идти только
+    // от осцилляторов и логики, такт LFSR - еще и от делителей
+    for (int d = 0; d < OSCILLATOR_LOGIC_DIVIDER_COUNT; d++) {
+        if (dividers[d].clock_id >= OSCILLATOR_LOGIC_FIRST_DIVIDER_NODE) {
+            return false;
+        }
+    }
+    for (int l = 0; l < OSCILLATOR_LOGIC_LFSR_COUNT; l++) {
+        if (lfsrs[l].clock_id >= OSCILLATOR_LOGIC_FIRST_LFSR_NODE) {
+            return false;
+        }
+    }
+    // триггеры идут по порядку, каждый читает только узлы с меньшим номером
+    for (int f = 0; f < OSCILLATOR_LOGIC_FLIP_FLOP_COUNT; f++) {
+        int node = OSCILLATOR_LOGIC_FIRST_FLIP_FLOP_NODE + f;
+        const flip_flop_t* ff = &flip_flops[f];
+        if (ff->input_ids[0] >= node || ff->input_ids[1] >= node || ff->clock_id >= node) {
+            return false;
+        }
+    }
+    if (delay_line.input_id >= OSCILLATOR_LOGIC_FIRST_DELAY_NODE) {
+        return false;
+    }
+    for (int m = 0; m < OSCILLATOR_LOGIC_MULTIPLEXER_COUNT; m++) {
+        int inputs[UNIT_MAX_INPUTS];
+        int node = OSCILLATOR_LOGIC_FIRST_MULTIPLEXER_NODE + m;
+        int n_inputs = unit_inputs(UNIT_FIRST_MULTIPLEXER + m, inputs);
+        for (int k = 0; k < n_inputs; k++) {
+            if (inputs[k] >= node) return false;
+        }
+    }
+
+    if (active_engine != OSCILLATOR_LOGIC_ENGINE_EDGE) {
+        edge_engine_init(&edge_engine, OSCILLATOR_LOGIC_OSCILLATOR_COUNT, SYSTEM_SAMPLE_RATE);
+        for (int i = 0; i < OSCILLATOR_LOGIC_OSCILLATOR_COUNT; i++) {
+            edge_engine_set_source(&edge_engine, i, oscillators[i].frequency, oscillators[i].phase_acc);
+        }
+        active_engine = OSCILLATOR_LOGIC_ENGINE_EDGE;
+        ESP_LOGI(TAG, "Edge engine active");
+    } else {
+        for (int i = 0; i < OSCILLATOR_LOGIC_OSCILLATOR_COUNT; i++) {
+            if (edge_engine.sources[i].frequency != oscillators[i].frequency) {
+                edge_engine_set_frequency(&edge_engine, i, oscillators[i].frequency);
+            }
+        }
+    }
+    for (int j = 0; j < OSCILLATOR_LOGIC_LOGICAL_OP_COUNT; j++) {
+        edge_engine_set_gate(&edge_engine, j, logical_ops[j].operation, inputs[j][0], inputs[j][1]);
+    }
+
+    edge_raster_t raster = {
+        .n_bits = n_bits,
+        .oversample = (uint32_t)factor,
+    };
+    for (int n = 0; n < OSCILLATOR_LOGIC_FIRST_DIVIDER_NODE; n++) {
+        raster.level[n] = edge_engine_get_level(&edge_engine, n);
+    }
+    edge_engine_run(&edge_engine, n_bits / factor, edge_raster_callback, &raster);
+    for (int n = 0; n < OSCILLATOR_LOGIC_FIRST_DIVIDER_NODE; n++) {
+        packed_fill(node_words[n], raster.pos[n], n_bits, raster.level[n]);
+    }
+    voice_pool_render_packed(&voice_pool, node_words[OSCILLATOR_LOGIC_VOICE_POOL_NODE], PACKED_WORDS(n_bits));
+    for (int d = 0; d < OSCILLATOR_LOGIC_DIVIDER_COUNT; d++) {
+        render_divider(d, n_bits);
+    }
+    for (int l = 0; l < OSCILLATOR_LOGIC_LFSR_COUNT; l++) {
+        render_lfsr(l, n_bits);
+    }
+    for (int f = 0; f < OSCILLATOR_LOGIC_FLIP_FLOP_COUNT; f++) {
+        render_flip_flop(f, n_bits);
+    }
+    render_delay_line(n_bits);
+    for (int m = 0; m < OSCILLATOR_LOGIC_MULTIPLEXER_COUNT; m++) {
+        render_multiplexer(m, n_bits);
+    }
+
+    // состояние узлов для API и для перехода обратно на блочный движок
+    for (int i = 0; i < OSCILLATOR_LOGIC_OSCILLATOR_COUNT; i++) {
+        oscillators[i].result_bool = packed_get_bit(node_words[i], n_bits - 1);
+    }
+    for (int j = 0; j < OSCILLATOR_LOGIC_LOGICAL_OP_COUNT; j++) {
+        const uint32_t* words = node_words[OSCILLATOR_LOGIC_FIRST_LOGICAL_OP_NODE + j];
+        logical_ops[j].result = packed_get_bit(words, n_bits - 1);
+        logical_ops[j].prev_result = packed_get_bit(words, n_bits - 2);
+    }
+    return true;
+}
+
+static void render_mixer(size_t n_bits)
+{
+    const uint32_t* inputs[DAC_MIXER_MAX_INPUTS];
+    for (int i = 0; i < DAC_MIXER_MAX_INPUTS; i++) {
+        int node = mixer.input_ids[i];
+        inputs[i] = (mixer.inputs[i] && node >= 0 && node < OSCILLATOR_LOGIC_NODE_COUNT) ? node_words[node] : NULL;
+    }
+    if (weights_ramp) {
+        dac_mixer_calculate_packed_ramp(&mixer, inputs, weight_from, weight_to, PACKED_WORDS(n_bits), mixer_block);
+    } else {
+        dac_mixer_calculate_packed(&mixer, inputs, PACKED_WORDS(n_bits), mixer_block);
+    }
+}
+
+// Гейты огибающих - уровни узлов в прошлом блоке, фронт внутри блока
+// перезапускает атаку. Модуляция отстает от гейта на один блок.
+static void apply_mod_gates(void)
+{
+    for (int e = 0; e < MOD_MATRIX_ENVELOPES; e++) {
+        int gate = mod_matrix.envelopes[e].gate_id;
+        if (gate < 0 || gate >= OSCILLATOR_LOGIC_NODE_COUNT || gate_bits == 0) continue;
+
+        const uint32_t* words = node_words[gate];
+        uint32_t rising = 0;
+        for (size_t w = 0; w < PACKED_WORDS(gate_bits); w++) {
+            rising |= packed_rising_edges(words[w], gate_prev[e]);
+            gate_prev[e] = words[w] >> (PACKED_WORD_BITS - 1);
+        }
+        mod_matrix_gate(&mod_matrix, e, packed_get_bit(words, gate_bits - 1), rising != 0);
+    }
+}
+
+// слова до start уже не нужны, даже если читатель до них не дошел
+static uint32_t tap_live_tail(const node_tap_t* tap)
+{
+    uint32_t tail = tap->tail;
+    uint32_t start = tap->start;
+    return (int32_t)(start - tail) > 0 ? start : tail;
+}
+
+// запросы из API применяются только между блоками
+static void apply_tap_requests(void)
+{
+    if (!tap_request_pending) return;
+
+    for (int t = 0; t < OSCILLATOR_LOGIC_MAX_TAPS; t++) {
+        node_tap_t* tap = &taps[t];
+        if (tap_requests[t] == tap->node_id) continue;
+        // start и узел видны читателю раньше слов нового узла
+        tap->start = tap->head;
+        tap->dropped = 0;
+        tap->node_id = tap_requests[t];
+        __sync_synchronize();
+    }
+    tap_request_pending = false;
+}
+
+static void capture_taps(size_t n_bits)
+{
+    size_t n_words = PACKED_WORDS(n_bits);
+    for (int t = 0; t < OSCILLATOR_LOGIC_MAX_TAPS; t++) {
+        node_tap_t* tap = &taps[t];
+        int node = tap->node_id;
+        if (node < 0) continue;
+
+        uint32_t head = tap->head;
+        if (OSCILLATOR_LOGIC_TAP_RING_WORDS - (head - tap_live_tail(tap)) < n_words) {
+            tap->dropped += n_words;
+            continue;
+        }
+        // блок может перейти через конец кольца - тогда два куска
+        uint32_t start = head % OSCILLATOR_LOGIC_TAP_RING_WORDS;
+        size_t first = OSCILLATOR_LOGIC_TAP_RING_WORDS - start;
+        if (first > n_words) first = n_words;
+        memcpy(&tap->ring[start], node_words[node], first * sizeof(uint32_t));
+        memcpy(tap->ring, &node_words[node][first], (n_words - first) * sizeof(uint32_t));
+        __sync_synchronize();
+        tap->head = head + n_words;
+    }
+}
+
+static void capture_node_words(size_t n_bits, int factor)
+{
+    if (capture_pending) {
+        capture_pending = false;
+        capture_ready = false;
+        capture_node = capture_request_node;
+        capture_factor = factor;
+        capture_fill = 0;
+        capture_target = PACKED_WORDS((size_t)OSCILLATOR_LOGIC_CAPTURE_SAMPLES * factor);
+    }
+    if (capture_node < 0 || capture_ready) return;
+
+    // смена передискретизации посреди снимка - начать заново с новым шагом
+    if (factor != capture_factor) {
+        capture_factor = factor;
+        capture_fill = 0;
+        capture_target = PACKED_WORDS((size_t)OSCILLATOR_LOGIC_CAPTURE_SAMPLES * factor);
+    }
+    size_t n_words = PACKED_WORDS(n_bits);
+    if (n_words > capture_target - capture_fill) n_words = capture_target - capture_fill;
+    memcpy(&capture_words[capture_fill], node_words[capture_node], n_words * sizeof(uint32_t));
+    capture_fill += n_words;
+    if (capture_fill == capture_target) {
+        __sync_synchronize();
+        capture_ready = true;
+    }
+}
+
+// смена уровня - бит, отличный от предыдущего: слово против себя со сдвигом на 1
+static void count_node_stats(size_t n_bits)
+{
+    size_t n_words = PACKED_WORDS(n_bits);
+    for (int n = 0; n < OSCILLATOR_LOGIC_NODE_COUNT; n++) {
+        const uint32_t* words = node_words[n];
+        uint32_t prev = stats_prev[n];
+        uint32_t ones = 0;
+        uint32_t edges = 0;
+        for (size_t w = 0; w < n_words; w++) {
+            uint32_t word = words[w];
+            ones += packed_popcount(word);
+            edges += packed_popcount(word ^ ((word << 1) | prev));
+            prev = word >> (PACKED_WORD_BITS - 1);
+        }
+        stats_prev[n] = prev;
+        stats_window[n].ones += ones;
+        stats_window[n].edges += edges;
+        stats_window[n].samples += (uint32_t)n_bits;
+    }
+
+    if (++stats_blocks < OSCILLATOR_LOGIC_STATS_WINDOW_BLOCKS) return;
+    stats_seq++;
+    __sync_synchronize();
+    memcpy(stats_published, stats_window, sizeof(stats_published));
+    __sync_synchronize();
+    stats_seq++;
+    memset(stats_window, 0, sizeof(stats_window));
+    stats_blocks = 0;
+}
+
+// запросы из API применяются только между блоками
+static void apply_mod_requests(void)
+{
+    for (int l = 0; l < MOD_MATRIX_LFOS; l++) {
+        if (!mod_lfo_pending[l]) continue;
+        mod_matrix_set_lfo(&mod_matrix, l, mod_requests.lfos[l].shape, mod_requests.lfos[l].rate);
+        mod_lfo_pending[l] = false;
+    }
+    for (int e = 0; e < MOD_MATRIX_ENVELOPES; e++) {
+        if (mod_envelope_pending[e]) {
+            const mod_matrix_envelope_t* env = &mod_requests.envelopes[e];
+            mod_matrix_set_envelope(&mod_matrix, e, env->attack_ms, env->decay_ms, env->sustain, env->release_ms);
+            mod_envelope_pending[e] = false;
+        }
+        if (mod_gate_pending[e]) {
+            mod_matrix_set_envelope_gate(&mod_matrix, e, mod_requests.envelopes[e].gate_id);
+            mod_gate_pending[e] = false;
+        }
+    }
+    for (int r = 0; r < MOD_MATRIX_MAX_ROUTES; r++) {
+        if (!mod_route_pending[r]) continue;
+        mod_matrix_set_route(&mod_matrix, r, &mod_requests.routes[r]);
+        mod_route_pending[r] = false;
+    }
+}
+
+static void apply_mod_matrix(size_t n_bits)
+{
+    apply_mod_gates();
+    mod_matrix_advance(&mod_matrix, (double)OSCILLATOR_LOGIC_BLOCK_SIZE / SYSTEM_SAMPLE_RATE);
+    gate_bits = n_bits;
+
+    double octaves[OSCILLATOR_LOGIC_OSCILLATOR_COUNT];
+    mod_matrix_sum(&mod_matrix, MOD_MATRIX_DEST_FREQUENCY, octaves, OSCILLATOR_LOGIC_OSCILLATOR_COUNT);
+    for (int i = 0; i < OSCILLATOR_LOGIC_OSCILLATOR_COUNT; i++) {
+        pitch_from[i] = pitch_to[i];
+        pitch_to[i] = octaves[i] != 0.0 ? pow(2.0, octaves[i]) : 1.0;
+    }
+
+    // вес входа: заданный вес плюс доля от него, после модуляции блок возврата к заданному
+    double shares[DAC_MIXER_MAX_INPUTS];
+    bool modulated = mod_matrix_sum(&mod_matrix, MOD_MATRIX_DEST_MIXER_WEIGHT, shares, DAC_MIXER_MAX_INPUTS);
+    weights_ramp = modulated || weights_modulated;
+    for (int i = 0; i < DAC_MIXER_MAX_INPUTS; i++) {
+        double weight = mixer.weights[i] * (1.0 + shares[i]);
+        if (weight > INT16_MAX) weight = INT16_MAX;
+        if (weight < INT16_MIN) weight = INT16_MIN;
+        weight_from[i] = weights_modulated ? weight_to[i] : mixer.weights[i];
+        weight_to[i] = (int16_t)lround(weight);
+    }
+    weights_modulated = modulated;
+}
+
+// шаг свипа на слово из текущей частоты и оставшегося числа отсчетов
+static void sweep_plan(sweep_state_t* sweep)
+{
+    double words = (double)sweep->remaining / PACKED_WORD_BITS;
+    sweep->word_delta = (sweep->end_frequency - sweep->frequency) / words;
+    sweep->word_ratio = pow(sweep->end_frequency / sweep->frequency, 1.0 / words);
+}
+
+// запросы из API применяются только между блоками
+static void apply_sweep_requests(int factor)
+{
+    for (int i = 0; i < OSCILLATOR_LOGIC_OSCILLATOR_COUNT; i++) {
+        sweep_state_t* sweep = &sweeps[i];
+        sweep_request_t pending = sweep->pending;
+        if (pending == SWEEP_REQUEST_NONE) continue;
+
+        if (pending == SWEEP_REQUEST_START) {
+            const oscillator_logic_sweep_t* request = &sweep->request;
+            double samples = request->duration_ms * 0.001 * SYSTEM_SAMPLE_RATE * factor;
+            sweep->shape = request->shape;
+            sweep->frequency = request->start_frequency;
+            sweep->end_frequency = request->end_frequency;
+            sweep->remaining = samples < 1.0 ? 1 : (uint32_t)samples;
+            sweep->active = true;
+            sweep_plan(sweep);
+        } else if (sweep->active) {
+            // остановка: держим частоту, до которой дошли
+            sweep->active = false;
+            oscillator_set_frequency(&oscillators[i], sweep->frequency);
+        }
+        sweep->pending = SWEEP_REQUEST_NONE;
+    }
+}
+
+// один писатель (задача HTTP), один читатель (рендер)
+static esp_err_t queue_note_event(note_event_type_t type, int note)
+{
+    uint32_t head = note_queue_head;
+    if (head - note_queue_tail >= NOTE_QUEUE_SIZE) {
+        ESP_LOGW(TAG, "Note queue full, event dropped");
+        return ESP_ERR_NO_MEM;
+    }
+    note_queue[head % NOTE_QUEUE_SIZE] = (note_event_t){ .type = type, .note = note };
+    __sync_synchronize();
+    note_queue_head = head + 1;
+    return ESP_OK;
+}
+
+static void apply_note_events(void)
+{
+    uint32_t tail = note_queue_tail;
+    uint32_t head = note_queue_head;
+    __sync_synchronize();
+    for (; tail != head; tail++) {
+        const note_event_t* event = &note_queue[tail % NOTE_QUEUE_SIZE];
+        switch (event->type) {
+        case NOTE_EVENT_ON:
+            capture_voice_patch();
+            voice_pool_note_on(&voice_pool, event->note);
+            break;
+        case NOTE_EVENT_OFF:
+            voice_pool_note_off(&voice_pool, event->note);
+            break;
+        case NOTE_EVENT_ALL_OFF:
+            voice_pool_all_notes_off(&voice_pool);
+            break;
+        }
+    }
+    note_queue_tail = tail;
+}
+
+// запросы из API применяются только между блоками
+static void apply_modulation_requests(void)
+{
+    for (int i = 0; i < OSCILLATOR_LOGIC_OSCILLATOR_COUNT; i++) {
+        if (!modulation_request_pending[i]) continue;
+
+        const oscillator_logic_modulation_t* request = &modulation_requests[i];
+        // новый источник синхронизации: фронт ищется от его текущего уровня
+        if (request->sync_source >= 0) {
+            sync_prev[i] = *oscillator_logic_get_node_result_pointer(request->sync_source);
+        }
+        modulations[i] = *request;
+        modulation_request_pending[i] = false;
+    }
+}
+
+// Вход операции j из номера узла. Операции 0 и 1 читают любую операцию по
+// прошлому отсчету; последняя читает младшие по текущему, себя - по прошлому.
+static bool* logic_input_pointer(int j, int node_id)
+{
+    int op = node_id - OSCILLATOR_LOGIC_FIRST_LOGICAL_OP_NODE;
+    if (op < 0 || op >= OSCILLATOR_LOGIC_LOGICAL_OP_COUNT) {
+        return oscillator_logic_get_node_result_pointer(node_id);
+    }
+    if (j < OSCILLATOR_LOGIC_LOGICAL_OP_COUNT - 1 || op == j) {
+        return &logical_ops[op].prev_result;
+    }
+    return &logical_ops[op].result;
+}
+
+// запросы из API применяются только между блоками
+static void apply_logic_requests(void)
+{
+    for (int j = 0; j < OSCILLATOR_LOGIC_LOGICAL_OP_COUNT; j++) {
+        if (!logic_request_pending[j]) continue;
+
+        const logic_request_t* request = &logic_requests[j];
+        logical_ops_set_operation(&logical_ops[j], request->operation);
+        logical_ops_set_inputs(&logical_ops[j],
+                               logic_input_pointer(j, request->input_ids[0]),
+                               logic_input_pointer(j, request->input_ids[1]),
+                               request->input_ids[0], request->input_ids[1]);
+        logic_request_pending[j] = false;
+    }
+}
+
+// новый узел сбрасывает историю входа, поэтому он ставится только при смене
+static void apply_mixer_requests(void)
+{
+    for (int i = 0; i < DAC_MIXER_MAX_INPUTS; i++) {
+        if (!mixer_request_pending[i]) continue;
+
+        const oscillator_logic_mixer_input_t* request = &mixer_requests[i];
+        if (request->node_id != mixer.input_ids[i]) {
+            dac_mixer_set_input(&mixer, i, oscillator_logic_get_node_result_pointer(request->node_id), request->node_id);
+        }
+        if (request->weight != mixer.weights[i]) {
+            dac_mixer_set_weight(&mixer, i, request->weight);
+        }
+        dac_mixer_set_delay(&mixer, i, request->delay);
+        mixer_request_pending[i] = false;
+    }
+}
+
+static void apply_divider_requests(void)
+{
+    for (int d = 0; d < OSCILLATOR_LOGIC_DIVIDER_COUNT; d++) {
+        if (divider_clock_pending[d]) {
+            int clock = divider_clock_requests[d];
+            frequency_divider_set_clock(&dividers[d], oscillator_logic_get_node_result_pointer(clock), clock);
+            divider_clock_pending[d] = false;
+        }
+        if (divider_reset_pending[d]) {
+            frequency_divider_reset(&dividers[d]);
+            divider_reset_pending[d] = false;
+        }
+    }
+}
+
+// длина перезаряжает регистр, поэтому затравка идет после нее
+static void apply_lfsr_requests(void)
+{
+    for (int l = 0; l < OSCILLATOR_LOGIC_LFSR_COUNT; l++) {
+        const lfsr_request_t* request = &lfsr_requests[l];
+        if (lfsr_length_pending[l]) {
+            lfsr_set_length(&lfsrs[l], request->length, request->taps);
+            lfsr_length_pending[l] = false;
+        }
+        if (lfsr_clock_pending[l]) {
+            lfsr_set_clock(&lfsrs[l], oscillator_logic_get_node_result_pointer(request->clock_id), request->clock_id);
+            lfsr_clock_pending[l] = false;
+        }
+        if (lfsr_seed_pending[l]) {
+            lfsr_seed(&lfsrs[l], request->seed);
+            lfsr_seed_pending[l] = false;
+        }
+    }
+}
+
+// такт переставляется только при смене узла: flip_flop_set_clock сбрасывает prev_clock
+static void apply_flip_flop_requests(void)
+{
+    for (int f = 0; f < OSCILLATOR_LOGIC_FLIP_FLOP_COUNT; f++) {
+        if (!flip_flop_request_pending[f]) continue;
+
+        const oscillator_logic_flip_flop_config_t* request = &flip_flop_requests[f];
+        flip_flop_t* ff = &flip_flops[f];
+        flip_flop_set_type(ff, request->type, request->edge);
+        flip_flop_set_inputs(ff, oscillator_logic_get_node_result_pointer(request->input_ids[0]),
+                             oscillator_logic_get_node_result_pointer(request->input_ids[1]),
+                             request->input_ids[0], request->input_ids[1]);
+        if (request->clock_id != ff->clock_id) {
+            flip_flop_set_clock(ff, oscillator_logic_get_node_result_pointer(request->clock_id), request->clock_id);
+        }
+        flip_flop_request_pending[f] = false;
+    }
+}
+
+static void apply_multiplexer_requests(void)
+{
+    for (int m = 0; m < OSCILLATOR_LOGIC_MULTIPLEXER_COUNT; m++) {
+        if (!multiplexer_request_pending[m]) continue;
+
+        const oscillator_logic_multiplexer_config_t* request = &multiplexer_requests[m];
+        for (int k = 0; k < MULTIPLEXER_MAX_INPUTS; k++) {
+            multiplexer_set_input(&multiplexers[m], k, oscillator_logic_get_node_result_pointer(request->input_ids[k]),
+                                  request->input_ids[k]);
+        }
+        for (int b = 0; b < MULTIPLEXER_SELECT_BITS; b++) {
+            multiplexer_set_select(&multiplexers[m], b, oscillator_logic_get_node_result_pointer(request->select_ids[b]),
+                                   request->select_ids[b]);
+        }
+        multiplexer_request_pending[m] = false;
+    }
+}
+
+// вход, очистка и задержки отводов в отсчетах движка, не длиннее буфера
+static void apply_delay_taps(int factor)
+{
+    delay_taps_pending = false;
+    int input = delay_input_request;
+    delay_line_set_input(&delay_line, oscillator_logic_get_node_result_pointer(input), input);
+    if (delay_clear_request) {
+        delay_clear_request = false;
+        delay_line_clear(&delay_line);
+    }
+    uint32_t max_delay = delay_line_get_max_delay(&delay_line);
+    for (int t = 0; t < DELAY_LINE_MAX_TAPS; t++) {
+        double samples = round(delay_tap_ms[t] * 0.001 * SYSTEM_SAMPLE_RATE * factor);
+        if (samples < 1.0) samples = 1.0;
+        if (samples > max_delay) samples = max_delay;
+        delay_line_set_delay(&delay_line, t, (uint32_t)samples);
+    }
+}
+
+static void apply_oversampling(int factor)
+{
+    for (int i = 0; i < OSCILLATOR_LOGIC_OSCILLATOR_COUNT; i++) {
+        oscillator_set_sample_rate(&oscillators[i], (double)SYSTEM_SAMPLE_RATE * factor);
+
+        // идущий свип сохраняет оставшееся время
+        sweep_state_t* sweep = &sweeps[i];
+        if (sweep->active && active_oversampling > 0) {
+            uint32_t remaining = (uint32_t)((uint64_t)sweep->remaining * factor / active_oversampling);
+            sweep->remaining = remaining > 0 ? remaining : 1;
+            sweep_plan(sweep);
+        }
+    }
+    voice_pool_set_sample_rate(&voice_pool, (double)SYSTEM_SAMPLE_RATE * factor);
+    for (int i = 0; i < OUTPUT_MAX_INSTANCES; i++) {
+        route_render[i].active_node = ROUTE_NODE_UNSET;
+    }
+    active_oversampling = factor;
+    delay_taps_pending = true;
+    ESP_LOGI(TAG, "Oversampling x%d, engine rate %d Hz", factor, SYSTEM_SAMPLE_RATE * factor);
+}
+
+// граф целиком на n_bits отсчетов движка, first_bit - начало отрезка в блоке
+static void render_graph(size_t n_bits, size_t first_bit, int factor)
+{
+    bool rendered = false;
+    segment_first_bit = first_bit;
+    if (requested_engine == OSCILLATOR_LOGIC_ENGINE_EDGE) {
+        rendered = render_edges(n_bits, factor);
+    }
+    if (!rendered) {
+        if (active_engine == OSCILLATOR_LOGIC_ENGINE_EDGE) {
+            leave_edge_engine();
+        }
+        int order[UNIT_COUNT];
+        int logic_inputs[OSCILLATOR_LOGIC_LOGICAL_OP_COUNT][2];
+        if (schedule_units(order, logic_inputs)) {
+            for (int u = 0; u < UNIT_COUNT; u++) {
+                render_unit(order[u], n_bits, logic_inputs);
+            }
+        } else {
+            render_unit_scalar(n_bits);
+        }
+    }
+}
+
+static void release_sequencer_note(sequencer_t* seq)
+{
+    if (seq->held_note >= 0) {
+        voice_pool_note_off(&voice_pool, seq->held_note);
+        seq->held_note = -1;
+    }
+}
+
+// запросы из API применяются только между блоками
+static void apply_sequencer_requests(int factor)
+{
+    double rate = (double)SYSTEM_SAMPLE_RATE * factor;
+    bool retempo = factor != sequencer_oversampling;
+    sequencer_oversampling = factor;
+    if (tempo_request_pending) {
+        double bpm = requested_bpm;
+        tempo_request_pending = false;
+        retempo = retempo || bpm != active_bpm;
+        active_bpm = bpm;
+    }
+
+    for (int s = 0; s < OSCILLATOR_LOGIC_SEQUENCER_COUNT; s++) {
+        sequencer_t* seq = &sequencers[s];
+        if (sequencer_request_pending[s]) {
+            if (sequencer_requests[s].target != SEQUENCER_TARGET_NOTE) {
+                release_sequencer_note(seq);
+            }
+            sequencer_set_pattern(seq, &sequencer_requests[s]);
+            sequencer_request_pending[s] = false;
+            retempo = true;
+        }
+    }
+    if (retempo) {
+        for (int s = 0; s < OSCILLATOR_LOGIC_SEQUENCER_COUNT; s++) {
+            sequencer_set_tempo(&sequencers[s], active_bpm, rate);
+        }
+    }
+
+    bool running = requested_sequencers_running;
+    if (running != sequencers_running) {
+        sequencers_running = running;
+        if (running) {
+            capture_voice_patch();
+        }
+        for (int s = 0; s < OSCILLATOR_LOGIC_SEQUENCER_COUNT; s++) {
+            if (running) {
+                sequencer_start(&sequencers[s]);
+            } else {
+                sequencer_stop(&sequencers[s]);
+                release_sequencer_note(&sequencers[s]);
+            }
+        }
+        ESP_LOGI(TAG, "Sequencers %s at %.1f BPM", running ? "started" : "stopped", active_bpm);
+    }
+}
+
+static void sequencer_step_callback(void* ctx, sequencer_t* seq, int step, uint32_t offset)
+{
+    (void)ctx;
+    if (block_event_count < SEQUENCER_MAX_BLOCK_EVENTS) {
+        block_events[block_event_count++] = (sequencer_event_t){
+            .offset = offset,
+            .sequencer = (int)(seq - sequencers),
+            .step = step,
+        };
+    }
+}
 
-// Initialize logical operators
-static logical_ops_t logical_ops[3];
+// шаги всех секвенсоров внутри блока по времени
+static void collect_sequencer_events(size_t n_bits)
+{
+    block_event_count = 0;
+    for (int s = 0; s < OSCILLATOR_LOGIC_SEQUENCER_COUNT; s++) {
+        sequencer_advance(&sequencers[s], (uint32_t)n_bits, sequencer_step_callback, NULL);
+    }
+    for (size_t i = 1; i < block_event_count; i++) {
+        sequencer_event_t event = block_events[i];
+        size_t j = i;
+        for (; j > 0 && block_events[j - 1].offset > event.offset; j--) {
+            block_events[j] = block_events[j - 1];
+        }
+        block_events[j] = event;
+    }
+}
 
-// Get oscillators array
-Oscillator* oscillator_logic_get_oscillators(void) {
-    return oscillators;
+static void apply_sequencer_step(const sequencer_event_t* event)
+{
+    sequencer_t* seq = &sequencers[event->sequencer];
+    const sequencer_pattern_t* pattern = &seq->pattern;
+    bool gate = sequencer_step_gate(seq, event->step);
+    double value = pattern->values[event->step];
+    int index = pattern->target_index;
+
+    switch (pattern->target) {
+    case SEQUENCER_TARGET_FREQUENCY:
+        if (gate && value > 0.0) {
+            oscillator_set_frequency(&oscillators[index], value);
+        }
+        break;
+    case SEQUENCER_TARGET_OPERATION:
+        if (gate && value >= 0.0 && value < LOGICAL_OP_COUNT) {
+            logical_ops_set_operation(&logical_ops[index], (logical_op_t)value);
+        }
+        break;
+    case SEQUENCER_TARGET_NOTE:
+        // нота звучит до следующего шага, шаг без гейта - пауза
+        release_sequencer_note(seq);
+        if (gate && voice_pool_note_on(&voice_pool, (int)value) >= 0) {
+            seq->held_note = (int)value;
+        }
+        break;
+    case SEQUENCER_TARGET_MIXER_WEIGHT:
+        if (gate) {
+            dac_mixer_set_weight(&mixer, index, (int16_t)value);
+        }
+        break;
+    default:
+        break;
+    }
 }
 
-// Get logical operations array
-logical_ops_t* oscillator_logic_get_logical_ops(void) {
-    return logical_ops;
+// Блок с шагами секвенсоров: граф считается отрезками, шаг применяется в
+// начале своего 32-битного слова (и целого выходного отсчета), так что
+// позиция шага точна до слова движка и не зависит от сети.
+static void render_sequenced(size_t n_bits, int factor)
+{
+    size_t grain = PACKED_WORD_BITS;
+    while (grain % factor != 0) {
+        grain += PACKED_WORD_BITS;
+    }
+
+    size_t pos = 0;
+    size_t e = 0;
+    while (pos < n_bits) {
+        while (e < block_event_count && block_events[e].offset / grain * grain <= pos) {
+            apply_sequencer_step(&block_events[e++]);
+        }
+        size_t end = e < block_event_count ? block_events[e].offset / grain * grain : n_bits;
+        if (pos == 0 && end == n_bits) {
+            render_graph(n_bits, 0, factor);
+            return;
+        }
+
+        render_graph(end - pos, pos, factor);
+        for (int n = 0; n < OSCILLATOR_LOGIC_NODE_COUNT; n++) {
+            memcpy(&segment_words[n][pos / PACKED_WORD_BITS], node_words[n],
+                   PACKED_WORDS(end - pos) * sizeof(uint32_t));
+        }
+        pos = end;
+    }
+    for (int n = 0; n < OSCILLATOR_LOGIC_NODE_COUNT; n++) {
+        memcpy(node_words[n], segment_words[n], PACKED_WORDS(n_bits) * sizeof(uint32_t));
+    }
 }
 
-// Timer callback function that processes oscillator outputs and applies logical operations
+void oscillator_logic_render_block(void)
+{
+    int factor = requested_oversampling;
+    if (factor != active_oversampling) {
+        apply_oversampling(factor);
+    }
+    size_t n_bits = (size_t)OSCILLATOR_LOGIC_BLOCK_SIZE * factor;
+    apply_sweep_requests(factor);
+    apply_modulation_requests();
+    apply_logic_requests();
+    apply_mixer_requests();
+    apply_divider_requests();
+    apply_lfsr_requests();
+    apply_flip_flop_requests();
+    apply_multiplexer_requests();
+    if (delay_taps_pending) {
+        apply_delay_taps(factor);
+    }
+
+    apply_tap_requests();
+
+    segment_block_bits = n_bits;
+    apply_mod_requests();
+    apply_mod_matrix(n_bits);
+    apply_sequencer_requests(factor);
+    apply_note_events();
+    collect_sequencer_events(n_bits);
+    if (block_event_count == 0) {
+        render_graph(n_bits, 0, factor);
+    } else {
+        render_sequenced(n_bits, factor);
+    }
+    capture_taps(n_bits);
+    capture_node_words(n_bits, factor);
+    count_node_stats(n_bits);
+
+    bool mixer_used = false;
+    for (int i = 0; i < OUTPUT_MAX_INSTANCES; i++) {
+        if (output_handles[i] && output_routes[i].node_id == OSCILLATOR_LOGIC_MIXER_NODE) {
+            mixer_used = true;
+        }
+    }
+    if (mixer_used) {
+        render_mixer(n_bits);
+    }
+
+    for (int i = 0; i < OUTPUT_MAX_INSTANCES; i++) {
+        if (!output_handles[i]) continue;
+
+        route_render_t* render = &route_render[i];
+        int node = output_routes[i].node_id;
+        bool is_mixer = (node == OSCILLATOR_LOGIC_MIXER_NODE);
+        if (node != render->active_node) {
+            decimator_init(&render->decimator, factor, is_mixer ? DECIMATOR_INPUT_PCM : DECIMATOR_INPUT_BITS);
+            render->active_node = node;
+        }
+
+        int16_t pcm[OSCILLATOR_LOGIC_BLOCK_SIZE];
+        size_t produced = is_mixer
+            ? decimator_process_pcm(&render->decimator, mixer_block, n_bits, pcm, OSCILLATOR_LOGIC_BLOCK_SIZE)
+            : decimator_process_bits(&render->decimator, node_words[node], n_bits, pcm, OSCILLATOR_LOGIC_BLOCK_SIZE);
+        for (size_t k = 0; k < produced; k++) {
+            render->block[k] = (int8_t)(pcm[k] >> 8);
+            render->pcm_block[k] = pcm[k];
+        }
+    }
+}
+
+// Timer callback, one output sample per call; a new block is rendered every OSCILLATOR_LOGIC_BLOCK_SIZE calls
 void oscillator_logic_next_bool(void)
 {
-    
-    //  ESP_LOGI(TAG, "---Processing oscillator logic---");
-    // Calculate boolean values
-    oscillator_calculate_bool(&oscillators[0]);
-    oscillator_calculate_bool(&oscillators[1]);
-    oscillator_calculate_bool(&oscillators[2]);
-    oscillator_calculate_bool(&oscillators[3]);
+    if (!engine_enabled) {
+        return;
+    }
+
+    if (block_pos >= OSCILLATOR_LOGIC_BLOCK_SIZE) {
+        oscillator_logic_render_block();
+        block_pos = 0;
+    }
+
+    for (int i = 0; i < OUTPUT_MAX_INSTANCES; i++) {
+        route_render[i].value = route_render[i].block[block_pos];
+        route_render[i].pcm_value = route_render[i].pcm_block[block_pos];
+    }
+    block_pos++;
+}
+
+esp_err_t oscillator_logic_set_oversampling(int factor)
+{
+    if (factor < OSCILLATOR_LOGIC_MIN_OVERSAMPLING || factor > OSCILLATOR_LOGIC_MAX_OVERSAMPLING) {
+        ESP_LOGE(TAG, "Invalid oversampling factor %d", factor);
+        return ESP_ERR_INVALID_ARG;
+    }
+    requested_oversampling = factor;
+    return ESP_OK;
+}
+
+int oscillator_logic_get_oversampling(void)
+{
+    return requested_oversampling;
+}
+
+esp_err_t oscillator_logic_set_engine(oscillator_logic_engine_t engine)
+{
+    if (engine != OSCILLATOR_LOGIC_ENGINE_BLOCK && engine != OSCILLATOR_LOGIC_ENGINE_EDGE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    requested_engine = engine;
+    return ESP_OK;
+}
+
+oscillator_logic_engine_t oscillator_logic_get_engine(void)
+{
+    return requested_engine;
+}
+
+oscillator_logic_engine_t oscillator_logic_get_active_engine(void)
+{
+    return active_engine;
+}
+
+esp_err_t oscillator_logic_set_taps(const int* node_ids, int count)
+{
+    if (count < 0 || count > OSCILLATOR_LOGIC_MAX_TAPS || (count > 0 && !node_ids)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int t = 0; t < count; t++) {
+        if (node_ids[t] < -1 || node_ids[t] >= OSCILLATOR_LOGIC_NODE_COUNT) {
+            ESP_LOGE(TAG, "Invalid tap node %d", node_ids[t]);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    tap_request_pending = false;
+    for (int t = 0; t < OSCILLATOR_LOGIC_MAX_TAPS; t++) {
+        tap_requests[t] = t < count ? node_ids[t] : -1;
+    }
+    tap_request_pending = true;
+    return ESP_OK;
+}
+
+int oscillator_logic_get_tap_node(int tap)
+{
+    if (tap < 0 || tap >= OSCILLATOR_LOGIC_MAX_TAPS) return -1;
+    return tap_request_pending ? tap_requests[tap] : taps[tap].node_id;
+}
+
+size_t oscillator_logic_read_tap(int tap, uint32_t* words, size_t max_words, int* node_id)
+{
+    if (node_id) *node_id = -1;
+    if (tap < 0 || tap >= OSCILLATOR_LOGIC_MAX_TAPS || !words) return 0;
+
+    node_tap_t* t = &taps[tap];
+    uint32_t head = t->head;
+    __sync_synchronize();
+    // start и узел берутся вместе: смена узла между ними - повтор
+    uint32_t start;
+    int node;
+    do {
+        start = t->start;
+        node = t->node_id;
+        __sync_synchronize();
+    } while (start != t->start);
+
+    uint32_t tail = tap_live_tail(t);
+    // узел сменился уже после head: слов нового узла еще нет
+    size_t count = (int32_t)(head - tail) > 0 ? head - tail : 0;
+    if (count > max_words) count = max_words;
+    for (size_t k = 0; k < count; k++) {
+        words[k] = t->ring[(tail + k) % OSCILLATOR_LOGIC_TAP_RING_WORDS];
+    }
+    t->tail = tail + count;
+    if (node_id) *node_id = node;
+    return count;
+}
+
+uint32_t oscillator_logic_get_tap_dropped(int tap)
+{
+    if (tap < 0 || tap >= OSCILLATOR_LOGIC_MAX_TAPS) return 0;
+    return taps[tap].dropped;
+}
+
+int oscillator_logic_get_node_stats(oscillator_logic_node_stats_t* stats, int max_nodes)
+{
+    if (!stats || max_nodes <= 0) return 0;
+
+    int count = max_nodes < OSCILLATOR_LOGIC_NODE_COUNT ? max_nodes : OSCILLATOR_LOGIC_NODE_COUNT;
+    uint32_t seq;
+    do {
+        seq = stats_seq;
+        __sync_synchronize();
+        memcpy(stats, stats_published, count * sizeof(oscillator_logic_node_stats_t));
+        __sync_synchronize();
+    } while ((seq & 1u) || seq != stats_seq);
+    return stats[0].samples > 0 ? count : 0;
+}
+
+esp_err_t oscillator_logic_request_capture(int node_id)
+{
+    if (node_id < 0 || node_id >= OSCILLATOR_LOGIC_NODE_COUNT) {
+        ESP_LOGE(TAG, "Invalid capture node %d", node_id);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    capture_ready = false;
+    capture_request_node = node_id;
+    capture_pending = true;
+    return ESP_OK;
+}
+
+const uint32_t* oscillator_logic_get_capture(size_t* bits, int* factor)
+{
+    if (capture_pending || !capture_ready) return NULL;
+
+    __sync_synchronize();
+    if (bits) *bits = capture_fill * PACKED_WORD_BITS;
+    if (factor) *factor = capture_factor;
+    return capture_words;
+}
+
+
+static bool modulation_source_valid(int source)
+{
+    return source >= -1 && source < OSCILLATOR_LOGIC_NODE_COUNT;
+}
+
+esp_err_t oscillator_logic_set_modulation(int oscillator_id, const oscillator_logic_modulation_t* modulation)
+{
+    if (oscillator_id < 0 || oscillator_id >= OSCILLATOR_LOGIC_OSCILLATOR_COUNT || !modulation) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!modulation_source_valid(modulation->fm_source) || !modulation_source_valid(modulation->sync_source)) {
+        ESP_LOGE(TAG, "Invalid modulation source for oscillator %d", oscillator_id);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    double max_depth;
+    switch (modulation->fm_mode) {
+        case OSCILLATOR_LOGIC_FM_LINEAR:
+            max_depth = 1.0;
+            break;
+        case OSCILLATOR_LOGIC_FM_EXPONENTIAL:
+            max_depth = OSCILLATOR_LOGIC_MAX_FM_OCTAVES;
+            break;
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+    if (modulation->fm_depth < 0.0 || modulation->fm_depth > max_depth) {
+        ESP_LOGE(TAG, "Invalid FM depth %.3f for oscillator %d", modulation->fm_depth, oscillator_id);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // рендер подхватит модуляцию целиком в начале следующего блока
+    modulation_request_pending[oscillator_id] = false;
+    modulation_requests[oscillator_id] = *modulation;
+    modulation_request_pending[oscillator_id] = true;
+    ESP_LOGI(TAG, "Oscillator %d modulation: fm %d depth %.3f, sync %d", oscillator_id,
+             modulation->fm_source, modulation->fm_depth, modulation->sync_source);
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_get_modulation(int oscillator_id, oscillator_logic_modulation_t* modulation)
+{
+    if (oscillator_id < 0 || oscillator_id >= OSCILLATOR_LOGIC_OSCILLATOR_COUNT || !modulation) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // еще не примененный запрос уже считается текущей модуляцией
+    *modulation = modulation_request_pending[oscillator_id]
+        ? modulation_requests[oscillator_id]
+        : modulations[oscillator_id];
+    return ESP_OK;
+}
+
+// частота, которую движок может держать на любом oversampling
+static bool frequency_valid(double frequency)
+{
+    return isfinite(frequency) && frequency > 0.0
+        && frequency <= (double)SYSTEM_SAMPLE_RATE * OSCILLATOR_LOGIC_MAX_OVERSAMPLING / 2.0;
+}
+
+esp_err_t oscillator_logic_start_sweep(int oscillator_id, const oscillator_logic_sweep_t* sweep)
+{
+    if (oscillator_id < 0 || oscillator_id >= OSCILLATOR_LOGIC_OSCILLATOR_COUNT || !sweep) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // длительность ограничена, чтобы число отсчетов влезло в remaining
+    if (!frequency_valid(sweep->start_frequency) || !frequency_valid(sweep->end_frequency)
+        || !(sweep->duration_ms >= 0.0 && sweep->duration_ms <= OSCILLATOR_LOGIC_MAX_SWEEP_MS)
+        || (sweep->shape != OSCILLATOR_LOGIC_SWEEP_LINEAR && sweep->shape != OSCILLATOR_LOGIC_SWEEP_EXPONENTIAL)) {
+        ESP_LOGE(TAG, "Invalid sweep for oscillator %d", oscillator_id);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    sweeps[oscillator_id].pending = SWEEP_REQUEST_NONE;
+    sweeps[oscillator_id].request = *sweep;
+    sweeps[oscillator_id].pending = SWEEP_REQUEST_START;
+    ESP_LOGI(TAG, "Oscillator %d sweep %.1f -> %.1f Hz in %.1f ms", oscillator_id,
+             sweep->start_frequency, sweep->end_frequency, sweep->duration_ms);
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_stop_sweep(int oscillator_id)
+{
+    if (oscillator_id < 0 || oscillator_id >= OSCILLATOR_LOGIC_OSCILLATOR_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sweeps[oscillator_id].pending = SWEEP_REQUEST_STOP;
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_get_sweep_status(int oscillator_id, oscillator_logic_sweep_status_t* status)
+{
+    if (oscillator_id < 0 || oscillator_id >= OSCILLATOR_LOGIC_OSCILLATOR_COUNT || !status) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const sweep_state_t* sweep = &sweeps[oscillator_id];
+    status->active = sweep->active;
+    status->frequency = sweep->active ? sweep->frequency : oscillators[oscillator_id].frequency;
+    status->end_frequency = sweep->end_frequency;
+    status->remaining_ms = sweep->active
+        ? 1000.0 * sweep->remaining / ((double)SYSTEM_SAMPLE_RATE * active_oversampling)
+        : 0.0;
+    return ESP_OK;
+}
+
+// вход узла: -1 не подключен, иначе узел с результатом
+static bool node_input_valid(int node_id)
+{
+    return node_id == -1 || oscillator_logic_get_node_result_pointer(node_id) != NULL;
+}
+
+esp_err_t oscillator_logic_set_logical_op(int index, logical_op_t operation, int input1_id, int input2_id)
+{
+    if (index < 0 || index >= OSCILLATOR_LOGIC_LOGICAL_OP_COUNT
+        || (int)operation < 0 || operation >= LOGICAL_OP_COUNT
+        || !oscillator_logic_get_node_result_pointer(input1_id)
+        || !oscillator_logic_get_node_result_pointer(input2_id)) {
+        ESP_LOGE(TAG, "Invalid logical operation %d or inputs %d, %d", index, input1_id, input2_id);
+        return ESP_ERR_INVALID_ARG;
+    }
+    logic_request_pending[index] = false;
+    logic_requests[index] = (logic_request_t){ .operation = operation, .input_ids = { input1_id, input2_id } };
+    logic_request_pending[index] = true;
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_get_mixer_input(int index, oscillator_logic_mixer_input_t* input)
+{
+    if (index < 0 || index >= DAC_MIXER_MAX_INPUTS || !input) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (mixer_request_pending[index]) {
+        *input = mixer_requests[index];
+        return ESP_OK;
+    }
+    *input = (oscillator_logic_mixer_input_t){
+        .node_id = mixer.input_ids[index],
+        .weight = mixer.weights[index],
+        .delay = mixer.delays[index],
+    };
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_set_mixer_input(int index, const oscillator_logic_mixer_input_t* input)
+{
+    if (index < 0 || index >= DAC_MIXER_MAX_INPUTS || !input || !node_input_valid(input->node_id)
+        || input->delay < 0 || input->delay > DAC_MIXER_MAX_DELAY) {
+        ESP_LOGE(TAG, "Invalid mixer input %d settings", index);
+        return ESP_ERR_INVALID_ARG;
+    }
+    mixer_request_pending[index] = false;
+    mixer_requests[index] = *input;
+    mixer_request_pending[index] = true;
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_set_divider_clock(int index, int clock_node)
+{
+    if (index < 0 || index >= OSCILLATOR_LOGIC_DIVIDER_COUNT || !node_input_valid(clock_node)) {
+        ESP_LOGE(TAG, "Invalid divider %d or clock node %d", index, clock_node);
+        return ESP_ERR_INVALID_ARG;
+    }
+    divider_clock_pending[index] = false;
+    divider_clock_requests[index] = clock_node;
+    divider_clock_pending[index] = true;
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_reset_divider(int index)
+{
+    if (index < 0 || index >= OSCILLATOR_LOGIC_DIVIDER_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    divider_reset_pending[index] = true;
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_set_lfsr_length(int index, int length, uint64_t taps)
+{
+    if (index < 0 || index >= OSCILLATOR_LOGIC_LFSR_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // проверка и выбор отводов по таблице на копии, живой регистр не трогается
+    lfsr_t probe;
+    lfsr_init(&probe);
+    esp_err_t err = lfsr_set_length(&probe, length > 0 ? length : lfsr_requests[index].length, taps);
+    if (err != ESP_OK) {
+        return err;
+    }
+    lfsr_length_pending[index] = false;
+    lfsr_requests[index].length = probe.length;
+    lfsr_requests[index].taps = probe.taps;
+    lfsr_length_pending[index] = true;
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_set_lfsr_clock(int index, int clock_node)
+{
+    if (index < 0 || index >= OSCILLATOR_LOGIC_LFSR_COUNT
+        || !node_input_valid(clock_node)) {
+        ESP_LOGE(TAG, "Invalid LFSR %d or clock node %d", index, clock_node);
+        return ESP_ERR_INVALID_ARG;
+    }
+    lfsr_clock_pending[index] = false;
+    lfsr_requests[index].clock_id = clock_node;
+    lfsr_clock_pending[index] = true;
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_seed_lfsr(int index, uint64_t seed)
+{
+    if (index < 0 || index >= OSCILLATOR_LOGIC_LFSR_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    lfsr_seed_pending[index] = false;
+    lfsr_requests[index].seed = seed;
+    lfsr_seed_pending[index] = true;
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_get_flip_flop_config(int index, oscillator_logic_flip_flop_config_t* config)
+{
+    if (index < 0 || index >= OSCILLATOR_LOGIC_FLIP_FLOP_COUNT || !config) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // еще не примененный запрос уже считается текущей настройкой
+    if (flip_flop_request_pending[index]) {
+        *config = flip_flop_requests[index];
+        return ESP_OK;
+    }
+    const flip_flop_t* ff = &flip_flops[index];
+    *config = (oscillator_logic_flip_flop_config_t){
+        .type = ff->type,
+        .edge = ff->edge,
+        .input_ids = { ff->input_ids[0], ff->input_ids[1] },
+        .clock_id = ff->clock_id,
+    };
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_set_flip_flop(int index, const oscillator_logic_flip_flop_config_t* config)
+{
+    if (index < 0 || index >= OSCILLATOR_LOGIC_FLIP_FLOP_COUNT || !config
+        || (int)config->type < 0 || config->type >= FLIP_FLOP_TYPE_COUNT
+        || (int)config->edge < 0 || config->edge >= FLIP_FLOP_EDGE_COUNT
+        || !node_input_valid(config->input_ids[0]) || !node_input_valid(config->input_ids[1])
+        || !node_input_valid(config->clock_id)) {
+        ESP_LOGE(TAG, "Invalid flip-flop %d settings", index);
+        return ESP_ERR_INVALID_ARG;
+    }
+    flip_flop_request_pending[index] = false;
+    flip_flop_requests[index] = *config;
+    flip_flop_request_pending[index] = true;
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_get_multiplexer_config(int index, oscillator_logic_multiplexer_config_t* config)
+{
+    if (index < 0 || index >= OSCILLATOR_LOGIC_MULTIPLEXER_COUNT || !config) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (multiplexer_request_pending[index]) {
+        *config = multiplexer_requests[index];
+        return ESP_OK;
+    }
+    memcpy(config->input_ids, multiplexers[index].input_ids, sizeof(config->input_ids));
+    memcpy(config->select_ids, multiplexers[index].select_ids, sizeof(config->select_ids));
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_set_multiplexer(int index, const oscillator_logic_multiplexer_config_t* config)
+{
+    if (index < 0 || index >= OSCILLATOR_LOGIC_MULTIPLEXER_COUNT || !config) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    bool valid = true;
+    for (int k = 0; k < MULTIPLEXER_MAX_INPUTS; k++) {
+        valid = valid && node_input_valid(config->input_ids[k]);
+    }
+    for (int b = 0; b < MULTIPLEXER_SELECT_BITS; b++) {
+        valid = valid && node_input_valid(config->select_ids[b]);
+    }
+    if (!valid) {
+        ESP_LOGE(TAG, "Invalid multiplexer %d connections", index);
+        return ESP_ERR_INVALID_ARG;
+    }
+    multiplexer_request_pending[index] = false;
+    multiplexer_requests[index] = *config;
+    multiplexer_request_pending[index] = true;
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_set_delay_tap(int tap, double delay_ms)
+{
+    if (tap < 0 || tap >= DELAY_LINE_MAX_TAPS || !(delay_ms > 0.0) || delay_ms > oscillator_logic_get_max_delay_ms()) {
+        ESP_LOGE(TAG, "Invalid delay tap %d or delay %.3f ms", tap, delay_ms);
+        return ESP_ERR_INVALID_ARG;
+    }
+    delay_tap_ms[tap] = delay_ms;
+    delay_taps_pending = true;
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_set_delay_input(int node_id)
+{
+    if (!node_input_valid(node_id)) {
+        ESP_LOGE(TAG, "Invalid delay input node %d", node_id);
+        return ESP_ERR_INVALID_ARG;
+    }
+    delay_input_request = node_id;
+    delay_taps_pending = true;
+    return ESP_OK;
+}
+
+int oscillator_logic_get_delay_input(void)
+{
+    return delay_input_request;
+}
+
+void oscillator_logic_clear_delay_line(void)
+{
+    delay_clear_request = true;
+    delay_taps_pending = true;
+}
+
+double oscillator_logic_get_delay_tap(int tap)
+{
+    if (tap < 0 || tap >= DELAY_LINE_MAX_TAPS) {
+        return -1.0;
+    }
+    return delay_tap_ms[tap];
+}
+
+double oscillator_logic_get_max_delay_ms(void)
+{
+    return 1000.0 * ((OSCILLATOR_LOGIC_DELAY_WORDS - 1) * PACKED_WORD_BITS) /
+           ((double)SYSTEM_SAMPLE_RATE * requested_oversampling);
+}
+
+esp_err_t oscillator_logic_note_on(int note)
+{
+    if (note < 0 || note > VOICE_POOL_MAX_NOTE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return queue_note_event(NOTE_EVENT_ON, note);
+}
+
+esp_err_t oscillator_logic_note_off(int note)
+{
+    if (note < 0 || note > VOICE_POOL_MAX_NOTE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return queue_note_event(NOTE_EVENT_OFF, note);
+}
+
+esp_err_t oscillator_logic_all_notes_off(void)
+{
+    return queue_note_event(NOTE_EVENT_ALL_OFF, 0);
+}
+
+const sequencer_t* oscillator_logic_get_sequencers(void)
+{
+    return sequencers;
+}
+
+// значение шага должно приводиться к типу цели без неопределенного поведения
+static bool sequencer_value_valid(sequencer_target_t target, double value)
+{
+    if (!isfinite(value)) return false;
+    switch (target) {
+    case SEQUENCER_TARGET_FREQUENCY:
+        // 0 и меньше - шаг без смены частоты
+        return value <= 0.0 || frequency_valid(value);
+    case SEQUENCER_TARGET_OPERATION:
+        return value >= 0.0 && value < LOGICAL_OP_COUNT;
+    case SEQUENCER_TARGET_NOTE:
+        return value >= 0.0 && value <= VOICE_POOL_MAX_NOTE;
+    case SEQUENCER_TARGET_MIXER_WEIGHT:
+        return value >= INT16_MIN && value <= INT16_MAX;
+    default:
+        return true;
+    }
+}
+
+esp_err_t oscillator_logic_validate_sequencer_pattern(const sequencer_pattern_t* pattern)
+{
+    if (sequencer_validate_pattern(pattern) != ESP_OK) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // номер цели должен существовать для своего типа
+    int limit = 1;
+    switch (pattern->target) {
+    case SEQUENCER_TARGET_FREQUENCY: limit = OSCILLATOR_LOGIC_OSCILLATOR_COUNT; break;
+    case SEQUENCER_TARGET_OPERATION: limit = OSCILLATOR_LOGIC_LOGICAL_OP_COUNT; break;
+    case SEQUENCER_TARGET_MIXER_WEIGHT: limit = DAC_MIXER_MAX_INPUTS; break;
+    default: break;
+    }
+    if (pattern->target_index >= limit) {
+        ESP_LOGE(TAG, "Invalid target index %d for %s", pattern->target_index,
+                 sequencer_get_target_name(pattern->target));
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int step = 0; step < pattern->length; step++) {
+        if (!sequencer_value_valid(pattern->target, pattern->values[step])) {
+            ESP_LOGE(TAG, "Invalid value %.3f in step %d for %s", pattern->values[step], step,
+                     sequencer_get_target_name(pattern->target));
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_set_sequencer_pattern(int index, const sequencer_pattern_t* pattern)
+{
+    if (index < 0 || index >= OSCILLATOR_LOGIC_SEQUENCER_COUNT || oscillator_logic_validate_sequencer_pattern(pattern) != ESP_OK) {
+        ESP_LOGE(TAG, "Invalid sequencer %d or pattern", index);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    sequencer_requests[index] = *pattern;
+    sequencer_request_pending[index] = true;
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_set_tempo(double bpm)
+{
+    if (!(bpm >= SEQUENCER_MIN_BPM && bpm <= SEQUENCER_MAX_BPM)) {
+        ESP_LOGE(TAG, "Invalid tempo %.1f BPM", bpm);
+        return ESP_ERR_INVALID_ARG;
+    }
+    tempo_request_pending = false;
+    requested_bpm = bpm;
+    tempo_request_pending = true;
+    return ESP_OK;
+}
+
+double oscillator_logic_get_tempo(void)
+{
+    return requested_bpm;
+}
+
+void oscillator_logic_set_sequencers_running(bool running)
+{
+    requested_sequencers_running = running;
+}
+
+bool oscillator_logic_get_sequencers_running(void)
+{
+    return requested_sequencers_running;
+}
+
+void oscillator_logic_get_mod_matrix(mod_matrix_t* matrix)
+{
+    if (!matrix) return;
+
+    *matrix = mod_matrix;
+    // настройки - последние заданные, даже если блок их еще не применил
+    for (int l = 0; l < MOD_MATRIX_LFOS; l++) {
+        matrix->lfos[l].shape = mod_requests.lfos[l].shape;
+        matrix->lfos[l].rate = mod_requests.lfos[l].rate;
+    }
+    for (int e = 0; e < MOD_MATRIX_ENVELOPES; e++) {
+        const mod_matrix_envelope_t* env = &mod_requests.envelopes[e];
+        matrix->envelopes[e].attack_ms = env->attack_ms;
+        matrix->envelopes[e].decay_ms = env->decay_ms;
+        matrix->envelopes[e].sustain = env->sustain;
+        matrix->envelopes[e].release_ms = env->release_ms;
+        matrix->envelopes[e].gate_id = env->gate_id;
+    }
+    memcpy(matrix->routes, mod_requests.routes, sizeof(matrix->routes));
+}
+
+esp_err_t oscillator_logic_set_mod_lfo(int index, mod_matrix_lfo_shape_t shape, double rate)
+{
+    if (index < 0 || index >= MOD_MATRIX_LFOS) {
+        ESP_LOGE(TAG, "Invalid LFO %d", index);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mod_lfo_pending[index] = false;
+    esp_err_t err = mod_matrix_set_lfo(&mod_requests, index, shape, rate);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Invalid shape %d or rate %.3f for LFO %d", shape, rate, index);
+        return err;
+    }
+    mod_lfo_pending[index] = true;
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_set_mod_envelope(int envelope, double attack_ms, double decay_ms, double sustain, double release_ms)
+{
+    if (envelope < 0 || envelope >= MOD_MATRIX_ENVELOPES) {
+        ESP_LOGE(TAG, "Invalid envelope %d", envelope);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    mod_envelope_pending[envelope] = false;
+    esp_err_t err = mod_matrix_set_envelope(&mod_requests, envelope, attack_ms, decay_ms, sustain, release_ms);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Invalid times or sustain for envelope %d", envelope);
+        return err;
+    }
+    mod_envelope_pending[envelope] = true;
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_set_mod_route(int slot, const mod_matrix_route_t* route)
+{
+    if (!route || slot < 0 || slot >= MOD_MATRIX_MAX_ROUTES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (route->active) {
+        bool frequency = route->dest == MOD_MATRIX_DEST_FREQUENCY;
+        int limit = frequency ? OSCILLATOR_LOGIC_OSCILLATOR_COUNT : DAC_MIXER_MAX_INPUTS;
+        double max_depth = frequency ? OSCILLATOR_LOGIC_MAX_FM_OCTAVES : 1.0;
+        if (route->dest_index >= limit || !(fabs(route->depth) <= max_depth)) {
+            ESP_LOGE(TAG, "Invalid destination %d or depth %.3f for route %d", route->dest_index, route->depth, slot);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    mod_route_pending[slot] = false;
+    esp_err_t err = mod_matrix_set_route(&mod_requests, slot, route);
+    if (err != ESP_OK) {
+        return err;
+    }
+    mod_route_pending[slot] = true;
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_set_mod_envelope_gate(int envelope, int node_id)
+{
+    if (envelope < 0 || envelope >= MOD_MATRIX_ENVELOPES || node_id < -1 || node_id >= OSCILLATOR_LOGIC_NODE_COUNT) {
+        ESP_LOGE(TAG, "Invalid envelope %d or gate node %d", envelope, node_id);
+        return ESP_ERR_INVALID_ARG;
+    }
 
-    // ESP_LOGI(TAG, "osc1_value: %d", oscillators[0].result_bool);
-    
-    // Calculate operator results
-    logical_ops_calculate(&logical_ops[0]);
-    logical_ops_calculate(&logical_ops[1]);
-    logical_ops_calculate(&logical_ops[2]);
+    mod_gate_pending[envelope] = false;
+    mod_requests.envelopes[envelope].gate_id = node_id;
+    mod_gate_pending[envelope] = true;
+    return ESP_OK;
+}
+
+esp_err_t oscillator_logic_set_enabled(bool enabled)
+{
+    engine_enabled = enabled;
+    return ESP_OK;
+}
 
-    // ESP_LOGI(TAG, "result1: %d", logical_ops[0].result);
+esp_err_t oscillator_logic_get_enabled(bool *enabled)
+{
+    if (!enabled) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *enabled = engine_enabled;
+    return ESP_OK;
 }
 
 esp_err_t oscillator_logic_init(void) {
@@ -54,6 +2457,16 @@ esp_err_t oscillator_logic_init(void) {
     oscillator_init(&oscillators[2], 2, 460.0, 1.0, OSCILLATOR_TYPE_SQUARE_BOOL);
     oscillator_init(&oscillators[3], 3, 220.0, 1.0, OSCILLATOR_TYPE_SQUARE_BOOL);
 
+    // без модуляции: осцилляторы независимы
+    for (int i = 0; i < OSCILLATOR_LOGIC_OSCILLATOR_COUNT; i++) {
+        modulations[i] = (oscillator_logic_modulation_t){
+            .fm_source = -1,
+            .fm_mode = OSCILLATOR_LOGIC_FM_EXPONENTIAL,
+            .fm_depth = 0.0,
+            .sync_source = -1,
+        };
+    }
+
     bool* osc1_result = oscillator_get_result_bool_pointer(&oscillators[0]);
     bool* osc2_result = oscillator_get_result_bool_pointer(&oscillators[1]);
     bool* osc3_result = oscillator_get_result_bool_pointer(&oscillators[2]);
@@ -82,12 +2495,76 @@ esp_err_t oscillator_logic_init(void) {
     bool* result2 = logical_ops_get_result_pointer(&logical_ops[1]);
     logical_ops_set_inputs(&logical_ops[2], result1, result2, 4, 5);
 
+    ESP_LOGI(TAG, "---Initializing frequency dividers---");
+    // делители без такта, пока их не подключат через API
+    for (int d = 0; d < OSCILLATOR_LOGIC_DIVIDER_COUNT; d++) {
+        frequency_divider_init(&dividers[d]);
+        for (int stage = 0; stage < FREQUENCY_DIVIDER_STAGES; stage++) {
+            divider_outputs[d][stage] = node_words[OSCILLATOR_LOGIC_FIRST_DIVIDER_NODE + d * FREQUENCY_DIVIDER_STAGES + stage];
+        }
+    }
+
+    ESP_LOGI(TAG, "---Initializing LFSR noise sources---");
+    // разные затравки, чтобы два генератора не шли в одной фазе
+    for (int l = 0; l < OSCILLATOR_LOGIC_LFSR_COUNT; l++) {
+        lfsr_init(&lfsrs[l]);
+        lfsr_seed(&lfsrs[l], 0xD1B54A32D192ED03ull * (uint64_t)(l + 1));
+        lfsr_requests[l] = (lfsr_request_t){ .length = lfsrs[l].length, .taps = lfsrs[l].taps, .clock_id = -1 };
+    }
+
+    ESP_LOGI(TAG, "---Initializing flip-flops---");
+    // триггеры без входов и такта, пока их не подключат через API
+    for (int f = 0; f < OSCILLATOR_LOGIC_FLIP_FLOP_COUNT; f++) {
+        flip_flop_init(&flip_flops[f]);
+    }
+
+    ESP_LOGI(TAG, "---Initializing delay line---");
+    // без входа, отводы получают задержки перед первым блоком
+    delay_line_init(&delay_line, delay_buffer, OSCILLATOR_LOGIC_DELAY_WORDS);
+    for (int t = 0; t < DELAY_LINE_MAX_TAPS; t++) {
+        delay_outputs[t] = node_words[OSCILLATOR_LOGIC_FIRST_DELAY_NODE + t];
+    }
+
+    ESP_LOGI(TAG, "---Initializing multiplexers---");
+    for (int m = 0; m < OSCILLATOR_LOGIC_MULTIPLEXER_COUNT; m++) {
+        multiplexer_init(&multiplexers[m]);
+    }
+
+    ESP_LOGI(TAG, "---Initializing voice pool---");
+    voice_pool_init(&voice_pool, OSCILLATOR_LOGIC_VOICE_COUNT,
+                    (double)SYSTEM_SAMPLE_RATE * OSCILLATOR_LOGIC_DEFAULT_OVERSAMPLING);
+
+    ESP_LOGI(TAG, "---Initializing sequencers---");
+    for (int s = 0; s < OSCILLATOR_LOGIC_SEQUENCER_COUNT; s++) {
+        sequencer_init(&sequencers[s]);
+    }
+
+    ESP_LOGI(TAG, "---Initializing modulation matrix---");
+    // без маршрутов: множители частоты 1, веса микшера как заданы
+    mod_matrix_init(&mod_matrix);
+    mod_matrix_init(&mod_requests);
+    for (int i = 0; i < OSCILLATOR_LOGIC_OSCILLATOR_COUNT; i++) {
+        pitch_from[i] = 1.0;
+        pitch_to[i] = 1.0;
+    }
+
+    ESP_LOGI(TAG, "---Initializing node taps---");
+    for (int t = 0; t < OSCILLATOR_LOGIC_MAX_TAPS; t++) {
+        taps[t].node_id = -1;
+        tap_requests[t] = -1;
+    }
+
+    ESP_LOGI(TAG, "---Initializing DAC mixer---");
+    // по умолчанию старший бит - финальный оператор, дальше по убыванию номеров узлов
+    dac_mixer_init(&mixer);
+    for (int i = 0; i < OSCILLATOR_LOGIC_FINAL_LOGICAL_OP_NODE + 1; i++) {
+        int node_id = OSCILLATOR_LOGIC_FINAL_LOGICAL_OP_NODE - i;
+        dac_mixer_set_input(&mixer, i, oscillator_logic_get_node_result_pointer(node_id), node_id);
+    }
+
     ESP_LOGI(TAG, "---Initializing output---");
     // Create output instance with final logical operator result
-    bool* final_result = logical_ops_get_result_pointer(&logical_ops[2]);
-
-    output_init_bool(4, final_result);
-    //output_init_bool(4, final_result);
+    ESP_ERROR_CHECK(oscillator_logic_set_output_route(OSCILLATOR_LOGIC_MAIN_OUTPUT_GPIO, OSCILLATOR_LOGIC_FINAL_LOGICAL_OP_NODE));
 
     ESP_LOGI(TAG, "---Initializing timer---");
     // Initialize shared timer
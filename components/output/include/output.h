@@ -4,11 +4,38 @@
 
 typedef void* output_handle_t;
 
+typedef void (*output_buffer_ready_callback_t)(output_handle_t handle);
+typedef void (*output_block_listener_t)(output_handle_t handle, const int8_t* samples, size_t length,
+                                        uint32_t first_sample);
+
 #define OUTPUT_SAMPLE_BUFFER_SIZE 256
 #define OUTPUT_SAMPLE_READY_BIT BIT0
 
+// Number of independent outputs (each owns an SDM or I2S channel)
+#define OUTPUT_MAX_INSTANCES 4
+// Blocks of up to OUTPUT_SAMPLE_BUFFER_SIZE kept in each capture ring
+#define OUTPUT_CAPTURE_BLOCKS 8
+
+// Capture block length is a power of two in this range, set per instance
+// so the stream can trade latency against per-frame overhead
+#define OUTPUT_MIN_BLOCK_SIZE 32
+
+// How long output_deinit waits for the timer side to drop an instance
+#define OUTPUT_DEINIT_TIMEOUT_MS 100
+
+// Capture stream runs at the engine rate divided by this factor (1..64)
+#define OUTPUT_STREAM_DEFAULT_DECIMATION 1
+
+// Bitstream output: samples are modulated in blocks and pushed to I2S DMA
+#define OUTPUT_BITSTREAM_BLOCK_SIZE 32
+#define OUTPUT_BITSTREAM_OVERSAMPLE 64
+#define OUTPUT_BITSTREAM_DEFAULT_ORDER 3
+
 /**
  * @brief Initialize a new output instance
+ *
+ * Several instances can run at once on different pins. Calling an init
+ * function again for a pin that is already in use returns the existing instance.
  * 
  * @param gpio_num GPIO pin number to use for output
  * @param value_ptr Pointer to the value that will be read for output
@@ -26,12 +53,50 @@ output_handle_t output_init(int gpio_num, int8_t* value_ptr);
 output_handle_t output_init_bool(int gpio_num, bool* value_ptr);
 
 /**
- * @brief Get the current output instance
+ * @brief Initialize a new output instance driven by the software delta-sigma modulator
+ *
+ * Multi-bit samples are collected into blocks of OUTPUT_BITSTREAM_BLOCK_SIZE,
+ * noise shaped into a 1-bit stream at OUTPUT_BITSTREAM_OVERSAMPLE times the
+ * sample rate and clocked out of a single GPIO by I2S DMA.
+ *
+ * @param gpio_num GPIO pin number to use for output
+ * @param value_ptr Pointer to the 16-bit value that will be read for output
+ * @param order Noise shaping order (2 or 3)
+ * @return output_handle_t Handle to the output instance, NULL if initialization failed
+ */
+output_handle_t output_init_bitstream(int gpio_num, int16_t* value_ptr, int order);
+
+/**
+ * @brief Get the primary output instance (slot 0)
  * 
  * @return output_handle_t Handle to the output instance, NULL if not initialized
  */
 output_handle_t output_get_instance(void);
 
+/**
+ * @brief Get an output instance by slot index
+ *
+ * @param index Slot index, 0..OUTPUT_MAX_INSTANCES-1
+ * @return output_handle_t Handle to the output instance, NULL if the slot is empty
+ */
+output_handle_t output_get_instance_by_index(int index);
+
+/**
+ * @brief Find the output instance driving a GPIO pin
+ *
+ * @param gpio_num GPIO pin number
+ * @return output_handle_t Handle to the output instance, NULL if the pin is not used
+ */
+output_handle_t output_get_instance_by_gpio(int gpio_num);
+
+/**
+ * @brief Get the GPIO pin an output instance drives
+ *
+ * @param handle Output instance handle
+ * @return int GPIO number, -1 if handle is NULL
+ */
+int output_get_gpio(output_handle_t handle);
+
 /**
  * @brief Update the value pointer for an output instance
  * 
@@ -50,46 +115,135 @@ void output_set_bool_value_ptr(output_handle_t handle, bool* value_ptr_bool);
 
 /**
  * @brief Deinitialize and free an output instance
- * 
+ *
+ * The timer side takes the instance out of service at its next sample and
+ * confirms it, only then the channel is released and the memory freed.
+ * Must not be called from the timer side itself.
+ *
  * @param handle Output instance handle
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG if handle is NULL,
+ *         ESP_ERR_TIMEOUT if the timer did not confirm within
+ *         OUTPUT_DEINIT_TIMEOUT_MS; the instance is then left allocated
  */
-void output_deinit(output_handle_t handle); 
+esp_err_t output_deinit(output_handle_t handle);
 
 /**
- * @brief Timer callback function that updates the PDM output
- * This function is called by the timer system to update the output value
+ * @brief Timer callback function that updates all output instances
+ * This function is called by the timer system once per sample, every
+ * instance reads its own source and feeds its own channel and capture ring
  */ 
 void output_timer_callback(void);
 
 /**
- * @brief Timer callback function that updates the PDM output for boolean values
- * This function is called by the timer system to update the output value
- */
-void output_timer_callback_bool(void);
-
-/**
- * @brief Get the current sample buffer
+ * @brief Get the oldest complete block from the capture ring
+ *
+ * Every captured sample advances a per-instance sample clock at the stream
+ * rate. A gap between the first sample of a block and the end of the
+ * previous one means blocks were dropped because the reader fell behind.
  * 
  * @param handle Output instance handle
- * @param buffer Buffer to store samples in (must be at least OUTPUT_SAMPLE_BUFFER_SIZE bytes)
+ * @param buffer Buffer to store samples in (OUTPUT_SAMPLE_BUFFER_SIZE bytes hold any block)
  * @param size Size of the buffer
- * @return esp_err_t ESP_OK on success, error code otherwise
+ * @param length Where the number of samples in the block is stored
+ * @param first_sample Where the sample clock of the first sample is stored, may be NULL
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_FOUND if no block is ready,
+ *         ESP_ERR_INVALID_SIZE if the block does not fit
  */
-esp_err_t output_get_samples(output_handle_t handle, int8_t* buffer, size_t size);
+esp_err_t output_get_samples(output_handle_t handle, int8_t* buffer, size_t size,
+                             size_t* length, uint32_t* first_sample);
 
 /**
- * @brief Check if a full sample buffer is ready
+ * @brief Check if a complete block is waiting in the capture ring
  * 
  * @param handle Output instance handle
  * @return true if buffer is ready, false otherwise
  */
 bool output_samples_ready(output_handle_t handle);
 
+/**
+ * @brief Set the decimation factor between the engine rate and the capture stream
+ *
+ * Captured samples pass through a third order CIC decimator with droop
+ * compensation, so the WebSocket and capture ring can run at a fraction of
+ * the engine rate without aliasing. Factor 1 captures every sample unfiltered.
+ *
+ * @param handle Output instance handle
+ * @param factor Decimation factor, 1..64
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t output_set_stream_decimation(output_handle_t handle, uint32_t factor);
+
+/**
+ * @brief Get the capture stream decimation factor
+ *
+ * @param handle Output instance handle
+ * @return uint32_t Decimation factor, 0 if handle is NULL
+ */
+uint32_t output_get_stream_decimation(output_handle_t handle);
+
+/**
+ * @brief Set the length of the next capture blocks
+ *
+ * Takes effect at the start of the next block.
+ *
+ * @param handle Output instance handle
+ * @param size Samples per block, a power of two OUTPUT_MIN_BLOCK_SIZE..OUTPUT_SAMPLE_BUFFER_SIZE
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t output_set_stream_block_size(output_handle_t handle, uint32_t size);
+
+/**
+ * @brief Get the capture block length
+ *
+ * @param handle Output instance handle
+ * @return uint32_t Samples per block, 0 if handle is NULL
+ */
+uint32_t output_get_stream_block_size(output_handle_t handle);
+
+/**
+ * @brief Set the range the stream may move the block length in
+ *
+ * The output only stores the limits, the streaming side adapts the block
+ * length inside them: short blocks for latency, long ones for overhead.
+ * Equal limits fix the block length.
+ *
+ * @param handle Output instance handle
+ * @param min_size Shortest block, a power of two OUTPUT_MIN_BLOCK_SIZE..OUTPUT_SAMPLE_BUFFER_SIZE
+ * @param max_size Longest block, a power of two min_size..OUTPUT_SAMPLE_BUFFER_SIZE
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t output_set_stream_block_limits(output_handle_t handle, uint32_t min_size, uint32_t max_size);
+
+/**
+ * @brief Get the block length range
+ *
+ * @param handle Output instance handle
+ * @param min_size Where the shortest block is stored
+ * @param max_size Where the longest block is stored
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t output_get_stream_block_limits(output_handle_t handle, uint32_t* min_size, uint32_t* max_size);
+
 /**
  * @brief Register a callback function to be called when a buffer is ready
+ *
+ * The callback is shared by all instances and receives the handle of the
+ * instance whose capture block has just been completed.
  * 
  * @param callback Callback function to register
  */
-void output_register_buffer_ready_callback(void (*callback)(void));
+void output_register_buffer_ready_callback(output_buffer_ready_callback_t callback);
+
+/**
+ * @brief Register a function that sees every finished capture block
+ *
+ * Called from the timer side right before the buffer ready callback, with
+ * the block still in the ring. Unlike output_get_samples it does not take the
+ * block, so a second stream can follow the output next to the WebSocket one.
+ * The listener must not block.
+ *
+ * @param listener Listener function, NULL removes it
+ */
+void output_register_block_listener(output_block_listener_t listener);
 
 //
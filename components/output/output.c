@@ -3,12 +3,20 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
+#include "driver/i2s_std.h"
 #include "timer.h"
+#include "delta_sigma.h"
+#include "decimator.h"
+#include "common_defs.h"
 
 #define MHZ                             (1000000)
 #define KHZ                            (1000)
 #define OVER_SAMPLE_RATE               (10 * MHZ)          // for PDM output
 
+// I2S std frame is two 32-bit slots, so the bit clock is 64 bits per frame
+#define I2S_BITS_PER_FRAME             (64)
+#define BITSTREAM_WORDS                (OUTPUT_BITSTREAM_BLOCK_SIZE * OUTPUT_BITSTREAM_OVERSAMPLE / DELTA_SIGMA_WORD_BITS)
+
 
 // Convert boolean to PDM value (-128 to 127)
 #define BOOL_TO_PDM(value) ((value) ? 127 : -128)
@@ -20,75 +28,235 @@
 // через дополнительный софтовый дельта сигма алгоритм
 
 //  сейчас он работает на частоте вызова
+//  для многобитного сигнала есть режим bitstream: модулятор 2/3 порядка
+//  формирует поток бит блоками, а I2S DMA выдает его на пин
+
+//  захват для передачи клиенту идет через дециматор, так что поток можно
+//  отдавать на меньшей частоте, чем работает движок
+
+//  экземпляров может быть несколько, каждый на своем пине со своим источником,
+//  все обслуживаются за один вызов таймера
 
 static const char *TAG = "output";
 
+typedef enum {
+    OUTPUT_MODE_INT8,
+    OUTPUT_MODE_BOOL,
+    OUTPUT_MODE_BITSTREAM,
+} output_mode_t;
+
 typedef struct {
+    int gpio_num;
+    output_mode_t mode;
     sdm_channel_handle_t sdm_chan;
     int8_t* value_ptr;
     bool* value_ptr_bool;
-    // Sample collection
-    int8_t sample_buffer[OUTPUT_SAMPLE_BUFFER_SIZE];
+    // Bitstream output
+    i2s_chan_handle_t i2s_chan;
+    int16_t* value_ptr_pcm;
+    delta_sigma_t modulator;
+    int16_t pcm_block[OUTPUT_BITSTREAM_BLOCK_SIZE];
+    size_t pcm_count;
+    uint32_t bitstream[BITSTREAM_WORDS];
+    // Sample collection, decimated to the stream rate first
+    decimator_t capture_decimator;
+    volatile uint32_t pending_decimation;   // applied by the timer side to avoid racing the filter state
+    // Ring of blocks so the reader never sees a block being written
+    int8_t capture_ring[OUTPUT_CAPTURE_BLOCKS][OUTPUT_SAMPLE_BUFFER_SIZE];
+    uint16_t block_length[OUTPUT_CAPTURE_BLOCKS];
+    uint32_t block_first_sample[OUTPUT_CAPTURE_BLOCKS];
+    uint32_t sample_clock;                  // captured samples, free-running
+    size_t block_size;
+    volatile uint32_t pending_block_size;   // like pending_decimation, taken at a block start
+    uint32_t block_min;
+    uint32_t block_max;
     size_t sample_count;
-    bool buffer_ready;
+    volatile uint32_t write_block;
+    volatile uint32_t read_block;
+    // Removal: output_deinit sets removing, the timer side drops the instance
+    // from the table and confirms with released, only then it is freed
+    volatile bool removing;
+    volatile bool released;
 } output_instance_t;
 
-static output_instance_t* g_output_instance = NULL;
+static output_instance_t* volatile g_output_instances[OUTPUT_MAX_INSTANCES] = { NULL };
 
 // Callback function pointer
-static void (*buffer_ready_callback)(void) = NULL;
+static output_buffer_ready_callback_t buffer_ready_callback = NULL;
+static output_block_listener_t block_listener = NULL;
 
 // Function to register buffer ready callback
-void output_register_buffer_ready_callback(void (*callback)(void)) {
+void output_register_buffer_ready_callback(output_buffer_ready_callback_t callback) {
     ESP_LOGI(TAG, "Registering buffer ready callback");
     buffer_ready_callback = callback;
 }
 
+void output_register_block_listener(output_block_listener_t listener) {
+    ESP_LOGI(TAG, "Registering block listener");
+    block_listener = listener;
+}
+
 //  для предотвращения обращения к несуществующему указателю
-static void execute_buffer_ready_callback(void) {
+static void execute_buffer_ready_callback(output_instance_t* instance) {
     if (buffer_ready_callback != NULL) {
-        buffer_ready_callback();
+        buffer_ready_callback((output_handle_t)instance);
     }
 }
 
-// функция для генерации сигнала на пине выхода
-// записывает в буфер значение сигнала
-void output_timer_callback(void)
+// Store sample, when a block is complete it becomes readable and writing moves on.
+// If the reader falls behind the oldest block is dropped.
+// Samples arrive at the engine rate, only every factor-th decimated one is stored.
+static void output_capture_sample(output_instance_t* instance, int16_t value)
 {
-    if (g_output_instance && g_output_instance->value_ptr) {
-        int8_t pdm_value = BOOL_TO_PDM(*(g_output_instance->value_ptr));
-        sdm_channel_set_pulse_density(g_output_instance->sdm_chan, pdm_value);
-        
-        // Store sample if buffer not full
-        if (g_output_instance->sample_count < OUTPUT_SAMPLE_BUFFER_SIZE) {
-            g_output_instance->sample_buffer[g_output_instance->sample_count++] = pdm_value;
-            if (g_output_instance->sample_count >= OUTPUT_SAMPLE_BUFFER_SIZE) {
-                g_output_instance->buffer_ready = true;
-                g_output_instance->sample_count = 0;
-                execute_buffer_ready_callback();
-            }
+    decimator_t* dec = &instance->capture_decimator;
+    if (instance->pending_decimation != dec->factor) {
+        decimator_init(dec, instance->pending_decimation, dec->input);
+    }
+
+    int16_t decimated;
+    if (!decimator_push(dec, value, &decimated)) {
+        return;
+    }
+
+    uint32_t block = instance->write_block % OUTPUT_CAPTURE_BLOCKS;
+    if (instance->sample_count == 0) {
+        instance->block_size = instance->pending_block_size;
+        instance->block_first_sample[block] = instance->sample_clock;
+    }
+    instance->sample_clock++;
+    instance->capture_ring[block][instance->sample_count++] = (int8_t)(decimated >> 8);
+    if (instance->sample_count >= instance->block_size) {
+        instance->block_length[block] = (uint16_t)instance->sample_count;
+        if (block_listener != NULL) {
+            block_listener((output_handle_t)instance, instance->capture_ring[block],
+                           instance->sample_count, instance->block_first_sample[block]);
+        }
+        instance->sample_count = 0;
+        instance->write_block++;
+        if (instance->write_block - instance->read_block > OUTPUT_CAPTURE_BLOCKS - 1) {
+            instance->read_block = instance->write_block - (OUTPUT_CAPTURE_BLOCKS - 1);
         }
+        execute_buffer_ready_callback(instance);
     }
 }
 
-// функция для генерации сигнала на пине выхода
-// записывает в буфер значение сигнала
-void output_timer_callback_bool(void)
+// I2S shifts out the most significant bit first, the modulator packs the earliest bit into bit 0
+static inline uint32_t reverse_bits(uint32_t x)
 {
-    if (g_output_instance && g_output_instance->value_ptr_bool) {
-        int8_t pdm_value = BOOL_TO_PDM(*(g_output_instance->value_ptr_bool));
-        sdm_channel_set_pulse_density(g_output_instance->sdm_chan, pdm_value);
-        
-        // Store sample if buffer not full
-        if (g_output_instance->sample_count < OUTPUT_SAMPLE_BUFFER_SIZE) {
-            g_output_instance->sample_buffer[g_output_instance->sample_count++] = pdm_value;
-            if (g_output_instance->sample_count >= OUTPUT_SAMPLE_BUFFER_SIZE) {
-                g_output_instance->buffer_ready = true;
-                g_output_instance->sample_count = 0;
-                execute_buffer_ready_callback();
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+// модулирует накопленный блок и отдает его в DMA без ожидания
+static void output_flush_bitstream(output_instance_t* instance)
+{
+    size_t words = delta_sigma_process_block(&instance->modulator, instance->pcm_block,
+                                             instance->pcm_count, instance->bitstream, BITSTREAM_WORDS);
+    instance->pcm_count = 0;
+    if (words == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < words; i++) {
+        instance->bitstream[i] = reverse_bits(instance->bitstream[i]);
+    }
+
+    size_t written = 0;
+    esp_err_t err = i2s_channel_write(instance->i2s_chan, instance->bitstream,
+                                      words * sizeof(uint32_t), &written, 0);
+    if (err != ESP_OK && err != ESP_ERR_TIMEOUT) {
+        ESP_LOGE(TAG, "Failed to write bitstream: %s", esp_err_to_name(err));
+    }
+}
+
+// обработка одного экземпляра на текущем отсчете
+static void output_service_instance(output_instance_t* instance)
+{
+    switch (instance->mode) {
+    case OUTPUT_MODE_INT8:
+        if (instance->value_ptr) {
+            int8_t pdm_value = *(instance->value_ptr);
+            sdm_channel_set_pulse_density(instance->sdm_chan, pdm_value);
+            output_capture_sample(instance, (int16_t)(pdm_value * 256));
+        }
+        break;
+    case OUTPUT_MODE_BOOL:
+        if (instance->value_ptr_bool) {
+            bool value = *(instance->value_ptr_bool);
+            sdm_channel_set_pulse_density(instance->sdm_chan, BOOL_TO_PDM(value));
+            output_capture_sample(instance, value);
+        }
+        break;
+    case OUTPUT_MODE_BITSTREAM:
+        // копит блок отсчетов, модуляция и отправка в DMA раз в блок
+        if (instance->value_ptr_pcm) {
+            int16_t value = *(instance->value_ptr_pcm);
+            instance->pcm_block[instance->pcm_count++] = value;
+            if (instance->pcm_count >= OUTPUT_BITSTREAM_BLOCK_SIZE) {
+                output_flush_bitstream(instance);
             }
+            output_capture_sample(instance, value);
         }
+        break;
+    }
+}
+
+// функция для генерации сигнала на пинах выхода
+// обслуживает все экземпляры и записывает в их буферы значение сигнала
+void output_timer_callback(void)
+{
+    for (int i = 0; i < OUTPUT_MAX_INSTANCES; i++) {
+        output_instance_t* instance = g_output_instances[i];
+        if (!instance) {
+            continue;
+        }
+        if (instance->removing) {
+            // после этого таймер экземпляр не трогает
+            g_output_instances[i] = NULL;
+            instance->released = true;
+            continue;
+        }
+        output_service_instance(instance);
+    }
+}
+
+// инициализация I2S канала для вывода потока бит
+// данные идут непрерывно по слотам, пины BCLK и WS не нужны
+static i2s_chan_handle_t init_bitstream_i2s(int gpio_num)
+{
+    i2s_chan_handle_t tx_chan = NULL;
+    i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(I2S_NUM_AUTO, I2S_ROLE_MASTER);
+    chan_cfg.auto_clear = true;  // при недогрузке DMA выдает нули, а не повтор старого блока
+    if (i2s_new_channel(&chan_cfg, &tx_chan, NULL) != ESP_OK) {
+        return NULL;
     }
+
+    i2s_std_config_t std_cfg = {
+        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(SYSTEM_SAMPLE_RATE * OUTPUT_BITSTREAM_OVERSAMPLE / I2S_BITS_PER_FRAME),
+        .slot_cfg = I2S_STD_MSB_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_32BIT, I2S_SLOT_MODE_STEREO),
+        .gpio_cfg = {
+            .mclk = I2S_GPIO_UNUSED,
+            .bclk = I2S_GPIO_UNUSED,
+            .ws = I2S_GPIO_UNUSED,
+            .dout = gpio_num,
+            .din = I2S_GPIO_UNUSED,
+            .invert_flags = {
+                .mclk_inv = false,
+                .bclk_inv = false,
+                .ws_inv = false,
+            },
+        },
+    };
+    if (i2s_channel_init_std_mode(tx_chan, &std_cfg) != ESP_OK ||
+        i2s_channel_enable(tx_chan) != ESP_OK) {
+        i2s_del_channel(tx_chan);
+        return NULL;
+    }
+
+    return tx_chan;
 }
 
 // инициализация SDM канала
@@ -106,11 +274,35 @@ static sdm_channel_handle_t example_init_sdm(int gpio_num)
     return sdm_chan;
 }
 
+static output_instance_t* output_find_by_gpio(int gpio_num)
+{
+    for (int i = 0; i < OUTPUT_MAX_INSTANCES; i++) {
+        if (g_output_instances[i] && g_output_instances[i]->gpio_num == gpio_num) {
+            return g_output_instances[i];
+        }
+    }
+    return NULL;
+}
+
 // инициализация экземпляра output
-static output_handle_t output_init_common(int gpio_num) {
-    if (g_output_instance != NULL) {
-        ESP_LOGW(TAG, "Output already initialized");
-        return (output_handle_t)g_output_instance;
+// повторный вызов на том же пине возвращает уже существующий экземпляр
+static output_handle_t output_init_common(int gpio_num, output_mode_t mode) {
+    output_instance_t* existing = output_find_by_gpio(gpio_num);
+    if (existing != NULL) {
+        ESP_LOGW(TAG, "Output already initialized on GPIO %d", gpio_num);
+        return (output_handle_t)existing;
+    }
+
+    int slot = -1;
+    for (int i = 0; i < OUTPUT_MAX_INSTANCES; i++) {
+        if (g_output_instances[i] == NULL) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0) {
+        ESP_LOGE(TAG, "No free output slots (max %d)", OUTPUT_MAX_INSTANCES);
+        return NULL;
     }
 
     output_instance_t* instance = malloc(sizeof(output_instance_t));
@@ -120,28 +312,54 @@ static output_handle_t output_init_common(int gpio_num) {
     }
 
     // Initialize pointers to NULL
+    instance->gpio_num = gpio_num;
+    instance->mode = mode;
     instance->value_ptr = NULL;
     instance->value_ptr_bool = NULL; //  для хранения указателя откуда забирать данные
+    instance->value_ptr_pcm = NULL;
     instance->sample_count = 0;
-    instance->buffer_ready = false;
-    
-    instance->sdm_chan = example_init_sdm(gpio_num);
-    if (!instance->sdm_chan) {
-        ESP_LOGE(TAG, "Failed to initialize SDM channel");
-        free(instance);
-        return NULL;
+    instance->write_block = 0;
+    instance->read_block = 0;
+    instance->removing = false;
+    instance->released = false;
+    instance->sdm_chan = NULL;
+    instance->i2s_chan = NULL;
+    instance->pcm_count = 0;
+    instance->pending_decimation = OUTPUT_STREAM_DEFAULT_DECIMATION;
+    instance->sample_clock = 0;
+    instance->block_size = OUTPUT_SAMPLE_BUFFER_SIZE;
+    instance->pending_block_size = OUTPUT_SAMPLE_BUFFER_SIZE;
+    instance->block_min = OUTPUT_MIN_BLOCK_SIZE;
+    instance->block_max = OUTPUT_SAMPLE_BUFFER_SIZE;
+    decimator_init(&instance->capture_decimator, OUTPUT_STREAM_DEFAULT_DECIMATION,
+                   mode == OUTPUT_MODE_BOOL ? DECIMATOR_INPUT_BITS : DECIMATOR_INPUT_PCM);
+
+    if (mode == OUTPUT_MODE_BITSTREAM) {
+        instance->i2s_chan = init_bitstream_i2s(gpio_num);
+        if (!instance->i2s_chan) {
+            ESP_LOGE(TAG, "Failed to initialize I2S bitstream channel");
+            free(instance);
+            return NULL;
+        }
+    } else {
+        instance->sdm_chan = example_init_sdm(gpio_num);
+        if (!instance->sdm_chan) {
+            ESP_LOGE(TAG, "Failed to initialize SDM channel");
+            free(instance);
+            return NULL;
+        }
     }
 
-    g_output_instance = instance;
-    ESP_LOGI(TAG, "Output initialized on GPIO %d", gpio_num);
-    
+    g_output_instances[slot] = instance;
+    ESP_LOGI(TAG, "Output %d initialized on GPIO %d", slot, gpio_num);
+
     return (output_handle_t)instance;
 }
 
 // создание экземпляра output для работы с булевым значением
 output_handle_t output_init_bool(int gpio_num, bool* value_ptr)
 {
-    output_handle_t handle = output_init_common(gpio_num);
+    output_handle_t handle = output_init_common(gpio_num, OUTPUT_MODE_BOOL);
     if (handle) {
         output_instance_t* instance = (output_instance_t*)handle;
         instance->value_ptr_bool = value_ptr;
@@ -152,7 +370,7 @@ output_handle_t output_init_bool(int gpio_num, bool* value_ptr)
 // создание экземпляра output для работы с целым значением
 output_handle_t output_init(int gpio_num, int8_t* value_ptr)
 {
-    output_handle_t handle = output_init_common(gpio_num);
+    output_handle_t handle = output_init_common(gpio_num, OUTPUT_MODE_INT8);
     if (handle) {
         output_instance_t* instance = (output_instance_t*)handle;
         instance->value_ptr = value_ptr;
@@ -160,7 +378,28 @@ output_handle_t output_init(int gpio_num, int8_t* value_ptr)
     return handle;
 }
 
-// не используется
+// создание экземпляра output для многобитного сигнала через дельта-сигма модулятор
+output_handle_t output_init_bitstream(int gpio_num, int16_t* value_ptr, int order)
+{
+    output_handle_t handle = output_init_common(gpio_num, OUTPUT_MODE_BITSTREAM);
+    if (!handle) {
+        return NULL;
+    }
+
+    output_instance_t* instance = (output_instance_t*)handle;
+    if (instance->mode != OUTPUT_MODE_BITSTREAM) {
+        ESP_LOGE(TAG, "Output on GPIO %d is not a bitstream output", gpio_num);
+        return NULL;
+    }
+    if (delta_sigma_init(&instance->modulator, order, OUTPUT_BITSTREAM_OVERSAMPLE) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize delta-sigma modulator");
+        output_deinit(handle);
+        return NULL;
+    }
+    instance->value_ptr_pcm = value_ptr;
+    return handle;
+}
+
 void output_set_value_ptr(output_handle_t handle, int8_t* value_ptr)
 {
     output_instance_t* instance = (output_instance_t*)handle;
@@ -169,7 +408,7 @@ void output_set_value_ptr(output_handle_t handle, int8_t* value_ptr)
     }
 }
 
-// не используется
+// переключение источника для уже созданного булевого выхода
 void output_set_bool_value_ptr(output_handle_t handle, bool* value_ptr_bool)
 {
     output_instance_t* instance = (output_instance_t*)handle;
@@ -178,37 +417,63 @@ void output_set_bool_value_ptr(output_handle_t handle, bool* value_ptr_bool)
     }
 }
 
-void output_deinit(output_handle_t handle)
+esp_err_t output_deinit(output_handle_t handle)
 {
     output_instance_t* instance = (output_instance_t*)handle;
-    if (instance) {
-        if (instance->sdm_chan) {
-            sdm_channel_disable(instance->sdm_chan);
-            sdm_del_channel(instance->sdm_chan);
-        }
-        free(instance);
-        g_output_instance = NULL;
+    if (!instance) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // из таблицы экземпляр убирает сторона таймера, здесь только ждем подтверждения
+    instance->removing = true;
+    for (int tick = 0; !instance->released && tick <= OUTPUT_DEINIT_TIMEOUT_MS / portTICK_PERIOD_MS; tick++) {
+        vTaskDelay(1);
+    }
+    if (!instance->released) {
+        // таймер стоит или не успел: экземпляр остается, освобождать его небезопасно
+        ESP_LOGE(TAG, "Output on GPIO %d was not released by the timer", instance->gpio_num);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    if (instance->sdm_chan) {
+        sdm_channel_disable(instance->sdm_chan);
+        sdm_del_channel(instance->sdm_chan);
+    }
+    if (instance->i2s_chan) {
+        i2s_channel_disable(instance->i2s_chan);
+        i2s_del_channel(instance->i2s_chan);
     }
+    ESP_LOGI(TAG, "Output on GPIO %d removed", instance->gpio_num);
+    free(instance);
+    return ESP_OK;
 }
 
-// для получения буфера с выходными значениями
-esp_err_t output_get_samples(output_handle_t handle, int8_t* buffer, size_t size)
+// для получения буфера с выходными значениями, отдает самый старый готовый блок
+esp_err_t output_get_samples(output_handle_t handle, int8_t* buffer, size_t size,
+                             size_t* length, uint32_t* first_sample)
 {
     output_instance_t* instance = (output_instance_t*)handle;
-    if (!instance || !buffer || size < OUTPUT_SAMPLE_BUFFER_SIZE) {
+    if (!instance || !buffer || !length) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    if (!instance->buffer_ready) {
+    if (instance->read_block == instance->write_block) {
         return ESP_ERR_NOT_FOUND;
     }
 
+    uint32_t block = instance->read_block % OUTPUT_CAPTURE_BLOCKS;
+    size_t count = instance->block_length[block];
+    if (size < count) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
     // Copy samples to provided buffer
-    memcpy(buffer, instance->sample_buffer, OUTPUT_SAMPLE_BUFFER_SIZE);
-    
-    // Reset buffer state
-    instance->sample_count = 0;
-    instance->buffer_ready = false;
+    memcpy(buffer, instance->capture_ring[block], count);
+    *length = count;
+    if (first_sample) {
+        *first_sample = instance->block_first_sample[block];
+    }
+    instance->read_block++;
 
     return ESP_OK;
 }
@@ -216,10 +481,95 @@ esp_err_t output_get_samples(output_handle_t handle, int8_t* buffer, size_t size
 bool output_samples_ready(output_handle_t handle)
 {
     output_instance_t* instance = (output_instance_t*)handle;
-    return instance && instance->buffer_ready;
+    return instance && instance->read_block != instance->write_block;
 }
 
 output_handle_t output_get_instance(void)
 {
-    return (output_handle_t)g_output_instance;
-} 
\ No newline at end of file
+    return output_get_instance_by_index(0);
+}
+
+output_handle_t output_get_instance_by_index(int index)
+{
+    if (index < 0 || index >= OUTPUT_MAX_INSTANCES) {
+        return NULL;
+    }
+    return (output_handle_t)g_output_instances[index];
+}
+
+int output_get_gpio(output_handle_t handle)
+{
+    output_instance_t* instance = (output_instance_t*)handle;
+    return instance ? instance->gpio_num : -1;
+}
+
+output_handle_t output_get_instance_by_gpio(int gpio_num)
+{
+    return (output_handle_t)output_find_by_gpio(gpio_num);
+}
+
+// смена коэффициента применяется таймером на следующем отсчете
+esp_err_t output_set_stream_decimation(output_handle_t handle, uint32_t factor)
+{
+    output_instance_t* instance = (output_instance_t*)handle;
+    if (!instance || factor < DECIMATOR_MIN_FACTOR || factor > DECIMATOR_MAX_FACTOR) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    instance->pending_decimation = factor;
+    return ESP_OK;
+}
+
+uint32_t output_get_stream_decimation(output_handle_t handle)
+{
+    output_instance_t* instance = (output_instance_t*)handle;
+    return instance ? instance->pending_decimation : 0;
+}
+
+static bool output_valid_block_size(uint32_t size)
+{
+    return size >= OUTPUT_MIN_BLOCK_SIZE && size <= OUTPUT_SAMPLE_BUFFER_SIZE && (size & (size - 1)) == 0;
+}
+
+esp_err_t output_set_stream_block_size(output_handle_t handle, uint32_t size)
+{
+    output_instance_t* instance = (output_instance_t*)handle;
+    if (!instance || !output_valid_block_size(size)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    instance->pending_block_size = size;
+    return ESP_OK;
+}
+
+uint32_t output_get_stream_block_size(output_handle_t handle)
+{
+    output_instance_t* instance = (output_instance_t*)handle;
+    return instance ? instance->pending_block_size : 0;
+}
+
+esp_err_t output_set_stream_block_limits(output_handle_t handle, uint32_t min_size, uint32_t max_size)
+{
+    output_instance_t* instance = (output_instance_t*)handle;
+    if (!instance || !output_valid_block_size(min_size) || !output_valid_block_size(max_size) || min_size > max_size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    instance->block_min = min_size;
+    instance->block_max = max_size;
+    // текущий размер сразу загоняется в новые границы
+    uint32_t size = instance->pending_block_size;
+    if (size < min_size) size = min_size;
+    if (size > max_size) size = max_size;
+    instance->pending_block_size = size;
+    return ESP_OK;
+}
+
+esp_err_t output_get_stream_block_limits(output_handle_t handle, uint32_t* min_size, uint32_t* max_size)
+{
+    output_instance_t* instance = (output_instance_t*)handle;
+    if (!instance || !min_size || !max_size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *min_size = instance->block_min;
+    *max_size = instance->block_max;
+    return ESP_OK;
+}
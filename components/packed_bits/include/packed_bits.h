@@ -0,0 +1,131 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Упакованный режим: 32 последовательных отсчета булевого сигнала в одном слове.
+// Бит 0 - самый ранний отсчет, бит 31 - самый поздний.
+
+#define PACKED_WORD_BITS 32
+#define PACKED_WORDS(bits) (((bits) + PACKED_WORD_BITS - 1) / PACKED_WORD_BITS)
+
+// All ones when value is true, zero otherwise
+static inline uint32_t packed_broadcast(bool value)
+{
+    return (uint32_t)0 - (uint32_t)value;
+}
+
+static inline int packed_popcount(uint32_t x)
+{
+    return __builtin_popcount(x);
+}
+
+static inline bool packed_get_bit(const uint32_t* words, size_t index)
+{
+    return (words[index / PACKED_WORD_BITS] >> (index % PACKED_WORD_BITS)) & 1u;
+}
+
+/**
+ * @brief Delay a packed stream by 0..31 samples
+ *
+ * @param word Current word
+ * @param prev Previous word of the same stream
+ * @param delay Delay in samples, 0..PACKED_WORD_BITS-1
+ * @return uint32_t Word holding the samples delay positions earlier
+ */
+static inline uint32_t packed_delay(uint32_t word, uint32_t prev, int delay)
+{
+    if (delay == 0) return word;
+    return (word << delay) | (prev >> (PACKED_WORD_BITS - delay));
+}
+
+/**
+ * @brief Set samples start..end-1 of a packed stream to one level
+ *
+ * Works a word at a time, bits outside the range are kept.
+ *
+ * @param words Packed stream
+ * @param start First sample
+ * @param end One past the last sample
+ * @param level Level to write
+ */
+static inline void packed_fill(uint32_t* words, size_t start, size_t end, bool level)
+{
+    while (start < end) {
+        size_t bit = start % PACKED_WORD_BITS;
+        size_t count = end - start < PACKED_WORD_BITS - bit ? end - start : PACKED_WORD_BITS - bit;
+        uint32_t mask = count == PACKED_WORD_BITS ? 0xFFFFFFFFu : ((1u << count) - 1) << bit;
+        if (level) {
+            words[start / PACKED_WORD_BITS] |= mask;
+        } else {
+            words[start / PACKED_WORD_BITS] &= ~mask;
+        }
+        start += count;
+    }
+}
+
+/**
+ * @brief Mark the rising edges of a packed stream
+ *
+ * @param word Current word
+ * @param prev_level Level of the sample before bit 0
+ * @return uint32_t Word with a one wherever the stream goes from low to high
+ */
+static inline uint32_t packed_rising_edges(uint32_t word, bool prev_level)
+{
+    return word & ~((word << 1) | (uint32_t)prev_level);
+}
+
+/**
+ * @brief Mark the falling edges of a packed stream
+ *
+ * @param word Current word
+ * @param prev_level Level of the sample before bit 0
+ * @return uint32_t Word with a one wherever the stream goes from high to low
+ */
+static inline uint32_t packed_falling_edges(uint32_t word, bool prev_level)
+{
+    return ~word & ((word << 1) | (uint32_t)prev_level);
+}
+
+/**
+ * @brief Running XOR from bit 0 up
+ *
+ * Bit k of the result is the parity of bits 0..k. Applied to an edge mask it
+ * gives the level of a toggle that flips on every marked sample.
+ *
+ * @param word Input word
+ * @return uint32_t Prefix parity of the word
+ */
+static inline uint32_t packed_prefix_xor(uint32_t word)
+{
+    word ^= word << 1;
+    word ^= word << 2;
+    word ^= word << 4;
+    word ^= word << 8;
+    word ^= word << 16;
+    return word;
+}
+
+/**
+ * @brief Hold values forward from the samples where they are set
+ *
+ * Bit k of the result is the bit of values at the last set bit of load at or
+ * below k, or prev_level if load has no set bit up to k. A segmented scan in
+ * five shift steps, the cost does not depend on the number of loads.
+ *
+ * @param values Values to hold, only read where load is set
+ * @param load Samples where a new value is taken
+ * @param prev_level Level held from before bit 0
+ * @return uint32_t Held stream
+ */
+static inline uint32_t packed_hold(uint32_t values, uint32_t load, bool prev_level)
+{
+    values &= load;
+    for (int s = 1; s < PACKED_WORD_BITS; s <<= 1) {
+        values |= (values << s) & ~load;
+        load |= load << s;
+    }
+    return values | (~load & packed_broadcast(prev_level));
+}
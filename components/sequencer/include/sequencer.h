@@ -0,0 +1,139 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Шаговый секвенсор на часах движка: шаги считаются в отсчетах движка с
+// дробной частью, так что темп не уплывает, а каждый шаг приходит с точной
+// позицией внутри блока. Что делает шаг, решает вызывающий по target.
+
+#define SEQUENCER_MAX_STEPS 64
+#define SEQUENCER_MAX_DIVISION 16
+#define SEQUENCER_MIN_BPM 20.0
+#define SEQUENCER_MAX_BPM 300.0
+#define SEQUENCER_DEFAULT_BPM 120.0
+
+typedef enum {
+    SEQUENCER_TARGET_NONE,
+    SEQUENCER_TARGET_FREQUENCY,     // oscillator target_index, value in Hz
+    SEQUENCER_TARGET_OPERATION,     // logical operation target_index, value is a logical_op_t
+    SEQUENCER_TARGET_NOTE,          // voice pool, value is a MIDI note held for the step
+    SEQUENCER_TARGET_MIXER_WEIGHT,  // mixer input target_index, value is the weight, 0 mutes
+    SEQUENCER_TARGET_COUNT
+} sequencer_target_t;
+
+extern const char* sequencer_target_names[];
+
+typedef struct {
+    sequencer_target_t target;
+    int target_index;
+    int length;                             // steps in the pattern
+    int division;                           // steps per beat, 4 for sixteenths
+    uint64_t gates;                         // bit s set: step s fires
+    double values[SEQUENCER_MAX_STEPS];
+} sequencer_pattern_t;
+
+typedef struct {
+    sequencer_pattern_t pattern;
+    double step_samples;                    // engine samples per step
+    double countdown;                       // engine samples to the next step
+    int step;                               // last step played, -1 before the first
+    bool running;
+    int held_note;                          // note target: note sounding since the last step, -1 none
+} sequencer_t;
+
+/**
+ * @param seq Sequencer invoking the callback
+ * @param step Step that starts
+ * @param offset Engine sample of the step inside the advanced window
+ */
+typedef void (*sequencer_step_callback_t)(void* ctx, sequencer_t* seq, int step, uint32_t offset);
+
+/**
+ * @brief Get the text name of a target
+ *
+ * @param target Sequencer target
+ * @return const char* Name, "unknown" for a bad value
+ */
+const char* sequencer_get_target_name(sequencer_target_t target);
+
+/**
+ * @brief Initialize a stopped sequencer with an empty 16-step pattern
+ *
+ * No steps run until sequencer_set_tempo gives the step length.
+ *
+ * @param seq Pointer to sequencer_t structure to initialize
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG if seq is NULL
+ */
+esp_err_t sequencer_init(sequencer_t* seq);
+
+/**
+ * @brief Check a pattern before it is handed to a running sequencer
+ *
+ * @param pattern Pattern to check
+ * @return esp_err_t ESP_OK if valid, ESP_ERR_INVALID_ARG otherwise
+ */
+esp_err_t sequencer_validate_pattern(const sequencer_pattern_t* pattern);
+
+/**
+ * @brief Replace the pattern, keeping the time position
+ *
+ * A running sequencer goes on from the same step, wrapped to the new
+ * length. Call sequencer_set_tempo afterwards: it applies a new division
+ * and scales the time to the next step with the step length.
+ *
+ * @param seq Pointer to sequencer_t structure
+ * @param pattern New pattern
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on a bad pattern
+ */
+esp_err_t sequencer_set_pattern(sequencer_t* seq, const sequencer_pattern_t* pattern);
+
+/**
+ * @brief Set the step length from the tempo and the engine rate
+ *
+ * The time left to the next step is scaled, so a tempo or rate change
+ * keeps the position inside the step.
+ *
+ * @param seq Pointer to sequencer_t structure
+ * @param bpm Beats per minute, SEQUENCER_MIN_BPM..SEQUENCER_MAX_BPM
+ * @param sample_rate Engine rate in Hz
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t sequencer_set_tempo(sequencer_t* seq, double bpm, double sample_rate);
+
+/**
+ * @brief Start from step 0 at the beginning of the next advanced window
+ *
+ * @param seq Pointer to sequencer_t structure
+ */
+void sequencer_start(sequencer_t* seq);
+
+/**
+ * @brief Stop; held_note is left for the caller to release
+ *
+ * @param seq Pointer to sequencer_t structure
+ */
+void sequencer_stop(sequencer_t* seq);
+
+/**
+ * @brief Advance the clock by a window of engine samples
+ *
+ * The callback runs for every step that starts inside the window, gated or
+ * not, in time order.
+ *
+ * @param seq Pointer to sequencer_t structure
+ * @param n_samples Window length in engine samples
+ * @param callback Step callback
+ * @param ctx Passed to the callback
+ */
+void sequencer_advance(sequencer_t* seq, uint32_t n_samples, sequencer_step_callback_t callback, void* ctx);
+
+/**
+ * @brief Check whether a step fires
+ *
+ * @param seq Pointer to sequencer_t structure
+ * @param step Step index
+ * @return true if the step gate is set
+ */
+bool sequencer_step_gate(const sequencer_t* seq, int step);
@@ -0,0 +1,113 @@
+#include "sequencer.h"
+#include <esp_log.h>
+#include <string.h>
+
+static const char *TAG = "sequencer";
+
+const char* sequencer_target_names[] = {
+    "none",
+    "frequency",
+    "operation",
+    "note",
+    "mixer_weight",
+};
+
+const char* sequencer_get_target_name(sequencer_target_t target)
+{
+    if (target >= 0 && target < SEQUENCER_TARGET_COUNT) {
+        return sequencer_target_names[target];
+    }
+    return "unknown";
+}
+
+esp_err_t sequencer_init(sequencer_t* seq)
+{
+    if (!seq) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(seq, 0, sizeof(*seq));
+    seq->pattern.target = SEQUENCER_TARGET_NONE;
+    seq->pattern.target_index = 0;
+    seq->pattern.length = 16;
+    seq->pattern.division = 4;
+    seq->step = -1;
+    seq->held_note = -1;
+    return ESP_OK;
+}
+
+esp_err_t sequencer_validate_pattern(const sequencer_pattern_t* pattern)
+{
+    if (!pattern
+    || pattern->target < 0 || pattern->target >= SEQUENCER_TARGET_COUNT
+    || pattern->target_index < 0
+    || pattern->length < 1 || pattern->length > SEQUENCER_MAX_STEPS
+    || pattern->division < 1 || pattern->division > SEQUENCER_MAX_DIVISION) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+esp_err_t sequencer_set_pattern(sequencer_t* seq, const sequencer_pattern_t* pattern)
+{
+    if (!seq || sequencer_validate_pattern(pattern) != ESP_OK) {
+        ESP_LOGE(TAG, "Invalid pattern");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // шаг длиной step_samples пересчитает set_tempo, позиция до следующего шага остается
+    seq->pattern = *pattern;
+    if (seq->step >= pattern->length) {
+        seq->step %= pattern->length;
+    }
+    return ESP_OK;
+}
+
+esp_err_t sequencer_set_tempo(sequencer_t* seq, double bpm, double sample_rate)
+{
+    if (!seq || bpm < SEQUENCER_MIN_BPM || bpm > SEQUENCER_MAX_BPM || sample_rate <= 0.0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    double step_samples = sample_rate * 60.0 / (bpm * seq->pattern.division);
+    if (seq->step_samples > 0.0) {
+        seq->countdown *= step_samples / seq->step_samples;
+    }
+    seq->step_samples = step_samples;
+    return ESP_OK;
+}
+
+void sequencer_start(sequencer_t* seq)
+{
+    if (!seq) return;
+    seq->step = -1;
+    seq->countdown = 0.0;
+    seq->running = true;
+}
+
+void sequencer_stop(sequencer_t* seq)
+{
+    if (!seq) return;
+    seq->running = false;
+}
+
+void sequencer_advance(sequencer_t* seq, uint32_t n_samples, sequencer_step_callback_t callback, void* ctx)
+{
+    // без темпа шаги не идут
+    if (!seq || !seq->running || seq->step_samples <= 0.0) return;
+
+    while (seq->countdown < n_samples) {
+        seq->step = (seq->step + 1) % seq->pattern.length;
+        if (callback) {
+            callback(ctx, seq, seq->step, (uint32_t)seq->countdown);
+        }
+        seq->countdown += seq->step_samples;
+    }
+    seq->countdown -= n_samples;
+}
+
+bool sequencer_step_gate(const sequencer_t* seq, int step)
+{
+    if (!seq || step < 0 || step >= seq->pattern.length) return false;
+    return (seq->pattern.gates >> step) & 1u;
+}
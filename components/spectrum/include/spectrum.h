@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+// Радикс-2 БПФ в Q15 для осциллографа и анализатора спектра. Каждый каскад
+// делит на 2, так что результат равен X[k] / N и не переполняется.
+
+#define SPECTRUM_MIN_POINTS 16
+#define SPECTRUM_MAX_POINTS 1024
+
+/**
+ * @brief Multiply a block by a Hann window in place
+ *
+ * @param x Samples
+ * @param n Number of samples, SPECTRUM_MIN_POINTS..SPECTRUM_MAX_POINTS
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t spectrum_apply_hann(int16_t* x, size_t n);
+
+/**
+ * @brief In-place complex FFT with per-stage scaling
+ *
+ * @param re Real parts, replaced by the real parts of X[k] / n
+ * @param im Imaginary parts, replaced by the imaginary parts of X[k] / n
+ * @param n Number of points, a power of two SPECTRUM_MIN_POINTS..SPECTRUM_MAX_POINTS
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t spectrum_fft_q15(int16_t* re, int16_t* im, size_t n);
+
+/**
+ * @brief Squared magnitude of the first bins
+ *
+ * @param re Real parts from spectrum_fft_q15
+ * @param im Imaginary parts from spectrum_fft_q15
+ * @param bins Number of bins, usually n / 2 + 1
+ * @param power re^2 + im^2 per bin
+ */
+void spectrum_power(const int16_t* re, const int16_t* im, size_t bins, uint32_t* power);
@@ -0,0 +1,104 @@
+#include "spectrum.h"
+#include <esp_log.h>
+#include <math.h>
+#include <stdbool.h>
+
+static const char *TAG = "spectrum";
+
+// Таблица на полный размер, меньшие БПФ берут каждый (MAX / n)-й элемент
+static int16_t twiddle_cos[SPECTRUM_MAX_POINTS / 2];
+static int16_t twiddle_sin[SPECTRUM_MAX_POINTS / 2];
+static int16_t hann_table[SPECTRUM_MAX_POINTS];
+static size_t hann_points = 0;
+static bool twiddles_ready = false;
+
+static bool spectrum_valid_points(size_t n)
+{
+    return n >= SPECTRUM_MIN_POINTS && n <= SPECTRUM_MAX_POINTS && (n & (n - 1)) == 0;
+}
+
+static void spectrum_build_twiddles(void)
+{
+    for (int k = 0; k < SPECTRUM_MAX_POINTS / 2; k++) {
+        double angle = 2.0 * M_PI * k / SPECTRUM_MAX_POINTS;
+        twiddle_cos[k] = (int16_t)lround(cos(angle) * INT16_MAX);
+        twiddle_sin[k] = (int16_t)lround(sin(angle) * INT16_MAX);
+    }
+    twiddles_ready = true;
+}
+
+esp_err_t spectrum_apply_hann(int16_t* x, size_t n)
+{
+    if (!x || n < SPECTRUM_MIN_POINTS || n > SPECTRUM_MAX_POINTS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (hann_points != n) {
+        for (size_t i = 0; i < n; i++) {
+            double w = 0.5 - 0.5 * cos(2.0 * M_PI * i / n);
+            hann_table[i] = (int16_t)lround(w * INT16_MAX);
+        }
+        hann_points = n;
+    }
+    for (size_t i = 0; i < n; i++) {
+        x[i] = (int16_t)(((int32_t)x[i] * hann_table[i]) >> 15);
+    }
+    return ESP_OK;
+}
+
+esp_err_t spectrum_fft_q15(int16_t* re, int16_t* im, size_t n)
+{
+    if (!re || !im || !spectrum_valid_points(n)) {
+        ESP_LOGE(TAG, "Invalid FFT size %u", (unsigned)n);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!twiddles_ready) {
+        spectrum_build_twiddles();
+    }
+
+    // перестановка с обращением битов
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j |= bit;
+        if (i < j) {
+            int16_t t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    for (size_t len = 2; len <= n; len <<= 1) {
+        size_t half = len >> 1;
+        size_t step = SPECTRUM_MAX_POINTS / len;
+        for (size_t start = 0; start < n; start += len) {
+            for (size_t k = 0; k < half; k++) {
+                int32_t wr = twiddle_cos[k * step];
+                int32_t wi = -twiddle_sin[k * step];
+                size_t a = start + k;
+                size_t b = a + half;
+
+                int32_t tr = (re[b] * wr - im[b] * wi) >> 15;
+                int32_t ti = (re[b] * wi + im[b] * wr) >> 15;
+                int32_t ar = re[a];
+                int32_t ai = im[a];
+
+                re[a] = (int16_t)((ar + tr) >> 1);
+                im[a] = (int16_t)((ai + ti) >> 1);
+                re[b] = (int16_t)((ar - tr) >> 1);
+                im[b] = (int16_t)((ai - ti) >> 1);
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+void spectrum_power(const int16_t* re, const int16_t* im, size_t bins, uint32_t* power)
+{
+    if (!re || !im || !power) return;
+
+    for (size_t k = 0; k < bins; k++) {
+        power[k] = (uint32_t)((int32_t)re[k] * re[k]) + (uint32_t)((int32_t)im[k] * im[k]);
+    }
+}
@@ -44,7 +44,7 @@ static void timer_event_handler(void* event_handler_arg, esp_event_base_t event_
         int64_t oscillator_end = esp_timer_get_time();
         
         int64_t output_start = esp_timer_get_time();
-        output_timer_callback_bool();
+        output_timer_callback();
         int64_t output_end = esp_timer_get_time();
         
         current_time = esp_timer_get_time();
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Основной выход по UDP: один пакет на блок захвата, заголовок как у RTP
+// (RFC 3550, 12 байт, big-endian), дальше int8 отсчеты блока. Поздний
+// пакет бесполезен, поэтому без повторов: потери видны по номеру пакета.
+
+#define UDP_STREAM_DEFAULT_PORT 5004
+#define UDP_STREAM_HEADER_SIZE 12
+// dynamic RTP payload type: signed 8-bit PCM, mono, at the stream rate
+#define UDP_STREAM_PAYLOAD_TYPE 96
+#define UDP_STREAM_MAX_HOST 64
+
+typedef struct {
+    bool enabled;
+    char host[UDP_STREAM_MAX_HOST];
+    uint16_t port;
+    uint32_t ssrc;
+    uint32_t sample_rate;           // RTP timestamp units per second
+    uint32_t packets_sent;
+    uint32_t send_errors;           // packets the network stack refused, not retried
+} udp_stream_status_t;
+
+/**
+ * @brief Hook the UDP stream to the capture blocks of the main output
+ *
+ * @return esp_err_t ESP_OK on success
+ */
+esp_err_t udp_stream_init(void);
+
+/**
+ * @brief Start sending to a receiver, or move the stream to another one
+ *
+ * The name is resolved here; the socket is switched by the output side
+ * before its next block, so the render path never waits for the network.
+ *
+ * @param host IPv4 address or host name
+ * @param port UDP port
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG for a bad port,
+ *         ESP_ERR_NOT_FOUND if the host does not resolve
+ */
+esp_err_t udp_stream_start(const char* host, uint16_t port);
+
+/**
+ * @brief Stop sending
+ *
+ * @return esp_err_t ESP_OK
+ */
+esp_err_t udp_stream_stop(void);
+
+/**
+ * @brief Get the stream settings and counters
+ *
+ * @param status Where the status is stored
+ */
+void udp_stream_get_status(udp_stream_status_t* status);
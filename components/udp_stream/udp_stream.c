@@ -0,0 +1,155 @@
+#include "udp_stream.h"
+#include <esp_log.h>
+#include <esp_random.h>
+#include <string.h>
+#include "lwip/sockets.h"
+#include "lwip/netdb.h"
+#include "output.h"
+#include "common_defs.h"
+
+static const char *TAG = "udp_stream";
+
+// Настройку меняет API, сокет открывает и закрывает сторона выхода перед
+// очередным блоком, чтобы не закрыть его посреди sendto
+static volatile bool config_pending = false;
+static bool requested_enabled = false;
+static struct sockaddr_in requested_addr;
+static char requested_host[UDP_STREAM_MAX_HOST];
+
+static int sock = -1;
+static struct sockaddr_in dest_addr;
+static uint16_t sequence;
+static uint32_t ssrc;
+static bool marker;
+static volatile uint32_t packets_sent;
+static volatile uint32_t send_errors;
+
+static uint8_t packet[UDP_STREAM_HEADER_SIZE + OUTPUT_SAMPLE_BUFFER_SIZE];
+
+static void udp_stream_apply_config(void)
+{
+    config_pending = false;
+    if (sock >= 0) {
+        close(sock);
+        sock = -1;
+    }
+    if (!requested_enabled) {
+        return;
+    }
+
+    sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    if (sock < 0) {
+        ESP_LOGE(TAG, "Failed to create socket: errno %d", errno);
+        return;
+    }
+    dest_addr = requested_addr;
+    // новый поток: случайные SSRC и начальный номер, как велит RTP
+    ssrc = esp_random();
+    sequence = (uint16_t)esp_random();
+    marker = true;
+    packets_sent = 0;
+    send_errors = 0;
+}
+
+static void put_u16(uint8_t* p, uint16_t v)
+{
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static void put_u32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+// вызывается на каждый готовый блок, в том же контексте, что и захват
+static void udp_stream_send_block(output_handle_t handle, const int8_t* samples, size_t length,
+                                  uint32_t first_sample)
+{
+    if (handle != output_get_instance()) {
+        return;
+    }
+    if (config_pending) {
+        udp_stream_apply_config();
+    }
+    if (sock < 0 || length > OUTPUT_SAMPLE_BUFFER_SIZE) {
+        return;
+    }
+
+    packet[0] = 0x80;   // version 2, no padding, extension or CSRC
+    packet[1] = (marker ? 0x80 : 0x00) | UDP_STREAM_PAYLOAD_TYPE;
+    put_u16(&packet[2], sequence);
+    put_u32(&packet[4], first_sample);
+    put_u32(&packet[8], ssrc);
+    memcpy(&packet[UDP_STREAM_HEADER_SIZE], samples, length);
+    sequence++;
+
+    int sent = sendto(sock, packet, UDP_STREAM_HEADER_SIZE + length, MSG_DONTWAIT,
+                      (struct sockaddr *)&dest_addr, sizeof(dest_addr));
+    if (sent < 0) {
+        send_errors++;
+        return;
+    }
+    marker = false;
+    packets_sent++;
+}
+
+esp_err_t udp_stream_init(void)
+{
+    output_register_block_listener(&udp_stream_send_block);
+    return ESP_OK;
+}
+
+esp_err_t udp_stream_start(const char* host, uint16_t port)
+{
+    if (!host || port == 0 || strlen(host) >= UDP_STREAM_MAX_HOST) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct addrinfo hints = {
+        .ai_family = AF_INET,
+        .ai_socktype = SOCK_DGRAM,
+    };
+    struct addrinfo *result = NULL;
+    if (getaddrinfo(host, NULL, &hints, &result) != 0 || !result) {
+        ESP_LOGE(TAG, "Failed to resolve %s", host);
+        return ESP_ERR_NOT_FOUND;
+    }
+    struct sockaddr_in addr;
+    memcpy(&addr, result->ai_addr, sizeof(addr));
+    freeaddrinfo(result);
+    addr.sin_port = htons(port);
+
+    requested_addr = addr;
+    strcpy(requested_host, host);
+    requested_enabled = true;
+    config_pending = true;
+    ESP_LOGI(TAG, "Streaming to %s:%u", host, port);
+    return ESP_OK;
+}
+
+esp_err_t udp_stream_stop(void)
+{
+    requested_enabled = false;
+    config_pending = true;
+    ESP_LOGI(TAG, "Stream stopped");
+    return ESP_OK;
+}
+
+void udp_stream_get_status(udp_stream_status_t* status)
+{
+    if (!status) return;
+
+    memset(status, 0, sizeof(*status));
+    status->enabled = requested_enabled;
+    strcpy(status->host, requested_host);
+    status->port = ntohs(requested_addr.sin_port);
+    status->ssrc = ssrc;
+    uint32_t decimation = output_get_stream_decimation(output_get_instance());
+    status->sample_rate = decimation ? SYSTEM_SAMPLE_RATE / decimation : 0;
+    status->packets_sent = packets_sent;
+    status->send_errors = send_errors;
+}
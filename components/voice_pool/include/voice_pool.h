@@ -0,0 +1,139 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "oscillator_bank.h"
+#include "logical_ops.h"
+
+// Пул голосов: патч из 4 осцилляторов и 3 логических операций повторен для
+// каждого голоса. Осцилляторы всех голосов - дорожки одного банка (голос v,
+// осциллятор i - дорожка v * 4 + i), так весь пул считается одним проходом
+// по массивам, а операции голоса - упакованными словами. Выходы голосов
+// объединяются одной логической операцией в один булев поток.
+
+#define VOICE_POOL_MAX_VOICES 8
+#define VOICE_POOL_OSCILLATORS 4
+#define VOICE_POOL_GATES 3
+// Highest MIDI note a voice plays
+#define VOICE_POOL_MAX_NOTE 127
+// Voice nodes: 0..3 oscillators, 4..6 gates, the last gate is the voice output
+#define VOICE_POOL_NODES (VOICE_POOL_OSCILLATORS + VOICE_POOL_GATES)
+
+// Words rendered per pass, bounds the scratch buffer
+#define VOICE_POOL_CHUNK_WORDS 8
+
+typedef struct {
+    double ratios[VOICE_POOL_OSCILLATORS];          // oscillator frequency over the note frequency
+    logical_op_t operations[VOICE_POOL_GATES];
+    int inputs[VOICE_POOL_GATES][2];                // voice nodes below the gate, -1 reads low
+} voice_pool_patch_t;
+
+typedef struct {
+    oscillator_bank_t bank;
+    uint32_t scratch[VOICE_POOL_MAX_VOICES * VOICE_POOL_OSCILLATORS][VOICE_POOL_CHUNK_WORDS];
+    voice_pool_patch_t patch;
+    logical_ops_t gates[VOICE_POOL_GATES];          // operation holders shared by all voices
+    logical_ops_t combine;                          // joins the voice outputs
+    int voice_count;
+    int notes[VOICE_POOL_MAX_VOICES];               // MIDI note of each voice
+    bool active[VOICE_POOL_MAX_VOICES];
+    uint32_t started[VOICE_POOL_MAX_VOICES];        // note-on order, the oldest voice is stolen
+    uint32_t note_counter;
+    bool result;
+} voice_pool_t;
+
+/**
+ * @brief Initialize a pool with all voices silent
+ *
+ * The default patch is one square per voice at the note frequency.
+ *
+ * @param pool Pointer to voice_pool_t structure to initialize
+ * @param voice_count Number of voices, 1..VOICE_POOL_MAX_VOICES
+ * @param sample_rate Rate the pool is rendered at
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t voice_pool_init(voice_pool_t* pool, int voice_count, double sample_rate);
+
+/**
+ * @brief Set the patch every voice plays, sounding voices follow at once
+ *
+ * @param pool Pointer to voice_pool_t structure
+ * @param patch Oscillator ratios and gates; a gate may only read lower voice nodes
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t voice_pool_set_patch(voice_pool_t* pool, const voice_pool_patch_t* patch);
+
+/**
+ * @brief Set the operation that joins the voice outputs
+ *
+ * @param pool Pointer to voice_pool_t structure
+ * @param op Logical operation, OR by default
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t voice_pool_set_combine(voice_pool_t* pool, logical_op_t op);
+
+/**
+ * @brief Change the rate the pool is rendered at
+ *
+ * @param pool Pointer to voice_pool_t structure
+ * @param sample_rate New rate
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t voice_pool_set_sample_rate(voice_pool_t* pool, double sample_rate);
+
+/**
+ * @brief Start a note
+ *
+ * A note that is already sounding restarts on its voice. Otherwise a free
+ * voice is taken, or the voice with the oldest note is stolen.
+ *
+ * @param pool Pointer to voice_pool_t structure
+ * @param note MIDI note, 0..127
+ * @return int Voice index, -1 on bad parameters
+ */
+int voice_pool_note_on(voice_pool_t* pool, int note);
+
+/**
+ * @brief Stop a note
+ *
+ * @param pool Pointer to voice_pool_t structure
+ * @param note MIDI note, 0..127
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_FOUND if the note is not sounding
+ */
+esp_err_t voice_pool_note_off(voice_pool_t* pool, int note);
+
+/**
+ * @brief Stop every note
+ *
+ * @param pool Pointer to voice_pool_t structure
+ */
+void voice_pool_all_notes_off(voice_pool_t* pool);
+
+/**
+ * @brief Count the sounding voices
+ *
+ * @param pool Pointer to voice_pool_t structure
+ * @return int Number of active voices
+ */
+int voice_pool_active_count(const voice_pool_t* pool);
+
+/**
+ * @brief Render the joined output of all sounding voices
+ *
+ * Nothing is computed while no voice sounds, the output is low.
+ *
+ * @param pool Pointer to voice_pool_t structure
+ * @param out Output stream
+ * @param n_words Number of words
+ */
+void voice_pool_render_packed(voice_pool_t* pool, uint32_t* out, size_t n_words);
+
+/**
+ * @brief Get pointer to the last output sample
+ *
+ * @param pool Pointer to voice_pool_t structure
+ * @return bool* Pointer to the output, NULL if pool is NULL
+ */
+bool* voice_pool_get_result_pointer(voice_pool_t* pool);
@@ -0,0 +1,226 @@
+#include "voice_pool.h"
+#include <esp_log.h>
+#include <math.h>
+#include <string.h>
+#include "packed_bits.h"
+
+static const char *TAG = "voice_pool";
+
+static const uint32_t zero_words[VOICE_POOL_CHUNK_WORDS];
+
+static double voice_pool_note_frequency(int note)
+{
+    return 440.0 * pow(2.0, (note - 69) / 12.0);
+}
+
+static void voice_pool_tune(voice_pool_t* pool, int voice)
+{
+    double frequency = voice_pool_note_frequency(pool->notes[voice]);
+    for (int i = 0; i < VOICE_POOL_OSCILLATORS; i++) {
+        oscillator_bank_set_frequency(&pool->bank, voice * VOICE_POOL_OSCILLATORS + i,
+                                      frequency * pool->patch.ratios[i]);
+    }
+}
+
+esp_err_t voice_pool_init(voice_pool_t* pool, int voice_count, double sample_rate)
+{
+    if (!pool || voice_count < 1 || voice_count > VOICE_POOL_MAX_VOICES || sample_rate <= 0.0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(pool, 0, sizeof(*pool));
+    oscillator_bank_init(&pool->bank, sample_rate);
+    pool->voice_count = voice_count;
+    for (int v = 0; v < voice_count; v++) {
+        pool->notes[v] = 69;
+        for (int i = 0; i < VOICE_POOL_OSCILLATORS; i++) {
+            oscillator_bank_add(&pool->bank, OSCILLATOR_TYPE_SQUARE_BOOL, 440.0, 1.0);
+        }
+    }
+
+    // по умолчанию голос - квадрат первого осциллятора, операции его пропускают
+    voice_pool_patch_t patch = {
+        .ratios = { 1.0, 1.0, 1.0, 1.0 },
+        .operations = { LOGICAL_OP_OR, LOGICAL_OP_OR, LOGICAL_OP_OR },
+        .inputs = { { 0, 0 }, { 4, 4 }, { 5, 5 } },
+    };
+    for (int g = 0; g < VOICE_POOL_GATES; g++) {
+        logical_ops_init(&pool->gates[g]);
+    }
+    logical_ops_init(&pool->combine);
+    voice_pool_set_combine(pool, LOGICAL_OP_OR);
+    voice_pool_set_patch(pool, &patch);
+
+    ESP_LOGI(TAG, "Initializing voice pool, %d voices", voice_count);
+    return ESP_OK;
+}
+
+esp_err_t voice_pool_set_patch(voice_pool_t* pool, const voice_pool_patch_t* patch)
+{
+    if (!pool || !patch) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < VOICE_POOL_OSCILLATORS; i++) {
+        if (!(patch->ratios[i] > 0.0)) {
+            ESP_LOGE(TAG, "Invalid ratio for oscillator %d", i);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    for (int g = 0; g < VOICE_POOL_GATES; g++) {
+        if (patch->operations[g] < 0 || patch->operations[g] >= LOGICAL_OP_COUNT) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        for (int k = 0; k < 2; k++) {
+            int input = patch->inputs[g][k];
+            if (input < -1 || input >= VOICE_POOL_OSCILLATORS + g) {
+                ESP_LOGE(TAG, "Gate %d reads voice node %d", g, input);
+                return ESP_ERR_INVALID_ARG;
+            }
+        }
+    }
+
+    pool->patch = *patch;
+    for (int g = 0; g < VOICE_POOL_GATES; g++) {
+        logical_ops_set_operation(&pool->gates[g], patch->operations[g]);
+    }
+    for (int v = 0; v < pool->voice_count; v++) {
+        voice_pool_tune(pool, v);
+    }
+    return ESP_OK;
+}
+
+esp_err_t voice_pool_set_combine(voice_pool_t* pool, logical_op_t op)
+{
+    if (!pool) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return logical_ops_set_operation(&pool->combine, op);
+}
+
+esp_err_t voice_pool_set_sample_rate(voice_pool_t* pool, double sample_rate)
+{
+    if (!pool) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return oscillator_bank_set_sample_rate(&pool->bank, sample_rate);
+}
+
+int voice_pool_note_on(voice_pool_t* pool, int note)
+{
+    if (!pool || note < 0 || note > VOICE_POOL_MAX_NOTE) {
+        return -1;
+    }
+
+    // та же нота звучит - перезапуск, иначе свободный голос, иначе самый старый
+    int voice = -1;
+    for (int v = 0; v < pool->voice_count && voice < 0; v++) {
+        if (pool->active[v] && pool->notes[v] == note) voice = v;
+    }
+    for (int v = 0; v < pool->voice_count && voice < 0; v++) {
+        if (!pool->active[v]) voice = v;
+    }
+    if (voice < 0) {
+        voice = 0;
+        for (int v = 1; v < pool->voice_count; v++) {
+            if (pool->started[v] - pool->started[voice] > UINT32_MAX / 2) voice = v;
+        }
+        ESP_LOGD(TAG, "Stealing voice %d from note %d", voice, pool->notes[voice]);
+    }
+
+    pool->notes[voice] = note;
+    pool->started[voice] = pool->note_counter++;
+    voice_pool_tune(pool, voice);
+    for (int i = 0; i < VOICE_POOL_OSCILLATORS; i++) {
+        pool->bank.phase[voice * VOICE_POOL_OSCILLATORS + i] = 0;
+    }
+    pool->active[voice] = true;
+    return voice;
+}
+
+esp_err_t voice_pool_note_off(voice_pool_t* pool, int note)
+{
+    if (!pool) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int v = 0; v < pool->voice_count; v++) {
+        if (pool->active[v] && pool->notes[v] == note) {
+            pool->active[v] = false;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+void voice_pool_all_notes_off(voice_pool_t* pool)
+{
+    if (!pool) return;
+    for (int v = 0; v < pool->voice_count; v++) {
+        pool->active[v] = false;
+    }
+}
+
+int voice_pool_active_count(const voice_pool_t* pool)
+{
+    if (!pool) return 0;
+    int count = 0;
+    for (int v = 0; v < pool->voice_count; v++) {
+        count += pool->active[v];
+    }
+    return count;
+}
+
+void voice_pool_render_packed(voice_pool_t* pool, uint32_t* out, size_t n_words)
+{
+    if (!pool || !out || n_words == 0) return;
+
+    if (voice_pool_active_count(pool) == 0) {
+        memset(out, 0, n_words * sizeof(uint32_t));
+        pool->result = false;
+        return;
+    }
+
+    for (size_t w0 = 0; w0 < n_words; w0 += VOICE_POOL_CHUNK_WORDS) {
+        size_t chunk = n_words - w0 < VOICE_POOL_CHUNK_WORDS ? n_words - w0 : VOICE_POOL_CHUNK_WORDS;
+        uint32_t* dst = &out[w0];
+        bool first = true;
+
+        // все дорожки банка одним проходом, дальше операции каждого звучащего голоса
+        oscillator_bank_render_packed(&pool->bank, &pool->scratch[0][0], VOICE_POOL_CHUNK_WORDS,
+                                      chunk * PACKED_WORD_BITS);
+        for (int v = 0; v < pool->voice_count; v++) {
+            if (!pool->active[v]) continue;
+
+            uint32_t gate_words[VOICE_POOL_GATES][VOICE_POOL_CHUNK_WORDS];
+            const uint32_t* nodes[VOICE_POOL_NODES];
+            for (int i = 0; i < VOICE_POOL_OSCILLATORS; i++) {
+                nodes[i] = pool->scratch[v * VOICE_POOL_OSCILLATORS + i];
+            }
+            for (int g = 0; g < VOICE_POOL_GATES; g++) {
+                int in1 = pool->patch.inputs[g][0];
+                int in2 = pool->patch.inputs[g][1];
+                logical_ops_calculate_packed(&pool->gates[g], in1 >= 0 ? nodes[in1] : zero_words,
+                                             in2 >= 0 ? nodes[in2] : zero_words, gate_words[g], chunk);
+                nodes[VOICE_POOL_OSCILLATORS + g] = gate_words[g];
+            }
+
+            const uint32_t* voice_out = nodes[VOICE_POOL_NODES - 1];
+            if (first) {
+                memcpy(dst, voice_out, chunk * sizeof(uint32_t));
+                first = false;
+            } else {
+                logical_ops_calculate_packed(&pool->combine, dst, voice_out, dst, chunk);
+            }
+        }
+    }
+
+    pool->result = out[n_words - 1] >> (PACKED_WORD_BITS - 1);
+}
+
+bool* voice_pool_get_result_pointer(voice_pool_t* pool)
+{
+    if (!pool) {
+        ESP_LOGE(TAG, "Voice pool is NULL");
+        return NULL;
+    }
+    return &pool->result;
+}
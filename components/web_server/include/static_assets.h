@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Статика клиента, собранная tools/gen_static_assets.py из dist при сборке.
+// Таблица отсортирована по hash, данные лежат во флеше, gzip - если так меньше.
+
+typedef struct {
+    uint32_t hash;          // FNV-1a of path
+    const char *path;       // URL path without the leading '/'
+    const char *mime;
+    const char *etag;       // quoted, ready for the ETag header
+    bool gzip;              // data is gzip, send with Content-Encoding: gzip
+    const uint8_t *data;
+    size_t size;
+} static_asset_t;
+
+extern const static_asset_t static_assets[];
+extern const size_t static_assets_count;
+
+// FNV-1a over the first len bytes of path, same as the generator
+uint32_t static_asset_hash(const char *path, size_t len);
+
+// Asset for the path without the leading '/', NULL if there is none
+const static_asset_t *static_asset_find(const char *path, size_t len);
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+
+// Кадр потока /ws: заголовок, таблица каналов, затем данные каналов подряд
+// в том же порядке. Все числа little-endian.
+//
+// sequence растет на 1 с каждым кадром, пропуск - потерянный кадр.
+// timestamp - часы отсчетов основного выхода на частоте sample_rate для
+// первого отсчета кадра; разрыв между кадрами - отсчеты, выброшенные до
+// отправки. Длина основного канала меняется, сервер подстраивает блок
+// под очередь отправки.
+//
+// Канал STREAM_CHANNEL_MAIN - основной выход, int8 на частоте захвата.
+// Остальные каналы - отводы узлов, упакованные биты на частоте движка:
+// samples_per_output бит на один отсчет выхода.
+// Канал STREAM_CHANNEL_STATS идет не в каждом кадре: u32 длина окна в
+// отсчетах движка, затем u32 единицы и u32 фронты каждого узла по порядку.
+
+#define STREAM_FRAME_VERSION 2
+#define STREAM_FRAME_MAX_CHANNELS 8
+
+#define STREAM_CHANNEL_MAIN (-1)
+#define STREAM_CHANNEL_STATS (-2)
+
+typedef enum {
+    STREAM_ENCODING_PCM8 = 0,           // int8 samples
+    STREAM_ENCODING_PACKED_BITS = 1,    // 32-bit words, bit 0 of the first word is the oldest sample
+    STREAM_ENCODING_NODE_STATS = 2,     // u32 window samples, then u32 ones and u32 edges per node
+} stream_encoding_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t version;
+    uint8_t channel_count;
+    uint16_t block_size;                // samples per capture block the server is using now
+    uint32_t sequence;
+    uint32_t timestamp;                 // sample clock of the first main output sample
+    uint32_t sample_rate;               // main output rate, Hz
+} stream_frame_header_t;
+
+typedef struct __attribute__((packed)) {
+    int16_t node_id;                    // node of a tap, STREAM_CHANNEL_MAIN for the main output
+    uint8_t encoding;                   // stream_encoding_t
+    uint8_t samples_per_output;         // packed bits per output sample, 1 for PCM
+    uint32_t length;                    // payload bytes
+} stream_channel_t;
@@ -41,6 +41,21 @@ export class BaseApi {
         }
     }
 
+    static async postBinary<T>(endpoint: string, data: ArrayBuffer): Promise<ApiResponse<T>> {
+        try {
+            const response = await fetch(`${this.baseUrl}/${endpoint}`, {
+                method: 'POST',
+                headers: {
+                    'Content-Type': 'application/octet-stream',
+                },
+                body: data
+            });
+            return await this.handleResponse<T>(response);
+        } catch (error) {
+            return this.handleFetchError(error);
+        }
+    }
+
     static async get<T>(endpoint: string): Promise<ApiResponse<T>> {
         try {
             const response = await fetch(`${this.baseUrl}/${endpoint}`);
@@ -1,3 +1,10 @@
 export * from './baseApi';
 export * from './oscillatorApi';
-export * from './logicBlockApi'; 
+export * from './logicBlockApi';
+export * from './voiceApi';
+export * from './sequencerApi';
+export * from './modMatrixApi';
+export * from './tapApi';
+export * from './nodeStatsApi';
+export * from './scopeApi';
+export * from './udpStreamApi';
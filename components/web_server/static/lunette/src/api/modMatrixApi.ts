@@ -0,0 +1,75 @@
+import { BaseApi } from './baseApi';
+
+export type LfoShape = 'sine' | 'triangle' | 'saw' | 'square' | 'random';
+export type ModSource = 'lfo' | 'envelope';
+// frequency: depth in octaves, mixer_weight: depth as a share of the set weight
+export type ModDestination = 'frequency' | 'mixer_weight';
+
+export interface LfoState {
+    index: number;
+    shape: LfoShape;
+    rate: number;
+    value: number;
+}
+
+export interface EnvelopeState {
+    index: number;
+    attack_ms: number;
+    decay_ms: number;
+    sustain: number;
+    release_ms: number;
+    gate: number;
+    value: number;
+}
+
+export interface ModRoute {
+    slot: number;
+    active?: boolean;
+    source?: ModSource;
+    source_index?: number;
+    destination?: ModDestination;
+    destination_index?: number;
+    depth?: number;
+}
+
+export interface ModMatrixState {
+    lfos: LfoState[];
+    envelopes: EnvelopeState[];
+    routes: ModRoute[];
+    max_routes: number;
+    shapes: LfoShape[];
+    sources: ModSource[];
+    destinations: ModDestination[];
+}
+
+// omitted fields keep their values on the device
+export interface ModMatrixCommand {
+    lfo?: Partial<Omit<LfoState, 'value'>> & { index: number };
+    envelope?: Partial<Omit<EnvelopeState, 'value'>> & { index: number };
+    route?: ModRoute;
+}
+
+const useModMatrixApi = () => {
+    const getModMatrix = async (): Promise<ModMatrixState> => {
+        const result = await BaseApi.get<ModMatrixState>('mod-matrix');
+        if (result.success) {
+            return result.data;
+        } else {
+            throw result.error;
+        }
+    };
+
+    const updateModMatrix = async (command: ModMatrixCommand): Promise<void> => {
+        const result = await BaseApi.post('mod-matrix', command);
+        if (!result.success) {
+            throw result.error;
+        }
+    };
+
+    return {
+        getModMatrix,
+        updateModMatrix,
+    };
+};
+
+export default useModMatrixApi;
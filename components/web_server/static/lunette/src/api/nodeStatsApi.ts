@@ -0,0 +1,33 @@
+import { BaseApi } from './baseApi';
+
+export interface NodeStatsState {
+    node: number;
+    duty: number;
+    edges: number;
+    edge_rate: number;
+    stuck?: 'low' | 'high';
+    expected_duty?: number;    // logical operations, from the input duties
+}
+
+export interface NodeStatsResponse {
+    nodes: NodeStatsState[];
+    window_samples: number;
+    engine_rate: number;
+}
+
+const useNodeStatsApi = () => {
+    const getNodeStats = async (): Promise<NodeStatsResponse> => {
+        const result = await BaseApi.get<NodeStatsResponse>('node-stats');
+        if (result.success) {
+            return result.data;
+        } else {
+            throw result.error;
+        }
+    };
+
+    return {
+        getNodeStats,
+    };
+};
+
+export default useNodeStatsApi;
@@ -0,0 +1,29 @@
+import { BaseApi } from './baseApi';
+
+export interface ScopeResponse {
+    node: number;
+    sample_rate: number;        // waveform rate, Hz
+    oversampling: number;
+    waveform: number[];         // int8 range, like the /ws stream
+    spectrum_db: number[];      // bins 0..fft_points/2, 0 dB is a full-scale sine
+    fft_points: number;
+    bin_hz: number;
+}
+
+const useScopeApi = () => {
+    // the device answers 429 when polled faster than every 250 ms
+    const getScope = async (node: number, points = 256): Promise<ScopeResponse> => {
+        const result = await BaseApi.get<ScopeResponse>(`scope?node=${node}&points=${points}`);
+        if (result.success) {
+            return result.data;
+        } else {
+            throw result.error;
+        }
+    };
+
+    return {
+        getScope,
+    };
+};
+
+export default useScopeApi;
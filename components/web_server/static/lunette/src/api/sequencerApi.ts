@@ -0,0 +1,91 @@
+import { BaseApi } from './baseApi';
+
+export type SequencerTarget = 'none' | 'frequency' | 'operation' | 'note' | 'mixer_weight';
+
+// order matches sequencer_target_t in firmware
+const TARGETS: SequencerTarget[] = ['none', 'frequency', 'operation', 'note', 'mixer_weight'];
+
+export interface SequencerPattern {
+    index: number;
+    target: SequencerTarget;
+    target_index: number;
+    division: number;       // steps per beat, 4 for sixteenths
+    gates: boolean[];       // one per step, pattern length is gates.length
+    values: number[];
+}
+
+export interface SequencerState extends SequencerPattern {
+    step: number;
+}
+
+export interface SequencerTransport {
+    bpm?: number;
+    running?: boolean;
+}
+
+interface SequencersResponse {
+    bpm: number;
+    running: boolean;
+    sequencers: SequencerState[];
+}
+
+const RECORD_HEADER_SIZE = 16;
+
+// All patterns in one binary message, see sequencer_handler.h for the layout
+export const encodePatterns = (patterns: SequencerPattern[]): ArrayBuffer => {
+    const size = patterns.reduce((sum, p) => sum + RECORD_HEADER_SIZE + p.gates.length * 4, 0);
+    const buffer = new ArrayBuffer(size);
+    const view = new DataView(buffer);
+    let pos = 0;
+    for (const pattern of patterns) {
+        const length = pattern.gates.length;
+        let gates = 0n;
+        pattern.gates.forEach((gate, step) => {
+            if (gate) gates |= 1n << BigInt(step);
+        });
+        view.setUint8(pos, pattern.index);
+        view.setUint8(pos + 1, TARGETS.indexOf(pattern.target));
+        view.setUint8(pos + 2, pattern.target_index);
+        view.setUint8(pos + 3, length);
+        view.setUint8(pos + 4, pattern.division);
+        view.setBigUint64(pos + 8, gates, true);
+        for (let step = 0; step < length; step++) {
+            view.setFloat32(pos + RECORD_HEADER_SIZE + step * 4, pattern.values[step] ?? 0, true);
+        }
+        pos += RECORD_HEADER_SIZE + length * 4;
+    }
+    return buffer;
+};
+
+const useSequencerApi = () => {
+    const getSequencers = async (): Promise<SequencersResponse> => {
+        const result = await BaseApi.get<SequencersResponse>('sequencers');
+        if (result.success) {
+            return result.data;
+        } else {
+            throw result.error;
+        }
+    };
+
+    const updateTransport = async (transport: SequencerTransport): Promise<void> => {
+        const result = await BaseApi.post('sequencers', transport);
+        if (!result.success) {
+            throw result.error;
+        }
+    };
+
+    const uploadPatterns = async (patterns: SequencerPattern[]): Promise<void> => {
+        const result = await BaseApi.postBinary('sequencer-patterns', encodePatterns(patterns));
+        if (!result.success) {
+            throw result.error;
+        }
+    };
+
+    return {
+        getSequencers,
+        updateTransport,
+        uploadPatterns,
+    };
+};
+
+export default useSequencerApi;
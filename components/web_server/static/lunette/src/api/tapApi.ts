@@ -0,0 +1,39 @@
+import { BaseApi } from './baseApi';
+
+export interface TapState {
+    tap: number;
+    node: number;
+    dropped_words: number;
+}
+
+export interface TapsState {
+    taps: TapState[];
+    max_taps: number;
+    oversampling: number;
+}
+
+const useTapApi = () => {
+    const getTaps = async (): Promise<TapsState> => {
+        const result = await BaseApi.get<TapsState>('taps');
+        if (result.success) {
+            return result.data;
+        } else {
+            throw result.error;
+        }
+    };
+
+    // tapped nodes stream in the /ws frames next to the main output, [] turns them off
+    const setTaps = async (nodes: number[]): Promise<void> => {
+        const result = await BaseApi.post('taps', { nodes });
+        if (!result.success) {
+            throw result.error;
+        }
+    };
+
+    return {
+        getTaps,
+        setTaps,
+    };
+};
+
+export default useTapApi;
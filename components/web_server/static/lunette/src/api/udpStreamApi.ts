@@ -0,0 +1,50 @@
+import { BaseApi } from './baseApi';
+
+export interface UdpStreamState {
+    enabled: boolean;
+    host: string;
+    port: number;
+    payload_type: number;
+    sample_rate: number;
+    ssrc: number;
+    packets_sent: number;
+    send_errors: number;
+}
+
+const useUdpStreamApi = () => {
+    const getUdpStream = async (): Promise<UdpStreamState> => {
+        const result = await BaseApi.get<UdpStreamState>('udp-stream');
+        if (result.success) {
+            return result.data;
+        } else {
+            throw result.error;
+        }
+    };
+
+    // RTP-like packets of the main output, see tools/udp_stream_receiver.py
+    const startUdpStream = async (host: string, port = 5004): Promise<UdpStreamState> => {
+        const result = await BaseApi.post<UdpStreamState>('udp-stream', { enabled: true, host, port });
+        if (result.success) {
+            return result.data;
+        } else {
+            throw result.error;
+        }
+    };
+
+    const stopUdpStream = async (): Promise<UdpStreamState> => {
+        const result = await BaseApi.post<UdpStreamState>('udp-stream', { enabled: false });
+        if (result.success) {
+            return result.data;
+        } else {
+            throw result.error;
+        }
+    };
+
+    return {
+        getUdpStream,
+        startUdpStream,
+        stopUdpStream,
+    };
+};
+
+export default useUdpStreamApi;
@@ -0,0 +1,52 @@
+import { BaseApi } from './baseApi';
+
+export interface VoiceState {
+    voice: number;
+    active: boolean;
+    note: number;
+}
+
+export interface VoicePoolState {
+    node: number;
+    voice_count: number;
+    active_count: number;
+    combine: string;
+    voices: VoiceState[];
+}
+
+export interface VoiceCommand {
+    note_on?: number | number[];
+    note_off?: number | number[];
+    all_off?: boolean;
+    combine?: string;
+}
+
+// MIDI note of a frequency, A4 = 440 Hz = 69
+export const frequencyToNote = (frequency: number): number =>
+    Math.round(69 + 12 * Math.log2(frequency / 440));
+
+const useVoiceApi = () => {
+    const getVoices = async (): Promise<VoicePoolState> => {
+        const result = await BaseApi.get<VoicePoolState>('voices');
+        if (result.success) {
+            return result.data;
+        } else {
+            throw result.error;
+        }
+    };
+
+    // notes are queued on the device and start with its next block
+    const sendVoices = async (command: VoiceCommand): Promise<void> => {
+        const result = await BaseApi.post('voices', command);
+        if (!result.success) {
+            throw result.error;
+        }
+    };
+
+    return {
+        getVoices,
+        sendVoices,
+    };
+};
+
+export default useVoiceApi;
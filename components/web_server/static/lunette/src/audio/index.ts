@@ -1,3 +1,5 @@
 export * from './webSocketAudioInput';
 export * from './reverbAlgo';
-export * from './clientOscillator';
\ No newline at end of file
+export * from './clientOscillator';
+export * from './streamFrame';
+export * from './streamJitterBuffer';
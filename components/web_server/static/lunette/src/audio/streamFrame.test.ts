@@ -0,0 +1,70 @@
+import { parseStreamFrame, parseNodeStats, packedBitsToFloat, pcm8ToFloat, StreamEncoding, STREAM_CHANNEL_MAIN } from './streamFrame';
+
+const buildFrame = (channels: { node: number; encoding: number; spo: number; data: number[] }[]): ArrayBuffer => {
+    const size = 16 + channels.length * 8 + channels.reduce((sum, c) => sum + c.data.length, 0);
+    const buffer = new ArrayBuffer(size);
+    const view = new DataView(buffer);
+    view.setUint8(0, 2);
+    view.setUint8(1, channels.length);
+    view.setUint16(2, 128, true);
+    view.setUint32(4, 7, true);
+    view.setUint32(8, 0xfffffff0, true);
+    view.setUint32(12, 10000, true);
+    let offset = 16 + channels.length * 8;
+    channels.forEach((c, i) => {
+        view.setInt16(16 + i * 8, c.node, true);
+        view.setUint8(16 + i * 8 + 2, c.encoding);
+        view.setUint8(16 + i * 8 + 3, c.spo);
+        view.setUint32(16 + i * 8 + 4, c.data.length, true);
+        c.data.forEach((byte, k) => view.setUint8(offset + k, byte));
+        offset += c.data.length;
+    });
+    return buffer;
+};
+
+describe('parseStreamFrame', () => {
+    it('splits the main output and the taps', () => {
+        const frame = parseStreamFrame(buildFrame([
+            { node: -1, encoding: 0, spo: 1, data: [0x80, 0x00, 0x7f] },
+            { node: 5, encoding: 1, spo: 8, data: [0x0f, 0x00, 0xff, 0xff] },
+        ]));
+
+        expect(frame).not.toBeNull();
+        expect(frame!.blockSize).toBe(128);
+        expect(frame!.sequence).toBe(7);
+        expect(frame!.timestamp).toBe(0xfffffff0);
+        expect(frame!.sampleRate).toBe(10000);
+        expect(frame!.channels).toHaveLength(2);
+        expect(frame!.channels[0].node).toBe(STREAM_CHANNEL_MAIN);
+        expect(frame!.channels[1].node).toBe(5);
+        expect(frame!.channels[1].encoding).toBe(StreamEncoding.PackedBits);
+        expect(Array.from(pcm8ToFloat(frame!.channels[0].data))).toEqual([-1, 0, 127 / 128]);
+        expect(Array.from(packedBitsToFloat(frame!.channels[1].data, 8))).toEqual([0, -1, 1, 1]);
+    });
+
+    it('rejects truncated frames and other versions', () => {
+        const buffer = buildFrame([{ node: -1, encoding: 0, spo: 1, data: [1, 2, 3, 4] }]);
+        expect(parseStreamFrame(buffer.slice(0, buffer.byteLength - 1))).toBeNull();
+        new DataView(buffer).setUint8(0, 1);
+        expect(parseStreamFrame(buffer)).toBeNull();
+    });
+});
+
+describe('parseNodeStats', () => {
+    it('turns ones into duty', () => {
+        const data = new Uint8Array(4 + 2 * 8);
+        const view = new DataView(data.buffer);
+        view.setUint32(0, 1000, true);
+        view.setUint32(4, 250, true);
+        view.setUint32(8, 40, true);
+        view.setUint32(12, 1000, true);
+        view.setUint32(16, 0, true);
+
+        const stats = parseNodeStats(data);
+        expect(stats.windowSamples).toBe(1000);
+        expect(stats.nodes).toEqual([
+            { node: 0, duty: 0.25, edges: 40 },
+            { node: 1, duty: 1, edges: 0 },
+        ]);
+    });
+});
@@ -0,0 +1,125 @@
+// Frame of the /ws stream, see components/web_server/include/stream_frame.h:
+// header, channel table, then the channel payloads in table order, little-endian.
+// sequence counts frames, timestamp is the sample clock of the first main sample.
+
+export const STREAM_FRAME_VERSION = 2;
+export const STREAM_CHANNEL_MAIN = -1;
+export const STREAM_CHANNEL_STATS = -2;
+
+const HEADER_SIZE = 16;
+const CHANNEL_SIZE = 8;
+
+export const StreamEncoding = {
+    Pcm8: 0,
+    PackedBits: 1,
+    NodeStats: 2,
+} as const;
+export type StreamEncoding = (typeof StreamEncoding)[keyof typeof StreamEncoding];
+
+export interface StreamChannel {
+    node: number;
+    encoding: StreamEncoding;
+    samplesPerOutput: number;
+    data: Uint8Array;
+}
+
+// Counters of one node over the last statistics window
+export interface NodeStats {
+    node: number;
+    duty: number;
+    edges: number;
+}
+
+export interface NodeStatsWindow {
+    windowSamples: number;
+    nodes: NodeStats[];
+}
+
+export interface StreamFrame {
+    version: number;
+    blockSize: number;          // capture block the server is using now
+    sequence: number;
+    timestamp: number;          // u32, wraps
+    sampleRate: number;         // main output rate, Hz
+    channels: StreamChannel[];
+}
+
+// null for a frame that is too short or of another version
+export const parseStreamFrame = (buffer: ArrayBuffer): StreamFrame | null => {
+    const view = new DataView(buffer);
+    if (buffer.byteLength < HEADER_SIZE || view.getUint8(0) !== STREAM_FRAME_VERSION) {
+        return null;
+    }
+
+    const count = view.getUint8(1);
+    let offset = HEADER_SIZE + count * CHANNEL_SIZE;
+    if (buffer.byteLength < offset) {
+        return null;
+    }
+
+    const channels: StreamChannel[] = [];
+    for (let c = 0; c < count; c++) {
+        const entry = HEADER_SIZE + c * CHANNEL_SIZE;
+        const length = view.getUint32(entry + 4, true);
+        if (offset + length > buffer.byteLength) {
+            return null;
+        }
+        channels.push({
+            node: view.getInt16(entry, true),
+            encoding: view.getUint8(entry + 2) as StreamEncoding,
+            samplesPerOutput: view.getUint8(entry + 3),
+            data: new Uint8Array(buffer, offset, length),
+        });
+        offset += length;
+    }
+    return {
+        version: STREAM_FRAME_VERSION,
+        blockSize: view.getUint16(2, true),
+        sequence: view.getUint32(4, true),
+        timestamp: view.getUint32(8, true),
+        sampleRate: view.getUint32(12, true),
+        channels,
+    };
+};
+
+// int8 samples (-128 to 127) to float32 (-1.0 to 1.0)
+export const pcm8ToFloat = (data: Uint8Array): Float32Array => {
+    const samples = new Int8Array(data.buffer, data.byteOffset, data.byteLength);
+    const out = new Float32Array(samples.length);
+    for (let i = 0; i < samples.length; i++) {
+        out[i] = samples[i] / 128.0;
+    }
+    return out;
+};
+
+// Packed bits at the engine rate to output samples: the mean of
+// samplesPerOutput bits, high = +1 and low = -1
+export const packedBitsToFloat = (data: Uint8Array, samplesPerOutput: number): Float32Array => {
+    const step = Math.max(1, samplesPerOutput);
+    const bits = data.byteLength * 8;
+    const out = new Float32Array(Math.floor(bits / step));
+    for (let i = 0; i < out.length; i++) {
+        let ones = 0;
+        for (let b = i * step; b < (i + 1) * step; b++) {
+            ones += (data[b >> 3] >> (b & 7)) & 1;
+        }
+        out[i] = (2 * ones - step) / step;
+    }
+    return out;
+};
+
+// u32 window length, then u32 ones and u32 edges per node
+export const parseNodeStats = (data: Uint8Array): NodeStatsWindow => {
+    const view = new DataView(data.buffer, data.byteOffset, data.byteLength);
+    const windowSamples = view.getUint32(0, true);
+    const nodes: NodeStats[] = [];
+    for (let offset = 4; offset + 8 <= data.byteLength; offset += 8) {
+        const ones = view.getUint32(offset, true);
+        nodes.push({
+            node: nodes.length,
+            duty: windowSamples > 0 ? ones / windowSamples : 0,
+            edges: view.getUint32(offset + 4, true),
+        });
+    }
+    return { windowSamples, nodes };
+};
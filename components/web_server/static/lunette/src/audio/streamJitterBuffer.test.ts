@@ -0,0 +1,59 @@
+import { StreamJitterBuffer } from './streamJitterBuffer';
+
+const block = (sequence: number, timestamp: number, length: number, value = 1) => ({
+    sequence,
+    timestamp,
+    sampleRate: 1000,
+    samples: new Float32Array(length).fill(value),
+});
+
+describe('StreamJitterBuffer', () => {
+    it('holds samples back until the target depth', () => {
+        const buffer = new StreamJitterBuffer(50);
+        buffer.push(block(0, 0, 32), 0);
+        buffer.push(block(1, 32, 32), 10);
+        expect(buffer.pop()).toHaveLength(0);
+        buffer.push(block(2, 64, 32), 20);
+        buffer.push(block(3, 96, 32), 30);
+        // blocks 2 and 3 keep 64 samples, at least the 50 ms target
+        expect(buffer.pop()).toHaveLength(64);
+        expect(buffer.pop()).toHaveLength(0);
+    });
+
+    it('orders blocks by timestamp and counts lost frames', () => {
+        const buffer = new StreamJitterBuffer(4);
+        buffer.push(block(0, 0, 4, 1), 0);
+        buffer.push(block(2, 8, 4, 3), 0);
+        expect(Array.from(buffer.pop())).toEqual([1, 1, 1, 1]);
+        // frame 1 arrives before its deadline and plays in its place
+        buffer.push(block(1, 4, 4, 2), 0);
+        buffer.push(block(3, 12, 4, 4), 0);
+        expect(Array.from(buffer.pop())).toEqual([2, 2, 2, 2, 3, 3, 3, 3]);
+        expect(buffer.getStats()).toMatchObject({ lostFrames: 0, reordered: 1 });
+
+        // frame 4 never comes: lost once its gap is played
+        buffer.push(block(5, 20, 4, 6), 0);
+        buffer.push(block(6, 24, 4, 7), 0);
+        expect(Array.from(buffer.pop())).toEqual([4, 4, 4, 4, 0, 0, 0, 0, 6, 6, 6, 6]);
+        expect(buffer.getStats()).toMatchObject({ lostFrames: 1, concealedSamples: 4 });
+    });
+
+    it('fills short gaps with silence and drops late blocks', () => {
+        const buffer = new StreamJitterBuffer(0, 100);
+        buffer.push(block(0, 0xfffffffc, 4), 0);
+        buffer.push(block(2, 4, 4), 0);
+        expect(Array.from(buffer.pop())).toEqual([1, 1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1]);
+        expect(buffer.getStats().concealedSamples).toBe(4);
+
+        buffer.push(block(1, 0, 4), 0);
+        expect(buffer.pop()).toHaveLength(0);
+        expect(buffer.getStats().late).toBe(1);
+    });
+
+    it('skips gaps longer than the limit', () => {
+        const buffer = new StreamJitterBuffer(0, 10);
+        buffer.push(block(0, 0, 4), 0);
+        buffer.push(block(1, 1000, 4), 0);
+        expect(buffer.pop()).toHaveLength(8);
+    });
+});
@@ -0,0 +1,147 @@
+// Jitter buffer for the main output of the /ws stream. Blocks are ordered by
+// the sample clock from the frame header and held until the playout deadline,
+// targetMs behind the newest sample received, so a block that arrives out of
+// order still makes it in. Short gaps are filled with silence, long ones resync.
+
+export interface JitterBlock {
+    sequence: number;
+    timestamp: number;          // u32 sample clock of the first sample
+    sampleRate: number;
+    samples: Float32Array;
+}
+
+export interface JitterBufferStats {
+    received: number;
+    lostFrames: number;         // frames still missing when their samples were played
+    reordered: number;
+    late: number;               // blocks dropped because their samples were already played
+    concealedSamples: number;
+    driftPpm: number;           // device sample clock against the local clock
+}
+
+// signed distance between two u32 sample clocks
+const clockDiff = (a: number, b: number): number => (a - b) | 0;
+
+export class StreamJitterBuffer {
+    private targetMs: number;       // held back behind the newest sample
+    private maxGapMs: number;       // longer gaps are skipped instead of filled
+    private pending: JitterBlock[] = [];
+    private nextTimestamp: number | null = null;
+    private newestEnd: number | null = null;       // sample clock after the newest block
+    private lastSequence: number | null = null;    // newest received
+    private playedSequence: number | null = null;  // last released
+    private firstArrival: { ms: number; timestamp: number } | null = null;
+    private stats: JitterBufferStats = {
+        received: 0,
+        lostFrames: 0,
+        reordered: 0,
+        late: 0,
+        concealedSamples: 0,
+        driftPpm: 0,
+    };
+
+    constructor(targetMs = 60, maxGapMs = 200) {
+        this.targetMs = targetMs;
+        this.maxGapMs = maxGapMs;
+    }
+
+    push(block: JitterBlock, arrivalMs: number = performance.now()) {
+        this.stats.received++;
+        if (this.lastSequence !== null && clockDiff(block.sequence, this.lastSequence) <= 0) {
+            this.stats.reordered++;
+        }
+        if (this.lastSequence === null || clockDiff(block.sequence, this.lastSequence) > 0) {
+            this.lastSequence = block.sequence;
+        }
+
+        if (this.nextTimestamp !== null
+            && clockDiff(block.timestamp + block.samples.length, this.nextTimestamp) <= 0) {
+            this.stats.late++;
+            return;
+        }
+        this.trackDrift(block, arrivalMs);
+        const end = (block.timestamp + block.samples.length) >>> 0;
+        if (this.newestEnd === null || clockDiff(end, this.newestEnd) > 0) {
+            this.newestEnd = end;
+        }
+
+        let i = this.pending.length;
+        while (i > 0 && clockDiff(this.pending[i - 1].timestamp, block.timestamp) > 0) {
+            i--;
+        }
+        this.pending.splice(i, 0, block);
+    }
+
+    // samples past the playout deadline in order, empty while they are all newer
+    pop(): Float32Array {
+        if (this.pending.length === 0 || this.newestEnd === null) {
+            return new Float32Array(0);
+        }
+        const rate = this.pending[0].sampleRate;
+        const deadline = (this.newestEnd - Math.round((this.targetMs * rate) / 1000)) >>> 0;
+
+        const parts: Float32Array[] = [];
+        const maxGap = (this.maxGapMs * rate) / 1000;
+        while (this.pending.length > 0) {
+            const block = this.pending[0];
+            // блок целиком старше срока, иначе ждем: недостающий может еще прийти
+            if (clockDiff(block.timestamp + block.samples.length, deadline) > 0) {
+                break;
+            }
+            this.pending.shift();
+            if (this.nextTimestamp === null) {
+                this.nextTimestamp = block.timestamp;
+            }
+            // кадры, которых так и не было к сроку
+            if (this.playedSequence !== null) {
+                const step = clockDiff(block.sequence, this.playedSequence);
+                if (step > 1) this.stats.lostFrames += step - 1;
+            }
+            this.playedSequence = block.sequence;
+
+            const gap = clockDiff(block.timestamp, this.nextTimestamp);
+            if (gap > 0 && gap <= maxGap) {
+                parts.push(new Float32Array(gap));
+                this.stats.concealedSamples += gap;
+            }
+            // перекрытие с уже сыгранным отрезается
+            const skip = gap < 0 ? -gap : 0;
+            parts.push(block.samples.subarray(skip));
+            this.nextTimestamp = (block.timestamp + block.samples.length) >>> 0;
+        }
+
+        const out = new Float32Array(parts.reduce((sum, p) => sum + p.length, 0));
+        let offset = 0;
+        for (const part of parts) {
+            out.set(part, offset);
+            offset += part.length;
+        }
+        return out;
+    }
+
+    getStats(): JitterBufferStats {
+        return { ...this.stats };
+    }
+
+    reset() {
+        this.pending = [];
+        this.nextTimestamp = null;
+        this.newestEnd = null;
+        this.lastSequence = null;
+        this.playedSequence = null;
+        this.firstArrival = null;
+    }
+
+    // сколько отсчетов устройство выдало за время по локальным часам
+    private trackDrift(block: JitterBlock, arrivalMs: number) {
+        if (!this.firstArrival) {
+            this.firstArrival = { ms: arrivalMs, timestamp: block.timestamp };
+            return;
+        }
+        const elapsedMs = arrivalMs - this.firstArrival.ms;
+        if (elapsedMs < 1000) return;
+        const produced = clockDiff(block.timestamp, this.firstArrival.timestamp);
+        const expected = (elapsedMs * block.sampleRate) / 1000;
+        this.stats.driftPpm = Math.round((produced / expected - 1) * 1e6);
+    }
+}
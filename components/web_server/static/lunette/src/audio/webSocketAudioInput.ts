@@ -1,9 +1,37 @@
 // write useWebSocketAudioInput hook
 import audioWorkletUrl from '@worklets/audio-worklet.js?url';
 import { useEffect, useRef, useCallback, useState } from 'react';
-
-export const useWebSocketAudioInput = (context: AudioContext | null, wsUrl: string) => {
+import {
+    parseStreamFrame,
+    parseNodeStats,
+    pcm8ToFloat,
+    packedBitsToFloat,
+    type NodeStatsWindow,
+    StreamEncoding,
+    STREAM_CHANNEL_MAIN,
+} from './streamFrame';
+import { StreamJitterBuffer } from './streamJitterBuffer';
+
+// Samples of a tapped node, one per output sample, -1.0 to 1.0
+export interface TapSamples {
+    node: number;
+    samples: Float32Array;
+}
+
+export interface StreamListeners {
+    onTaps?: (taps: TapSamples[]) => void;
+    onStats?: (stats: NodeStatsWindow) => void;
+}
+
+export const useWebSocketAudioInput = (
+    context: AudioContext | null,
+    wsUrl: string,
+    listeners?: StreamListeners
+) => {
     const ws = useRef<WebSocket | null>(null);
+    const listenersRef = useRef(listeners);
+    listenersRef.current = listeners;
+    const jitterBuffer = useRef(new StreamJitterBuffer());
     const audioContext = useRef<AudioContext | null>(null);
     const audioWorkletNode = useRef<AudioWorkletNode | null>(null);
     const [audioWorkletNodeState, setAudioWorkletNodeState] = useState<AudioWorkletNode | null>(null);
@@ -36,19 +64,40 @@ export const useWebSocketAudioInput = (context: AudioContext | null, wsUrl: stri
         // }
 
         const arrayBuffer = await blob.arrayBuffer();
-        const int8Array = new Int8Array(arrayBuffer);
+        const frame = parseStreamFrame(arrayBuffer);
+        if (!frame) {
+            console.error('WebSocketAudioInput: bad stream frame', arrayBuffer.byteLength);
+            return;
+        }
 
-        // Convert int8 samples (-128 to 127) to float32 (-1.0 to 1.0)
-        const float32Array = new Float32Array(int8Array.length);
-        for (let i = 0; i < int8Array.length; i++) {
-            float32Array[i] = int8Array[i] / 128.0;
+        // main output goes to the worklet, node taps to the listener
+        const main = frame.channels.find((channel) => channel.node === STREAM_CHANNEL_MAIN);
+        const taps = frame.channels
+            .filter((channel) => channel.node !== STREAM_CHANNEL_MAIN && channel.encoding === StreamEncoding.PackedBits)
+            .map((channel) => ({ node: channel.node, samples: packedBitsToFloat(channel.data, channel.samplesPerOutput) }));
+        if (taps.length > 0) {
+            listenersRef.current?.onTaps?.(taps);
+        }
+        const stats = frame.channels.find((channel) => channel.encoding === StreamEncoding.NodeStats);
+        if (stats) {
+            listenersRef.current?.onStats?.(parseNodeStats(stats.data));
+        }
+        if (!main) {
+            return;
         }
+        jitterBuffer.current.push({
+            sequence: frame.sequence,
+            timestamp: frame.timestamp,
+            sampleRate: frame.sampleRate,
+            samples: pcm8ToFloat(main.data),
+        });
+        const float32Array = jitterBuffer.current.pop();
 
         // Send audio data to the worklet
-        if (audioWorkletNode.current) {
+        if (audioWorkletNode.current && float32Array.length > 0) {
             audioWorkletNode.current.port.postMessage({
                 audioData: float32Array,
-                sampleRate: 10000 // ESP32 sample rate
+                sampleRate: frame.sampleRate
             });
         }
     }, []);
@@ -71,6 +120,7 @@ export const useWebSocketAudioInput = (context: AudioContext | null, wsUrl: stri
 
         ws.current.onopen = () => {
             console.log('Connected to WebSocket server');
+            jitterBuffer.current.reset();
         };
 
         ws.current.onmessage = async (event: MessageEvent) => {
@@ -96,6 +146,7 @@ export const useWebSocketAudioInput = (context: AudioContext | null, wsUrl: stri
 
     return {
         audioWorkletNode: audioWorkletNodeState,
+        getStreamStats: () => jitterBuffer.current.getStats(),
     };
 };
 
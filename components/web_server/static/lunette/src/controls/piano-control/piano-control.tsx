@@ -22,6 +22,8 @@ interface PianoControlProps {
   freq?: number;
   onNoteSelect?: (frequency: number) => void;
   showTwoOctaves?: boolean;
+  // chord mode: every held frequency is highlighted instead of the last pressed key
+  heldFrequencies?: number[];
 }
 
 const NOTES = ['C', 'C#', 'D', 'D#', 'E', 'F', 'F#', 'G', 'G#', 'A', 'A#', 'B'];
@@ -52,6 +54,7 @@ export const PianoControl: React.FC<PianoControlProps> = ({
   freq,
   onNoteSelect,
   showTwoOctaves = true,
+  heldFrequencies,
 }) => {
   const [selectedOctave, setSelectedOctave] = useState(4);
   const [secondOctave, setSecondOctave] = useState(5);
@@ -110,7 +113,8 @@ export const PianoControl: React.FC<PianoControlProps> = ({
       const isPressed = pressedKey === fullNote;
       const showOctaveLabel = note === 'C';
 
-      const isActive = pressedKey === "" ? isOutsideFrequency : isPressed;
+      const isHeld = heldFrequencies?.some((held) => getNoteFromFrequency(held) === fullNote) ?? false;
+      const isActive = heldFrequencies ? isHeld : pressedKey === "" ? isOutsideFrequency : isPressed;
 
       return (
         <div
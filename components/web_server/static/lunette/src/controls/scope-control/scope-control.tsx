@@ -0,0 +1,81 @@
+import React, { useEffect, useRef, useState } from 'react';
+import useScopeApi, { type ScopeResponse } from '@api/scopeApi';
+import './scope-control.css';
+
+interface ScopeControlProps {
+    node: number;
+    intervalMs?: number;        // not below the 250 ms the device allows
+}
+
+const DB_RANGE = 100;
+
+// waveform on top, spectrum in dB below; the device does the FFT so only
+// a few KB of JSON cross the link per refresh
+const drawScope = (canvas: HTMLCanvasElement, scope: ScopeResponse) => {
+    const ctx = canvas.getContext('2d');
+    if (!ctx) return;
+    const { width, height } = canvas;
+    const half = height / 2;
+    ctx.clearRect(0, 0, width, height);
+
+    ctx.strokeStyle = '#4caf50';
+    ctx.beginPath();
+    scope.waveform.forEach((value, i) => {
+        const x = (i / (scope.waveform.length - 1)) * width;
+        const y = half / 2 - (value / 128) * (half / 2 - 2);
+        if (i === 0) ctx.moveTo(x, y); else ctx.lineTo(x, y);
+    });
+    ctx.stroke();
+
+    ctx.strokeStyle = '#ff9800';
+    ctx.beginPath();
+    scope.spectrum_db.forEach((db, k) => {
+        const x = (k / (scope.spectrum_db.length - 1)) * width;
+        const level = Math.max(0, Math.min(1, (db + DB_RANGE) / DB_RANGE));
+        const y = height - level * (half - 2);
+        if (k === 0) ctx.moveTo(x, y); else ctx.lineTo(x, y);
+    });
+    ctx.stroke();
+};
+
+const ScopeControl: React.FC<ScopeControlProps> = ({ node, intervalMs = 500 }) => {
+    const { getScope } = useScopeApi();
+    const canvasRef = useRef<HTMLCanvasElement>(null);
+    const [peak, setPeak] = useState<string>('');
+
+    useEffect(() => {
+        let cancelled = false;
+        let timer: number | null = null;
+
+        const refresh = async () => {
+            try {
+                const scope = await getScope(node);
+                if (cancelled) return;
+                if (canvasRef.current) drawScope(canvasRef.current, scope);
+                let best = 1;
+                scope.spectrum_db.forEach((db, k) => {
+                    if (k > 0 && db > scope.spectrum_db[best]) best = k;
+                });
+                setPeak(`${Math.round(best * scope.bin_hz)} Hz, ${scope.spectrum_db[best]} dB`);
+            } catch {
+                if (!cancelled) setPeak('—');
+            }
+            if (!cancelled) timer = window.setTimeout(refresh, Math.max(intervalMs, 250));
+        };
+        refresh();
+
+        return () => {
+            cancelled = true;
+            if (timer !== null) window.clearTimeout(timer);
+        };
+    }, [node, intervalMs]);
+
+    return (
+        <div className="scope-control">
+            <canvas ref={canvasRef} width={512} height={240} />
+            <div className="title">NODE {node} · {peak}</div>
+        </div>
+    );
+};
+
+export default ScopeControl;
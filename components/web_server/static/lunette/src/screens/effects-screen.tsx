@@ -1,6 +1,7 @@
 // screen for managing effects
 import React, { useEffect, useState } from 'react';
 import ValueControl from '@controls/value-control/value-control';
+import ScopeControl from '@controls/scope-control/scope-control';
 import { useEffects } from '@contexts/EffectsContext';
 import { type OutputFiltersParameters } from '@audio/output-filters';
 import { type ReverbParameters } from '@audio/reverbAlgo';
@@ -185,6 +186,9 @@ const EffectsScreen: React.FC<EffectsScreenProps> = ({
                     />
                 </div>
             </div>
+            <div className="content-block">
+                <ScopeControl node={6} />
+            </div>
             <div id="debug-log" className="debug-log" style={{ color: 'black' }}>
             </div>
         </div>
@@ -1,16 +1,48 @@
+import { useEffect, useState } from "react";
 import { PianoControl } from "@controls/piano-control/piano-control";
 import './keyboard-screen.css';
 import { useOscillatorContext } from "@/contexts/OscillatorContext";
+import useVoiceApi, { frequencyToNote } from "@api/voiceApi";
+
+const noteToFrequency = (note: number): number => 440 * Math.pow(2, (note - 69) / 12);
 
 export const KeyboardScreen = () => {
     const { oscillators, updateOscillator, isLoading: oscillatorsLoading } = useOscillatorContext();
+    const { getVoices, sendVoices } = useVoiceApi();
+    // notes held on the voice pool, a key press toggles its note
+    const [heldNotes, setHeldNotes] = useState<number[]>([]);
 
     const updateOscillatorFrequency = (oscillator_id: number, frequency: number) => {
         updateOscillator({ oscillator_id, frequency, amplitude: 1.0 });
     }
 
+    useEffect(() => {
+        getVoices()
+            .then((pool) => setHeldNotes(pool.voices.filter((voice) => voice.active).map((voice) => voice.note)))
+            .catch((error) => console.error('Failed to load voices', error));
+    }, []);
+
+    const toggleChordNote = (frequency: number) => {
+        const note = frequencyToNote(frequency);
+        const held = heldNotes.includes(note);
+        sendVoices(held ? { note_off: note } : { note_on: note })
+            .then(() => getVoices())
+            .then((pool) => setHeldNotes(pool.voices.filter((voice) => voice.active).map((voice) => voice.note)))
+            .catch((error) => console.error('Failed to update voices', error));
+    }
+
+    const releaseChord = () => {
+        sendVoices({ all_off: true })
+            .then(() => setHeldNotes([]))
+            .catch((error) => console.error('Failed to release voices', error));
+    }
+
   return (
     <div className={`keyboard-screen ${!oscillatorsLoading || "loading-block"} `}>
+      <div className="keyboard-screen-chord">
+        <PianoControl heldFrequencies={heldNotes.map(noteToFrequency)} onNoteSelect={toggleChordNote} />
+        <button className="keyboard-screen-release" onClick={releaseChord}>All notes off</button>
+      </div>
       <PianoControl freq={oscillators[0]?.frequency} onNoteSelect={(value) => updateOscillatorFrequency(0, value)} />
       <PianoControl freq={oscillators[1]?.frequency} onNoteSelect={(value) => updateOscillatorFrequency(1, value)} />
       <PianoControl freq={oscillators[2]?.frequency} onNoteSelect={(value) => updateOscillatorFrequency(2, value)} />
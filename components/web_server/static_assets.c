@@ -0,0 +1,44 @@
+#include "static_assets.h"
+
+#include <string.h>
+
+uint32_t static_asset_hash(const char *path, size_t len)
+{
+    uint32_t hash = 0x811C9DC5u;
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= (uint8_t)path[i];
+        hash *= 0x01000193u;
+    }
+    return hash;
+}
+
+const static_asset_t *static_asset_find(const char *path, size_t len)
+{
+    uint32_t hash = static_asset_hash(path, len);
+    size_t lo = 0;
+    size_t hi = static_assets_count;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        const static_asset_t *asset = &static_assets[mid];
+        if (asset->hash < hash)
+        {
+            lo = mid + 1;
+        }
+        else if (asset->hash > hash)
+        {
+            hi = mid;
+        }
+        else
+        {
+            // генератор не допускает коллизий, строка сверяется от чужих путей
+            if (strncmp(asset->path, path, len) == 0 && asset->path[len] == '\0')
+            {
+                return asset;
+            }
+            return NULL;
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+"""Generate the static asset table for the web server.
+
+Walks the client build (static/lunette/dist), gzip-compresses every file
+and writes a C source with the data and a table sorted by path hash:
+
+    python3 gen_static_assets.py static/lunette/dist build/static_assets_data.c
+
+Each entry carries the FNV-1a hash of the URL path without the leading
+slash, the MIME type, a strong ETag from the content and whether the data
+is gzip. Files that do not shrink (images, tiny files) are stored as is.
+The hash must match static_asset_hash() in static_assets.c.
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+import sys
+
+MIME_TYPES = {
+    ".html": "text/html",
+    ".js": "application/javascript",
+    ".mjs": "application/javascript",
+    ".css": "text/css",
+    ".json": "application/json",
+    ".svg": "image/svg+xml",
+    ".png": "image/png",
+    ".jpg": "image/jpeg",
+    ".jpeg": "image/jpeg",
+    ".ico": "image/x-icon",
+    ".woff2": "font/woff2",
+    ".txt": "text/plain",
+}
+
+
+def fnv1a(text):
+    h = 0x811C9DC5
+    for b in text.encode("utf-8"):
+        h ^= b
+        h = (h * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def collect(root):
+    assets = []
+    for dirpath, _, files in os.walk(root):
+        for name in files:
+            full = os.path.join(dirpath, name)
+            path = os.path.relpath(full, root).replace(os.sep, "/")
+            if path.endswith((".gz", ".map")):
+                continue
+            with open(full, "rb") as f:
+                raw = f.read()
+            # mtime=0 keeps the output reproducible between builds
+            packed = gzip.compress(raw, compresslevel=9, mtime=0)
+            is_gzip = len(packed) < len(raw)
+            ext = os.path.splitext(name)[1].lower()
+            assets.append({
+                "path": path,
+                "hash": fnv1a(path),
+                "mime": MIME_TYPES.get(ext, "application/octet-stream"),
+                "etag": '"%s"' % hashlib.sha1(raw).hexdigest()[:16],
+                "gzip": is_gzip,
+                "data": packed if is_gzip else raw,
+                "raw_size": len(raw),
+            })
+    assets.sort(key=lambda a: a["hash"])
+    for a, b in zip(assets, assets[1:]):
+        if a["hash"] == b["hash"]:
+            raise SystemExit(f"path hash collision: {a['path']} and {b['path']}")
+    return assets
+
+
+def c_string(text):
+    return '"' + text.replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+
+def write_source(assets, out):
+    lines = [
+        "// Generated by gen_static_assets.py, do not edit",
+        "",
+        '#include "static_assets.h"',
+        "",
+    ]
+    for i, a in enumerate(assets):
+        lines.append(f"// {a['path']}: {a['raw_size']} -> {len(a['data'])} bytes")
+        lines.append(f"static const uint8_t asset_{i}[] = {{")
+        data = a["data"]
+        for off in range(0, len(data), 16):
+            lines.append("    " + ", ".join(f"0x{b:02x}" for b in data[off:off + 16]) + ",")
+        lines.append("};")
+        lines.append("")
+
+    lines.append("const static_asset_t static_assets[] = {")
+    for i, a in enumerate(assets):
+        lines.append(
+            f"    {{0x{a['hash']:08x}u, {c_string(a['path'])}, {c_string(a['mime'])}, "
+            f"{c_string(a['etag'])}, {'true' if a['gzip'] else 'false'}, asset_{i}, sizeof(asset_{i})}},"
+        )
+    if not assets:
+        # пустой dist: таблица из одного нулевого элемента, count остается 0
+        lines.append("    {0},")
+    lines.append("};")
+    lines.append("")
+    lines.append(f"const size_t static_assets_count = {len(assets)};")
+    lines.append("")
+
+    text = "\n".join(lines)
+    # не трогать файл без изменений, чтобы не пересобирать компонент
+    if os.path.exists(out):
+        with open(out) as f:
+            if f.read() == text:
+                return
+    with open(out, "w") as f:
+        f.write(text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("dist", help="client build directory")
+    parser.add_argument("output", help="generated C source")
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.dist):
+        print(f"warning: {args.dist} not found, build the client first", file=sys.stderr)
+        assets = []
+    else:
+        assets = collect(args.dist)
+    write_source(assets, args.output)
+
+    raw = sum(a["raw_size"] for a in assets)
+    stored = sum(len(a["data"]) for a in assets)
+    print(f"static assets: {len(assets)} files, {raw} -> {stored} bytes")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -2,22 +2,43 @@
 #include "api_registry.h"
 #include "oscillator_handler.h"
 #include "output.h"
+#include "oscillator_logic.h"
+#include "stream_frame.h"
+#include "common_defs.h"
 
 #include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdint.h>
 #include "esp_log.h"
 #include "esp_http_server.h"
 #include "esp_https_server.h"
 #include "mdns.h"
 #include "cJSON.h"
 #include "esp_timer.h"
+#include "static_assets.h"
 
 static const char *TAG = "web_server";
 static httpd_handle_t server = NULL;
-// static httpd_req_t *ws_req = NULL;
-static httpd_handle_t ws_req_hd = NULL;
-static int ws_req_fd = 0;
-static bool ws_connected = false;     // Add connection state tracking
-static uint32_t last_ws_activity = 0; // Track last successful WebSocket activity
+
+// Клиент потока живет вместе с сессией httpd: состояние кладется в sess_ctx
+// при рукопожатии, закрытие сокета приходит в close_fn. Поток читает только
+// stream_fd, все остальное трогает одна задача HTTP-сервера.
+typedef struct {
+    int fd;
+    uint32_t missed_pongs;      // pings sent since the last pong or frame from the client
+    int64_t last_seen_us;       // last pong or frame from the client
+} ws_session_t;
+
+// Ping every this often, a client silent for WS_MAX_MISSED_PONGS pings is closed
+#define WS_PING_INTERVAL_MS 1000
+#define WS_MAX_MISSED_PONGS 3
+// control frames carry at most 125 bytes, the client sends nothing longer
+#define WS_MAX_RECV_PAYLOAD 125
+
+static volatile int stream_fd = -1;
+static ws_session_t *stream_session = NULL;
+static esp_timer_handle_t ping_timer = NULL;
 
 // WebSocket frame receive buffer
 // #define WS_BUFFER_SIZE 1024
@@ -25,6 +46,34 @@ static uint32_t last_ws_activity = 0; // Track last successful WebSocket activit
 
 static output_handle_t output = NULL;
 
+// Tap words sent per frame and tap, the rest waits in the ring for the next frame
+#define STREAM_TAP_MAX_WORDS 512
+// Node statistics ride along every this many frames, about 5 times a second
+#define STREAM_STATS_INTERVAL 8
+#define STREAM_STATS_SIZE (sizeof(uint32_t) + OSCILLATOR_LOGIC_NODE_COUNT * 2 * sizeof(uint32_t))
+// All blocks waiting in the capture ring go out in one frame
+#define STREAM_MAIN_MAX_SIZE (OUTPUT_CAPTURE_BLOCKS * OUTPUT_SAMPLE_BUFFER_SIZE)
+#define STREAM_FRAME_SIZE (sizeof(stream_frame_header_t) \
+                           + STREAM_FRAME_MAX_CHANNELS * sizeof(stream_channel_t) \
+                           + STREAM_MAIN_MAX_SIZE \
+                           + OSCILLATOR_LOGIC_MAX_TAPS * STREAM_TAP_MAX_WORDS * sizeof(uint32_t) \
+                           + STREAM_STATS_SIZE)
+
+// Кадры уходят асинхронно: пока один в очереди HTTP-сервера, собирается
+// следующий. Оба заняты - блоки копятся в кольце выхода и уйдут одним кадром.
+#define STREAM_FRAME_SLOTS 2
+// Блоков в очереди (кадр в полете плюс лишние блоки кольца), с которых блок удлиняется
+#define STREAM_QUEUE_HIGH 2
+// Кадров подряд без очереди, после которых блок укорачивается
+#define STREAM_CALM_FRAMES 32
+
+// кадр собирается здесь: заголовок, таблица каналов, основной выход, отводы
+static uint8_t frame_buffers[STREAM_FRAME_SLOTS][STREAM_FRAME_SIZE] __attribute__((aligned(4)));
+static volatile bool frame_busy[STREAM_FRAME_SLOTS];
+static uint32_t frames_since_stats = 0;
+static uint32_t frame_sequence = 0;
+static uint32_t calm_frames = 0;
+
 // execute_buffer_ready_callback
 
 // lunette.local to connect to the web server
@@ -61,22 +110,61 @@ void start_mdns_service()
     ESP_LOGI(TAG, "MDNS service started successfully");
 }
 
+// вызывается задачей HTTP-сервера, когда кадр ушел в сокет или не смог
+static void stream_frame_sent(esp_err_t err, int socket, void *arg)
+{
+    frame_busy[(intptr_t)arg] = false;
+    if (err != ESP_OK)
+    {
+        ESP_LOGD(TAG, "Stream frame was not sent: %d", err);
+    }
+}
+
+// Очередь растет - блок вдвое длиннее: меньше кадров и заголовков на секунду.
+// Долго пусто - вдвое короче ради задержки. Границы задаются у выхода.
+static void stream_adapt_block_size(int queued)
+{
+    uint32_t min_size, max_size;
+    if (output_get_stream_block_limits(output, &min_size, &max_size) != ESP_OK)
+    {
+        return;
+    }
+    uint32_t size = output_get_stream_block_size(output);
+    if (queued >= STREAM_QUEUE_HIGH)
+    {
+        calm_frames = 0;
+        if (size < max_size)
+        {
+            output_set_stream_block_size(output, size * 2);
+        }
+    }
+    else if (queued > 0)
+    {
+        calm_frames = 0;
+    }
+    else if (++calm_frames >= STREAM_CALM_FRAMES)
+    {
+        calm_frames = 0;
+        if (size > min_size)
+        {
+            output_set_stream_block_size(output, size / 2);
+        }
+    }
+}
+
 // отправляет буфер с выходными значениями на клиента
-static void send_samples_to_client()
+// стримится только основной выход, остальные экземпляры пропускаем
+static void send_samples_to_client(output_handle_t handle)
 {
-    if (!ws_connected || !ws_req_hd || ws_req_fd <= 0)
+    if (handle != output)
     {
-        ESP_LOGD(TAG, "WebSocket not connected, skipping send");
         return;
     }
 
-    // Check if connection is still valid
-    if (httpd_ws_get_fd_info(ws_req_hd, ws_req_fd) != HTTPD_WS_CLIENT_WEBSOCKET)
+    // сокет проверяет задача сервера при отправке, мертвый клиент снимается в close_fn
+    int fd = stream_fd;
+    if (fd < 0)
     {
-        ESP_LOGD(TAG, "WebSocket connection no longer valid");
-        ws_connected = false;
-        ws_req_hd = NULL;
-        ws_req_fd = 0;
         return;
     }
 
@@ -92,178 +180,369 @@ static void send_samples_to_client()
         return;
     }
 
-    int8_t samples[OUTPUT_SAMPLE_BUFFER_SIZE];
-    esp_err_t err = output_get_samples(output, samples, OUTPUT_SAMPLE_BUFFER_SIZE);
-    if (err != ESP_OK)
+    int slot = -1;
+    int in_flight = 0;
+    for (int i = 0; i < STREAM_FRAME_SLOTS; i++)
+    {
+        if (frame_busy[i])
+        {
+            in_flight++;
+        }
+        else if (slot < 0)
+        {
+            slot = i;
+        }
+    }
+    if (slot < 0)
+    {
+        // блок остается в кольце и уйдет со следующим кадром
+        stream_adapt_block_size(STREAM_FRAME_SLOTS + 1);
+        return;
+    }
+    uint8_t *frame_buffer = frame_buffers[slot];
+
+    // таблица каналов: основной выход и включенные отводы
+    stream_channel_t channels[STREAM_FRAME_MAX_CHANNELS];
+    int tap_of_channel[STREAM_FRAME_MAX_CHANNELS];
+    int channel_count = 0;
+    channels[channel_count] = (stream_channel_t){
+        .node_id = STREAM_CHANNEL_MAIN,
+        .encoding = STREAM_ENCODING_PCM8,
+        .samples_per_output = 1,
+        .length = 0,
+    };
+    tap_of_channel[channel_count++] = -1;
+    for (int t = 0; t < OSCILLATOR_LOGIC_MAX_TAPS; t++)
+    {
+        int node = oscillator_logic_get_tap_node(t);
+        if (node < 0)
+        {
+            continue;
+        }
+        channels[channel_count] = (stream_channel_t){
+            .node_id = (int16_t)node,
+            .encoding = STREAM_ENCODING_PACKED_BITS,
+            .samples_per_output = (uint8_t)oscillator_logic_get_oversampling(),
+            .length = 0,
+        };
+        tap_of_channel[channel_count++] = t;
+    }
+
+    static oscillator_logic_node_stats_t stats[OSCILLATOR_LOGIC_NODE_COUNT];
+    bool send_stats = ++frames_since_stats >= STREAM_STATS_INTERVAL
+                   && oscillator_logic_get_node_stats(stats, OSCILLATOR_LOGIC_NODE_COUNT) > 0;
+    if (send_stats)
+    {
+        frames_since_stats = 0;
+        channels[channel_count] = (stream_channel_t){
+            .node_id = STREAM_CHANNEL_STATS,
+            .encoding = STREAM_ENCODING_NODE_STATS,
+            .samples_per_output = (uint8_t)oscillator_logic_get_oversampling(),
+            .length = STREAM_STATS_SIZE,
+        };
+        tap_of_channel[channel_count++] = -1;
+    }
+
+    size_t table_size = sizeof(stream_frame_header_t) + channel_count * sizeof(stream_channel_t);
+    uint8_t *payload = frame_buffer + table_size;
+
+    // все готовые блоки подряд: кольцо пишется в этой же задаче, так что
+    // между ними нет разрывов и хватает отметки времени первого
+    uint32_t timestamp = 0;
+    int blocks = 0;
+    size_t main_length = 0;
+    while (output_samples_ready(output))
+    {
+        size_t length;
+        uint32_t first_sample;
+        esp_err_t err = output_get_samples(output, (int8_t *)payload + main_length,
+                                           STREAM_MAIN_MAX_SIZE - main_length, &length, &first_sample);
+        if (err != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Failed to get samples: %d", err);
+            break;
+        }
+        if (blocks++ == 0)
+        {
+            timestamp = first_sample;
+        }
+        main_length += length;
+    }
+    if (blocks == 0)
     {
-        ESP_LOGE(TAG, "Failed to get samples: %d", err);
         return;
     }
+    channels[0].length = main_length;
+    payload += main_length;
+    stream_adapt_block_size(in_flight + blocks - 1);
+
+    // слова отводов и счетчики копируются прямо в кадр, все смещения кратны 4
+    for (int c = 1; c < channel_count; c++)
+    {
+        if (channels[c].node_id == STREAM_CHANNEL_STATS)
+        {
+            uint32_t *out = (uint32_t *)payload;
+            *out++ = stats[0].samples;
+            for (int n = 0; n < OSCILLATOR_LOGIC_NODE_COUNT; n++)
+            {
+                *out++ = stats[n].ones;
+                *out++ = stats[n].edges;
+            }
+            payload += STREAM_STATS_SIZE;
+            continue;
+        }
+        // узел мог смениться после таблицы каналов, подпись берется у слов
+        int node;
+        size_t words = oscillator_logic_read_tap(tap_of_channel[c], (uint32_t *)payload, STREAM_TAP_MAX_WORDS, &node);
+        if (node >= 0)
+        {
+            channels[c].node_id = (int16_t)node;
+        }
+        channels[c].length = words * sizeof(uint32_t);
+        payload += channels[c].length;
+    }
+
+    stream_frame_header_t header = {
+        .version = STREAM_FRAME_VERSION,
+        .channel_count = (uint8_t)channel_count,
+        .block_size = (uint16_t)output_get_stream_block_size(output),
+        .sequence = frame_sequence++,
+        .timestamp = timestamp,
+        .sample_rate = SYSTEM_SAMPLE_RATE / output_get_stream_decimation(output),
+    };
+    memcpy(frame_buffer, &header, sizeof(header));
+    memcpy(frame_buffer + sizeof(header), channels, channel_count * sizeof(stream_channel_t));
 
     httpd_ws_frame_t ws_pkt;
     memset(&ws_pkt, 0, sizeof(httpd_ws_frame_t));
     ws_pkt.type = HTTPD_WS_TYPE_BINARY;
-    ws_pkt.payload = (uint8_t *)samples;
-    ws_pkt.len = OUTPUT_SAMPLE_BUFFER_SIZE;
+    ws_pkt.payload = frame_buffer;
+    ws_pkt.len = payload - frame_buffer;
     ws_pkt.final = true;
 
-    err = httpd_ws_send_frame_async(ws_req_hd, ws_req_fd, &ws_pkt);
+    frame_busy[slot] = true;
+    esp_err_t err = httpd_ws_send_data_async(server, fd, &ws_pkt, stream_frame_sent, (void *)(intptr_t)slot);
     if (err != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to send WebSocket frame: %d", err);
-        if (err == ESP_ERR_HTTPD_INVALID_REQ)
-        {
-            ws_connected = false;
-            ws_req_hd = NULL;
-            ws_req_fd = 0;
-        }
-    }
-    else
-    {
-        last_ws_activity = esp_timer_get_time() / 1000; // Update last activity timestamp
+        frame_busy[slot] = false;
+        ESP_LOGD(TAG, "Failed to queue WebSocket frame: %d", err);
     }
 }
 
-// WebSocket handler
-static esp_err_t ws_handler(httpd_req_t *req)
+static void ws_session_free(void *ctx)
 {
-    if (req->method == HTTP_GET)
-    {
-        // Clean up any existing connection
-        if (ws_connected)
-        {
-            ESP_LOGI(TAG, "Cleaning up existing WebSocket connection");
-            ws_connected = false;
-            ws_req_hd = NULL;
-            ws_req_fd = 0;
-        }
+    free(ctx);
+}
 
-        httpd_ws_frame_t ws_pkt;
-        memset(&ws_pkt, 0, sizeof(httpd_ws_frame_t));
-        ws_pkt.type = HTTPD_WS_TYPE_TEXT;
+// задача сервера: пинг клиенту потока, молчащий клиент закрывается
+static void ws_keepalive_work(void *arg)
+{
+    ws_session_t *session = stream_session;
+    if (!session)
+    {
+        return;
+    }
+    if (session->missed_pongs >= WS_MAX_MISSED_PONGS)
+    {
+        ESP_LOGI(TAG, "WebSocket client %d missed %d pings, closing", session->fd, WS_MAX_MISSED_PONGS);
+        httpd_sess_trigger_close(server, session->fd);
+        return;
+    }
+    // клиент, слышанный за последний интервал, пинговать незачем
+    if (esp_timer_get_time() - session->last_seen_us < (int64_t)WS_PING_INTERVAL_MS * 1000)
+    {
+        return;
+    }
 
-        ws_req_hd = req->handle;
-        ws_req_fd = httpd_req_to_sockfd(req);
+    httpd_ws_frame_t ping;
+    memset(&ping, 0, sizeof(ping));
+    ping.type = HTTPD_WS_TYPE_PING;
+    ping.final = true;
+    if (httpd_ws_send_frame_async(server, session->fd, &ping) == ESP_OK)
+    {
+        session->missed_pongs++;
+    }
+}
 
-        // Verify the connection is valid before marking as connected
-        if (httpd_ws_get_fd_info(ws_req_hd, ws_req_fd) == HTTPD_WS_CLIENT_WEBSOCKET)
-        {
-            ws_connected = true;
-            last_ws_activity = esp_timer_get_time() / 1000;
-            ESP_LOGI(TAG, "Handshake done, the new connection was opened");
+static void ws_ping_timer_callback(void *arg)
+{
+    if (server)
+    {
+        httpd_queue_work(server, ws_keepalive_work, NULL);
+    }
+}
 
-            output = output_get_instance();
-            if (!output)
-            {
-                ESP_LOGE(TAG, "Failed to get output instance");
-                ws_connected = false;
-                ws_req_hd = NULL;
-                ws_req_fd = 0;
-                return ESP_FAIL;
-            }
+// httpd закрывает сокет сам, только если close_fn не задан
+static void ws_close_fd(httpd_handle_t hd, int sockfd)
+{
+    if (sockfd == stream_fd)
+    {
+        ESP_LOGI(TAG, "WebSocket client %d disconnected", sockfd);
+        stream_fd = -1;
+        stream_session = NULL;
+        esp_timer_stop(ping_timer);
+    }
+    close(sockfd);
+}
 
-            output_register_buffer_ready_callback(&send_samples_to_client);
-            ESP_LOGI(TAG, "Buffer ready callback registered");
-        }
-        else
-        {
-            ESP_LOGE(TAG, "Invalid WebSocket connection");
-            ws_req_hd = NULL;
-            ws_req_fd = 0;
-            return ESP_FAIL;
-        }
+static esp_err_t ws_handshake(httpd_req_t *req)
+{
+    output = output_get_instance();
+    if (!output)
+    {
+        ESP_LOGE(TAG, "Failed to get output instance");
+        return ESP_FAIL;
+    }
 
-        return ESP_OK;
+    ws_session_t *session = calloc(1, sizeof(ws_session_t));
+    if (!session)
+    {
+        return ESP_ERR_NO_MEM;
     }
+    session->fd = httpd_req_to_sockfd(req);
+    session->last_seen_us = esp_timer_get_time();
+    req->sess_ctx = session;
+    req->free_ctx = ws_session_free;
 
-    // Handle WebSocket close
-    if (req->method == HTTP_DELETE)
+    // поток идет одному клиенту, прежний закрывается сразу
+    int previous = stream_fd;
+    if (previous >= 0 && previous != session->fd)
     {
-        ESP_LOGI(TAG, "WebSocket connection closed");
-        ws_connected = false;
-        ws_req_hd = NULL;
-        ws_req_fd = 0;
-        return ESP_OK;
+        ESP_LOGI(TAG, "Replacing WebSocket client %d", previous);
+        httpd_sess_trigger_close(req->handle, previous);
     }
+    stream_session = session;
+    stream_fd = session->fd;
 
+    output_register_buffer_ready_callback(&send_samples_to_client);
+    esp_timer_stop(ping_timer);
+    esp_timer_start_periodic(ping_timer, (uint64_t)WS_PING_INTERVAL_MS * 1000);
+    ESP_LOGI(TAG, "Handshake done, streaming to client %d", session->fd);
     return ESP_OK;
 }
 
-// Helper function to send file content
-static esp_err_t send_file_content(httpd_req_t *req, const char *file_path)
+// WebSocket handler: the handshake, then every frame from the client, control frames included
+static esp_err_t ws_handler(httpd_req_t *req)
 {
-    ESP_LOGD(TAG, "Opening file: %s", file_path);
+    if (req->method == HTTP_GET)
+    {
+        return ws_handshake(req);
+    }
 
-    extern const unsigned char index_html_start[] asm("_binary_index_html_start");
-    extern const unsigned char index_html_end[] asm("_binary_index_html_end");
-    extern const unsigned char index_js_start[] asm("_binary_index_js_start");
-    extern const unsigned char index_js_end[] asm("_binary_index_js_end");
-    extern const unsigned char index_css_start[] asm("_binary_index_css_start");
-    extern const unsigned char index_css_end[] asm("_binary_index_css_end");
-    extern const unsigned char audio_worklet_js_start[] asm("_binary_audio_worklet_js_start");
-    extern const unsigned char audio_worklet_js_end[] asm("_binary_audio_worklet_js_end");
-    extern const unsigned char vite_svg_start[] asm("_binary_vite_svg_start");
-    extern const unsigned char vite_svg_end[] asm("_binary_vite_svg_end");
+    uint8_t payload[WS_MAX_RECV_PAYLOAD];
+    httpd_ws_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+    esp_err_t err = httpd_ws_recv_frame(req, &frame, 0);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    if (frame.len > sizeof(payload))
+    {
+        ESP_LOGW(TAG, "WebSocket frame of %u bytes is too long", (unsigned)frame.len);
+        return ESP_FAIL;
+    }
+    if (frame.len > 0)
+    {
+        frame.payload = payload;
+        err = httpd_ws_recv_frame(req, &frame, frame.len);
+        if (err != ESP_OK)
+        {
+            return err;
+        }
+    }
 
-    const unsigned char *start = NULL;
-    const unsigned char *end = NULL;
-    esp_err_t err = ESP_OK;
+    // любой кадр от клиента - признак жизни
+    ws_session_t *session = req->sess_ctx;
+    if (session)
+    {
+        session->missed_pongs = 0;
+        session->last_seen_us = esp_timer_get_time();
+    }
 
-    // Determine which embedded file to serve
-    if (strcmp(file_path, "index.html") == 0)
+    if (frame.type == HTTPD_WS_TYPE_PING)
     {
-        start = index_html_start;
-        end = index_html_end;
-        httpd_resp_set_type(req, "text/html");
+        frame.type = HTTPD_WS_TYPE_PONG;
+        frame.final = true;
+        return httpd_ws_send_frame(req, &frame);
     }
-    else if (strcmp(file_path, "index.js") == 0)
+    if (frame.type == HTTPD_WS_TYPE_CLOSE)
+    {
+        // ответный CLOSE с тем же кодом, дальше сокет закрывается через close_fn
+        frame.final = true;
+        httpd_ws_send_frame(req, &frame);
+        return httpd_sess_trigger_close(req->handle, httpd_req_to_sockfd(req));
+    }
+    return ESP_OK;
+}
+
+// Embedded assets go out in chunks of this size straight from flash
+#define STATIC_CHUNK_SIZE 4096
+
+// true when If-None-Match lists the asset's ETag or is "*"
+static bool etag_matches(httpd_req_t *req, const char *etag)
+{
+    char if_none_match[128];
+    size_t len = httpd_req_get_hdr_value_len(req, "If-None-Match");
+    if (len == 0 || len >= sizeof(if_none_match))
     {
-        start = index_js_start;
-        end = index_js_end;
-        httpd_resp_set_type(req, "application/javascript");
+        return false;
     }
-    else if (strcmp(file_path, "index.css") == 0)
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", if_none_match, sizeof(if_none_match)) != ESP_OK)
     {
-        start = index_css_start;
-        end = index_css_end;
-        httpd_resp_set_type(req, "text/css");
+        return false;
     }
-    else if (strcmp(file_path, "audio-worklet.js") == 0)
+    return strstr(if_none_match, etag) != NULL || strcmp(if_none_match, "*") == 0;
+}
+
+// Helper function to send file content
+static esp_err_t send_file_content(httpd_req_t *req, const char *file_path)
+{
+    // query string не часть пути
+    size_t path_len = strcspn(file_path, "?#");
+    const static_asset_t *asset = static_asset_find(file_path, path_len);
+    if (!asset)
     {
-        start = audio_worklet_js_start;
-        end = audio_worklet_js_end;
-        httpd_resp_set_type(req, "application/javascript");
+        ESP_LOGW(TAG, "File not found: %.*s", (int)path_len, file_path);
+        return httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "Not found");
     }
-    else if (strcmp(file_path, "vite.svg") == 0)
+
+    // имена файлов без хэшей, поэтому браузер каждый раз сверяет ETag
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(req, "ETag", asset->etag);
+    if (etag_matches(req, asset->etag))
     {
-        start = vite_svg_start;
-        end = vite_svg_end;
-        httpd_resp_set_type(req, "image/svg+xml");
+        ESP_LOGD(TAG, "%s not modified", asset->path);
+        httpd_resp_set_status(req, "304 Not Modified");
+        return httpd_resp_send(req, NULL, 0);
     }
-    else
+
+    httpd_resp_set_type(req, asset->mime);
+    if (asset->gzip)
     {
-        ESP_LOGE(TAG, "File not found: %s", file_path);
-        return ESP_FAIL;
+        // распаковать на устройстве нечем, gzip понимают все браузеры
+        httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+        httpd_resp_set_hdr(req, "Vary", "Accept-Encoding");
     }
-    // Send the file content
-    ESP_LOGD(TAG, "File found");
-    if (start && end)
+
+    ESP_LOGD(TAG, "Sending %s: %zu bytes%s", asset->path, asset->size, asset->gzip ? " gzip" : "");
+    for (size_t offset = 0; offset < asset->size; offset += STATIC_CHUNK_SIZE)
     {
-        size_t file_size = end - start;
-        ESP_LOGD(TAG, "File size: %zu bytes", file_size);
-        err = httpd_resp_send(req, (const char *)start, file_size);
+        size_t chunk = asset->size - offset;
+        if (chunk > STATIC_CHUNK_SIZE)
+        {
+            chunk = STATIC_CHUNK_SIZE;
+        }
+        esp_err_t err = httpd_resp_send_chunk(req, (const char *)asset->data + offset, chunk);
         if (err != ESP_OK)
         {
-            ESP_LOGE(TAG, "Error sending file: %s", esp_err_to_name(err));
+            ESP_LOGE(TAG, "Error sending %s: %s", asset->path, esp_err_to_name(err));
+            // завершить chunked-ответ, сокет закроет httpd
+            httpd_resp_send_chunk(req, NULL, 0);
+            return err;
         }
     }
-    else
-    {
-        ESP_LOGE(TAG, "File content not found");
-        err = ESP_FAIL;
-    }
-
-    return err;
+    return httpd_resp_send_chunk(req, NULL, 0);
 }
 
 // Handler for root path
@@ -272,9 +551,7 @@ static esp_err_t root_handler(httpd_req_t *req)
     ESP_LOGD(TAG, "GET /");
     ESP_LOGD(TAG, "Request headers:");
 
-    // Set response headers
-    httpd_resp_set_type(req, "text/html");
-    httpd_resp_set_hdr(req, "Cache-Control", "no-cache, no-store, must-revalidate");
+    // Set response headers, type and caching come from the asset table
     httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Headers", "Content-Type, Authorization");
@@ -308,33 +585,7 @@ static esp_err_t static_handler(httpd_req_t *req)
     ESP_LOGD(TAG, "GET %s", uri);
     ESP_LOGD(TAG, "Request headers:");
 
-    // Set content type based on file extension
-    const char *content_type = "text/plain";
-    if (strstr(file_path, ".js"))
-    {
-        content_type = "application/javascript";
-    }
-    else if (strstr(file_path, ".css"))
-    {
-        content_type = "text/css";
-    }
-    else if (strstr(file_path, ".html"))
-    {
-        content_type = "text/html";
-    }
-    else if (strstr(file_path, ".png"))
-    {
-        content_type = "image/png";
-    }
-    else if (strstr(file_path, ".jpg") || strstr(file_path, ".jpeg"))
-    {
-        content_type = "image/jpeg";
-    }
-    ESP_LOGD(TAG, "Content-Type: %s", content_type);
-
-    // Set response headers
-    httpd_resp_set_type(req, content_type);
-    httpd_resp_set_hdr(req, "Cache-Control", "public, max-age=31536000");
+    // Set response headers, type and caching come from the asset table
     httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Headers", "Content-Type, Authorization");
@@ -399,9 +650,9 @@ httpd_handle_t start_webserver(void)
     // conf.httpd.max_open_sockets = max_clients;
     // conf.httpd.global_user_ctx = keep_alive;
     // conf.httpd.open_fn = wss_open_fd;
-    // conf.httpd.close_fn = wss_close_fd;
+    conf.httpd.close_fn = ws_close_fd;
     conf.httpd.uri_match_fn = uri_match_fn; // Set our custom URI matching function
-    conf.httpd.max_uri_handlers = 16; // Increase maximum number of URI handlers
+    conf.httpd.max_uri_handlers = 48; // Increase maximum number of URI handlers
     conf.httpd.max_open_sockets = 7; // Increase maximum number of open sockets
 
     extern const unsigned char certificate_pem_start[] asm("_binary_certificate_pem_start");
@@ -452,6 +703,7 @@ httpd_handle_t start_webserver(void)
         .method = HTTP_GET,
         .handler = ws_handler,
         .is_websocket = true,
+        .handle_ws_control_frames = true,
         .user_ctx = NULL,
     };
     httpd_register_uri_handler(server, &ws_uri);
@@ -477,27 +729,6 @@ httpd_handle_t start_webserver(void)
     return server;
 }
 
-// Add periodic connection check task
-static void check_ws_connection(void *arg)
-{
-    while (1)
-    {
-        if (ws_connected && ws_req_hd && ws_req_fd > 0)
-        {
-            uint32_t current_time = esp_timer_get_time() / 1000;
-            // If no activity for more than 5 seconds, consider connection dead
-            if (current_time - last_ws_activity > 5000)
-            {
-                ESP_LOGI(TAG, "WebSocket connection timeout");
-                ws_connected = false;
-                ws_req_hd = NULL;
-                ws_req_fd = 0;
-            }
-        }
-        vTaskDelay(pdMS_TO_TICKS(1000)); // Check every second
-    }
-}
-
 // Initialize and start web server
 esp_err_t web_server_init(void)
 {
@@ -516,6 +747,18 @@ esp_err_t web_server_init(void)
     // Start mDNS service
     start_mdns_service();
 
+    // keepalive pings for the stream client, running only while one is connected
+    const esp_timer_create_args_t ping_timer_args = {
+        .callback = ws_ping_timer_callback,
+        .name = "ws_ping",
+    };
+    esp_err_t err = ping_timer ? ESP_OK : esp_timer_create(&ping_timer_args, &ping_timer);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to create ping timer: %s", esp_err_to_name(err));
+        return err;
+    }
+
     // Start web server with configuration
     server = start_webserver();
     if (server == NULL)
@@ -524,9 +767,6 @@ esp_err_t web_server_init(void)
         return ESP_FAIL;
     }
 
-    // Create task to check WebSocket connection
-    xTaskCreate(check_ws_connection, "ws_check", 2048, NULL, 5, NULL);
-
     return ESP_OK;
 }
 
@@ -548,6 +788,11 @@ esp_err_t web_server_deinit(void)
     }
 
     server = NULL;
+    stream_fd = -1;
+    stream_session = NULL;
+    esp_timer_stop(ping_timer);
+    esp_timer_delete(ping_timer);
+    ping_timer = NULL;
     ESP_LOGD(TAG, "Web server stopped successfully");
     return ESP_OK;
 }
@@ -5,6 +5,8 @@
 #include "web_server.h"
 #include "oscillator_logic.h"
 #include "timer.h"
+#include "benchmark.h"
+#include "udp_stream.h"
 
 static const char *TAG = "MAIN";
 
@@ -26,4 +28,13 @@ void app_main(void)
             // Initialize oscillator logic
    ESP_ERROR_CHECK(oscillator_logic_init());
 
+    ESP_ERROR_CHECK(udp_stream_init());
+#if CONFIG_LUNETTE_UDP_STREAM_ON_BOOT
+    udp_stream_start(CONFIG_LUNETTE_UDP_STREAM_HOST, CONFIG_LUNETTE_UDP_STREAM_PORT);
+#endif
+
+#if CONFIG_LUNETTE_BENCHMARK_ON_BOOT
+    benchmark_run();
+#endif
+
 }
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdio.h>
+
+// Counts failed checks, main returns host_test_result()
+static int host_test_failures;
+
+#define CHECK(cond, ...)                                                       \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            host_test_failures++;                                              \
+            printf("FAIL %s:%d: %s: ", __FILE__, __LINE__, #cond);             \
+            printf(__VA_ARGS__);                                               \
+            printf("\n");                                                      \
+        }                                                                      \
+    } while (0)
+
+static inline int host_test_result(void)
+{
+    printf("%s\n", host_test_failures ? "FAILED" : "passed");
+    return host_test_failures ? 1 : 0;
+}
@@ -0,0 +1,148 @@
+// Modulation matrix in the engine: a zero-depth route leaves the render
+// bit-identical, a one-octave LFO sweeps the period smoothly over the whole
+// octave range, a removed route stops modulating after its ramp back, and
+// the ramped mixer with equal end weights matches the plain mixer.
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "../../components/oscillator_logic/oscillator_logic.c"
+
+#define BLOCKS 200
+#define BLOCK_WORDS 8   // 256 engine samples at 8x oversampling
+#define ENGINE_RATE (SYSTEM_SAMPLE_RATE * 8)
+#define LFO_BLOCKS 3200
+
+static int fake_output;
+
+output_handle_t output_init(int gpio_num, int8_t* value_ptr) { return &fake_output; }
+output_handle_t output_init_bitstream(int gpio_num, int16_t* value_ptr, int order) { return &fake_output; }
+esp_err_t output_deinit(output_handle_t handle) { return ESP_OK; }
+esp_err_t timer_init(void) { return ESP_OK; }
+
+static Oscillator saved_oscillators[OSCILLATOR_LOGIC_OSCILLATOR_COUNT];
+static logical_ops_t saved_logical_ops[OSCILLATOR_LOGIC_LOGICAL_OP_COUNT];
+static uint32_t reference[BLOCKS][OSCILLATOR_LOGIC_FIRST_DIVIDER_NODE][BLOCK_WORDS];
+static uint32_t lfo_words[LFO_BLOCKS * BLOCK_WORDS];
+
+// oscillators and gates, the nodes a frequency route reaches
+static long render_against_reference(bool save)
+{
+    long diff = 0;
+    for (int b = 0; b < BLOCKS; b++) {
+        oscillator_logic_render_block();
+        for (int n = 0; n < OSCILLATOR_LOGIC_FIRST_DIVIDER_NODE; n++) {
+            for (int w = 0; w < BLOCK_WORDS; w++) {
+                if (save) {
+                    reference[b][n][w] = node_words[n][w];
+                } else {
+                    diff += __builtin_popcount(reference[b][n][w] ^ node_words[n][w]);
+                }
+            }
+        }
+    }
+    return diff;
+}
+
+static void check_zero_depth(void)
+{
+    memcpy(saved_oscillators, oscillators, sizeof(oscillators));
+    memcpy(saved_logical_ops, logical_ops, sizeof(logical_ops));
+    render_against_reference(true);
+
+    mod_matrix_route_t route = {
+        .active = true, .source = MOD_MATRIX_SOURCE_LFO, .source_index = 0,
+        .dest = MOD_MATRIX_DEST_FREQUENCY, .dest_index = 0, .depth = 0.0,
+    };
+    CHECK(oscillator_logic_set_mod_route(0, &route) == ESP_OK, "zero-depth route");
+    memcpy(oscillators, saved_oscillators, sizeof(oscillators));
+    memcpy(logical_ops, saved_logical_ops, sizeof(logical_ops));
+    long diff = render_against_reference(false);
+    printf("zero depth: %ld bits differ\n", diff);
+    CHECK(diff == 0, "zero-depth route changes %ld bits", diff);
+
+    CHECK(oscillator_logic_set_mod_route(1, &(mod_matrix_route_t){ .active = true, .dest_index = OSCILLATOR_LOGIC_OSCILLATOR_COUNT }) != ESP_OK,
+          "destination past the oscillators");
+    CHECK(oscillator_logic_set_mod_route(1, &(mod_matrix_route_t){ .active = true, .depth = OSCILLATOR_LOGIC_MAX_FM_OCTAVES + 1.0 }) != ESP_OK,
+          "depth past the limit");
+}
+
+static void check_lfo_sweep(void)
+{
+    // 2 Hz sine, one octave on oscillator 0 at 440 Hz
+    CHECK(oscillator_logic_set_mod_lfo(0, MOD_MATRIX_LFO_SINE, 2.0) == ESP_OK, "LFO");
+    mod_matrix_route_t route = {
+        .active = true, .source = MOD_MATRIX_SOURCE_LFO, .source_index = 0,
+        .dest = MOD_MATRIX_DEST_FREQUENCY, .dest_index = 0, .depth = 1.0,
+    };
+    CHECK(oscillator_logic_set_mod_route(0, &route) == ESP_OK, "one-octave route");
+    CHECK(mod_matrix.routes[0].depth == 0.0, "route applied before the next block");
+    mod_matrix_t requested;
+    oscillator_logic_get_mod_matrix(&requested);
+    CHECK(requested.routes[0].depth == 1.0, "pending route not reported");
+
+    for (int b = 0; b < LFO_BLOCKS; b++) {
+        oscillator_logic_render_block();
+        memcpy(&lfo_words[b * BLOCK_WORDS], node_words[0], BLOCK_WORDS * sizeof(uint32_t));
+    }
+
+    // periods between rising edges, and the largest change from one period to
+    // the next; the first blocks hold the ramp from the plain pitch to the LFO
+    long first = 4 * BLOCK_WORDS * 32;
+    long last = -1, prev_period = 0, shortest = LONG_MAX, longest = 0, max_jump = 0;
+    bool prev_level = packed_get_bit(lfo_words, (size_t)first);
+    for (long k = first; k < (long)LFO_BLOCKS * BLOCK_WORDS * 32; k++) {
+        bool level = packed_get_bit(lfo_words, (size_t)k);
+        if (level && !prev_level) {
+            if (last >= 0) {
+                long period = k - last;
+                if (period < shortest) shortest = period;
+                if (period > longest) longest = period;
+                if (prev_period && labs(period - prev_period) > max_jump) max_jump = labs(period - prev_period);
+                prev_period = period;
+            }
+            last = k;
+        }
+        prev_level = level;
+    }
+    double center = ENGINE_RATE / 440.0;
+    printf("LFO sweep: period %ld..%ld samples (440 Hz = %.1f), largest step %ld\n", shortest, longest, center, max_jump);
+    CHECK(shortest >= center / 2.0 - 2.0 && shortest <= center / 2.0 + 4.0, "shortest period %ld", shortest);
+    CHECK(longest >= center * 2.0 - 8.0 && longest <= center * 2.0 + 2.0, "longest period %ld", longest);
+    CHECK(max_jump <= 12, "period steps by %ld samples", max_jump);
+
+    // the ramp back takes one block, after it the oscillator is plain again
+    route.active = false;
+    oscillator_logic_set_mod_route(0, &route);
+    oscillator_logic_render_block();
+    oscillator_logic_render_block();
+    CHECK(!oscillator_is_modulated(0), "oscillator still modulated");
+    CHECK(pitch_from[0] == 1.0 && pitch_to[0] == 1.0, "pitch %f -> %f", pitch_from[0], pitch_to[0]);
+}
+
+static void check_mixer_ramp(void)
+{
+    const uint32_t* inputs[DAC_MIXER_MAX_INPUTS] = { 0 };
+    for (int i = 0; i < 3; i++) {
+        inputs[i] = node_words[6 - i];
+    }
+    static int16_t plain[BLOCK_WORDS * 32];
+    static int16_t ramp[BLOCK_WORDS * 32];
+    dac_mixer_t plain_mixer = mixer;
+    dac_mixer_t ramp_mixer = mixer;
+    dac_mixer_calculate_packed(&plain_mixer, inputs, BLOCK_WORDS, plain);
+    dac_mixer_calculate_packed_ramp(&ramp_mixer, inputs, mixer.weights, mixer.weights, BLOCK_WORDS, ramp);
+    CHECK(memcmp(plain, ramp, sizeof(plain)) == 0, "ramp with equal weights differs from the plain mix");
+}
+
+int main(void)
+{
+    oscillator_logic_init();
+    oscillator_logic_set_oversampling(8);
+    oscillator_logic_render_block();
+    check_zero_depth();
+    check_lfo_sweep();
+    check_mixer_ramp();
+    return host_test_result();
+}
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""Host builds of the engine tests.
+
+Compiles each *_test.c here with the host gcc against the component
+sources it needs and a few stand-in ESP-IDF headers (stubs/), then runs
+it. The tests cover what can be measured without the board: the render
+output of the engine and its components.
+
+    python3 tools/host_test/run.py                 # all tests
+    python3 tools/host_test/run.py oscillator_alias
+
+A test prints its measurements and ends with "passed" or "FAILED".
+"""
+
+import argparse
+import glob
+import os
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(os.path.dirname(HERE))
+
+# test name -> component sources it links against
+TESTS = {
+    "oscillator_alias": [
+        "components/oscillator/oscillator.c",
+    ],
+}
+
+# sources the engine tests link against, oscillator_logic.c is included by the test
+ENGINE_SOURCES = [
+    "components/oscillator/oscillator.c",
+    "components/logical_ops/logical_ops.c",
+    "components/dac_mixer/dac_mixer.c",
+    "components/decimator/decimator.c",
+    "components/edge_engine/edge_engine.c",
+    "components/frequency_divider/frequency_divider.c",
+    "components/lfsr/lfsr.c",
+    "components/flip_flop/flip_flop.c",
+    "components/delay_line/delay_line.c",
+    "components/multiplexer/multiplexer.c",
+    "components/voice_pool/voice_pool.c",
+    "components/oscillator_bank/oscillator_bank.c",
+    "components/sequencer/sequencer.c",
+    "components/mod_matrix/mod_matrix.c",
+]
+TESTS["sequencer_segments"] = ENGINE_SOURCES
+TESTS["mod_matrix"] = ENGINE_SOURCES
+TESTS["taps"] = ENGINE_SOURCES
+
+
+def include_flags():
+    flags = ["-I" + os.path.join(HERE, "stubs"), "-I" + HERE]
+    for path in sorted(glob.glob(os.path.join(ROOT, "components", "*", "include"))):
+        flags.append("-I" + path)
+    return flags
+
+
+def run_test(name, sources, cc, workdir):
+    binary = os.path.join(workdir, name)
+    cmd = [cc, "-std=gnu17", "-O2", "-Wall", "-Wno-unused-function",
+           *include_flags(), os.path.join(HERE, name + "_test.c"),
+           *(os.path.join(ROOT, s) for s in sources), "-lm", "-o", binary]
+    build = subprocess.run(cmd, capture_output=True, text=True)
+    if build.returncode != 0:
+        print(build.stderr)
+        print(f"{name}: build failed")
+        return False
+    print(f"== {name}", flush=True)
+    return subprocess.run([binary]).returncode == 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("tests", nargs="*", help="tests to run, all by default")
+    parser.add_argument("--cc", default=os.environ.get("CC", "gcc"))
+    args = parser.parse_args()
+
+    names = args.tests or list(TESTS)
+    unknown = [n for n in names if n not in TESTS]
+    if unknown:
+        parser.error("unknown test: " + ", ".join(unknown))
+
+    failed = []
+    with tempfile.TemporaryDirectory() as workdir:
+        for name in names:
+            if not run_test(name, TESTS[name], args.cc, workdir):
+                failed.append(name)
+    print(f"{len(names) - len(failed)}/{len(names)} passed" + (": failed " + ", ".join(failed) if failed else ""))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,163 @@
+// Segmented render of sequencer steps. A step inside a block splits the
+// block into segments. Sequencers with no target split the blocks without
+// changing anything, so every node must stay bit-identical to the unsplit
+// render in the block, scalar and edge engines. Also checks that bad step
+// values are refused before a pattern is queued.
+
+#include <math.h>
+#include <string.h>
+#include "host_test.h"
+#include "../../components/oscillator_logic/oscillator_logic.c"
+
+#define BLOCKS 200
+#define BLOCK_WORDS 8   // 256 engine samples at 8x oversampling
+
+static int fake_output;
+
+output_handle_t output_init(int gpio_num, int8_t* value_ptr) { return &fake_output; }
+output_handle_t output_init_bitstream(int gpio_num, int16_t* value_ptr, int order) { return &fake_output; }
+esp_err_t output_deinit(output_handle_t handle) { return ESP_OK; }
+esp_err_t timer_init(void) { return ESP_OK; }
+
+// engine state a run changes, restored so every run starts alike
+static struct {
+    voice_pool_t voice_pool;
+    Oscillator oscillators[OSCILLATOR_LOGIC_OSCILLATOR_COUNT];
+    logical_ops_t logical_ops[OSCILLATOR_LOGIC_LOGICAL_OP_COUNT];
+    frequency_divider_t dividers[OSCILLATOR_LOGIC_DIVIDER_COUNT];
+    lfsr_t lfsrs[OSCILLATOR_LOGIC_LFSR_COUNT];
+    flip_flop_t flip_flops[OSCILLATOR_LOGIC_FLIP_FLOP_COUNT];
+    delay_line_t delay_line;
+    uint32_t delay_buffer[OSCILLATOR_LOGIC_DELAY_WORDS];
+    multiplexer_t multiplexers[OSCILLATOR_LOGIC_MULTIPLEXER_COUNT];
+} snapshot;
+
+static uint32_t reference[BLOCKS][OSCILLATOR_LOGIC_NODE_COUNT][BLOCK_WORDS];
+
+static void save_state(void)
+{
+    snapshot.voice_pool = voice_pool;
+    memcpy(snapshot.oscillators, oscillators, sizeof(oscillators));
+    memcpy(snapshot.logical_ops, logical_ops, sizeof(logical_ops));
+    memcpy(snapshot.dividers, dividers, sizeof(dividers));
+    memcpy(snapshot.lfsrs, lfsrs, sizeof(lfsrs));
+    memcpy(snapshot.flip_flops, flip_flops, sizeof(flip_flops));
+    snapshot.delay_line = delay_line;
+    memcpy(snapshot.delay_buffer, delay_buffer, sizeof(delay_buffer));
+    memcpy(snapshot.multiplexers, multiplexers, sizeof(multiplexers));
+}
+
+static void restore_state(void)
+{
+    voice_pool = snapshot.voice_pool;
+    memcpy(oscillators, snapshot.oscillators, sizeof(oscillators));
+    memcpy(logical_ops, snapshot.logical_ops, sizeof(logical_ops));
+    memcpy(dividers, snapshot.dividers, sizeof(dividers));
+    memcpy(lfsrs, snapshot.lfsrs, sizeof(lfsrs));
+    memcpy(flip_flops, snapshot.flip_flops, sizeof(flip_flops));
+    delay_line = snapshot.delay_line;
+    memcpy(delay_buffer, snapshot.delay_buffer, sizeof(delay_buffer));
+    memcpy(multiplexers, snapshot.multiplexers, sizeof(multiplexers));
+}
+
+// renders BLOCKS blocks, returns the bits that differ from the reference
+static long render_against_reference(bool save, long* events)
+{
+    long diff = 0;
+    for (int b = 0; b < BLOCKS; b++) {
+        oscillator_logic_render_block();
+        if (events) *events += (long)block_event_count;
+        for (int n = 0; n < OSCILLATOR_LOGIC_NODE_COUNT; n++) {
+            for (int w = 0; w < BLOCK_WORDS; w++) {
+                if (save) {
+                    reference[b][n][w] = node_words[n][w];
+                } else {
+                    diff += __builtin_popcount(reference[b][n][w] ^ node_words[n][w]);
+                }
+            }
+        }
+    }
+    return diff;
+}
+
+static void check_split_blocks(void)
+{
+    oscillator_logic_set_oversampling(8);
+    oscillator_logic_render_block();
+
+    // a patch that touches the stateful units: divider, flip-flop, delay, voices
+    oscillator_logic_set_divider_clock(0, 0);
+    flip_flop_set_inputs(&flip_flops[0], oscillator_logic_get_node_result_pointer(19), NULL, 19, -1);
+    flip_flop_set_clock(&flip_flops[0], oscillator_logic_get_node_result_pointer(1), 1);
+    oscillator_logic_set_delay_input(6);
+    oscillator_logic_note_on(60);
+    oscillator_logic_note_on(67);
+    oscillator_logic_render_block();
+
+    save_state();
+    render_against_reference(true, NULL);
+
+    // steps at an odd tempo land at uneven offsets inside the blocks
+    sequencer_pattern_t none = { .target = SEQUENCER_TARGET_NONE, .length = 7, .division = 16, .gates = ~0ull };
+    for (int s = 0; s < OSCILLATOR_LOGIC_SEQUENCER_COUNT; s++) {
+        CHECK(oscillator_logic_set_sequencer_pattern(s, &none) == ESP_OK, "sequencer %d", s);
+    }
+    oscillator_logic_set_tempo(287.3);
+    oscillator_logic_set_sequencers_running(true);
+
+    long events = 0;
+    restore_state();
+    long diff = render_against_reference(false, &events);
+    printf("block engine: %ld step events, %ld bits differ\n", events, diff);
+    CHECK(events > BLOCKS, "blocks were not split: %ld events", events);
+    CHECK(diff == 0, "block engine differs by %ld bits", diff);
+
+    // FM with zero depth moves osc 3 onto the scalar path without changing it
+    oscillator_logic_modulation_t fm = {
+        .fm_source = 6, .fm_mode = OSCILLATOR_LOGIC_FM_LINEAR, .fm_depth = 0.0, .sync_source = -1,
+    };
+    CHECK(oscillator_logic_set_modulation(3, &fm) == ESP_OK, "zero-depth FM");
+    restore_state();
+    diff = render_against_reference(false, NULL);
+    printf("scalar path: %ld bits differ\n", diff);
+    CHECK(diff == 0, "scalar path differs by %ld bits", diff);
+    fm.fm_source = -1;
+    oscillator_logic_set_modulation(3, &fm);
+
+    oscillator_logic_set_engine(OSCILLATOR_LOGIC_ENGINE_EDGE);
+    restore_state();
+    diff = render_against_reference(false, NULL);
+    printf("edge engine: %ld bits differ\n", diff);
+    CHECK(diff == 0, "edge engine differs by %ld bits", diff);
+    oscillator_logic_set_engine(OSCILLATOR_LOGIC_ENGINE_BLOCK);
+    oscillator_logic_set_sequencers_running(false);
+}
+
+static void check_step_values(void)
+{
+    sequencer_pattern_t p = { .target = SEQUENCER_TARGET_MIXER_WEIGHT, .length = 2, .division = 4, .values = { 100.0, -300.0 } };
+    CHECK(oscillator_logic_validate_sequencer_pattern(&p) == ESP_OK, "weights in range");
+    p.values[1] = NAN;
+    CHECK(oscillator_logic_validate_sequencer_pattern(&p) != ESP_OK, "NaN weight");
+    p.values[1] = 40000.0;
+    CHECK(oscillator_logic_validate_sequencer_pattern(&p) != ESP_OK, "weight over int16");
+    p.length = 1;
+    CHECK(oscillator_logic_validate_sequencer_pattern(&p) == ESP_OK, "steps past the length are ignored");
+
+    p = (sequencer_pattern_t){ .target = SEQUENCER_TARGET_NOTE, .length = 2, .division = 4, .values = { 60.0, 128.0 } };
+    CHECK(oscillator_logic_validate_sequencer_pattern(&p) != ESP_OK, "note 128");
+    p = (sequencer_pattern_t){ .target = SEQUENCER_TARGET_OPERATION, .length = 1, .division = 4, .values = { LOGICAL_OP_COUNT } };
+    CHECK(oscillator_logic_validate_sequencer_pattern(&p) != ESP_OK, "unknown operation");
+    p = (sequencer_pattern_t){ .target = SEQUENCER_TARGET_FREQUENCY, .length = 1, .division = 4, .values = { INFINITY } };
+    CHECK(oscillator_logic_validate_sequencer_pattern(&p) != ESP_OK, "infinite frequency");
+    p.values[0] = 1000.0;
+    CHECK(oscillator_logic_validate_sequencer_pattern(&p) == ESP_OK, "1 kHz");
+}
+
+int main(void)
+{
+    oscillator_logic_init();
+    check_split_blocks();
+    check_step_values();
+    return host_test_result();
+}
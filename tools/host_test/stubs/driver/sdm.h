@@ -0,0 +1,3 @@
+#pragma once
+
+typedef void* sdm_channel_handle_t;
@@ -0,0 +1,27 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF headers the engine components include
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int esp_err_t;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_NO_MEM 0x101
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_STATE 0x103
+#define ESP_ERR_INVALID_SIZE 0x104
+#define ESP_ERR_NOT_FOUND 0x105
+#define ESP_ERR_NOT_SUPPORTED 0x106
+#define ESP_ERR_TIMEOUT 0x107
+
+#define ESP_ERROR_CHECK(x) do { esp_err_t err_ = (x); (void)err_; } while (0)
+
+static inline const char* esp_err_to_name(esp_err_t err)
+{
+    (void)err;
+    return "error";
+}
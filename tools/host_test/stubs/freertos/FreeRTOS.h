@@ -0,0 +1,12 @@
+#pragma once
+
+#include "esp_err.h"
+
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdMS_TO_TICKS(ms) (ms)
+#define portTICK_PERIOD_MS 1
+#define portMAX_DELAY 0xffffffffu
@@ -0,0 +1,71 @@
+// Node taps: the words read from a tap match the node words block for block,
+// across the ring wrap and at x3 oversampling. A node change waits for the
+// next block and starts the ring over: nothing of the old node is read after
+// it and the drop count restarts.
+
+#include <string.h>
+#include "host_test.h"
+#include "../../components/oscillator_logic/oscillator_logic.c"
+
+static int fake_output;
+
+output_handle_t output_init(int gpio_num, int8_t* value_ptr) { return &fake_output; }
+output_handle_t output_init_bitstream(int gpio_num, int16_t* value_ptr, int order) { return &fake_output; }
+esp_err_t output_deinit(output_handle_t handle) { return ESP_OK; }
+esp_err_t timer_init(void) { return ESP_OK; }
+
+static uint32_t words[OSCILLATOR_LOGIC_TAP_RING_WORDS];
+
+// renders blocks and reads the tap after each, the words must be the block's
+static void check_block_for_block(int node, int blocks)
+{
+    size_t n_words = PACKED_WORDS((size_t)OSCILLATOR_LOGIC_BLOCK_SIZE * oscillator_logic_get_oversampling());
+    int mismatches = 0;
+    for (int b = 0; b < blocks; b++) {
+        oscillator_logic_render_block();
+        int read_node;
+        size_t count = oscillator_logic_read_tap(0, words, OSCILLATOR_LOGIC_TAP_RING_WORDS, &read_node);
+        if (count != n_words || read_node != node || memcmp(words, node_words[node], n_words * sizeof(uint32_t)) != 0) {
+            mismatches++;
+        }
+    }
+    CHECK(mismatches == 0, "node %d: %d of %d blocks differ", node, mismatches, blocks);
+}
+
+int main(void)
+{
+    oscillator_logic_init();
+    oscillator_logic_set_oversampling(3);
+    oscillator_logic_render_block();
+
+    int node = 0;
+    CHECK(oscillator_logic_set_taps(&node, 1) == ESP_OK, "tap on node 0");
+    CHECK(oscillator_logic_get_tap_node(0) == 0, "requested node not reported");
+    CHECK(taps[0].node_id == -1, "node changed before the next block");
+    // 3 words a block do not divide the ring, so the blocks wrap around it
+    check_block_for_block(0, 1000);
+
+    // fill the ring past full, then move the tap without reading it
+    for (int b = 0; b < 400; b++) {
+        oscillator_logic_render_block();
+    }
+    CHECK(oscillator_logic_get_tap_dropped(0) > 0, "full ring dropped nothing");
+    node = 1;
+    oscillator_logic_set_taps(&node, 1);
+    check_block_for_block(1, 1);
+    CHECK(oscillator_logic_get_tap_dropped(0) == 0, "drop count kept after a node change");
+    check_block_for_block(1, 10);
+
+    // a tap turned off keeps nothing for the reader
+    for (int b = 0; b < 4; b++) {
+        oscillator_logic_render_block();
+    }
+    node = -1;
+    oscillator_logic_set_taps(&node, 1);
+    oscillator_logic_render_block();
+    int read_node;
+    size_t count = oscillator_logic_read_tap(0, words, OSCILLATOR_LOGIC_TAP_RING_WORDS, &read_node);
+    CHECK(count == 0 && read_node == -1, "tap off: %zu words of node %d", count, read_node);
+
+    return host_test_result();
+}
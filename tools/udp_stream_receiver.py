@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""Receiver for the LUNETTE UDP audio stream.
+
+Listens for the RTP-like packets sent by components/udp_stream: a 12-byte
+RTP header (RFC 3550) followed by signed 8-bit samples. Counts lost and
+reordered packets by sequence number, tracks interarrival jitter and can
+write the audio to a WAV file.
+
+    python3 tools/udp_stream_receiver.py --port 5004 --wav out.wav
+
+Start the stream with POST /api/udp-stream {"enabled": true, "host": "<this machine>", "port": 5004}.
+--self-test sends a synthetic stream with a gap and a swapped pair over
+loopback and checks the counters, no device needed.
+"""
+
+import argparse
+import socket
+import struct
+import sys
+import threading
+import time
+import wave
+
+HEADER = struct.Struct("!BBHII")
+PAYLOAD_TYPE = 96
+
+
+class StreamStats:
+    def __init__(self, sample_rate):
+        self.sample_rate = sample_rate
+        self.received = 0
+        self.lost = 0
+        self.reordered = 0
+        self.duplicates = 0
+        self.jitter = 0.0           # RFC 3550 interarrival jitter, in samples
+        self.highest = None         # extended highest sequence number
+        self.seen = set()
+        self.last_transit = None
+        self.ssrc = None
+
+    def add(self, seq, timestamp, ssrc, arrival):
+        if ssrc != self.ssrc:
+            # new stream: the device picks a fresh SSRC and sequence on start
+            self.__init__(self.sample_rate)
+            self.ssrc = ssrc
+        self.received += 1
+
+        if self.highest is None:
+            self.highest = seq
+            extended = seq
+        else:
+            delta = (seq - self.highest) & 0xFFFF
+            if delta < 0x8000:
+                extended = self.highest + delta
+                if delta == 0:
+                    self.duplicates += 1
+                    return False
+                self.lost += delta - 1
+                self.highest = extended
+            else:
+                extended = self.highest - (0x10000 - delta)
+                if extended in self.seen:
+                    self.duplicates += 1
+                    return False
+                # late packet fills a gap counted as lost
+                self.reordered += 1
+                self.lost -= 1
+        self.seen.add(extended)
+
+        transit = arrival * self.sample_rate - timestamp
+        if self.last_transit is not None:
+            d = abs(transit - self.last_transit)
+            self.jitter += (d - self.jitter) / 16.0
+        self.last_transit = transit
+        return True
+
+    def summary(self):
+        expected = self.received + self.lost
+        loss = 100.0 * self.lost / expected if expected else 0.0
+        return (f"received {self.received} lost {self.lost} ({loss:.2f}%) "
+                f"reordered {self.reordered} duplicates {self.duplicates} "
+                f"jitter {1000.0 * self.jitter / self.sample_rate:.2f} ms")
+
+
+def parse_packet(data):
+    if len(data) < HEADER.size:
+        return None
+    first, second, seq, timestamp, ssrc = HEADER.unpack_from(data)
+    if first >> 6 != 2 or (second & 0x7F) != PAYLOAD_TYPE:
+        return None
+    return seq, timestamp, ssrc, bool(second & 0x80), data[HEADER.size:]
+
+
+def receive(sock, stats, wav_file=None, duration=None, report_every=1.0, quiet=False):
+    start = time.monotonic()
+    next_report = start + report_every
+    sock.settimeout(0.2)
+    while duration is None or time.monotonic() - start < duration:
+        try:
+            data, _ = sock.recvfrom(2048)
+        except socket.timeout:
+            continue
+        packet = parse_packet(data)
+        if packet is None:
+            continue
+        seq, timestamp, ssrc, _marker, payload = packet
+        if stats.add(seq, timestamp, ssrc, time.monotonic()) and wav_file:
+            # WAV wants unsigned 8-bit
+            wav_file.writeframes(bytes((b + 128) & 0xFF for b in payload))
+        now = time.monotonic()
+        if not quiet and now >= next_report:
+            print(stats.summary(), flush=True)
+            next_report = now + report_every
+    return stats
+
+
+def self_test(port):
+    rx = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    rx.bind(("127.0.0.1", port))
+    stats = StreamStats(10000)
+    # 0..99 without 40 and with 60/61 swapped, sequence wraps past 65535
+    order = [s for s in range(100) if s != 40]
+    i = order.index(60)
+    order[i], order[i + 1] = order[i + 1], order[i]
+
+    def send():
+        tx = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        for s in order:
+            seq = (65500 + s) & 0xFFFF
+            header = HEADER.pack(0x80, PAYLOAD_TYPE | (0x80 if s == 0 else 0), seq, s * 64, 0x1234)
+            tx.sendto(header + bytes(64), ("127.0.0.1", port))
+        tx.close()
+
+    sender = threading.Thread(target=send)
+    sender.start()
+    receive(rx, stats, duration=1.0, quiet=True)
+    sender.join()
+    rx.close()
+    print(stats.summary())
+    ok = stats.received == 99 and stats.lost == 1 and stats.reordered == 1
+    print("self-test", "passed" if ok else "FAILED")
+    return 0 if ok else 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--bind", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=5004)
+    parser.add_argument("--rate", type=int, default=10000, help="stream sample rate, see GET /api/udp-stream")
+    parser.add_argument("--wav", help="write the received audio to this file")
+    parser.add_argument("--duration", type=float, help="stop after this many seconds")
+    parser.add_argument("--self-test", action="store_true")
+    args = parser.parse_args()
+
+    if args.self_test:
+        return self_test(args.port)
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind((args.bind, args.port))
+    print(f"listening on {args.bind}:{args.port}")
+    wav_file = None
+    if args.wav:
+        wav_file = wave.open(args.wav, "wb")
+        wav_file.setnchannels(1)
+        wav_file.setsampwidth(1)
+        wav_file.setframerate(args.rate)
+    stats = StreamStats(args.rate)
+    try:
+        receive(sock, stats, wav_file, args.duration)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if wav_file:
+            wav_file.close()
+        print(stats.summary())
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())